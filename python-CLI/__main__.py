@@ -8,11 +8,15 @@ import os
 
 
 from .common import calculate_wait_time
-from .actions import reboot_device, update_display
+from .actions import reboot_device, update_display, flush_config
 from .security import get_api_key, DEFAULT_API_KEY
-from .items import get_items,  add_item,  delete_item,  replace_all_items,  setup_temporary_item,  setup_multiple_items
-from .settings import get_setting, get_all_settings, change_api_key, trigger_factory_reset, trigger_manual_factory_reset, download_config_file, list_files, update_wifi_settings, update_hostname
-from .status import check_status
+from .items import get_items,  get_item,  add_item,  update_item,  delete_item,  replace_all_items,  setup_temporary_item,  setup_multiple_items
+from .settings import get_setting, get_all_settings, change_api_key, trigger_factory_reset, trigger_manual_factory_reset, download_config_file, upload_config_file, list_files, update_wifi_settings, update_hostname
+from .status import check_status, get_snapshot
+from .stress import run_stress_test
+from .zones import get_zones, set_zones
+from .animations import upload_animation, list_animations, delete_animation
+from .events import watch_events
 
 
 
@@ -48,6 +52,8 @@ def main():
                               help='Turn display on/off (true/false)')
     update_parser.add_argument('--loopItems', type=lambda x: (str(x).lower() == 'true'),
                               help='Loop through items when reaching the end (true/false)')
+    update_parser.add_argument('--frame-rate', dest='frameRate', type=int,
+                              help='Render frame rate in frames per second (1-200)')
     update_parser.add_argument('--mode', type=str, choices=['text', 'twinkle'], 
                               help='Display mode for current item ("text" or "twinkle")')
     update_parser.add_argument('--text', type=str, 
@@ -73,8 +79,8 @@ def main():
     
     # Add item command
     add_item_parser = subparsers.add_parser('add-item', help='Add a new display item')
-    add_item_parser.add_argument('--mode', type=str, choices=['text', 'twinkle'], required=True,
-                               help='Display mode ("text" or "twinkle")')
+    add_item_parser.add_argument('--mode', type=str, choices=['text', 'twinkle', 'layers', 'bitmap', 'animation'], required=True,
+                               help='Display mode ("text", "twinkle", "layers", "bitmap" or "animation")')
     add_item_parser.add_argument('--text', type=str, 
                                help='Text to display (required for text mode)')
     add_item_parser.add_argument('--alignment', type=str, choices=['left', 'center', 'right', 'scroll_left', 'scroll_right'], default='scroll_left',
@@ -87,17 +93,77 @@ def main():
                                help='Delete after playing (default: false)')
     add_item_parser.add_argument('--max-plays', type=int, default=0,
                                help='Maximum times to play item (0 = unlimited, default: 0)')
+    add_item_parser.add_argument('--layers', type=str,
+                               help='Layer stack for layers mode, bottom first, as mode:op pairs '
+                                    '(op is or, xor or andnot), e.g. "twinkle:or,text:xor"')
+    add_item_parser.add_argument('--file', type=str,
+                               help='Uploaded animation name (for bitmap and animation modes)')
+    add_item_parser.add_argument('--frame-delay', type=int, default=0,
+                               help='ms per animation frame (0 = the file\'s own timing, default: 0)')
+    
+    # Get one item command
+    get_item_parser = subparsers.add_parser('get-item', help='Get one display item by its id')
+    get_item_parser.add_argument('--id', type=int, required=True,
+                               help='Item id (shown by get-items and add-item)')
+    
+    # Update item command
+    update_item_parser = subparsers.add_parser('update-item', help='Change some fields of one display item')
+    update_item_parser.add_argument('--id', type=int, required=True,
+                                  help='Item id (shown by get-items and add-item)')
+    update_item_parser.add_argument('--text', type=str,
+                                  help='New text')
+    update_item_parser.add_argument('--alignment', type=str, choices=['left', 'center', 'right', 'scroll_left', 'scroll_right'],
+                                  help='New text alignment')
+    update_item_parser.add_argument('--brightness', type=int, choices=range(0, 16),
+                                  help='New brightness (0-15)')
+    update_item_parser.add_argument('--duration', type=int,
+                                  help='New duration in ms (0 = forever)')
+    update_item_parser.add_argument('--json', type=str,
+                                  help='Any other fields, as a JSON object (e.g. \'{"mode": "twinkle"}\')')
     
     # Delete item command
     delete_item_parser = subparsers.add_parser('delete-item', help='Delete a display item')
-    delete_item_parser.add_argument('--index', type=int, required=True,
-                                  help='Index of the item to delete')
+    delete_target = delete_item_parser.add_mutually_exclusive_group(required=True)
+    delete_target.add_argument('--id', type=int,
+                             help='Id of the item to delete (any zone)')
+    delete_target.add_argument('--index', type=int,
+                             help='Index of the item to delete in the primary playlist')
     
     # Replace all items command
     replace_items_parser = subparsers.add_parser('replace-items', help='Replace all display items with new ones')
     replace_items_parser.add_argument('--file', type=str, required=True,
                                     help='JSON file containing array of items to use')
     
+    # Animation file commands
+    upload_anim_parser = subparsers.add_parser('upload-animation', help='Upload a .anim file (see tools/make_animation.py)')
+    upload_anim_parser.add_argument('--name', type=str, required=True,
+                                  help='Name items refer to (1-20 letters, digits, _ or -)')
+    upload_anim_parser.add_argument('--file', type=str, required=True,
+                                  help='.anim file to upload')
+    list_anim_parser = subparsers.add_parser('list-animations', help='List animation files on the device')
+    delete_anim_parser = subparsers.add_parser('delete-animation', help='Delete an animation file')
+    delete_anim_parser.add_argument('--name', type=str, required=True,
+                                  help='Animation to delete')
+    
+    # Event stream
+    watch_parser = subparsers.add_parser('watch', help='Print events pushed by the device over /ws')
+    watch_parser.add_argument('--count', type=int, default=0,
+                            help='Stop after this many events (default: run until Ctrl+C)')
+    watch_parser.add_argument('--raw', action='store_true', help='Print the JSON as received')
+    
+    # Snapshot of the display
+    snapshot_parser = subparsers.add_parser('snapshot', help='Show or save what the display is showing')
+    snapshot_parser.add_argument('--output', type=str, help='File to save (default: print as text)')
+    snapshot_parser.add_argument('--format', choices=['pbm', 'png'], default='png',
+                               help='Image format when saving (default: png)')
+    snapshot_parser.add_argument('--scale', type=int, default=1, help='Pixels per LED, 1-8 (default: 1)')
+    
+    # Zone commands
+    get_zones_parser = subparsers.add_parser('get-zones', help='Show the display zones')
+    set_zones_parser = subparsers.add_parser('set-zones', help='Split the display into zones')
+    set_zones_parser.add_argument('--file', type=str, required=True,
+                                help='JSON file with "main" (startCol/width) and a "zones" array')
+    
     # WiFi update command
     update_wifi_parser = subparsers.add_parser('update-wifi', help='Update WiFi credentials')
     update_wifi_parser.add_argument('--ssid', type=str, required=True,
@@ -112,6 +178,9 @@ def main():
     # Reboot device command
     reboot_parser = subparsers.add_parser('reboot', help='Reboot the device')
     
+    # Flush config command
+    flush_parser = subparsers.add_parser('flush', help='Write pending config changes to flash now')
+    
     # Demo command
     demo_parser = subparsers.add_parser('demo', help='Run a demonstration of different settings')
     
@@ -141,9 +210,20 @@ def main():
     download_config_parser.add_argument('--output', type=str, 
                                       help='Output filename (default: config.json or security_config.json)')
     
+    # Upload config file command
+    upload_config_parser = subparsers.add_parser('upload-config', help='Replace the device config with a JSON file')
+    upload_config_parser.add_argument('file', type=str, help='Config JSON, as saved by download-config')
+    
     # List files command
     list_files_parser = subparsers.add_parser('list-files', help='List all files on the device')
     
+    # Stress test command
+    stress_parser = subparsers.add_parser('stress', help='Fire concurrent API calls and report render-frame latency')
+    stress_parser.add_argument('--workers', type=int, default=4,
+                               help='Number of concurrent API clients (default: 4)')
+    stress_parser.add_argument('--duration', type=int, default=20,
+                               help='Test duration in seconds (default: 20)')
+    
     args = parser.parse_args()
     
     # If no command is specified, show help
@@ -174,6 +254,8 @@ def main():
             settings['displayOn'] = args.displayOn
         if args.loopItems is not None:
             settings['loopItems'] = args.loopItems
+        if args.frameRate is not None:
+            settings['frameRate'] = args.frameRate
         
         # Current item settings
         if args.mode:
@@ -231,11 +313,55 @@ def main():
             item["text"] = args.text
             item["alignment"] = args.alignment
         
+        # Add layer stack for layers mode
+        if args.mode == 'layers':
+            if not args.layers:
+                print("❌ Error: --layers is required for layers mode")
+                sys.exit(1)
+            
+            item["layers"] = []
+            for spec in args.layers.split(','):
+                layer_mode, _, op = spec.strip().partition(':')
+                item["layers"].append({"mode": layer_mode, "op": op or "or"})
+                if layer_mode == 'text':
+                    item["text"] = args.text or "Layered"
+                    item["alignment"] = args.alignment
+        
+        # Frame file for bitmap and animation modes
+        if args.mode in ('bitmap', 'animation'):
+            if not args.file:
+                print(f"❌ Error: --file is required for {args.mode} mode")
+                sys.exit(1)
+            
+            item["file"] = args.file
+            item["frameDelay"] = args.frame_delay
+            item["alignment"] = args.alignment if args.alignment in ('left', 'right') else 'center'
+        
         # Add the item
         add_item(args.host, item, api_key)
     
+    elif args.command == 'get-item':
+        get_item(args.host, args.id, api_key)
+    
+    elif args.command == 'update-item':
+        changes = {}
+        if args.json:
+            try:
+                changes = json.loads(args.json)
+            except json.JSONDecodeError as e:
+                print(f"❌ Error: Invalid JSON: {e}")
+                sys.exit(1)
+        for field, value in (("text", args.text), ("alignment", args.alignment),
+                             ("brightness", args.brightness), ("duration", args.duration)):
+            if value is not None:
+                changes[field] = value
+        if not changes:
+            print("❌ Error: Nothing to change")
+            sys.exit(1)
+        update_item(args.host, args.id, changes, api_key)
+    
     elif args.command == 'delete-item':
-        delete_item(args.host, args.index, api_key)
+        delete_item(args.host, api_key, item_id=args.id, index=args.index)
     
     elif args.command == 'replace-items':
         try:
@@ -254,6 +380,41 @@ def main():
             print(f"❌ Error: File '{args.file}' not found")
             sys.exit(1)
     
+    elif args.command == 'upload-animation':
+        upload_animation(args.host, args.name, args.file, api_key)
+    
+    elif args.command == 'list-animations':
+        list_animations(args.host, api_key)
+    
+    elif args.command == 'delete-animation':
+        delete_animation(args.host, args.name, api_key)
+    
+    elif args.command == 'snapshot':
+        get_snapshot(args.host, api_key, args.output, args.format, args.scale)
+    
+    elif args.command == 'watch':
+        watch_events(args.host, api_key, args.count, args.raw)
+    
+    elif args.command == 'get-zones':
+        get_zones(args.host, api_key)
+    
+    elif args.command == 'set-zones':
+        try:
+            with open(args.file, 'r') as f:
+                layout = json.load(f)
+            
+            if not isinstance(layout, dict) or not isinstance(layout.get("zones"), list):
+                print("❌ Error: File must contain an object with a \"zones\" array")
+                sys.exit(1)
+            
+            set_zones(args.host, layout, api_key)
+        except json.JSONDecodeError:
+            print("❌ Error: Invalid JSON file")
+            sys.exit(1)
+        except FileNotFoundError:
+            print(f"❌ Error: File '{args.file}' not found")
+            sys.exit(1)
+    
     elif args.command == 'demo':
         print("🚀 Running LED Matrix Demo")
         
@@ -424,10 +585,17 @@ def main():
         print(f"📥 Downloading {args.type} config file")
         download_config_file(args.host, api_key, args.type, args.output)
     
+    elif args.command == 'upload-config':
+        print(f"📤 Uploading config file {args.file}")
+        upload_config_file(args.host, api_key, args.file)
+    
     elif args.command == 'list-files':
         print("📋 Listing files on device")
         list_files(args.host, api_key)
     
+    elif args.command == 'stress':
+        run_stress_test(args.host, api_key, args.workers, args.duration)
+    
     elif args.command == 'update-wifi':
         print("📡 Updating WiFi Settings")
         update_wifi_settings(args.host, args.ssid, args.password, api_key)
@@ -440,5 +608,9 @@ def main():
         print("🔄 Rebooting Device")
         reboot_device(args.host, api_key)
     
+    elif args.command == 'flush':
+        print("💾 Flushing Config")
+        flush_config(args.host, api_key)
+    
 if __name__ == "__main__":
     main()
\ No newline at end of file
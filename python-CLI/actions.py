@@ -37,6 +37,30 @@ def update_display(host, settings, api_key, retries=3, timeout=10):
     print("Failed to update settings after multiple attempts")
     return False
 
+def flush_config(host, api_key):
+    """Write pending config changes to flash now."""
+    headers = {"X-API-Key": api_key}
+    
+    try:
+        response = requests.post(f"http://{host}/flush", headers=headers, timeout=10)
+        if response.status_code == 200:
+            data = response.json()
+            if data.get("written"):
+                print("✅ Pending changes written")
+            else:
+                print("✅ Nothing pending; config already saved")
+            print(f"   Writes since boot: {data.get('writes')}, bytes written: {data.get('bytesWritten')}")
+            return True
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+            if response.text:
+                print(f"   Message: {response.text}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return False
+
 def reboot_device(host, api_key, retries=3):
     """Reboot the device."""
     headers = {"X-API-Key": api_key}
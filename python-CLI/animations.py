@@ -0,0 +1,71 @@
+import os
+import requests
+
+
+def upload_animation(host, name, path, api_key):
+    """Upload a .anim file (see tools/make_animation.py) under a name."""
+    try:
+        with open(path, "rb") as f:
+            data = f.read()
+    except FileNotFoundError:
+        print(f"❌ Error: File '{path}' not found")
+        return False
+
+    print(f"Uploading {os.path.basename(path)} ({len(data)} bytes) as '{name}'...")
+    try:
+        response = requests.post(f"http://{host}/animations", params={"name": name}, data=data,
+                                 headers={"X-API-Key": api_key, "Content-Type": "application/octet-stream"},
+                                 timeout=30)
+        if response.status_code == 200:
+            info = response.json()
+            print(f"✅ Animation '{name}' stored: {info.get('frames')} frames, {info.get('width')} columns")
+            return True
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+            if response.text:
+                print(f"   Message: {response.text}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return False
+
+
+def list_animations(host, api_key):
+    """List the animation files on the device."""
+    try:
+        response = requests.get(f"http://{host}/animations", headers={"X-API-Key": api_key}, timeout=10)
+        if response.status_code == 200:
+            data = response.json()
+            print(f"🎞️  Animations ({data.get('freeBytes')} bytes of flash free):")
+            for anim in data.get("animations", []):
+                if "error" in anim:
+                    print(f"   {anim['name']}: {anim['error']}")
+                else:
+                    print(f"   {anim['name']}: {anim['frames']} frames, {anim['width']} columns, "
+                          f"{anim['frameDelay']}ms, {anim['bytes']} bytes")
+            return data
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return None
+
+
+def delete_animation(host, name, api_key):
+    """Remove an animation file."""
+    try:
+        response = requests.post(f"http://{host}/animations/delete", params={"name": name},
+                                 headers={"X-API-Key": api_key}, timeout=10)
+        if response.status_code == 200:
+            print(f"✅ Animation '{name}' deleted")
+            return True
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return False
@@ -0,0 +1,108 @@
+import base64
+import json
+import os
+import socket
+import struct
+from urllib.parse import quote
+
+
+def _recv_exact(sock, n):
+    data = b""
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise ConnectionError("connection closed")
+        data += chunk
+    return data
+
+
+def _send_frame(sock, opcode, payload=b""):
+    # Client frames must be masked
+    mask = os.urandom(4)
+    header = bytes([0x80 | opcode])
+    if len(payload) < 126:
+        header += bytes([0x80 | len(payload)])
+    else:
+        header += bytes([0x80 | 126]) + struct.pack(">H", len(payload))
+    masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+    sock.sendall(header + mask + masked)
+
+
+def _read_message(sock):
+    """Next text message, answering pings on the way. None when closed."""
+    while True:
+        b0, b1 = _recv_exact(sock, 2)
+        opcode = b0 & 0x0F
+        length = b1 & 0x7F
+        if length == 126:
+            length = struct.unpack(">H", _recv_exact(sock, 2))[0]
+        elif length == 127:
+            length = struct.unpack(">Q", _recv_exact(sock, 8))[0]
+        payload = _recv_exact(sock, length)
+
+        if opcode == 0x1:
+            return payload.decode("utf-8", "replace")
+        if opcode == 0x8:
+            return None
+        if opcode == 0x9:
+            _send_frame(sock, 0xA, payload)
+
+
+def watch_events(host, api_key, count=0, raw=False):
+    """Subscribe to /ws and print events as they arrive (Ctrl+C to stop)."""
+    hostname, _, port = host.partition(":")
+    port = int(port) if port else 80
+    key = base64.b64encode(os.urandom(16)).decode()
+
+    try:
+        sock = socket.create_connection((hostname, port), timeout=10)
+        sock.sendall((f"GET /ws?api_key={quote(api_key)} HTTP/1.1\r\n"
+                      f"Host: {host}\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Connection: Upgrade\r\n"
+                      f"Sec-WebSocket-Key: {key}\r\n"
+                      "Sec-WebSocket-Version: 13\r\n\r\n").encode())
+
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = sock.recv(1024)
+            if not chunk:
+                break
+            response += chunk
+        status = response.split(b"\r\n", 1)[0].decode(errors="replace")
+        if " 101 " not in status:
+            if " 401 " in status:
+                print("❌ Error: Unauthorized - Invalid API key")
+            else:
+                print(f"❌ Error: WebSocket upgrade failed ({status})")
+            return False
+
+        print(f"📡 Watching events on {host} (Ctrl+C to stop)")
+        sock.settimeout(None)
+        seen = 0
+        while not count or seen < count:
+            message = _read_message(sock)
+            if message is None:
+                print("Connection closed by device")
+                break
+            seen += 1
+            if raw:
+                print(message)
+                continue
+            try:
+                event = json.loads(message)
+            except json.JSONDecodeError:
+                print(message)
+                continue
+            name = event.pop("event", "?")
+            t = event.pop("t", 0)
+            details = ", ".join(f"{k}={v}" for k, v in event.items())
+            print(f"[{t / 1000:10.3f}s] {name:<14} {details}")
+        _send_frame(sock, 0x8)
+        sock.close()
+        return True
+    except KeyboardInterrupt:
+        return True
+    except (OSError, ConnectionError) as e:
+        print(f"❌ Connection Error: {e}")
+    return False
@@ -52,6 +52,7 @@ def add_item(host, item, api_key, retries=3):
                 data = response.json()
                 print("✅ Item added successfully!")
                 print(f"   Item index: {data.get('index')}")
+                print(f"   Item id: {data.get('id')}")
                 return True
             elif response.status_code == 401:
                 print("❌ Error: Unauthorized - Invalid API key")
@@ -73,17 +74,93 @@ def add_item(host, item, api_key, retries=3):
     print("Failed to add item after multiple attempts")
     return False
 
-def delete_item(host, index, api_key, retries=3):
-    """Delete an item from the display playlist."""
+def get_item(host, item_id, api_key, retries=3):
+    """Get one display item by its ID."""
     headers = {"X-API-Key": api_key}
     
     for attempt in range(retries):
         try:
-            print(f"Deleting display item at index {index} (attempt {attempt+1}/{retries})...")
-            response = requests.post(f"http://{host}/items/delete", 
-                                    json={"index": index},
-                                    headers=headers,
-                                    timeout=10)
+            response = requests.get(f"http://{host}/items/{item_id}", headers=headers, timeout=10)
+            if response.status_code == 200:
+                data = response.json()
+                print(f"📋 Item {item_id} (zone {data.get('zone')}, index {data.get('index')}):")
+                print(json.dumps(data.get('item'), indent=2))
+                return data
+            elif response.status_code == 401:
+                print("❌ Error: Unauthorized - Invalid API key")
+                print("Check your API key and try again")
+                return None
+            elif response.status_code == 404:
+                print(f"❌ Error: No item with id {item_id}")
+                return None
+            else:
+                print(f"❌ Error: Received status code {response.status_code}")
+                if attempt < retries - 1:
+                    print("Retrying in 1 second...")
+                    time.sleep(1)
+        except requests.exceptions.RequestException as e:
+            print(f"❌ Connection Error: {e}")
+            if attempt < retries - 1:
+                print("Retrying in 1 second...")
+                time.sleep(1)
+    
+    print("Failed to retrieve item after multiple attempts")
+    return None
+
+def update_item(host, item_id, changes, api_key, retries=3):
+    """Change some fields of one display item, leaving the others as they are."""
+    headers = {"X-API-Key": api_key}
+    
+    for attempt in range(retries):
+        try:
+            print(f"Updating display item {item_id} (attempt {attempt+1}/{retries})...")
+            response = requests.patch(f"http://{host}/items/{item_id}", 
+                                      json=changes,
+                                      headers=headers,
+                                      timeout=10)
+            if response.status_code == 200:
+                print("✅ Item updated successfully!")
+                return True
+            elif response.status_code == 401:
+                print("❌ Error: Unauthorized - Invalid API key")
+                print("Check your API key and try again")
+                return False
+            elif response.status_code in (400, 404):
+                print(f"❌ Error: {response.json().get('error', response.text)}")
+                return False
+            else:
+                print(f"❌ Error: Received status code {response.status_code}")
+                if response.text:
+                    print(f"   Message: {response.text}")
+                if attempt < retries - 1:
+                    print(f"Retrying in 1 second...")
+                    time.sleep(1)
+        except requests.exceptions.RequestException as e:
+            print(f"❌ Connection Error: {e}")
+            if attempt < retries - 1:
+                print(f"Retrying in 1 second...")
+                time.sleep(1)
+    
+    print("Failed to update item after multiple attempts")
+    return False
+
+def delete_item(host, api_key, item_id=None, index=None, retries=3):
+    """Delete an item by its ID (any zone) or by its index in the primary playlist."""
+    headers = {"X-API-Key": api_key}
+    
+    for attempt in range(retries):
+        try:
+            if item_id is not None:
+                print(f"Deleting display item {item_id} (attempt {attempt+1}/{retries})...")
+                response = requests.delete(f"http://{host}/items/{item_id}", 
+                                           headers=headers,
+                                           timeout=10)
+            else:
+                print(f"Deleting display item at index {index} (attempt {attempt+1}/{retries})...")
+                response = requests.post(f"http://{host}/items/delete", 
+                                        json={"index": index},
+                                        headers=headers,
+                                        timeout=10)
             if response.status_code == 200:
                 data = response.json()
                 print("✅ Item deleted successfully!")
@@ -93,6 +170,9 @@ def delete_item(host, index, api_key, retries=3):
                 print("❌ Error: Unauthorized - Invalid API key")
                 print("Check your API key and try again")
                 return False
+            elif response.status_code == 404:
+                print(f"❌ Error: No item with id {item_id}")
+                return False
             else:
                 print(f"❌ Error: Received status code {response.status_code}")
                 if response.text:
@@ -246,6 +326,15 @@ def setup_multiple_items(host, api_key):
                 "brightness": 10,
                 "duration": 8000,
                 "invert": False
+                },
+                {
+                "mode": "life",
+                "lifeRule": "B3/S23",
+                "lifeSpeed": 120,
+                "lifeDensity": 35,
+                "brightness": 10,
+                "duration": 10000,
+                "invert": False
                 }
             ]
     
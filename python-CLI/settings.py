@@ -254,6 +254,34 @@ def download_config_file(host, api_key, config_type, output_file=None, retries=3
     print("Failed to download config file after multiple attempts")
     return False
 
+def upload_config_file(host, api_key, input_file):
+    """Replace the device config with a JSON export (as saved by download-config)."""
+    headers = {"X-API-Key": api_key, "Content-Type": "application/json"}
+    
+    try:
+        with open(input_file, 'r') as f:
+            data = json.load(f)
+    except (OSError, json.JSONDecodeError) as e:
+        print(f"❌ Error: Cannot read '{input_file}': {e}")
+        return False
+    
+    try:
+        response = requests.post(f"http://{host}/upload_config", headers=headers,
+                                 data=json.dumps(data), timeout=10)
+        if response.status_code == 200:
+            result = response.json()
+            print(f"✅ Config uploaded: {result.get('items')} item(s), {result.get('zones')} zone(s)")
+            return True
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+            if response.text:
+                print(f"   Message: {response.text}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return False
+
 def list_files(host, api_key, retries=3):
     """List all files on the device's filesystem."""
     headers = {"X-API-Key": api_key}
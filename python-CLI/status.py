@@ -28,3 +28,35 @@ def check_status(host, api_key=None, retries=3):
     print("Failed to connect after multiple attempts")
     print("Check that the device is powered on and connected to your network")
     return False
+
+
+def get_snapshot(host, api_key, output=None, fmt="pbm", scale=1):
+    """Fetch what the display is showing. Saves it to output, or prints it
+    as text art when no output file is given."""
+    if output is None:
+        fmt, scale = "pbm", 1
+    try:
+        response = requests.get(f"http://{host}/snapshot", params={"format": fmt, "scale": scale},
+                                headers={"X-API-Key": api_key}, timeout=10)
+        if response.status_code == 200:
+            if output:
+                with open(output, "wb") as f:
+                    f.write(response.content)
+                print(f"✅ Snapshot saved to {output}")
+                return True
+
+            # P4: "P4\n<w> <h>\n" then rows packed MSB first, 1 = lit
+            _, size, pixels = response.content.split(b"\n", 2)
+            width, height = (int(v) for v in size.split())
+            row_bytes = (width + 7) // 8
+            for y in range(height):
+                row = pixels[y * row_bytes:(y + 1) * row_bytes]
+                print("".join("█" if row[x // 8] & (0x80 >> (x % 8)) else "·" for x in range(width)))
+            return True
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return False
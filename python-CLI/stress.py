@@ -0,0 +1,108 @@
+import time
+import threading
+import requests
+
+
+def get_debug(host, api_key):
+    """Fetch the /debug document, or None on failure."""
+    try:
+        response = requests.get(f"http://{host}/debug", headers={"X-API-Key": api_key}, timeout=10)
+        if response.status_code == 200:
+            return response.json()
+        print(f"❌ Error: /debug returned status code {response.status_code}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return None
+
+
+def _hammer(host, api_key, stop_event, results, worker_id):
+    """Fire API calls back to back until told to stop."""
+    headers = {"X-API-Key": api_key}
+    session = requests.Session()
+    calls = 0
+    errors = 0
+    latencies = []
+
+    while not stop_event.is_set():
+        # Alternate a cheap read, a heavy read and a display update
+        try:
+            start = time.time()
+            if calls % 3 == 0:
+                response = session.get(f"http://{host}/status", timeout=10)
+            elif calls % 3 == 1:
+                response = session.get(f"http://{host}/items", headers=headers, timeout=10)
+            else:
+                response = session.post(f"http://{host}/update_display",
+                                        json={"brightness": 3 + (calls + worker_id) % 8},
+                                        headers=headers, timeout=10)
+            latencies.append(time.time() - start)
+            if response.status_code != 200:
+                errors += 1
+        except requests.exceptions.RequestException:
+            errors += 1
+        calls += 1
+
+    results[worker_id] = (calls, errors, latencies)
+
+
+def run_stress_test(host, api_key, workers=4, duration=20):
+    """Hammer the API from several threads and report render-frame latency."""
+    print(f"🔥 Stress test: {workers} concurrent clients for {duration}s")
+
+    before = get_debug(host, api_key)
+    if before is None:
+        print("Failed to read frame statistics before the test")
+        return False
+
+    stop_event = threading.Event()
+    results = {}
+    threads = [threading.Thread(target=_hammer, args=(host, api_key, stop_event, results, i))
+               for i in range(workers)]
+    for thread in threads:
+        thread.start()
+
+    # Sample the frame clock while the API is under load
+    worst_jitter = 0
+    worst_frame = 0
+    lowest_fps = None
+    end_time = time.time() + duration
+    while time.time() < end_time:
+        time.sleep(2)
+        sample = get_debug(host, api_key)
+        if sample is None:
+            continue
+        clock = sample.get("frameClock", {})
+        worst_jitter = max(worst_jitter, clock.get("maxJitterUs", 0))
+        worst_frame = max(worst_frame, clock.get("maxFrameTimeUs", 0))
+        fps = clock.get("achievedFps")
+        if fps:
+            lowest_fps = fps if lowest_fps is None else min(lowest_fps, fps)
+
+    stop_event.set()
+    for thread in threads:
+        thread.join()
+
+    after = get_debug(host, api_key)
+    if after is None:
+        print("Failed to read frame statistics after the test")
+        return False
+
+    calls = sum(r[0] for r in results.values())
+    errors = sum(r[1] for r in results.values())
+    latencies = sorted(l for r in results.values() for l in r[2])
+    missed = after["frameClock"]["missedDeadlines"] - before["frameClock"]["missedDeadlines"]
+    frames = after["frameClock"]["frames"] - before["frameClock"]["frames"]
+    render = after.get("renderTask", {})
+
+    print("📊 Results:")
+    print(f"   API calls: {calls} ({calls / duration:.1f}/s), errors: {errors}")
+    if latencies:
+        p95 = latencies[int(len(latencies) * 0.95) - 1]
+        print(f"   API latency: median {latencies[len(latencies) // 2] * 1000:.0f}ms, p95 {p95 * 1000:.0f}ms")
+    print(f"   Target FPS: {after['frameClock']['targetFps']}, lowest achieved: {lowest_fps}")
+    print(f"   Frames rendered: {frames}, missed deadlines: {missed}")
+    print(f"   Worst frame jitter: {worst_jitter}us, worst render time: {worst_frame}us")
+    print(f"   Render task core: {render.get('core')}, "
+          f"max command latency: {render.get('maxCommandLatencyUs')}us, "
+          f"dropped commands: {render.get('commandsDropped')}")
+    return True
@@ -0,0 +1,46 @@
+import json
+import requests
+
+
+def get_zones(host, api_key):
+    """Show the display zones and what each one is playing."""
+    try:
+        response = requests.get(f"http://{host}/zones", headers={"X-API-Key": api_key}, timeout=10)
+        if response.status_code == 200:
+            data = response.json()
+            print(f"🗺️  Display Zones ({data.get('columns')} columns):")
+            for zone in data.get("zones", []):
+                print(f"   [{zone['index']}] {zone['name'] or '(unnamed)'}: "
+                      f"columns {zone['startCol']}-{zone['startCol'] + zone['width'] - 1}, "
+                      f"item {zone['currentItemIndex'] + 1}/{zone['itemCount']} ({zone.get('mode', '-')})")
+            return data
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return None
+
+
+def set_zones(host, layout, api_key):
+    """Replace the zone layout.
+
+    layout is {"main": {"startCol", "width"}, "zones": [{"name", "startCol",
+    "width", "loopItems", "items": [...]}]}; columns count from the left.
+    """
+    try:
+        response = requests.post(f"http://{host}/zones", json=layout,
+                                 headers={"X-API-Key": api_key}, timeout=10)
+        if response.status_code == 200:
+            print(f"✅ Zones updated: {response.json().get('zones')} zone(s)")
+            return True
+        elif response.status_code == 401:
+            print("❌ Error: Unauthorized - Invalid API key")
+        else:
+            print(f"❌ Error: Received status code {response.status_code}")
+            if response.text:
+                print(f"   Message: {response.text}")
+    except requests.exceptions.RequestException as e:
+        print(f"❌ Connection Error: {e}")
+    return False
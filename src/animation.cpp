@@ -0,0 +1,240 @@
+#include "includes/animation.h"
+#include <esp_timer.h>
+
+// Initialize global variables
+AnimationStats animationStats;
+
+// Frames skipped at most in one update when playback falls behind; past
+// that the clock is reset rather than decoding a backlog
+#define ANIMATION_MAX_CATCH_UP 4
+
+bool animationNameValid(const String& name) {
+  if (name.length() == 0 || name.length() > ANIMATION_MAX_NAME) return false;
+
+  for (size_t i = 0; i < name.length(); i++) {
+    char c = name[i];
+    if (!isalnum(c) && c != '_' && c != '-') return false;
+  }
+  return true;
+}
+
+String animationPath(const String& name) {
+  return String(ANIMATION_DIR) + name + ANIMATION_EXT;
+}
+
+static uint16_t readU16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+bool animationReadHeader(File& file, AnimationHeader& header, String& error) {
+  uint8_t raw[ANIMATION_HEADER_BYTES];
+  if (file.read(raw, sizeof(raw)) != sizeof(raw)) {
+    error = "File too short";
+    return false;
+  }
+  if (memcmp(raw, ANIMATION_MAGIC, 4) != 0) {
+    error = "Not an animation file";
+    return false;
+  }
+  if (raw[4] != ANIMATION_VERSION) {
+    error = "Unsupported version " + String(raw[4]);
+    return false;
+  }
+
+  header.width = readU16(raw + 6);
+  header.frameCount = readU16(raw + 8);
+  header.frameDelay = readU16(raw + 10);
+
+  if (header.width == 0 || header.width > FRAME_COLS) {
+    error = "Width must be 1-" + String(FRAME_COLS);
+    return false;
+  }
+  if (header.frameCount == 0) {
+    error = "No frames";
+    return false;
+  }
+  return true;
+}
+
+bool animationValidate(File& file, AnimationHeader& header, String& error) {
+  if (!animationReadHeader(file, header, error)) return false;
+
+  size_t pos = ANIMATION_HEADER_BYTES;
+  size_t size = file.size();
+  for (uint16_t i = 0; i < header.frameCount; i++) {
+    uint8_t head[3];
+    if (!file.seek(pos) || file.read(head, sizeof(head)) != sizeof(head)) {
+      error = "Frame " + String(i) + " is missing";
+      return false;
+    }
+
+    uint16_t len = readU16(head + 1);
+    if (head[0] > ANIM_FRAME_DELTA || len > ANIMATION_MAX_PAYLOAD || pos + sizeof(head) + len > size) {
+      error = "Frame " + String(i) + " is corrupt";
+      return false;
+    }
+    if (i == 0 && head[0] == ANIM_FRAME_DELTA) {
+      error = "First frame cannot be a delta";
+      return false;
+    }
+    pos += sizeof(head) + len;
+  }
+  return true;
+}
+
+// Expand PackBits into out (exactly width bytes), XORing when delta is set
+static bool unpackBits(const uint8_t* in, size_t len, uint8_t* out, uint16_t width, bool delta) {
+  size_t pos = 0;
+  uint16_t col = 0;
+
+  while (pos < len && col < width) {
+    int8_t n = (int8_t)in[pos++];
+    if (n >= 0) {
+      uint16_t count = n + 1;
+      if (pos + count > len || col + count > width) return false;
+      for (uint16_t i = 0; i < count; i++) {
+        out[col] = delta ? (out[col] ^ in[pos + i]) : in[pos + i];
+        col++;
+      }
+      pos += count;
+    } else if (n != -128) {
+      uint16_t count = 1 - n;
+      if (pos >= len || col + count > width) return false;
+      uint8_t value = in[pos++];
+      for (uint16_t i = 0; i < count; i++) {
+        out[col] = delta ? (out[col] ^ value) : value;
+        col++;
+      }
+    }
+  }
+
+  return col == width;
+}
+
+// Read and decode the frame at the file position into player.frame
+static bool decodeNextFrame(AnimationPlayer& player) {
+  int64_t start = esp_timer_get_time();
+
+  // Wrap around after the last frame
+  if (player.frameIndex + 1 >= player.header.frameCount || player.file.position() >= player.file.size()) {
+    player.file.seek(ANIMATION_HEADER_BYTES);
+    memset(player.frame, 0, sizeof(player.frame));
+    player.frameIndex = 0xFFFF;   // Next frame is 0
+  }
+
+  uint8_t head[3];
+  uint8_t payload[ANIMATION_MAX_PAYLOAD];
+  bool ok = player.file.read(head, sizeof(head)) == sizeof(head);
+  uint16_t len = ok ? readU16(head + 1) : 0;
+  ok = ok && len <= sizeof(payload) && player.file.read(payload, len) == len;
+
+  if (ok) {
+    switch (head[0]) {
+      case ANIM_FRAME_RAW:
+        ok = len == player.header.width;
+        if (ok) memcpy(player.frame, payload, len);
+        break;
+      case ANIM_FRAME_RLE:
+        ok = unpackBits(payload, len, player.frame, player.header.width, false);
+        break;
+      case ANIM_FRAME_DELTA:
+        ok = unpackBits(payload, len, player.frame, player.header.width, true);
+        break;
+      default:
+        ok = false;
+        break;
+    }
+  }
+
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+  animationStats.lastDecodeUs = elapsed;
+  if (elapsed > animationStats.maxDecodeUs) animationStats.maxDecodeUs = elapsed;
+
+  if (!ok) {
+    animationStats.decodeErrors++;
+    return false;
+  }
+
+  player.frameIndex++;
+  animationStats.framesDecoded++;
+  animationStats.bytesRead += sizeof(head) + len;
+  return true;
+}
+
+bool animationOpen(AnimationPlayer& player, const String& name) {
+  animationClose(player);
+  memset(player.frame, 0, sizeof(player.frame));
+
+  if (!animationNameValid(name)) {
+    Serial.println("⚠️ Invalid animation name: '" + name + "'");
+    return false;
+  }
+
+  player.file = SPIFFS.open(animationPath(name), "r");
+  if (!player.file) {
+    Serial.println("⚠️ Animation not found: " + name);
+    return false;
+  }
+
+  String error;
+  if (!animationReadHeader(player.file, player.header, error)) {
+    Serial.println("⚠️ Animation " + name + ": " + error);
+    player.file.close();
+    return false;
+  }
+
+  player.open = true;
+  player.frameIndex = 0xFFFF;   // Next frame is 0
+  player.frameTime = millis();
+  if (!decodeNextFrame(player)) {
+    Serial.println("⚠️ Animation " + name + ": bad first frame");
+    animationClose(player);
+    return false;
+  }
+  return true;
+}
+
+void animationClose(AnimationPlayer& player) {
+  if (player.open) player.file.close();
+  player.open = false;
+}
+
+void animationUpdate(AnimationPlayer& player, const DisplayItem& item) {
+  if (!player.open || item.mode != MODE_ANIMATION || player.header.frameCount < 2) return;
+
+  uint32_t delay = item.params.frames.frameDelay > 0 ? item.params.frames.frameDelay : player.header.frameDelay;
+  if (delay == 0) delay = 100;
+
+  unsigned long now = millis();
+  uint8_t steps = 0;
+  while (now - player.frameTime >= delay) {
+    if (steps++ == ANIMATION_MAX_CATCH_UP) {
+      player.frameTime = now;
+      break;
+    }
+    if (!decodeNextFrame(player)) {
+      // Leave the last good frame up; try from the start next time
+      player.frameIndex = player.header.frameCount;
+      player.frameTime = now;
+      break;
+    }
+    player.frameTime += delay;
+  }
+}
+
+void animationDraw(const AnimationPlayer& player, const DisplayItem& item,
+                   uint16_t firstCol, uint16_t cols) {
+  int32_t width = player.open ? player.header.width : 0;
+  int32_t span = cols;
+  int32_t left;
+
+  if (item.alignment == PA_LEFT) {
+    left = 0;
+  } else if (item.alignment == PA_RIGHT) {
+    left = span - width;
+  } else {
+    left = (span - width) / 2;
+  }
+
+  fbDrawColumns(player.frame, width, left, firstCol, cols, item.invert);
+}
@@ -4,18 +4,457 @@
 #include "includes/config.h"
 #include "includes/effects.h"
 #include "includes/display.h"
+#include "includes/display_backend.h"
+#include "includes/framebuffer.h"
+#include "includes/frame_clock.h"
+#include "includes/render_task.h"
+#include "includes/text_raster.h"
+#include "includes/compositor.h"
+#include "includes/zones.h"
+#include "includes/animation.h"
+#include "includes/realtime.h"
+#include "includes/events.h"
+#include "includes/preview.h"
+#include "includes/metrics.h"
+#include "includes/request_body.h"
+#include "includes/config_edit.h"
+#include "includes/deferred_response.h"
+#include "includes/persistence.h"
+#include "includes/config_binary.h"
+#include "includes/config_log.h"
+#include "includes/item_index.h"
+#include "includes/effect_registry.h"
+#include "includes/loop_functions.h"
 #include "includes/utils.h"
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
+#include <esp_timer.h>
+#include <atomic>
 
 // Initialize web server on port 80
 AsyncWebServer server(80);
 
+// Requests being timed, from the first callback for one until its
+// connection closes. Body and upload chunks arrive before the request
+// handler runs, and a reply may be sent long after it returns (see
+// deferred_response.h), so timing the handler alone would miss both.
+// Only touched on the web server task.
+typedef struct {
+  AsyncWebServerRequest* request;   // NULL = free
+  int endpoint;
+  int64_t startUs;
+} RequestTiming;
+
+static RequestTiming requestTimings[METRICS_MAX_TIMED_REQUESTS];
+
+// Start timing request unless it already is. False if too many are.
+static bool startRequestTiming(AsyncWebServerRequest *request, int endpoint) {
+  RequestTiming* slot = NULL;
+  for (RequestTiming& timing : requestTimings) {
+    if (timing.request == request) return true;
+    if (timing.request == NULL && slot == NULL) slot = &timing;
+  }
+  if (slot == NULL) return false;
+
+  slot->request = request;
+  slot->endpoint = endpoint;
+  slot->startUs = esp_timer_get_time();
+  request->onDisconnect([request]() {
+    for (RequestTiming& timing : requestTimings) {
+      if (timing.request != request) continue;
+      metricsRequestDone(timing.endpoint, (uint32_t)(esp_timer_get_time() - timing.startUs));
+      timing.request = NULL;
+    }
+  });
+  return true;
+}
+
+// server.on(), also counting requests and timing them under the path
+static AsyncCallbackWebHandler& onTracked(const char* uri, WebRequestMethodComposite method,
+                                          ArRequestHandlerFunction onRequest,
+                                          ArUploadHandlerFunction onUpload = nullptr,
+                                          ArBodyHandlerFunction onBody = nullptr) {
+  int endpoint = metricsRegisterEndpoint(uri, method);
+  if (onUpload) {
+    onUpload = [endpoint, onUpload](AsyncWebServerRequest *request, const String& filename, size_t index,
+                                    uint8_t *data, size_t len, bool final) {
+      if (index == 0) startRequestTiming(request, endpoint);
+      onUpload(request, filename, index, data, len, final);
+    };
+  }
+  if (onBody) {
+    onBody = [endpoint, onBody](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index,
+                                size_t total) {
+      if (index == 0) startRequestTiming(request, endpoint);
+      onBody(request, data, len, index, total);
+    };
+  }
+  return server.on(uri, method, [endpoint, onRequest](AsyncWebServerRequest *request) {
+    if (startRequestTiming(request, endpoint)) {
+      onRequest(request);
+      return;
+    }
+    // Too many requests in flight to follow this one: time the handler
+    int64_t start = esp_timer_get_time();
+    onRequest(request);
+    metricsRequestDone(endpoint, (uint32_t)(esp_timer_get_time() - start));
+  }, onUpload, onBody);
+}
+
+typedef struct {
+  unsigned long parsed;        // Bodies assembled and handed to a handler
+  unsigned long chunks;        // Chunks received for them
+  unsigned long invalidJson;
+  unsigned long tooLarge;      // Refused: over MAX_REQUEST_BODY_BYTES
+  unsigned long noMemory;
+  unsigned long badChunks;
+  size_t largestBody;
+} RequestBodyStats;
+
+static RequestBodyStats bodyStats;
+
+typedef std::function<void(AsyncWebServerRequest*, JsonDocument&)> JsonBodyHandler;
+
+// Body handler that puts the chunks of a JSON body back together (see
+// request_body.h), parses the whole body once and passes it to handler.
+// Nothing is buffered for requests without a valid API key; their
+// request handler answers 401.
+static ArBodyHandlerFunction jsonBody(JsonBodyHandler handler) {
+  return [handler](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (index == 0 && !validateApiKey(request)) return;
+
+    bodyStats.chunks++;
+    switch (requestBodyAppend(&request->_tempObject, data, len, index, total, MAX_REQUEST_BODY_BYTES)) {
+      case REQUEST_BODY_PENDING:
+      case REQUEST_BODY_IGNORED:
+        return;
+      case REQUEST_BODY_TOO_LARGE:
+        bodyStats.tooLarge++;
+        Serial.printf("⚠️ Request body of %u bytes refused\n", (unsigned)total);
+        request->send(413, "application/json", "{\"error\":\"Request body too large\"}");
+        return;
+      case REQUEST_BODY_NO_MEMORY:
+        bodyStats.noMemory++;
+        Serial.printf("❌ No memory for a %u byte request body\n", (unsigned)total);
+        request->send(503, "application/json", "{\"error\":\"Out of memory\"}");
+        return;
+      case REQUEST_BODY_BAD_CHUNK:
+        bodyStats.badChunks++;
+        request->send(400, "application/json", "{\"error\":\"Incomplete request body\"}");
+        return;
+      case REQUEST_BODY_COMPLETE:
+        break;
+    }
+
+    if (total > bodyStats.largestBody) bodyStats.largestBody = total;
+
+    // Strings are copied into the document, so the body can go before the handler runs
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, (const char*)requestBodyData(request->_tempObject), total);
+    requestBodyRelease(&request->_tempObject);
+    if (error) {
+      bodyStats.invalidJson++;
+      Serial.print("❌ ERROR: JSON parse error: ");
+      Serial.println(error.c_str());
+      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+      return;
+    }
+
+    bodyStats.parsed++;
+    handler(request, doc);
+  };
+}
+
+// Live preview on the status page: decodes /preview packets (realtime
+// format, see realtime_packet.h) onto a canvas
+static const char previewHtml[] = R"rawliteral(
+<h2>Live Preview</h2>
+<canvas id='preview' width='960' height='80' style='background:#111;max-width:100%'></canvas>
+<p>API key <input id='key' type='password'>
+fps <input id='fps' type='number' value='10' min='1' max='25' style='width:4em'>
+<button onclick='connect()'>Connect</button> <span id='state'></span></p>
+<script>
+var COLS = 96, DEV = 12, S = 10, ws = null, rows = [];
+var ctx = document.getElementById('preview').getContext('2d');
+function draw() {
+  for (var r = 0; r < rows.length; r++) {
+    for (var col = 0; col < COLS; col++) {
+      var lit = (rows[r][col >> 3] >> (col & 7)) & 1;
+      var x = COLS - 1 - col;   // Frame column 0 is the rightmost
+      ctx.fillStyle = lit ? '#ff3020' : '#301010';
+      ctx.beginPath();
+      ctx.arc(x * S + S / 2, r * S + S / 2, S * 0.4, 0, 6.3);
+      ctx.fill();
+    }
+  }
+}
+function onPacket(data) {
+  var b = new Uint8Array(data), p = 12;
+  if (b.length < p || b[0] != 76 || b[1] != 82) return;
+  if (b[2] == 0) {
+    for (var r = 0; r < 8; r++) rows[r] = b.slice(p + r * DEV, p + (r + 1) * DEV);
+  } else if (b[2] == 1 && rows.length == 8) {
+    var mask = b[p++];
+    for (var r = 0; r < 8; r++) {
+      if (mask & (1 << r)) { rows[r] = b.slice(p, p + DEV); p += DEV; }
+    }
+  }
+  draw();
+}
+function setState(text) { document.getElementById('state').textContent = text; }
+function connect() {
+  if (ws) ws.close();
+  var key = document.getElementById('key').value;
+  localStorage.setItem('ledApiKey', key);
+  ws = new WebSocket('ws://' + location.host + '/preview?api_key=' + encodeURIComponent(key) +
+                     '&fps=' + document.getElementById('fps').value);
+  ws.binaryType = 'arraybuffer';
+  ws.onopen = function() { setState('connected'); };
+  ws.onclose = function() { setState('disconnected'); rows = []; };
+  ws.onmessage = function(e) { onPacket(e.data); };
+}
+document.getElementById('fps').onchange = function() {
+  if (ws && ws.readyState == 1) ws.send(this.value);
+};
+var saved = localStorage.getItem('ledApiKey');
+if (saved) { document.getElementById('key').value = saved; connect(); }
+</script>
+)rawliteral";
+
+// Animation upload being written to flash (one at a time)
+#define ANIMATION_UPLOAD_TMP ANIMATION_DIR "upload.tmp"
+static File animationUpload;
+static AsyncWebServerRequest* animationUploader = NULL;
+static bool animationUploadFailed = false;
+
+// Parse one item (POST /items, items_replace, zones)
+static void parseItem(DisplayItem& item, JsonObject itemObj) {
+  // Get the mode with "text" as default; resolved once, here
+  String mode = itemObj["mode"] | "text";
+  item.setMode(effectModeFromName(mode));
+  
+  // Handle mode-specific parameters
+  parseEffectParams(item, itemObj);
+  if (item.mode == MODE_UNKNOWN || (item.mode == MODE_LAYERS && item.layers().empty())) {
+    // If an unknown mode is specified, default to text
+    Serial.print("⚠️ Unknown mode: '");
+    Serial.print(mode);
+    Serial.println("', defaulting to 'text'");
+    item.setMode(MODE_TEXT);
+    item.text = "Unknown Mode";
+  }
+  
+  // Common parameters for all modes
+  item.invert = itemObj["invert"] | false;
+  item.brightness = itemObj["brightness"] | DEFAULT_BRIGHTNESS;
+  item.duration = itemObj["duration"] | 0;
+  item.playCount = itemObj["playCount"] | 0;
+  item.maxPlays = itemObj["maxPlays"] | 0;
+  item.deleteAfterPlay = itemObj["deleteAfterPlay"] | false;
+}
+
+static const char* alignmentName(uint8_t alignment) {
+  return alignment == PA_LEFT ? "left" : 
+        (alignment == PA_RIGHT ? "right" : 
+        (alignment == PA_CENTER ? "center" : 
+        (alignment == PA_SCROLL_LEFT ? "scroll_left" : "scroll_right")));
+}
+
+// Write one item as the API shows it (GET /items, GET /items/{id}): the
+// common fields and the parameters of its mode
+static void writeItem(JsonObject itemObj, const DisplayItem& item) {
+  itemObj["id"] = item.id;
+  itemObj["mode"] = effectModeName(item.mode);
+  serializeEffectParams(itemObj, item);
+  itemObj["alignment"] = alignmentName(item.alignment);
+  itemObj["invert"] = item.invert;
+  itemObj["brightness"] = item.brightness;
+  itemObj["duration"] = item.duration;
+  itemObj["playCount"] = item.playCount;
+  itemObj["maxPlays"] = item.maxPlays;
+  itemObj["deleteAfterPlay"] = item.deleteAfterPlay;
+  const ModeParams* text = item.paramsFor(MODE_TEXT);
+  if (text) {
+    itemObj["rasterUs"] = text->text.rasterUs;
+    itemObj["rasterBytes"] = text->text.rasterBytes;
+  }
+}
+
+// Item ID from an /items/{id} path, 0 if it is not a number
+static uint32_t itemIdFromUrl(AsyncWebServerRequest *request) {
+  String id = request->url().substring(strlen("/items/"));
+  if (id.length() == 0 || id.length() > 10) return 0;
+  for (size_t i = 0; i < id.length(); i++) {
+    if (!isdigit((unsigned char)id[i])) return 0;
+  }
+  return strtoul(id.c_str(), NULL, 10);
+}
+
+// Copy a field from a PATCH body if it is there
+template <typename T>
+static void patchField(JsonObject patch, const char* key, T& field) {
+  JsonVariant value = patch[key];
+  if (!value.isNull()) field = value.as<T>();
+}
+
+// Apply the fields present in a PATCH body, leaving the rest as they are.
+// Returns false, with the item untouched, if the result would be unusable.
+static bool patchItem(DisplayItem& item, JsonObject patch, String& error) {
+  DisplayItem patched = item;
+
+  // A new mode starts from its defaults; the body then fills them in
+  if (!patch["mode"].isNull()) {
+    String mode = patch["mode"].as<String>();
+    EffectMode newMode = effectModeFromName(mode);
+    if (newMode == MODE_UNKNOWN) {
+      error = "Unknown mode: " + mode;
+      return false;
+    }
+    if (newMode != patched.mode) patched.setMode(newMode);
+  }
+  if (patch["layers"].is<JsonArray>() && parseLayers(patched, patch["layers"].as<JsonArray>()) == 0) {
+    error = "layers has no usable layer";
+    return false;
+  }
+  if (patched.mode == MODE_UNKNOWN) {
+    error = "Unknown mode";
+    return false;
+  }
+  if (patched.mode == MODE_LAYERS && patched.layers().empty()) {
+    error = "layers mode needs layers";
+    return false;
+  }
+
+  if (patch["alignment"].is<String>()) {
+    String alignment = patch["alignment"].as<String>();
+    if (alignment != "left" && alignment != "right" && alignment != "center" &&
+        alignment != "scroll_left" && alignment != "scroll_right") {
+      error = "Unknown alignment: " + alignment;
+      return false;
+    }
+  }
+
+  // Parameters of the item's mode (its layers' modes for a layered item);
+  // fields of other modes have nowhere to go and are ignored
+  parseEffectParams(patched, patch);
+
+  patchField(patch, "brightness", patched.brightness);
+  patchField(patch, "duration", patched.duration);
+  patchField(patch, "playCount", patched.playCount);
+  patchField(patch, "maxPlays", patched.maxPlays);
+  if (!patch["invert"].isNull()) patched.invert = patch["invert"].as<bool>();
+  if (!patch["deleteAfterPlay"].isNull()) patched.deleteAfterPlay = patch["deleteAfterPlay"].as<bool>();
+
+  item = std::move(patched);
+  return true;
+}
+
+// Reapply an item that was changed or removed if its zone is showing it
+static void reloadIfCurrent(ConfigEditResult& result, uint8_t zone, uint16_t slot) {
+  if ((int)slot != zoneAt(zone).currentItemIndex) return;
+  zoneAt(zone).itemStartTime = 0;
+  if (zone == 0) result.reload = true;
+  if (!config.zones.empty()) zoneRuntime(zone)->reload = true;
+}
+
+// Remove an item by ID from whichever zone has it, keeping that zone's
+// place in its playlist and never leaving it empty. False if there is no
+// such item.
+static bool deleteItemById(ConfigEditResult& result, uint32_t id) {
+  uint8_t zone;
+  uint16_t slot;
+  if (findItemById(id, &zone, &slot) == NULL) return false;
+
+  DisplayZone& target = zoneAt(zone);
+  bool wasCurrent = (int)slot == target.currentItemIndex;
+  logItemDeleted(id);
+  target.items.erase(target.items.begin() + slot);
+  invalidateItemIndex();
+
+  if ((int)slot < target.currentItemIndex) target.currentItemIndex--;
+  if (target.currentItemIndex >= (int)target.items.size()) target.currentItemIndex = 0;
+  if (target.items.empty()) {
+    createDefaultItem(target);
+    target.currentItemIndex = 0;
+  }
+  if (wasCurrent) reloadIfCurrent(result, zone, target.currentItemIndex);
+
+  result.reply["status"] = "success";
+  result.reply["message"] = "Item deleted successfully";
+  result.reply["remaining"] = target.items.size();
+  return true;
+}
+
+// Reply to /flush once the main loop has written the config, or 503
+// after CONFIG_FLUSH_TIMEOUT_MS
+class ConfigFlushResponse : public DeferredResponse {
+ public:
+  ConfigFlushResponse(bool wasDirty) : wasDirty(wasDirty), started(millis()) {}
+
+ protected:
+  AsyncWebServerResponse* poll() override {
+    if (configDirty()) {
+      if (millis() - started < CONFIG_FLUSH_TIMEOUT_MS) return NULL;
+      return new AsyncBasicResponse(503, "application/json", "{\"error\":\"Config write did not complete\"}");
+    }
+
+    JsonDocument responseDoc;
+    responseDoc["status"] = "success";
+    responseDoc["written"] = wasDirty;
+    responseDoc["writes"] = persistStats.writes;
+    responseDoc["bytesWritten"] = persistStats.bytesWritten;
+    
+    String response;
+    serializeJson(responseDoc, response);
+    return new AsyncBasicResponse(200, "application/json", response);
+  }
+
+ private:
+  bool wasDirty;
+  unsigned long started;
+};
+
+// Restart asked for by /reboot or /manual_factory_reset, carried out by
+// the main loop
+static std::atomic<bool> restartPending(false);
+static bool restartClearsWifi = false;
+static unsigned long restartRequestedMs = 0;
+
+static void scheduleRestart(bool clearWifi) {
+  if (restartPending.load(std::memory_order_acquire)) return;
+  restartClearsWifi = clearWifi;
+  restartRequestedMs = millis();
+  requestConfigFlush();
+  restartPending.store(true, std::memory_order_release);
+}
+
+void pumpRestart() {
+  if (!restartPending.load(std::memory_order_acquire)) return;
+
+  // Give the reply and the message time to go out, then the config write
+  // up to CONFIG_FLUSH_TIMEOUT_MS
+  unsigned long elapsed = millis() - restartRequestedMs;
+  if (elapsed < API_RESTART_DELAY_MS) return;
+  if (configDirty() && elapsed < API_RESTART_DELAY_MS + CONFIG_FLUSH_TIMEOUT_MS) return;
+
+  if (configDirty()) Serial.println("⚠️ Restarting with config changes not written");
+  if (restartClearsWifi) {
+    WiFi.disconnect(true, true);
+    Serial.println("WiFi credentials cleared");
+  }
+  ESP.restart();
+}
+
+uint32_t restartPollMs() {
+  return restartPending.load(std::memory_order_relaxed) ? CONFIG_EDIT_POLL_MS : UINT32_MAX;
+}
+
 void setupApiEndpoints() {
   Serial.println("Setting up API endpoints...");
+  initConfigEdits();
   
   // Debug endpoint - no authentication needed
-  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onTracked("/", HTTP_GET, [](AsyncWebServerRequest *request) {
     String html = "<html><head><title>ESP32 LED Matrix</title></head>";
     html += "<body style='font-family: Arial, sans-serif; margin: 20px;'>";
     html += "<h1>ESP32 LED Matrix</h1>";
@@ -25,184 +464,233 @@ void setupApiEndpoints() {
     html += "<p>WiFi SSID: " + WiFi.SSID() + "</p>";
     html += "<p>Signal Strength: " + String(WiFi.RSSI()) + " dBm</p>";
     html += "<p>Access the API with your API key for full control.</p>";
+    html += previewHtml;
     html += "</body></html>";
     request->send(200, "text/html", html);
   });
   // Settings API endpoints
-  server.on("/settings", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onTracked("/settings", HTTP_GET, [](AsyncWebServerRequest *request) {
     // Validate API key
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
     
-    JsonDocument doc;
-    doc["displayOn"] = config.displayOn;
-    doc["loopItems"] = config.loopItems;
-    doc["currentItemIndex"] = config.currentItemIndex;
-    
-    JsonArray itemsArray = doc.createNestedArray("items");
-    
-    for (const DisplayItem& item : config.items) {
-      JsonObject itemObj = itemsArray.createNestedObject();
-      
-      itemObj["mode"] = item.mode;
-      itemObj["text"] = item.text;
-      itemObj["alignment"] = item.alignment == PA_LEFT ? "left" : 
-                            (item.alignment == PA_RIGHT ? "right" : 
-                            (item.alignment == PA_CENTER ? "center" : 
-                            (item.alignment == PA_SCROLL_LEFT ? "scroll_left" : "scroll_right")));
-      itemObj["invert"] = item.invert;
-      itemObj["brightness"] = item.brightness;
-      itemObj["scrollSpeed"] = item.scrollSpeed;
-      itemObj["pauseTime"] = item.pauseTime;
-      itemObj["twinkleDensity"] = item.twinkleDensity;
-      itemObj["twinkleMinSpeed"] = item.twinkleMinSpeed;
-      itemObj["twinkleMaxSpeed"] = item.twinkleMaxSpeed;
-      itemObj["duration"] = item.duration;
-      itemObj["playCount"] = item.playCount;
-      itemObj["maxPlays"] = item.maxPlays;
-      itemObj["deleteAfterPlay"] = item.deleteAfterPlay;
-    }
-    
-    String response;
-    serializeJson(doc, response);
     Serial.println("✅ Settings requested via API");
-    request->send(200, "application/json", response);
+    // Read on the render task between frames, like GET /items
+    postConfigEdit(request, [](ConfigEditResult& result) {
+      JsonDocument& doc = result.reply;
+      doc["displayOn"] = config.displayOn;
+      doc["loopItems"] = config.loopItems;
+      doc["frameRate"] = config.frameRate;
+      doc["realtimeTimeout"] = config.realtimeTimeout;
+      doc["currentItemIndex"] = config.currentItemIndex;
+      
+      JsonArray itemsArray = doc.createNestedArray("items");
+      
+      for (const DisplayItem& item : config.items) {
+        JsonObject itemObj = itemsArray.createNestedObject();
+        
+        writeItem(itemObj, item);
+      }
+    });
   });
 
-  server.on("/items", HTTP_GET, [](AsyncWebServerRequest *request) {
-    // Validate API key
+  // One item by its stable ID, in any zone. Registered ahead of /items,
+  // which would otherwise take /items/{id} as one of its subpaths.
+  onTracked("/items/*", HTTP_GET, [](AsyncWebServerRequest *request) {
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-    updateInProgress = true;
+    uint32_t itemId = itemIdFromUrl(request);
+    if (itemId == 0) {
+      request->send(400, "application/json", "{\"error\":\"Invalid item id\"}");
+      return;
+    }
+    postConfigEdit(request, [itemId](ConfigEditResult& result) {
+      uint8_t zone;
+      uint16_t slot;
+      DisplayItem* item = findItemById(itemId, &zone, &slot);
+      if (item == NULL) {
+        configEditError(result, 404, "Item not found");
+        return;
+      }
+      writeItem(result.reply.createNestedObject("item"), *item);
+      result.reply["zone"] = zone;
+      result.reply["index"] = slot;
+    });
+  });
 
-    JsonDocument doc;
-    JsonArray itemsArray = doc.createNestedArray("items");
-    
-    for (const DisplayItem& item : config.items) {
-      JsonObject itemObj = itemsArray.createNestedObject();
-      
-      itemObj["mode"] = item.mode;
-      itemObj["text"] = item.text;
-      itemObj["alignment"] = item.alignment == PA_LEFT ? "left" : 
-                            (item.alignment == PA_RIGHT ? "right" : 
-                            (item.alignment == PA_CENTER ? "center" : 
-                            (item.alignment == PA_SCROLL_LEFT ? "scroll_left" : "scroll_right")));
-      itemObj["invert"] = item.invert;
-      itemObj["brightness"] = item.brightness;
-      itemObj["scrollSpeed"] = item.scrollSpeed;
-      itemObj["pauseTime"] = item.pauseTime;
-      itemObj["twinkleDensity"] = item.twinkleDensity;
-      itemObj["twinkleMinSpeed"] = item.twinkleMinSpeed;
-      itemObj["twinkleMaxSpeed"] = item.twinkleMaxSpeed;
-      itemObj["duration"] = item.duration;
-      itemObj["playCount"] = item.playCount;
-      itemObj["maxPlays"] = item.maxPlays;
-      itemObj["deleteAfterPlay"] = item.deleteAfterPlay;
+  // Change some fields of one item; saved as one change log record
+  onTracked("/items/*", HTTP_PATCH, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
+    uint32_t itemId = itemIdFromUrl(request);
+    if (itemId == 0) {
+      request->send(400, "application/json", "{\"error\":\"Invalid item id\"}");
+      return;
+    }
+    if (!doc.is<JsonObject>()) {
+      request->send(400, "application/json", "{\"error\":\"Expected a JSON object\"}");
+      return;
     }
     
-    String response;
-    serializeJson(doc, response);
-    Serial.println("✅ Items requested via API");
-    request->send(200, "application/json", response);
-    updateInProgress = false;
+    // The edit runs after this handler returns, so it keeps its own copy
+    postConfigEdit(request, [itemId, patch = JsonDocument(doc)](ConfigEditResult& result) mutable {
+      uint8_t zone;
+      uint16_t slot;
+      DisplayItem* item = findItemById(itemId, &zone, &slot);
+      if (item == NULL) {
+        configEditError(result, 404, "Item not found");
+        return;
+      }
+      
+      String error;
+      if (!patchItem(*item, patch.as<JsonObject>(), error)) {
+        configEditError(result, 400, error.c_str());
+        return;
+      }
+      logItemUpdated(*item);
+      reloadIfCurrent(result, zone, slot);
+      
+      result.reply["status"] = "success";
+      writeItem(result.reply.createNestedObject("item"), *item);
+    });
+  }));
 
+  onTracked("/items/*", HTTP_DELETE, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+    uint32_t itemId = itemIdFromUrl(request);
+    if (itemId == 0) {
+      request->send(400, "application/json", "{\"error\":\"Invalid item id\"}");
+      return;
+    }
+    postConfigEdit(request, [itemId](ConfigEditResult& result) {
+      if (!deleteItemById(result, itemId)) {
+        configEditError(result, 404, "Item not found");
+      }
+    });
   });
 
-  server.on("/items", HTTP_POST, [](AsyncWebServerRequest *request) {
-    Serial.println("DEBUG: /items POST endpoint called!");
+  // Delete a specific item. Registered ahead of /items, which would
+  // otherwise take /items/delete as one of its subpaths.
+  onTracked("/items/delete", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    updateInProgress = true;
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data);
-    if (error) {
-      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
+    // The item is named by "id" (any zone) or by "index" (primary zone)
+    if (!doc["index"].is<int>() && !doc["id"].is<uint32_t>()) {
+      request->send(400, "application/json", "{\"error\":\"id or index parameter is required\"}");
       return;
     }
     
-    DisplayItem newItem;
+    int itemIndex = doc["index"] | -1;
+    uint32_t itemId = doc["id"] | 0;
     
-    // Parse the item details
-    if (doc["mode"].is<String>()) {
-      newItem.mode = doc["mode"].as<String>();
-    } else {
-      newItem.mode = "text";
+    postConfigEdit(request, [itemIndex, itemId](ConfigEditResult& result) {
+      if (itemId != 0) {
+        if (!deleteItemById(result, itemId)) {
+          configEditError(result, 404, "Item not found");
+        }
+        return;
+      }
+      
+      // Validate index against the list as it is when the edit runs
+      if (itemIndex < 0 || itemIndex >= (int)config.items.size()) {
+        configEditError(result, 400, "Invalid item index");
+        return;
+      }
+      
+      // Delete the item
+      logItemDeleted(config.items[itemIndex].id);
+      config.items.erase(config.items.begin() + itemIndex);
+      invalidateItemIndex();
+      
+      // If we deleted the current item or an item before it, adjust current index
+      if (itemIndex <= config.currentItemIndex) {
+        if (config.currentItemIndex > 0) {
+          config.currentItemIndex--;
+        }
+      }
+      
+      // If we deleted all items, add a default one
+      if (config.items.empty()) {
+        createDefaultItem(config);
+        config.currentItemIndex = 0;
+      }
+      
+      config.itemStartTime = 0;
+      result.reload = true;
+      
+      result.reply["status"] = "success";
+      result.reply["message"] = "Item deleted successfully";
+      result.reply["remaining"] = config.items.size();
+    });
+  }));
+  
+  onTracked("/items", HTTP_GET, [](AsyncWebServerRequest *request) {
+    // Validate API key
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
     }
- 
-    // Ensure there's a duration
-    if (doc["duration"].is<int>()) {
-      newItem.duration = doc["duration"].as<int>();
-    } else {
-      newItem.duration = 10000;  // Default 10 seconds if not specified
+    // Read on the render task between frames, so the list cannot change under us
+    postConfigEdit(request, [](ConfigEditResult& result) {
+      JsonArray itemsArray = result.reply.createNestedArray("items");
+      
+      for (const DisplayItem& item : config.items) {
+        writeItem(itemsArray.createNestedObject(), item);
+      }
+    });
+  });
+
+  onTracked("/items", HTTP_POST, [](AsyncWebServerRequest *request) {
+    Serial.println("DEBUG: /items POST endpoint called!");
+    // Validate API key
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
     }
-    
-    if (doc["text"].is<String>()) {
-      newItem.text = doc["text"].as<String>();
-    } else {
-      newItem.text = "New Item";
-    }
-    
-    if (doc["alignment"].is<String>()) {
-      String alignment = doc["alignment"].as<String>();
-      if (alignment == "left") {
-        newItem.alignment = PA_LEFT;
-      } else if (alignment == "right") {
-        newItem.alignment = PA_RIGHT;
-      } else if (alignment == "center") {
-        newItem.alignment = PA_CENTER;
-      } else if (alignment == "scroll_left") {
-        newItem.alignment = PA_SCROLL_LEFT;
-      } else if (alignment == "scroll_right") {
-        newItem.alignment = PA_SCROLL_RIGHT;
-      } else {
-        newItem.alignment = PA_SCROLL_LEFT;
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
+    DisplayItem newItem;
+    JsonObject itemObj = doc.as<JsonObject>();
+    parseItem(newItem, itemObj);
+    
+    // A layers array makes a layered item whatever the mode says
+    if (newItem.mode != MODE_LAYERS && itemObj["layers"].is<JsonArray>()) {
+      DisplayItem layered = newItem;
+      if (parseLayers(layered, itemObj["layers"].as<JsonArray>()) > 0) {
+        parseEffectParams(layered, itemObj);
+        newItem = std::move(layered);
       }
-    } else {
-      newItem.alignment = PA_SCROLL_LEFT;
     }
     
-    newItem.invert = doc["invert"] | false;
-    newItem.brightness = doc["brightness"] | DEFAULT_BRIGHTNESS;
-    newItem.scrollSpeed = doc["scrollSpeed"] | DEFAULT_SCROLL_SPEED;
-    newItem.pauseTime = doc["pauseTime"] | DEFAULT_PAUSE_TIME;
-    newItem.twinkleDensity = doc["twinkleDensity"] | DEFAULT_TWINKLE_DENSITY;
-    newItem.twinkleMinSpeed = doc["twinkleMinSpeed"] | DEFAULT_TWINKLE_MIN_SPEED;
-    newItem.twinkleMaxSpeed = doc["twinkleMaxSpeed"] | DEFAULT_TWINKLE_MAX_SPEED;
-    newItem.duration = doc["duration"] | 0;
-    newItem.playCount = doc["playCount"] | 0;
-    newItem.maxPlays = doc["maxPlays"] | 0;
-    newItem.deleteAfterPlay = doc["deleteAfterPlay"] | false;
-    
-    // Add the new item
-    config.items.push_back(newItem);
-    
-    // Save the config
-    saveConfig();
-    
-    // Send response
-    JsonDocument responseDoc;
-    responseDoc["status"] = "success";
-    responseDoc["message"] = "Item added successfully";
-    responseDoc["index"] = config.items.size() - 1;
-    
-    String response;
-    serializeJson(responseDoc, response);
-    request->send(200, "application/json", response);
-    updateInProgress = false;
-
-  });
+    // Add the new item between frames; the reply follows once it is in.
+    // Saved as one change log record rather than the whole config.
+    postConfigEdit(request, [newItem](ConfigEditResult& result) {
+      config.items.push_back(newItem);
+      logItemAdded(0, config.items.back());
+      invalidateItemIndex();
+      
+      result.reply["status"] = "success";
+      result.reply["message"] = "Item added successfully";
+      result.reply["index"] = config.items.size() - 1;
+      result.reply["id"] = config.items.back().id;
+    });
+  }));
   
 // Update or replace all items
-server.on("/items_replace", HTTP_POST, [](AsyncWebServerRequest *request) {
+onTracked("/items_replace", HTTP_POST, [](AsyncWebServerRequest *request) {
   Serial.println("DEBUG: /items/replace POST endpoint called!");
 
   // Validate API key
@@ -211,172 +699,67 @@ server.on("/items_replace", HTTP_POST, [](AsyncWebServerRequest *request) {
     request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
     return;
   }
-}, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+}, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
 
   Serial.println("\n========== ITEMS REPLACE API CALLED ==========");
-  Serial.println("✅ API Key validation successful");
   Serial.print("📦 Received data size: ");
-  Serial.println(total);
-  
-  updateInProgress = true;
-  Serial.println("🚩 Update flag set to true");
-
-  // Log initial state
-  Serial.print("📊 BEFORE UPDATE: Current item count: ");
-  Serial.println(config.items.size());
-  Serial.print("📊 BEFORE UPDATE: Current item index: ");
-  Serial.println(config.currentItemIndex);
-  
-  for (size_t i = 0; i < config.items.size(); i++) {
-    Serial.print("  Item ");
-    Serial.print(i);
-    Serial.print(": Mode=");
-    Serial.print(config.items[i].mode);
-    if (config.items[i].mode == "text") {
-      Serial.print(", Text='");
-      Serial.print(config.items[i].text);
-      Serial.print("'");
-    }
-    Serial.println();
-  }
-
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, data);
-  if (error) {
-    Serial.print("❌ ERROR: JSON parse error: ");
-    Serial.println(error.c_str());
-    request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-    updateInProgress = false;
-    return;
-  }
-  
-  Serial.println("✅ JSON parsed successfully");
+  Serial.println(request->contentLength());
   
   // Check if we have an items array
   if (!doc["items"].is<JsonArray>()) {
     Serial.println("❌ ERROR: 'items' array is missing in request");
     request->send(400, "application/json", "{\"error\":\"items array is required\"}");
-    updateInProgress = false;
     return;
   }
   
-  Serial.println("✅ 'items' array found in request");
   Serial.print("📊 Incoming items count: ");
   Serial.println(doc["items"].as<JsonArray>().size());
   
-  // Clear existing items
-  size_t oldCount = config.items.size();
-  config.items.clear();
-  Serial.print("🗑️ Cleared existing items. Old count: ");
-  Serial.print(oldCount);
-  Serial.print(", New count: ");
-  Serial.println(config.items.size());
-  
-  // Add new items
+  // Build the new list here; the render task only swaps it in
+  std::vector<DisplayItem> items;
   int newItemsAdded = 0;
   for (JsonObject itemObj : doc["items"].as<JsonArray>()) {
     DisplayItem item;
+    parseItem(item, itemObj);
     
-    // Get the mode with "text" as default
-    item.mode = itemObj["mode"] | "text";
-    
-    // Handle mode-specific parameters
-    if (item.mode == "text") {
-      item.text = itemObj["text"] | "New Item";
-      
-      String alignment = itemObj["alignment"] | "scroll_left";
-      if (alignment == "left") {
-        item.alignment = PA_LEFT;
-      } else if (alignment == "right") {
-        item.alignment = PA_RIGHT;
-      } else if (alignment == "center") {
-        item.alignment = PA_CENTER;
-      } else if (alignment == "scroll_left") {
-        item.alignment = PA_SCROLL_LEFT;
-      } else if (alignment == "scroll_right") {
-        item.alignment = PA_SCROLL_RIGHT;
-      } else {
-        item.alignment = PA_SCROLL_LEFT;
-      }
-      
-      item.scrollSpeed = itemObj["scrollSpeed"] | DEFAULT_SCROLL_SPEED;
-      item.pauseTime = itemObj["pauseTime"] | DEFAULT_PAUSE_TIME;
-    } 
-    else if (item.mode == "twinkle") {
-      // Twinkle effect parameters
-      item.twinkleDensity = itemObj["twinkleDensity"] | DEFAULT_TWINKLE_DENSITY;
-      item.twinkleMinSpeed = itemObj["twinkleMinSpeed"] | DEFAULT_TWINKLE_MIN_SPEED;
-      item.twinkleMaxSpeed = itemObj["twinkleMaxSpeed"] | DEFAULT_TWINKLE_MAX_SPEED;
-    }
-    else if (item.mode == "knightrider") {
-      // Knight Rider effect parameters
-      item.knightRiderSpeed = itemObj["knightRiderSpeed"] | 50; // Default 50ms update interval
-      item.knightRiderTailLength = itemObj["knightRiderTailLength"] | 3; // Default tail length of 3
-    }
-    else if (item.mode == "pong") {
-      // Pong effect parameters
-      item.pongSpeed = itemObj["pongSpeed"] | 100; // Default 100ms update interval
-      item.pongBallSpeedX = itemObj["pongBallSpeedX"] | 0.5; // Default horizontal speed
-      item.pongBallSpeedY = itemObj["pongBallSpeedY"] | 0.25; // Default vertical speed
-    }
-    else if (item.mode == "sinewave") {
-      // Sine wave effect parameters
-      item.sineWaveSpeed = itemObj["sineWaveSpeed"] | 50; // Default 50ms update interval
-      item.sineWaveAmplitude = itemObj["sineWaveAmplitude"] | 3; // Default amplitude
-      item.sineWavePhases = itemObj["sineWavePhases"] | 3; // Default number of phases
-    }
-    else {
-      // If an unknown mode is specified, default to text
-      Serial.print("⚠️ Unknown mode: '");
-      Serial.print(item.mode);
-      Serial.println("', defaulting to 'text'");
-      item.mode = "text";
-      item.text = "Unknown Mode";
-      item.alignment = PA_SCROLL_LEFT;
-    }
-    
-    // Common parameters for all modes
-    item.invert = itemObj["invert"] | false;
-    item.brightness = itemObj["brightness"] | DEFAULT_BRIGHTNESS;
-    item.duration = itemObj["duration"] | 0;
-    item.playCount = itemObj["playCount"] | 0;
-    item.maxPlays = itemObj["maxPlays"] | 0;
-    item.deleteAfterPlay = itemObj["deleteAfterPlay"] | false;
-    
-    config.items.push_back(item);
+    items.push_back(item);
     newItemsAdded++;
     
     Serial.print("➕ Added item #");
     Serial.print(newItemsAdded);
     Serial.print(": Mode='");
-    Serial.print(item.mode);
+    Serial.print(effectModeName(item.mode));
     Serial.print("'");
     
     // Log mode-specific details
-    if (item.mode == "text") {
-      Serial.print(", Text='");
-      Serial.print(item.text);
-      Serial.print("'");
-    } 
-    else if (item.mode == "twinkle") {
-      Serial.print(", Density=");
-      Serial.print(item.twinkleDensity);
-    }
-    else if (item.mode == "knightrider") {
-      Serial.print(", Speed=");
-      Serial.print(item.knightRiderSpeed);
-      Serial.print(", TailLength=");
-      Serial.print(item.knightRiderTailLength);
-    }
-    else if (item.mode == "pong") {
-      Serial.print(", Speed=");
-      Serial.print(item.pongSpeed);
-    }
-    else if (item.mode == "sinewave") {
-      Serial.print(", Speed=");
-      Serial.print(item.sineWaveSpeed);
-      Serial.print(", Amplitude=");
-      Serial.print(item.sineWaveAmplitude);
+    switch (item.mode) {
+      case MODE_TEXT:
+        Serial.print(", Text='");
+        Serial.print(item.text.c_str());
+        Serial.print("'");
+        break;
+      case MODE_TWINKLE:
+        Serial.print(", Density=");
+        Serial.print(item.params.twinkle.density);
+        break;
+      case MODE_KNIGHTRIDER:
+        Serial.print(", Speed=");
+        Serial.print(item.params.knightRider.speed);
+        Serial.print(", TailLength=");
+        Serial.print(item.params.knightRider.tailLength);
+        break;
+      case MODE_PONG:
+        Serial.print(", Speed=");
+        Serial.print(item.params.pong.speed);
+        break;
+      case MODE_SINEWAVE:
+        Serial.print(", Speed=");
+        Serial.print(item.params.sineWave.speed);
+        Serial.print(", Amplitude=");
+        Serial.print(item.params.sineWave.amplitude);
+        break;
+      default:
+        break;
     }
     
     Serial.print(", Duration=");
@@ -384,164 +767,126 @@ server.on("/items_replace", HTTP_POST, [](AsyncWebServerRequest *request) {
     Serial.println("ms");
   }
   
-  Serial.print("📊 AFTER ADDING: Items count: ");
-  Serial.println(config.items.size());
-  
-  // If no items were added, add a default one
-  if (config.items.empty()) {
+  // If no items were added, the edit adds the default one
+  if (items.empty()) {
     Serial.println("⚠️ No items were added, adding default item");
-    
-    DisplayItem defaultItem;
-    defaultItem.mode = "text";
-    defaultItem.text = "ESP32 LED Display";
-    defaultItem.alignment = PA_SCROLL_LEFT;
-    defaultItem.invert = false;
-    defaultItem.brightness = DEFAULT_BRIGHTNESS;
-    defaultItem.scrollSpeed = DEFAULT_SCROLL_SPEED;
-    defaultItem.pauseTime = DEFAULT_PAUSE_TIME;
-    defaultItem.twinkleDensity = DEFAULT_TWINKLE_DENSITY;
-    defaultItem.twinkleMinSpeed = DEFAULT_TWINKLE_MIN_SPEED;
-    defaultItem.twinkleMaxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
-    defaultItem.duration = 0;
-    defaultItem.playCount = 0;
-    defaultItem.maxPlays = 0;
-    defaultItem.deleteAfterPlay = false;
-    
-    config.items.push_back(defaultItem);
-    
-    Serial.print("➕ Added default item. New count: ");
-    Serial.println(config.items.size());
-  }
-  
-  // Reset to the first item
-  config.currentItemIndex = 0;
-  config.itemStartTime = 0;
-  textNeedsUpdate = true;
-  
-  Serial.println("🔄 Reset to first item and set text update flag");
-  
-  // Save the config
-  Serial.println("💾 Saving configuration to SPIFFS...");
-  saveConfig();
-  Serial.println("✅ Configuration saved");
-  
-  // Log final state
-  Serial.print("📊 FINAL: Items count: ");
-  Serial.println(config.items.size());
-  for (size_t i = 0; i < config.items.size(); i++) {
-    Serial.print("  Item ");
-    Serial.print(i);
-    Serial.print(": Mode=");
-    Serial.print(config.items[i].mode);
-    if (config.items[i].mode == "text") {
-      Serial.print(", Text='");
-      Serial.print(config.items[i].text);
-      Serial.print("'");
-    }
-    Serial.println();
   }
   
-  // Send response
-  JsonDocument responseDoc;
-  responseDoc["status"] = "success";
-  responseDoc["message"] = "Items replaced successfully";
-  responseDoc["count"] = config.items.size();
-  
-  String response;
-  serializeJson(responseDoc, response);
-  Serial.print("📤 Sending response: ");
-  Serial.println(response);
-  request->send(200, "application/json", response);
+  postConfigEdit(request, [items = std::move(items)](ConfigEditResult& result) mutable {
+    // The old list goes out with the edit, freed off the render task
+    config.items.swap(items);
+    invalidateItemIndex();
+    if (config.items.empty()) createDefaultItem(config);
+    
+    // Reset to the first item
+    config.currentItemIndex = 0;
+    config.itemStartTime = 0;
+    result.changed = true;
+    result.reload = true;
+    
+    result.reply["status"] = "success";
+    result.reply["message"] = "Items replaced successfully";
+    result.reply["count"] = config.items.size();
+  });
   
-  updateInProgress = false;
-  Serial.println("🚩 Update flag set to false");
-  Serial.println("=========== ITEMS REPLACE API COMPLETED ===========\n");
-});
-  // Delete a specific item
-  server.on("/items/delete", HTTP_POST, [](AsyncWebServerRequest *request) {
-    // Validate API key
+  Serial.println("=========== ITEMS REPLACE QUEUED ===========\n");
+}));
+
+  // Display zones: the primary zone ("main", the regular items) plus extras
+  onTracked("/zones", HTTP_GET, [](AsyncWebServerRequest *request) {
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    updateInProgress = true;
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data);
-    if (error) {
-      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    
+    // Zone names and item lists belong to the render task
+    postConfigEdit(request, [](ConfigEditResult& result) {
+      JsonDocument& doc = result.reply;
+      doc["columns"] = FRAME_COLS;
+      doc["maxZones"] = MAX_ZONES;
+      JsonArray zonesArray = doc.createNestedArray("zones");
+      
+      for (uint8_t i = 0; i < zoneCount(); i++) {
+        const DisplayZone& zone = zoneAt(i);
+        JsonObject zoneObj = zonesArray.createNestedObject();
+        zoneObj["index"] = i;
+        zoneObj["name"] = i == 0 ? "main" : zone.name;
+        zoneObj["startCol"] = zone.startCol;
+        zoneObj["width"] = zone.width;
+        zoneObj["loopItems"] = zone.loopItems;
+        zoneObj["currentItemIndex"] = zone.currentItemIndex;
+        zoneObj["itemCount"] = zone.items.size();
+        if (!zone.items.empty() && zone.currentItemIndex < (int)zone.items.size()) {
+          zoneObj["mode"] = effectModeName(zone.items[zone.currentItemIndex].mode);
+        }
+      }
+    });
+  });
+  
+  // Replace the extra zones, optionally moving the primary one. Body:
+  // {"main": {"startCol": 24, "width": 72},
+  //  "zones": [{"name": "clock", "startCol": 0, "width": 24, "items": [...]}]}
+  // An empty "zones" array goes back to a single full-width zone.
+  onTracked("/zones", HTTP_POST, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-    
-    // Check if index parameter is provided
-    if (!doc["index"].is<int>()) {
-      request->send(400, "application/json", "{\"error\":\"index parameter is required\"}");
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
+    if (!doc["zones"].is<JsonArray>()) {
+      request->send(400, "application/json", "{\"error\":\"zones array is required\"}");
       return;
     }
     
-    int itemIndex = doc["index"].as<int>();
-    
-    // Validate index
-    if (itemIndex < 0 || itemIndex >= config.items.size()) {
-      request->send(400, "application/json", "{\"error\":\"Invalid item index\"}");
+    if (doc["zones"].as<JsonArray>().size() + 1 > MAX_ZONES) {
+      request->send(400, "application/json", "{\"error\":\"Too many zones\"}");
       return;
     }
     
-    // Delete the item
-    config.items.erase(config.items.begin() + itemIndex);
-    
-    // If we deleted the current item or an item before it, adjust current index
-    if (itemIndex <= config.currentItemIndex) {
-      if (config.currentItemIndex > 0) {
-        config.currentItemIndex--;
+    JsonObject mainObj = doc["main"];
+    uint16_t mainStartCol = mainObj["startCol"] | (uint16_t)0;
+    uint16_t mainWidth = mainObj["width"] | (uint16_t)FRAME_COLS;
+    
+    std::vector<DisplayZone> zones;
+    for (JsonObject zoneObj : doc["zones"].as<JsonArray>()) {
+      DisplayZone zone;
+      zone.name = zoneObj["name"] | "";
+      zone.startCol = zoneObj["startCol"] | 0;
+      zone.width = zoneObj["width"] | 0;
+      zone.loopItems = zoneObj["loopItems"] | true;
+      zone.currentItemIndex = 0;
+      zone.itemStartTime = 0;
+      
+      for (JsonObject itemObj : zoneObj["items"].as<JsonArray>()) {
+        DisplayItem item;
+        parseItem(item, itemObj);
+        zone.items.push_back(item);
       }
+      
+      sanitizeZone(zone);
+      zones.push_back(zone);
     }
     
-    // If we deleted all items, add a default one
-    if (config.items.empty()) {
-      DisplayItem defaultItem;
-      defaultItem.mode = "text";
-      defaultItem.text = "ESP32 LED Display";
-      defaultItem.alignment = PA_SCROLL_LEFT;
-      defaultItem.invert = false;
-      defaultItem.brightness = DEFAULT_BRIGHTNESS;
-      defaultItem.scrollSpeed = DEFAULT_SCROLL_SPEED;
-      defaultItem.pauseTime = DEFAULT_PAUSE_TIME;
-      defaultItem.twinkleDensity = DEFAULT_TWINKLE_DENSITY;
-      defaultItem.twinkleMinSpeed = DEFAULT_TWINKLE_MIN_SPEED;
-      defaultItem.twinkleMaxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
-      defaultItem.duration = 0;
-      defaultItem.playCount = 0;
-      defaultItem.maxPlays = 0;
-      defaultItem.deleteAfterPlay = false;
+    postConfigEdit(request, [mainStartCol, mainWidth, zones = std::move(zones)](ConfigEditResult& result) mutable {
+      config.startCol = mainStartCol;
+      config.width = mainWidth;
+      sanitizeZone(config);
+      config.zones.swap(zones);
+      invalidateItemIndex();
       
-      config.items.push_back(defaultItem);
+      // Restart every zone from its first item
       config.currentItemIndex = 0;
-    }
-    
-    // Force update
-    textNeedsUpdate = true;
-    config.itemStartTime = 0;
-    
-    // Save the config
-    saveConfig();
-    
-    // Send response
-    JsonDocument responseDoc;
-    responseDoc["status"] = "success";
-    responseDoc["message"] = "Item deleted successfully";
-    responseDoc["remaining"] = config.items.size();
-    
-    String response;
-    serializeJson(responseDoc, response);
-    request->send(200, "application/json", response);
-    updateInProgress = false;
-
-  });
-  
+      config.itemStartTime = 0;
+      result.changed = true;
+      result.reload = true;
+      
+      Serial.println("✅ Zones updated: " + String(config.zones.size() + 1) + " zone(s)");
+      result.reply["status"] = "success";
+      result.reply["zones"] = config.zones.size() + 1;
+    });
+  }));
   // Security settings endpoint
-  server.on("/security", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onTracked("/security", HTTP_GET, [](AsyncWebServerRequest *request) {
     // Validate API key - this is a sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
@@ -561,22 +906,13 @@ server.on("/items_replace", HTTP_POST, [](AsyncWebServerRequest *request) {
   });
   
   // Update security settings endpoint
-  server.on("/security", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/security", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key - this is a sensitive operation
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    updateInProgress = true;
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data);
-    if (error) {
-      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-      return;
-    }
-    
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
     bool configChanged = false;
     
     if (doc["apName"].is<String>() && doc["apName"].as<String>().length() > 0) {
@@ -601,97 +937,87 @@ server.on("/items_replace", HTTP_POST, [](AsyncWebServerRequest *request) {
     } else {
       request->send(400, "application/json", "{\"error\":\"No valid settings provided\"}");
     }
-    updateInProgress = false;
-
-  });
+  }));
   
   // Get specific setting
-// Get specific setting
-server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
+  static const char getParamsError[] = "Invalid parameter. Available parameters: displayOn, loopItems, frameRate, currentItemIndex, numItems, mode, text, alignment, invert, brightness, scrollSpeed, pauseTime, twinkleDensity, twinkleMinSpeed, twinkleMaxSpeed, duration, playCount, maxPlays, deleteAfterPlay, apName, hostname";
+onTracked("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
   // Validate API key
   if (!validateApiKey(request)) {
     request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
     return;
   }
   
-  String paramName = "";
-  String response = "{";
-  bool paramFound = false;
-  
-  // Check if a specific parameter was requested
-  if (request->hasParam("param")) {
-    paramName = request->getParam("param")->value();
-    paramFound = true;
+  if (!request->hasParam("param")) {
+    request->send(400, "application/json", String("{\"error\":\"") + getParamsError + "\"}");
+    return;
+  }
+  String paramName = request->getParam("param")->value();
+  Serial.println("✅ Parameter '" + paramName + "' requested via API");
+
+  // The current item is read on the render task between frames
+  postConfigEdit(request, [paramName](ConfigEditResult& result) {
+    JsonDocument& reply = result.reply;
     
     if (paramName == "displayOn") {
-      response += "\"displayOn\":" + String(config.displayOn ? "true" : "false");
+      reply["displayOn"] = config.displayOn;
     } else if (paramName == "loopItems") {
-      response += "\"loopItems\":" + String(config.loopItems ? "true" : "false");
+      reply["loopItems"] = config.loopItems;
+    } else if (paramName == "frameRate") {
+      reply["frameRate"] = config.frameRate;
     } else if (paramName == "currentItemIndex") {
-      response += "\"currentItemIndex\":" + String(config.currentItemIndex);
+      reply["currentItemIndex"] = config.currentItemIndex;
     } else if (paramName == "numItems") {
-      response += "\"numItems\":" + String(config.items.size());
+      reply["numItems"] = config.items.size();
     } else if (paramName == "apName") {
-      response += "\"apName\":\"" + securityConfig.apName + "\"";
+      reply["apName"] = securityConfig.apName;
     } else if (paramName == "hostname") {
-      response += "\"hostname\":\"" + securityConfig.hostname + "\"";
+      reply["hostname"] = securityConfig.hostname;
     } else if (config.items.size() > 0 && config.currentItemIndex < config.items.size()) {
       // Get parameters from the current item
-      DisplayItem& currentItem = config.items[config.currentItemIndex];
+      const DisplayItem& currentItem = config.items[config.currentItemIndex];
       
       if (paramName == "mode") {
-        response += "\"mode\":\"" + currentItem.mode + "\"";
+        reply["mode"] = effectModeName(currentItem.mode);
       } else if (paramName == "text") {
-        response += "\"text\":\"" + currentItem.text + "\"";
+        reply["text"] = currentItem.text.str();
       } else if (paramName == "alignment") {
-        String align = currentItem.alignment == PA_LEFT ? "left" : 
-                      (currentItem.alignment == PA_RIGHT ? "right" : 
-                      (currentItem.alignment == PA_CENTER ? "center" : 
-                      (currentItem.alignment == PA_SCROLL_LEFT ? "scroll_left" : "scroll_right")));
-        response += "\"alignment\":\"" + align + "\"";
+        reply["alignment"] = currentItem.alignment == PA_LEFT ? "left" : 
+                            (currentItem.alignment == PA_RIGHT ? "right" : 
+                            (currentItem.alignment == PA_CENTER ? "center" : 
+                            (currentItem.alignment == PA_SCROLL_LEFT ? "scroll_left" : "scroll_right")));
       } else if (paramName == "invert") {
-        response += "\"invert\":" + String(currentItem.invert ? "true" : "false");
+        reply["invert"] = currentItem.invert;
       } else if (paramName == "brightness") {
-        response += "\"brightness\":" + String(currentItem.brightness);
+        reply["brightness"] = currentItem.brightness;
       } else if (paramName == "scrollSpeed") {
-        response += "\"scrollSpeed\":" + String(currentItem.scrollSpeed);
+        reply["scrollSpeed"] = currentItem.textParams().scrollSpeed;
       } else if (paramName == "pauseTime") {
-        response += "\"pauseTime\":" + String(currentItem.pauseTime);
+        reply["pauseTime"] = currentItem.textParams().pauseTime;
       } else if (paramName == "twinkleDensity") {
-        response += "\"twinkleDensity\":" + String(currentItem.twinkleDensity);
+        reply["twinkleDensity"] = currentItem.twinkle().density;
       } else if (paramName == "twinkleMinSpeed") {
-        response += "\"twinkleMinSpeed\":" + String(currentItem.twinkleMinSpeed);
+        reply["twinkleMinSpeed"] = currentItem.twinkle().minSpeed;
       } else if (paramName == "twinkleMaxSpeed") {
-        response += "\"twinkleMaxSpeed\":" + String(currentItem.twinkleMaxSpeed);
+        reply["twinkleMaxSpeed"] = currentItem.twinkle().maxSpeed;
       } else if (paramName == "duration") {
-        response += "\"duration\":" + String(currentItem.duration);
+        reply["duration"] = currentItem.duration;
       } else if (paramName == "playCount") {
-        response += "\"playCount\":" + String(currentItem.playCount);
+        reply["playCount"] = currentItem.playCount;
       } else if (paramName == "maxPlays") {
-        response += "\"maxPlays\":" + String(currentItem.maxPlays);
+        reply["maxPlays"] = currentItem.maxPlays;
       } else if (paramName == "deleteAfterPlay") {
-        response += "\"deleteAfterPlay\":" + String(currentItem.deleteAfterPlay ? "true" : "false");
+        reply["deleteAfterPlay"] = currentItem.deleteAfterPlay;
       } else {
-        paramFound = false;
+        configEditError(result, 400, getParamsError);
       }
     } else {
-      paramFound = false;
+      configEditError(result, 400, getParamsError);
     }
-  }
-  
-  // If no valid parameter was specified, return an error
-  if (!paramFound) {
-    response = "{\"error\":\"Invalid parameter. Available parameters: displayOn, loopItems, currentItemIndex, numItems, mode, text, alignment, invert, brightness, scrollSpeed, pauseTime, twinkleDensity, twinkleMinSpeed, twinkleMaxSpeed, duration, playCount, maxPlays, deleteAfterPlay, apName, hostname\"}";
-    request->send(400, "application/json", response);
-    return;
-  }
-  
-  response += "}";
-  Serial.println("✅ Parameter '" + paramName + "' requested via API");
-  request->send(200, "application/json", response);
+  });
 });
   // Status endpoint
-  server.on("/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onTracked("/status", HTTP_GET, [](AsyncWebServerRequest *request) {
     // No API key required for status endpoint
     JsonDocument doc;
     doc["status"] = "online";
@@ -705,7 +1031,7 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
   });
   
   // Factory reset endpoint
-  server.on("/factory_reset", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/factory_reset", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key - this is a sensitive operation
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
@@ -714,30 +1040,19 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
     
     request->send(200, "application/json", "{\"status\":\"success\",\"message\":\"Factory reset initiated\"}");
     // Slight delayWithWatchdog to allow response to be sent
-    updateInProgress = true;
     delayWithWatchdog(500);
 
     factoryReset();
-    updateInProgress = false;
   });
   
   // API key change endpoint
-  server.on("/change_api_key", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/change_api_key", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Must validate with current API key
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    updateInProgress = true;
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data);
-    if (error) {
-      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-      return;
-    }
-    
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
     if (!doc["new_key"].is<String>()) {
       request->send(400, "application/json", "{\"error\":\"new_key parameter required\"}");
       return;
@@ -751,205 +1066,219 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
     
     changeApiKey(newKey);
     request->send(200, "application/json", "{\"status\":\"success\",\"message\":\"API key updated\"}");
-    updateInProgress = false;
+  }));
 
-  });
-
-  server.on("/update_display", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/update_display", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
   }, NULL,
-    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-      JsonDocument doc;
-      DeserializationError error = deserializeJson(doc, data);
-      if (error) {
-        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-        return;
-      }
-  
-      bool configChanged = false;
+    jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
+      // The edit reads its own copy of the request once it runs on the render task
+      postConfigEdit(request, [doc](ConfigEditResult& result) mutable {
+        bool configChanged = false;
       
-      // Global settings
-      if (doc["displayOn"].is<bool>()) {
-        config.displayOn = doc["displayOn"].as<bool>();
-        configChanged = true;
-      }
+        // Global settings
+        if (doc["displayOn"].is<bool>()) {
+          config.displayOn = doc["displayOn"].as<bool>();
+          configChanged = true;
+        }
       
-      if (doc["loopItems"].is<bool>()) {
-        config.loopItems = doc["loopItems"].as<bool>();
-        configChanged = true;
-      }
+        if (doc["loopItems"].is<bool>()) {
+          config.loopItems = doc["loopItems"].as<bool>();
+          configChanged = true;
+        }
       
-      // Check if there are any items
-      if (config.items.empty()) {
-        // Add a default item
-        DisplayItem defaultItem;
-        defaultItem.mode = "text";
-        defaultItem.text = "ESP32 LED Display";
-        defaultItem.alignment = PA_SCROLL_LEFT;
-        defaultItem.invert = false;
-        defaultItem.brightness = DEFAULT_BRIGHTNESS;
-        defaultItem.scrollSpeed = DEFAULT_SCROLL_SPEED;
-        defaultItem.pauseTime = DEFAULT_PAUSE_TIME;
-        defaultItem.twinkleDensity = DEFAULT_TWINKLE_DENSITY;
-        defaultItem.twinkleMinSpeed = DEFAULT_TWINKLE_MIN_SPEED;
-        defaultItem.twinkleMaxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
-        defaultItem.duration = 0;
-        defaultItem.playCount = 0;
-        defaultItem.maxPlays = 0;
-        defaultItem.deleteAfterPlay = false;
-        
-        config.items.push_back(defaultItem);
-        config.currentItemIndex = 0;
-      }
+        if (doc["frameRate"].is<int>()) {
+          config.frameRate = constrain(doc["frameRate"].as<int>(), MIN_FRAME_RATE, MAX_FRAME_RATE);
+          setFrameRate(config.frameRate);
+          configChanged = true;
+        }
       
-      // Ensure valid current item index
-      if (config.currentItemIndex >= config.items.size()) {
-        config.currentItemIndex = 0;
-      }
+        if (doc["realtimeTimeout"].is<int>()) {
+          config.realtimeTimeout = constrain(doc["realtimeTimeout"].as<int>(),
+                                             REALTIME_MIN_TIMEOUT_MS, REALTIME_MAX_TIMEOUT_MS);
+          configChanged = true;
+        }
       
-      // Get reference to current item
-      DisplayItem& currentItem = config.items[config.currentItemIndex];
+        // Check if there are any items
+        if (config.items.empty()) {
+          createDefaultItem(config);
+          config.currentItemIndex = 0;
+        }
       
-      String oldMode = currentItem.mode;
-  
-      // Check for each parameter and update if present
-      if (doc["mode"].is<String>()) {
-        String newMode = doc["mode"].as<String>();
-        // Only clear display if mode is actually changing
-        if (oldMode != newMode) {
-          clearDisplayForModeChange(oldMode, newMode);
-          currentItem.mode = newMode;
-          // Force a complete restart of the display
-          disp.begin();
-          disp.setIntensity(currentItem.brightness);
-          disp.setSpeed(currentItem.scrollSpeed);
-          disp.setPause(currentItem.pauseTime);
+        // Ensure valid current item index
+        if (config.currentItemIndex >= config.items.size()) {
+          config.currentItemIndex = 0;
+        }
+      
+        // Get reference to current item
+        DisplayItem& currentItem = config.items[config.currentItemIndex];
+      
+        // Check for each parameter and update if present
+        if (doc["mode"].is<String>()) {
+          String name = doc["mode"].as<String>();
+          EffectMode newMode = effectModeFromName(name);
+          // The render task clears up after the old mode when it reloads the item
+          if (newMode == MODE_UNKNOWN) {
+            Serial.println("⚠️ Unknown mode: '" + name + "', ignored");
+          } else if (currentItem.mode != newMode) {
+            currentItem.setMode(newMode);
+            configChanged = true;
+          }
         }
-        configChanged = true;
-      }
   
-      if (doc["text"].is<String>()) {
-        currentItem.text = doc["text"].as<String>();
-        configChanged = true;
-      }
+        if (doc["text"].is<String>()) {
+          currentItem.text = doc["text"].as<String>();
+          configChanged = true;
+        }
   
-      if (doc["alignment"].is<String>()) {
-        String alignment = doc["alignment"].as<String>();
-        if (alignment == "left") {
-          currentItem.alignment = PA_LEFT;
-        } else if (alignment == "right") {
-          currentItem.alignment = PA_RIGHT;
-        } else if (alignment == "center") {
-          currentItem.alignment = PA_CENTER;
-        } else if (alignment == "scroll_left") {
-          currentItem.alignment = PA_SCROLL_LEFT;
-        } else if (alignment == "scroll_right") {
-          currentItem.alignment = PA_SCROLL_RIGHT;
+        if (doc["alignment"].is<String>()) {
+          String alignment = doc["alignment"].as<String>();
+          if (alignment == "left") {
+            currentItem.alignment = PA_LEFT;
+          } else if (alignment == "right") {
+            currentItem.alignment = PA_RIGHT;
+          } else if (alignment == "center") {
+            currentItem.alignment = PA_CENTER;
+          } else if (alignment == "scroll_left") {
+            currentItem.alignment = PA_SCROLL_LEFT;
+          } else if (alignment == "scroll_right") {
+            currentItem.alignment = PA_SCROLL_RIGHT;
+          }
+          configChanged = true;
+          Serial.println("Alignment changed to: " + alignment);
         }
-        configChanged = true;
-        Serial.println("Alignment changed to: " + alignment);
-      }
   
-      if (doc["invert"].is<bool>()) {
-        currentItem.invert = doc["invert"].as<bool>();
-        configChanged = true;
-      }
+        if (doc["invert"].is<bool>()) {
+          currentItem.invert = doc["invert"].as<bool>();
+          configChanged = true;
+        }
   
-      if (doc["brightness"].is<int>()) {
-        currentItem.brightness = doc["brightness"].as<int>();
-        disp.setIntensity(currentItem.brightness);
-        configChanged = true;
-      }
+        if (doc["brightness"].is<int>()) {
+          currentItem.brightness = doc["brightness"].as<int>();
+          configChanged = true;
+        }
   
-      if (doc["scrollSpeed"].is<int>()) {
-        currentItem.scrollSpeed = doc["scrollSpeed"].as<int>();
-        disp.setSpeed(currentItem.scrollSpeed);
-        configChanged = true;
-      }
+        // Text and twinkle parameters only apply if the item draws that mode
+        ModeParams* text = currentItem.paramsFor(MODE_TEXT);
+        if (text && doc["scrollSpeed"].is<int>()) {
+          text->text.scrollSpeed = doc["scrollSpeed"].as<int>();
+          configChanged = true;
+        }
   
-      if (doc["pauseTime"].is<int>()) {
-        currentItem.pauseTime = doc["pauseTime"].as<int>();
-        disp.setPause(currentItem.pauseTime);
-        configChanged = true;
-      }
+        if (text && doc["pauseTime"].is<int>()) {
+          text->text.pauseTime = doc["pauseTime"].as<int>();
+          configChanged = true;
+        }
       
-      if (doc["twinkleDensity"].is<int>()) {
-        // Constrain the value to prevent crashes
-        currentItem.twinkleDensity = constrain(doc["twinkleDensity"].as<int>(), 1, 50);
-        configChanged = true;
-      }
+        ModeParams* twinkle = currentItem.paramsFor(MODE_TWINKLE);
+        if (twinkle && doc["twinkleDensity"].is<int>()) {
+          // Constrain the value to prevent crashes
+          twinkle->twinkle.density = constrain(doc["twinkleDensity"].as<int>(), 1, 50);
+          configChanged = true;
+        }
       
-      if (doc["twinkleMinSpeed"].is<int>()) {
-        // Constrain min speed to reasonable values
-        currentItem.twinkleMinSpeed = constrain(doc["twinkleMinSpeed"].as<int>(), 10, 1000);
-        configChanged = true;
-      }
+        if (twinkle && doc["twinkleMinSpeed"].is<int>()) {
+          // Constrain min speed to reasonable values
+          twinkle->twinkle.minSpeed = constrain(doc["twinkleMinSpeed"].as<int>(), 10, 1000);
+          configChanged = true;
+        }
       
-      if (doc["twinkleMaxSpeed"].is<int>()) {
-        // Make sure max speed is always >= min speed
-        int minSpeed = currentItem.twinkleMinSpeed;
-        currentItem.twinkleMaxSpeed = constrain(doc["twinkleMaxSpeed"].as<int>(), minSpeed, 2000);
-        configChanged = true;
-      }
+        if (twinkle && doc["twinkleMaxSpeed"].is<int>()) {
+          // Make sure max speed is always >= min speed
+          int minSpeed = twinkle->twinkle.minSpeed;
+          twinkle->twinkle.maxSpeed = constrain(doc["twinkleMaxSpeed"].as<int>(), minSpeed, 2000);
+          configChanged = true;
+        }
       
-      if (doc["duration"].is<int>()) {
-        currentItem.duration = doc["duration"].as<int>();
-        configChanged = true;
-      }
+        if (doc["duration"].is<int>()) {
+          currentItem.duration = doc["duration"].as<int>();
+          configChanged = true;
+        }
       
-      if (doc["maxPlays"].is<int>()) {
-        currentItem.maxPlays = doc["maxPlays"].as<int>();
-        configChanged = true;
-      }
+        if (doc["maxPlays"].is<int>()) {
+          currentItem.maxPlays = doc["maxPlays"].as<int>();
+          configChanged = true;
+        }
       
-      if (doc["deleteAfterPlay"].is<bool>()) {
-        currentItem.deleteAfterPlay = doc["deleteAfterPlay"].as<bool>();
-        configChanged = true;
-      }
+        if (doc["deleteAfterPlay"].is<bool>()) {
+          currentItem.deleteAfterPlay = doc["deleteAfterPlay"].as<bool>();
+          configChanged = true;
+        }
       
-      if (configChanged) {
-        Serial.println("✅ Display settings updated via API");
-        Serial.println("Mode: " + currentItem.mode);
-        if (currentItem.mode == "text") {
-          Serial.println("Text: " + currentItem.text);
+        if (configChanged) {
+          Serial.println("✅ Display settings updated via API");
+          Serial.println("Mode: " + String(effectModeName(currentItem.mode)));
+          if (currentItem.mode == MODE_TEXT) {
+            Serial.println("Text: " + currentItem.text.str());
+          }
+          result.changed = true;
+          result.reload = true;
         }
-        saveConfig();
-        
-        // Signal that display needs to be updated
-        textNeedsUpdate = true;
-        
-
-      }
       
-      request->send(200, "application/json", "{\"status\":\"success\"}");
-    });
+        result.reply["status"] = "success";
+      });
+    }));
 
-  // Download config file endpoint
-  server.on("/download_config", HTTP_GET, [](AsyncWebServerRequest *request) {
+  // Download config file endpoint. The config is stored in binary
+  // (config_binary.h); this exports it as JSON, built on the render task.
+  onTracked("/download_config", HTTP_GET, [](AsyncWebServerRequest *request) {
     // Validate API key for this sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
     
-    // Try to open the file
-    File file = SPIFFS.open(CONFIG_FILE, "r");
-    if (!file || file.size() == 0) {
-      request->send(404, "application/json", "{\"error\":\"Config file not found or empty\"}");
+    postConfigEdit(request, [](ConfigEditResult& result) {
+      configToJson(config, result.reply);
+      Serial.println("✅ Config file downloaded via API");
+    });
+  });
+  
+  // Replace the whole config with a JSON export (as from /download_config)
+  onTracked("/upload_config", HTTP_POST, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
+    if (!doc["items"].is<JsonArray>()) {
+      request->send(400, "application/json", "{\"error\":\"Missing items array\"}");
       return;
     }
     
-    // Send the file as a download
-    request->send(SPIFFS, CONFIG_FILE, "application/json", true);
-    Serial.println("✅ Config file downloaded via API");
-  });
+    // Parse here; the render task only swaps it in
+    DisplayConfig imported;
+    configFromJson(doc, imported);
+    
+    postConfigEdit(request, [imported = std::move(imported)](ConfigEditResult& result) mutable {
+      config.displayOn = imported.displayOn;
+      config.loopItems = imported.loopItems;
+      config.frameRate = constrain(imported.frameRate, MIN_FRAME_RATE, MAX_FRAME_RATE);
+      setFrameRate(config.frameRate);
+      config.realtimeTimeout = imported.realtimeTimeout;
+      config.startCol = imported.startCol;
+      config.width = imported.width;
+      config.items.swap(imported.items);
+      config.zones.swap(imported.zones);
+      invalidateItemIndex();
+      config.currentItemIndex = 0;
+      config.itemStartTime = 0;
+      result.changed = true;
+      result.reload = true;
+      
+      Serial.println("✅ Config uploaded via API: " + String(config.items.size()) + " item(s)");
+      result.reply["status"] = "success";
+      result.reply["items"] = config.items.size();
+      result.reply["zones"] = config.zones.size() + 1;
+    });
+  }));
   
   // Download security config file endpoint
-  server.on("/download_security_config", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onTracked("/download_security_config", HTTP_GET, [](AsyncWebServerRequest *request) {
     // Validate API key for this sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
@@ -969,7 +1298,7 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
   });
   
   // List all files in SPIFFS
-  server.on("/list_files", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onTracked("/list_files", HTTP_GET, [](AsyncWebServerRequest *request) {
     // Validate API key for this sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
@@ -995,50 +1324,180 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
     Serial.println("✅ File list requested via API");
   });
   
+  // Animation files for bitmap/animation items
+  onTracked("/animations", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+    
+    JsonDocument doc;
+    JsonArray list = doc.createNestedArray("animations");
+    
+    File root = SPIFFS.open("/");
+    File file = root.openNextFile();
+    while (file) {
+      String path = file.path();
+      if (path.startsWith(ANIMATION_DIR) && path.endsWith(ANIMATION_EXT)) {
+        AnimationHeader header;
+        String error;
+        JsonObject info = list.createNestedObject();
+        info["name"] = path.substring(strlen(ANIMATION_DIR), path.length() - strlen(ANIMATION_EXT));
+        info["bytes"] = file.size();
+        if (animationReadHeader(file, header, error)) {
+          info["width"] = header.width;
+          info["frames"] = header.frameCount;
+          info["frameDelay"] = header.frameDelay;
+        } else {
+          info["error"] = error;
+        }
+      }
+      file = root.openNextFile();
+    }
+    
+    doc["freeBytes"] = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+  });
+  
+  // Registered ahead of POST /animations, which would otherwise take
+  // /animations/delete as one of its subpaths and reject it as an upload
+  onTracked("/animations/delete", HTTP_POST, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+    
+    String name = request->hasParam("name") ? request->getParam("name")->value() : "";
+    if (!animationNameValid(name) || !SPIFFS.exists(animationPath(name))) {
+      request->send(404, "application/json", "{\"error\":\"Animation not found\"}");
+      return;
+    }
+    
+    SPIFFS.remove(animationPath(name));
+    
+    // Items still naming it reload and show nothing
+    postRenderCommand(RENDER_CMD_RELOAD_ITEM);
+    Serial.println("✅ Animation deleted: " + name);
+    request->send(200, "application/json", "{\"status\":\"success\"}");
+  });
+  
+  // Upload an animation: POST /animations?name=NAME with the file as the
+  // raw body. Chunks go straight to flash as they arrive; the file is only
+  // put in place once it has been checked.
+  onTracked("/animations", HTTP_POST, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+    
+    String name = request->hasParam("name") ? request->getParam("name")->value() : "";
+    if (!animationNameValid(name)) {
+      request->send(400, "application/json", "{\"error\":\"name must be 1-20 letters, digits, _ or -\"}");
+      return;
+    }
+    
+    bool received = animationUploader == request && !animationUploadFailed;
+    animationUploader = NULL;
+    if (!received) {
+      SPIFFS.remove(ANIMATION_UPLOAD_TMP);
+      request->send(400, "application/json", "{\"error\":\"Upload failed or empty\"}");
+      return;
+    }
+    
+    AnimationHeader header;
+    String error;
+    File file = SPIFFS.open(ANIMATION_UPLOAD_TMP, "r");
+    bool valid = file && animationValidate(file, header, error);
+    size_t bytes = file ? file.size() : 0;
+    if (file) file.close();
+    
+    if (!valid) {
+      SPIFFS.remove(ANIMATION_UPLOAD_TMP);
+      Serial.println("❌ Animation upload rejected: " + error);
+      request->send(400, "application/json", "{\"error\":\"" + error + "\"}");
+      return;
+    }
+    
+    String path = animationPath(name);
+    SPIFFS.remove(path);
+    if (!SPIFFS.rename(ANIMATION_UPLOAD_TMP, path.c_str())) {
+      SPIFFS.remove(ANIMATION_UPLOAD_TMP);
+      request->send(500, "application/json", "{\"error\":\"Failed to store animation\"}");
+      return;
+    }
+    
+    // Items showing the old file reopen it
+    postRenderCommand(RENDER_CMD_RELOAD_ITEM);
+    Serial.println("✅ Animation uploaded: " + name + " (" + String(header.frameCount) + " frames, " + String(bytes) + " bytes)");
+    
+    JsonDocument responseDoc;
+    responseDoc["status"] = "success";
+    responseDoc["name"] = name;
+    responseDoc["width"] = header.width;
+    responseDoc["frames"] = header.frameCount;
+    responseDoc["bytes"] = bytes;
+    
+    String response;
+    serializeJson(responseDoc, response);
+    request->send(200, "application/json", response);
+  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+      // A new upload replaces any that was abandoned part way
+      if (animationUpload) animationUpload.close();
+      animationUploader = request;
+      animationUploadFailed = true;
+      
+      if (!validateApiKey(request)) return;
+      if (total > SPIFFS.totalBytes() - SPIFFS.usedBytes()) {
+        Serial.println("❌ Animation upload too large for free flash");
+        return;
+      }
+      
+      animationUpload = SPIFFS.open(ANIMATION_UPLOAD_TMP, "w");
+      animationUploadFailed = !animationUpload;
+    }
+    
+    if (request != animationUploader || animationUploadFailed) return;
+    
+    if (animationUpload.write(data, len) != len) {
+      Serial.println("❌ Flash write failed during animation upload");
+      animationUploadFailed = true;
+      animationUpload.close();
+      return;
+    }
+    
+    if (index + len == total) animationUpload.close();
+  });
+  
   // Add a manual factory reset endpoint
-  server.on("/manual_factory_reset", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/manual_factory_reset", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key for this sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-    updateInProgress = true;
-
     // Send success response first so client gets it before we reset
     request->send(200, "application/json", "{\"status\":\"success\",\"message\":\"Manual factory reset initiated\"}");
     
-    // Short delayWithWatchdog to allow response to be sent
-    delayWithWatchdog(500);
-    
-    // Perform a simplified factory reset
+    // Perform a simplified factory reset: WiFi settings are cleared on the
+    // main loop, which restarts once pending config changes are written
+    // (the display config is kept)
     Serial.println("⚠️ MANUAL FACTORY RESET INITIATED ⚠️");
-    
-    // Reset WiFi settings first (most important part)
-    WiFi.disconnect(true, true);
-    Serial.println("WiFi credentials cleared");
-    
-    // Restart the device
-    ESP.restart();
+    scheduleRestart(true);
   });
 
 
   // Update WiFi settings endpoint
-  server.on("/update_wifi", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/update_wifi", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key for this sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    updateInProgress = true;
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data);
-    if (error) {
-      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-      return;
-    }
-    
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
     // Check if required parameters are provided
     if (!doc["ssid"].is<String>() || !doc["password"].is<String>()) {
       request->send(400, "application/json", "{\"error\":\"SSID and password are required\"}");
@@ -1083,40 +1542,23 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
       Serial.println("\n✅ Connected to WiFi with new credentials");
       Serial.println("IP Address: " + WiFi.localIP().toString());
       
-      // Set up the temporary IP display
-      ipDisplayConfig.active = true;
-      ipDisplayConfig.text = "WiFi: " + ssid + " - IP: " + WiFi.localIP().toString();
-      ipDisplayConfig.startTime = millis();
-      
-      // Update display with the new connection info
-      disp.displayClear();
-      disp.setTextAlignment(PA_LEFT);
-      disp.setSpeed(40);  // Slightly faster for IP message
-      disp.displayText(ipDisplayConfig.text.c_str(), PA_LEFT, 40, 1000, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+      // Have the render task scroll the new connection info
+      String ipText = "WiFi: " + ssid + " - IP: " + WiFi.localIP().toString();
+      postRenderCommand(RENDER_CMD_SHOW_IP, ipText.c_str());
     } else {
       Serial.println("\n❌ Failed to connect with new credentials");
       Serial.println("Will revert to Access Point mode on next restart");
     }
-    updateInProgress = false;
-
-  });
+  }));
 
   // Update hostname endpoint
-  server.on("/update_hostname", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/update_hostname", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key for this sensitive endpoint
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
       return;
     }
-  }, NULL, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
-    updateInProgress = true;
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data);
-    if (error) {
-      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-      return;
-    }
-    
+  }, NULL, jsonBody([](AsyncWebServerRequest *request, JsonDocument &doc) {
     // Check if hostname parameter is provided
     if (!doc["hostname"].is<String>()) {
       request->send(400, "application/json", "{\"error\":\"hostname parameter is required\"}");
@@ -1161,12 +1603,10 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
     request->send(200, "application/json", response);
     
     Serial.println("✅ Hostname updated to: " + newHostname);
-    updateInProgress = false;
-
-  });
+  }));
 
   // Reboot device endpoint
-  server.on("/reboot", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onTracked("/reboot", HTTP_POST, [](AsyncWebServerRequest *request) {
     // Validate API key for this operation
     if (!validateApiKey(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
@@ -1176,48 +1616,259 @@ server.on("/get", HTTP_GET, [](AsyncWebServerRequest *request) {
     // Send success response before rebooting
     request->send(200, "application/json", "{\"status\":\"success\",\"message\":\"Device is rebooting\"}");
     
-    // Short delayWithWatchdog to allow response to be sent
-    delayWithWatchdog(500);
-    
     // Display reboot message
-    disp.displayClear();
-    disp.setTextAlignment(PA_CENTER);
-    disp.print("REBOOTING");
+    postRenderCommand(RENDER_CMD_SHOW_MESSAGE, "REBOOTING");
     
     // Log reboot
     Serial.println("⚠️ Device reboot initiated via API");
     
-    // Small delayWithWatchdog to show the message
-    delayWithWatchdog(1000);
+    // The main loop restarts once pending config changes are written
+    scheduleRestart(false);
+  });
+
+  // Write pending config changes now instead of after the save delay
+  onTracked("/flush", HTTP_POST, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
     
-    // Restart the device
-    ESP.restart();
+    bool wasDirty = configDirty();
+    requestConfigFlush();
+    request->send(new ConfigFlushResponse(wasDirty));
   });
 
 // Add this to api.cpp in the setupApiEndpoints() function
-server.on("/debug", HTTP_GET, [](AsyncWebServerRequest *request) {
+onTracked("/debug", HTTP_GET, [](AsyncWebServerRequest *request) {
   // Validate API key
   if (!validateApiKey(request)) {
     request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
     return;
   }
   
-  JsonDocument doc;
-  doc["currentTime"] = millis();
-  doc["currentItemIndex"] = config.currentItemIndex;
-  doc["itemStartTime"] = config.itemStartTime;
+  // Item and zone state is read on the render task between frames
+  postConfigEdit(request, [](ConfigEditResult& result) {
+    JsonDocument& doc = result.reply;
+    doc["currentTime"] = millis();
+    doc["currentItemIndex"] = config.currentItemIndex;
+    doc["itemStartTime"] = config.itemStartTime;
   
-  if (config.items.size() > 0 && config.currentItemIndex < config.items.size()) {
-    DisplayItem& currentItem = config.items[config.currentItemIndex];
-    doc["currentItemDuration"] = currentItem.duration;
-    doc["timeElapsed"] = millis() - config.itemStartTime;
-    doc["timeRemaining"] = (config.itemStartTime + currentItem.duration) - millis();
-  }
+    if (config.items.size() > 0 && config.currentItemIndex < config.items.size()) {
+      DisplayItem& currentItem = config.items[config.currentItemIndex];
+      doc["currentItemDuration"] = currentItem.duration;
+      doc["timeElapsed"] = millis() - config.itemStartTime;
+      doc["timeRemaining"] = (config.itemStartTime + currentItem.duration) - millis();
+    }
+  
+    // SPI traffic for the current item (reset on every item transition)
+    JsonObject flush = doc.createNestedObject("flush");
+    flush["flushes"] = frameStats.flushes;
+    flush["framesSent"] = frameStats.framesSent;
+    flush["rowsSent"] = frameStats.rowsSent;
+    flush["bytesSent"] = frameStats.bytesSent;
+    flush["lastFrameBytes"] = frameStats.lastFrameBytes;
+    flush["maxFrameBytes"] = frameStats.maxFrameBytes;
+    flush["fullFrameBytes"] = FRAME_ROWS * MAX7219_PACKET_BYTES;
+    flush["backend"] = getDisplayBackend()->name();
+    flush["lastSendUs"] = frameStats.lastSendUs;
+    flush["maxSendUs"] = frameStats.maxSendUs;
+    flush["avgBytesPerFlush"] = frameStats.flushes ? (float)frameStats.bytesSent / frameStats.flushes : 0;
+  
+    // Frame clock health: is the target rate actually being hit?
+    JsonObject clock = doc.createNestedObject("frameClock");
+    clock["targetFps"] = frameClockStats.targetFps;
+    clock["achievedFps"] = frameClockStats.achievedFps;
+    clock["frames"] = frameClockStats.frames;
+    clock["missedDeadlines"] = frameClockStats.missedDeadlines;
+    clock["jitterUs"] = frameClockStats.jitterUs;
+    clock["avgJitterUs"] = frameClockStats.avgJitterUs;
+    clock["maxJitterUs"] = frameClockStats.maxJitterUs;
+    clock["frameTimeUs"] = frameClockStats.frameTimeUs;
+    clock["maxFrameTimeUs"] = frameClockStats.maxFrameTimeUs;
+  
+    // Render task and web-to-render command queue
+    JsonObject render = doc.createNestedObject("renderTask");
+    render["core"] = renderTaskStats.core;
+    render["commandsApplied"] = renderTaskStats.commandsApplied;
+    render["commandsDropped"] = renderTaskStats.commandsDropped;
+    render["lastCommandLatencyUs"] = renderTaskStats.lastCommandLatencyUs;
+    render["maxCommandLatencyUs"] = renderTaskStats.maxCommandLatencyUs;
+    render["stackHighWater"] = renderTaskStats.stackHighWater;
+  
+    // Text raster cache: cost of the current text item
+    JsonObject text = doc.createNestedObject("textRaster");
+    text["rasters"] = textRasterStats.rasters;
+    text["cacheHits"] = textRasterStats.cacheHits;
+    text["lastRasterUs"] = textRasterStats.lastRasterUs;
+    text["width"] = textRasterStats.width;
+    text["bytes"] = textRasterStats.bytes;
+  
+    // Layer compositor: cost of combining the current layered item
+    JsonObject layers = doc.createNestedObject("compositor");
+    layers["layers"] = compositorStats.layers;
+    layers["composites"] = compositorStats.composites;
+    layers["lastCompositeUs"] = compositorStats.lastCompositeUs;
+    layers["avgCompositeUs"] = compositorStats.avgCompositeUs;
+    layers["maxCompositeUs"] = compositorStats.maxCompositeUs;
+    layers["lastFrameUs"] = compositorStats.lastFrameUs;
+    layers["maxFrameUs"] = compositorStats.maxFrameUs;
+  
+    // Playlist item memory: the fixed part plus pooled text and layer stacks
+    JsonObject mem = doc.createNestedObject("itemMemory");
+    uint32_t liveItems = displayItemStats.items;
+    uint32_t layerStacks = displayItemStats.layerStacks;
+    uint32_t itemHeap = textPoolStats.bytes + layerStacks * sizeof(LayerStack);
+    mem["itemBytes"] = sizeof(DisplayItem);
+    mem["paramBytes"] = sizeof(ModeParams);
+    mem["layerStackBytes"] = sizeof(LayerStack);
+    mem["items"] = liveItems;
+    mem["layerStacks"] = layerStacks;
+    mem["textPoolPages"] = textPoolStats.pages;
+    mem["textPoolBytes"] = textPoolStats.bytes;
+    mem["textStrings"] = textPoolStats.strings;
+    mem["textBytes"] = textPoolStats.textBytes;
+    mem["textStoreFailures"] = textPoolStats.storeFailures;
+    mem["heapPerItem"] = liveItems ? itemHeap / liveItems : 0;
+    mem["bytesPerItem"] = sizeof(DisplayItem) + (liveItems ? itemHeap / liveItems : 0);
+  
+    // Animation playback from flash
+    JsonObject anim = doc.createNestedObject("animation");
+    anim["framesDecoded"] = animationStats.framesDecoded;
+    anim["bytesRead"] = animationStats.bytesRead;
+    anim["decodeErrors"] = animationStats.decodeErrors;
+    anim["lastDecodeUs"] = animationStats.lastDecodeUs;
+    anim["maxDecodeUs"] = animationStats.maxDecodeUs;
+  
+    // Realtime UDP stream: loss, reordering and receive-to-flush latency
+    JsonObject realtime = doc.createNestedObject("realtime");
+    realtime["port"] = REALTIME_UDP_PORT;
+    realtime["active"] = realtimeStats.active;
+    realtime["packets"] = realtimeStats.packets;
+    realtime["frames"] = realtimeStats.frames;
+    realtime["deltas"] = realtimeStats.deltas;
+    realtime["lost"] = realtimeStats.lost;
+    realtime["outOfOrder"] = realtimeStats.outOfOrder;
+    realtime["staleDeltas"] = realtimeStats.staleDeltas;
+    realtime["badPackets"] = realtimeStats.badPackets;
+    realtime["overwritten"] = realtimeStats.overwritten;
+    realtime["shown"] = realtimeStats.shown;
+    realtime["lastSeq"] = realtimeStats.lastSeq;
+    realtime["lastLatencyUs"] = realtimeStats.lastLatencyUs;
+    realtime["maxLatencyUs"] = realtimeStats.maxLatencyUs;
+  
+    // WebSocket event channel
+    JsonObject events = doc.createNestedObject("events");
+    events["clients"] = eventStats.clients;
+    events["posted"] = eventStats.posted;
+    events["dropped"] = eventStats.dropped;
+    events["broadcasts"] = eventStats.broadcasts;
+  
+    // Live preview stream
+    JsonObject preview = doc.createNestedObject("preview");
+    preview["clients"] = previewStats.clients;
+    preview["captures"] = previewStats.captures;
+    preview["framesSent"] = previewStats.framesSent;
+    preview["fullFrames"] = previewStats.fullFrames;
+    preview["bytesSent"] = previewStats.bytesSent;
+    preview["skippedBusy"] = previewStats.skippedBusy;
+    preview["snapshots"] = previewStats.snapshots;
+
+    // Write-behind config saving
+    JsonObject persist = doc.createNestedObject("persistence");
+    persist["dirty"] = configDirty();
+    persist["requests"] = persistStats.requests;
+    persist["snapshots"] = persistStats.snapshots;
+    persist["writes"] = persistStats.writes;
+    persist["failures"] = persistStats.failures;
+    persist["flushes"] = persistStats.flushes;
+    persist["bytesWritten"] = persistStats.bytesWritten;
+    persist["lastSnapshotUs"] = persistStats.lastSnapshotUs;
+    persist["maxSnapshotUs"] = persistStats.maxSnapshotUs;
+    persist["lastWriteMs"] = persistStats.lastWriteMs;
   
-  String response;
-  serializeJson(doc, response);
-  request->send(200, "application/json", response);
+    // How the config was loaded at boot
+    JsonObject load = doc.createNestedObject("configLoad");
+    load["format"] = configLoadStats.format;
+    load["bytes"] = configLoadStats.bytes;
+    load["items"] = configLoadStats.items;
+    load["readUs"] = configLoadStats.readUs;
+    load["decodeUs"] = configLoadStats.decodeUs;
+    load["heapUsed"] = configLoadStats.heapUsed;
+  
+    // Item change log beside the config file
+    JsonObject changeLog = doc.createNestedObject("configLog");
+    changeLog["generation"] = configLogStats.generation;
+    changeLog["bytes"] = configLogStats.bytes;
+    changeLog["replayed"] = configLogStats.replayed;
+    changeLog["torn"] = configLogStats.torn;
+    changeLog["records"] = configLogStats.records;
+    changeLog["appends"] = configLogStats.appends;
+    changeLog["failures"] = configLogStats.failures;
+    changeLog["compactions"] = configLogStats.compactions;
+    changeLog["lastAppendUs"] = configLogStats.lastAppendUs;
+    changeLog["maxAppendUs"] = configLogStats.maxAppendUs;
+  
+    // Item ID lookups for /items/{id}
+    JsonObject idIndex = doc.createNestedObject("itemIndex");
+    idIndex["lookups"] = itemIndexStats.lookups;
+    idIndex["misses"] = itemIndexStats.misses;
+    idIndex["rebuilds"] = itemIndexStats.rebuilds;
+    idIndex["capacity"] = itemIndexStats.capacity;
+    idIndex["items"] = itemIndexStats.items;
+    idIndex["maxProbe"] = itemIndexStats.maxProbe;
+    idIndex["lastRebuildUs"] = itemIndexStats.lastRebuildUs;
+  
+    // API config edits applied by the render task
+    JsonObject edits = doc.createNestedObject("configEdits");
+    edits["posted"] = configEditStats.posted;
+    edits["applied"] = configEditStats.applied;
+    edits["batches"] = configEditStats.batches;
+    edits["largestBatch"] = configEditStats.largestBatch;
+    edits["lastBatchUs"] = configEditStats.lastBatchUs;
+    edits["maxBatchUs"] = configEditStats.maxBatchUs;
+    edits["busy"] = configEditStats.busy;
+    edits["abandoned"] = configEditStats.abandoned;
+  
+    // JSON request bodies
+    JsonObject bodies = doc.createNestedObject("requestBodies");
+    bodies["parsed"] = bodyStats.parsed;
+    bodies["chunks"] = bodyStats.chunks;
+    bodies["invalidJson"] = bodyStats.invalidJson;
+    bodies["tooLarge"] = bodyStats.tooLarge;
+    bodies["noMemory"] = bodyStats.noMemory;
+    bodies["badChunks"] = bodyStats.badChunks;
+    bodies["largestBody"] = bodyStats.largestBody;
+    bodies["limit"] = MAX_REQUEST_BODY_BYTES;
+
+    // Zones sharing the chain, with each one's current item
+    JsonArray zonesArray = doc.createNestedArray("zones");
+    for (uint8_t i = 0; i < zoneCount(); i++) {
+      const DisplayZone& zone = zoneAt(i);
+      JsonObject zoneObj = zonesArray.createNestedObject();
+      zoneObj["name"] = i == 0 ? "main" : zone.name;
+      zoneObj["firstCol"] = zoneFirstCol(zone);
+      zoneObj["width"] = zone.width;
+      zoneObj["currentItemIndex"] = zone.currentItemIndex;
+      zoneObj["timeElapsed"] = zone.itemStartTime ? millis() - zone.itemStartTime : 0;
+    }
+  });
 });  
+  // Prometheus scrape target
+  onTracked("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+    
+    AsyncResponseStream *response = request->beginResponseStream("text/plain; version=0.0.4");
+    writeMetrics(*response);
+    request->send(response);
+  });
+  
+  // Push channel for dashboards, and the live preview
+  setupEventSocket(server);
+  setupPreview(server);
+  
   // Make sure to begin the server at the end of setup
   Serial.println("Starting web server on port 80...");
   server.begin();
@@ -0,0 +1,170 @@
+#include "includes/compositor.h"
+#include "includes/effects.h"
+#include "includes/framebuffer.h"
+#include "includes/grayscale.h"
+#include "includes/text_raster.h"
+#include "includes/effect_registry.h"
+#include <esp_timer.h>
+
+// Initialize global variables
+CompositorStats compositorStats;
+
+static PackedFrame layerPlanes[GRAY_PLANES];       // One grayscale layer, sliced
+static PackedFrame outPlanes[GRAY_PLANES];         // Composite result per bit plane
+
+static const char* const layerOpNames[] = {"or", "xor", "andnot"};
+
+size_t parseLayers(DisplayItem& item, JsonArray layers) {
+  if (item.mode != MODE_LAYERS) item.setMode(MODE_LAYERS);
+  item.clearLayers();
+
+  for (JsonObject layerObj : layers) {
+    if (item.layers().size() >= MAX_ITEM_LAYERS) {
+      Serial.println("⚠️ Too many layers, ignoring the rest");
+      break;
+    }
+
+    String mode = layerObj["mode"] | "text";
+    EffectMode layerMode = effectModeFromName(mode);
+    if (!effectHas(layerMode, EFFECT_LAYER)) {
+      Serial.println("⚠️ Unknown layer mode: '" + mode + "', skipping");
+      continue;
+    }
+
+    String op = layerObj["op"] | "or";
+    if (op == "xor") {
+      item.addLayer(layerMode, LAYER_OP_XOR);
+    } else if (op == "andnot") {
+      item.addLayer(layerMode, LAYER_OP_ANDNOT);
+    } else {
+      item.addLayer(layerMode, LAYER_OP_OR);
+    }
+  }
+
+  return item.layers().size();
+}
+
+void writeLayers(JsonObject itemObj, const DisplayItem& item) {
+  JsonArray layersArray = itemObj.createNestedArray("layers");
+  for (const DisplayLayer& layer : item.layers()) {
+    JsonObject layerObj = layersArray.createNestedObject();
+    layerObj["mode"] = effectModeName(layer.mode);
+    // op is a plain byte, so an out-of-range one from a newer config saves as "or"
+    uint8_t op = layer.op <= LAYER_OP_ANDNOT ? layer.op : (uint8_t)LAYER_OP_OR;
+    layerObj["op"] = layerOpNames[op];
+  }
+}
+
+void resetLayers(LayerBuffers& buffers, const DisplayItem& item) {
+  memset(&buffers, 0, sizeof(buffers));
+  memset(&compositorStats, 0, sizeof(compositorStats));
+  compositorStats.layers = item.layers().size();
+}
+
+// Combine one layer into the result a word at a time
+static void combine(PackedFrame& out, const PackedFrame& layer, uint8_t op) {
+  uint32_t* dst = &out.words[0][0];
+  const uint32_t* src = &layer.words[0][0];
+  const size_t words = FRAME_ROWS * FRAME_ROW_WORDS;
+
+  switch (op) {
+    case LAYER_OP_XOR:
+      for (size_t i = 0; i < words; i++) dst[i] ^= src[i];
+      break;
+    case LAYER_OP_ANDNOT:
+      for (size_t i = 0; i < words; i++) dst[i] &= ~src[i];
+      break;
+    default:
+      for (size_t i = 0; i < words; i++) dst[i] |= src[i];
+      break;
+  }
+}
+
+static void drawLayer(const DisplayLayer& layer, const DisplayItem& item, const TextRaster& raster) {
+  const EffectInfo& effect = effectInfo(layer.mode);
+  if (effect.update) {
+    effect.update(item);
+  } else if (effect.flags & EFFECT_TEXT) {
+    EffectInstance* fx = currentEffects();
+    textRasterDraw(raster, item, fx->firstCol, fx->cols);
+  }
+}
+
+// Combine the layer buffers bottom-up into planes, all of them if any
+// layer is grayscale (returning true) or only planes[0]
+static bool combineLayers(const DisplayItem& item, LayerBuffers& buffers, PackedFrame planes[GRAY_PLANES]) {
+  LayerList layers = item.layers();
+  size_t count = layers.size();
+  bool anyGray = false;
+  for (size_t i = 0; i < count; i++) anyGray = anyGray || effectHas(layers[i].mode, EFFECT_GRAY);
+
+  if (!anyGray) {
+    memset(&planes[0], 0, sizeof(PackedFrame));
+    for (size_t i = 0; i < count; i++) {
+      combine(planes[0], buffers.frames[i], layers[i].op);
+    }
+  } else {
+    memset(planes, 0, sizeof(PackedFrame) * GRAY_PLANES);
+    for (size_t i = 0; i < count; i++) {
+      const DisplayLayer& layer = layers[i];
+      if (effectHas(layer.mode, EFFECT_GRAY)) {
+        graySlice(buffers.gray[i], layerPlanes);
+        for (uint8_t p = 0; p < GRAY_PLANES; p++) combine(planes[p], layerPlanes[p], layer.op);
+      } else {
+        for (uint8_t p = 0; p < GRAY_PLANES; p++) combine(planes[p], buffers.frames[i], layer.op);
+      }
+    }
+  }
+  return anyGray;
+}
+
+bool composeLayers(const DisplayItem& item, LayerBuffers& buffers, const TextRaster& raster,
+                   PackedFrame planes[GRAY_PLANES]) {
+  LayerList layers = item.layers();
+  size_t count = layers.size();
+
+  int64_t frameStart = esp_timer_get_time();
+
+  // Each layer draws into its own buffer; effects that only redraw on
+  // their own interval keep their last frame there
+  for (size_t i = 0; i < count; i++) {
+    const DisplayLayer& layer = layers[i];
+    if (effectHas(layer.mode, EFFECT_GRAY)) {
+      graySetTarget(&buffers.gray[i]);
+      drawLayer(layer, item, raster);
+      graySetTarget(NULL);
+    } else {
+      fbSetTarget(&buffers.frames[i]);
+      drawLayer(layer, item, raster);
+      fbSetTarget(NULL);
+    }
+  }
+
+  int64_t combineStart = esp_timer_get_time();
+  bool anyGray = combineLayers(item, buffers, planes);
+
+  int64_t end = esp_timer_get_time();
+  uint32_t combineUs = (uint32_t)(end - combineStart);
+  uint32_t frameUs = (uint32_t)(end - frameStart);
+
+  compositorStats.composites++;
+  compositorStats.lastCompositeUs = combineUs;
+  if (combineUs > compositorStats.maxCompositeUs) compositorStats.maxCompositeUs = combineUs;
+  // Running average over roughly the last 16 frames
+  compositorStats.avgCompositeUs = compositorStats.composites == 1 ? combineUs :
+      (compositorStats.avgCompositeUs * 15 + combineUs) / 16;
+  compositorStats.lastFrameUs = frameUs;
+  if (frameUs > compositorStats.maxFrameUs) compositorStats.maxFrameUs = frameUs;
+
+  return anyGray;
+}
+
+void renderLayers(const DisplayItem& item, LayerBuffers& buffers, const TextRaster& raster) {
+  if (composeLayers(item, buffers, raster, outPlanes)) {
+    grayCommitPlanes(outPlanes);
+  } else {
+    fbSetFrame(outPlanes[0]);
+    grayStop();
+    fbFlush();
+  }
+}
@@ -2,6 +2,16 @@
 #include "includes/defaults.h"
 #include "includes/display.h"
 #include "includes/utils.h"
+#include "includes/compositor.h"
+#include "includes/zones.h"
+#include "includes/events.h"
+#include "includes/metrics.h"
+#include "includes/persistence.h"
+#include "includes/config_binary.h"
+#include "includes/config_log.h"
+#include "includes/effect_registry.h"
+#include <algorithm>
+#include <esp_timer.h>
 
 // Initialize global variables
 DisplayConfig config;
@@ -14,176 +24,197 @@ TempIPConfig ipDisplayConfig = {
 };
 bool textNeedsUpdate = true;
 
-// Function implementations
-void loadConfig() {
-  File file = SPIFFS.open(CONFIG_FILE, "r");
-  if (!file || file.size() == 0) {
-    Serial.println("⚠️ Config file missing or empty. Resetting...");
-    resetConfig();
-    return;
+// Add the default item to a config with none
+void addDefaultItem(DisplayConfig& cfg) {
+  if (!cfg.items.empty()) return;
+  
+  DisplayItem defaultItem;
+  defaultItem.text = "ESP32 LED Display";
+  defaultItem.alignment = PA_SCROLL_LEFT;
+  defaultItem.invert = false;
+  defaultItem.brightness = DEFAULT_BRIGHTNESS;
+  defaultItem.duration = 0;  // Show forever
+  defaultItem.playCount = 0;
+  defaultItem.maxPlays = 0;
+  defaultItem.deleteAfterPlay = false;
+  
+  cfg.items.push_back(defaultItem);
+}
+
+void assignItemId(DisplayItem& item) {
+  if (item.id == 0) item.id = config.nextItemId++;
+}
+
+void ensureItemIds(DisplayConfig& cfg) {
+  std::vector<uint32_t> seen;
+  seen.reserve(cfg.items.size());
+  for (uint8_t zone = 0; zone <= cfg.zones.size(); zone++) {
+    for (const DisplayItem& item : zone == 0 ? cfg.items : cfg.zones[zone - 1].items) {
+      if (item.id != 0) seen.push_back(item.id);
+    }
+  }
+  std::sort(seen.begin(), seen.end());
+  if (!seen.empty() && seen.back() >= cfg.nextItemId) cfg.nextItemId = seen.back() + 1;
+  
+  // Items without an ID, or sharing one (e.g. from an edited upload), get a new one
+  for (uint8_t zone = 0; zone <= cfg.zones.size(); zone++) {
+    for (DisplayItem& item : zone == 0 ? cfg.items : cfg.zones[zone - 1].items) {
+      if (item.id != 0) {
+        auto first = std::lower_bound(seen.begin(), seen.end(), item.id);
+        if (first + 1 == seen.end() || first[1] != item.id) continue;
+        seen.erase(first);   // The next holder of this ID keeps it
+      }
+      item.id = cfg.nextItemId++;
+    }
+  }
+}
+
+static size_t countItems(const DisplayConfig& cfg) {
+  size_t items = cfg.items.size();
+  for (const DisplayZone& zone : cfg.zones) items += zone.items.size();
+  return items;
+}
+
+// Load an encoded config with one read. False if it is missing or does not check out.
+static bool loadConfigBinary(const char* path, uint32_t heapBefore) {
+  File file = SPIFFS.open(path, "r");
+  if (!file) return false;
+  size_t size = file.size();
+  if (size < CONFIG_BINARY_HEADER_BYTES) {
+    file.close();
+    return false;
   }
   
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, file);
-  if (error) {
-    Serial.println("⚠️ Config file corrupted. Resetting...");
-    resetConfig();
-    return;
+  uint8_t* data = (uint8_t*)malloc(size);
+  if (data == NULL) {
+    Serial.println("❌ No memory to load the config");
+    file.close();
+    return false;
   }
   
-  // Load global settings
-  config.displayOn = doc["displayOn"] | true;
-  config.loopItems = doc["loopItems"] | true;
-  config.currentItemIndex = 0;  // Always start with the first item
-  config.itemStartTime = 0;
+  int64_t start = esp_timer_get_time();
+  bool ok = file.read(data, size) == size;
+  file.close();
+  int64_t read = esp_timer_get_time();
+  
+  ok = ok && decodeConfigBinary(data, size, config);
+  uint32_t heapPeak = ESP.getFreeHeap();   // Buffer and items both held
+  uint16_t generation = ok ? configBinaryGeneration(data) : 0;
+  free(data);
+  if (!ok) {
+    Serial.printf("⚠️ Config file %s is corrupted\n", path);
+    return false;
+  }
   
-  // Clear existing items
-  config.items.clear();
+  // Changes made since the file was written; a damaged log is compacted away
+  bool replayed = replayConfigLog(config, generation);
+  ensureItemIds(config);
+  if (!replayed) {
+    saveConfig();
+  } else if (configLogStats.bytes >= CONFIG_LOG_COMPACT_BYTES) {
+    configLogStats.compactions++;
+    saveConfig();
+  } else if (configLogStats.bytes == 0) {
+    startConfigLog(generation);   // None yet, or left from an older config file
+  }
   
-  // Load items array
-  if (doc["items"].is<JsonArray>()) {
-    for (JsonObject itemObj : doc["items"].as<JsonArray>()) {
-      DisplayItem item;
-      
-      // Load item settings
-      item.mode = itemObj["mode"].as<String>();
-      if (item.mode.length() == 0) {
-        item.mode = "text";  // Default mode
-      }
-      
-      // Load mode-specific parameters
-      if (item.mode == "text") {
-        item.text = itemObj["text"].as<String>();
-        if (item.text.length() == 0) {
-          item.text = "ESP32 LED Display";  // Default text
-        }
-        item.alignment = itemObj["alignment"] | PA_SCROLL_LEFT;
-        item.scrollSpeed = itemObj["scrollSpeed"] | DEFAULT_SCROLL_SPEED;
-        item.pauseTime = itemObj["pauseTime"] | DEFAULT_PAUSE_TIME;
-      }
-      else if (item.mode == "twinkle") {
-        item.twinkleDensity = itemObj["twinkleDensity"] | DEFAULT_TWINKLE_DENSITY;
-        item.twinkleMinSpeed = itemObj["twinkleMinSpeed"] | DEFAULT_TWINKLE_MIN_SPEED;
-        item.twinkleMaxSpeed = itemObj["twinkleMaxSpeed"] | DEFAULT_TWINKLE_MAX_SPEED;
-      }
-      else if (item.mode == "knightrider") {
-        item.knightRiderSpeed = itemObj["knightRiderSpeed"] | 50;
-        item.knightRiderTailLength = itemObj["knightRiderTailLength"] | 3;
-      }
-      else if (item.mode == "pong") {
-        item.pongSpeed = itemObj["pongSpeed"] | 100;
-        item.pongBallSpeedX = itemObj["pongBallSpeedX"] | 0.5;
-        item.pongBallSpeedY = itemObj["pongBallSpeedY"] | 0.25;
-      }
-      else if (item.mode == "sinewave") {
-        item.sineWaveSpeed = itemObj["sineWaveSpeed"] | 50;
-        item.sineWaveAmplitude = itemObj["sineWaveAmplitude"] | 3;
-        item.sineWavePhases = itemObj["sineWavePhases"] | 3;
-      }
-      
-      // Load common parameters
-      item.invert = itemObj["invert"] | false;
-      item.brightness = itemObj["brightness"] | DEFAULT_BRIGHTNESS;
-      item.duration = itemObj["duration"] | 0;  // Default: show forever
-      item.playCount = itemObj["playCount"] | 0;
-      item.maxPlays = itemObj["maxPlays"] | 0;  // 0 = unlimited plays
-      item.deleteAfterPlay = itemObj["deleteAfterPlay"] | false;
-      
-      // Add to items array
-      config.items.push_back(item);
-    }
+  configLoadStats.format = "binary";
+  configLoadStats.bytes = size;
+  configLoadStats.readUs = (uint32_t)(read - start);
+  configLoadStats.decodeUs = (uint32_t)(esp_timer_get_time() - read);
+  configLoadStats.heapUsed = heapBefore > heapPeak ? heapBefore - heapPeak : 0;
+  return true;
+}
+
+// Load a JSON config (CONFIG_FILE from before the binary format)
+static bool loadConfigJson(const char* path, uint32_t heapBefore) {
+  File file = SPIFFS.open(path, "r");
+  if (!file || file.size() == 0) return false;
+  size_t size = file.size();
+  
+  int64_t start = esp_timer_get_time();
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+  int64_t read = esp_timer_get_time();
+  if (error) {
+    Serial.printf("⚠️ Config file %s is corrupted\n", path);
+    return false;
   }
   
-  // If no items were loaded, add a default item
-  if (config.items.empty()) {
-    DisplayItem defaultItem;
-    defaultItem.mode = "text";
-    defaultItem.text = "ESP32 LED Display";
-    defaultItem.alignment = PA_SCROLL_LEFT;
-    defaultItem.invert = false;
-    defaultItem.brightness = DEFAULT_BRIGHTNESS;
-    defaultItem.scrollSpeed = DEFAULT_SCROLL_SPEED;
-    defaultItem.pauseTime = DEFAULT_PAUSE_TIME;
-    defaultItem.twinkleDensity = DEFAULT_TWINKLE_DENSITY;
-    defaultItem.twinkleMinSpeed = DEFAULT_TWINKLE_MIN_SPEED;
-    defaultItem.twinkleMaxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
-    defaultItem.duration = 0;  // Show forever
-    defaultItem.playCount = 0;
-    defaultItem.maxPlays = 0;
-    defaultItem.deleteAfterPlay = false;
-    
-    config.items.push_back(defaultItem);
+  configFromJson(doc, config);
+  configLoadStats.format = "json";
+  configLoadStats.bytes = size;
+  configLoadStats.readUs = (uint32_t)(read - start);
+  configLoadStats.decodeUs = (uint32_t)(esp_timer_get_time() - read);
+  uint32_t heapPeak = ESP.getFreeHeap();   // Document and items both held
+  configLoadStats.heapUsed = heapBefore > heapPeak ? heapBefore - heapPeak : 0;
+  return true;
+}
+
+// Function implementations
+void loadConfig() {
+  uint32_t heapBefore = ESP.getFreeHeap();
+  
+  // A save interrupted between removing the old file and renaming the new
+  // one leaves only the temporary file
+  if (loadConfigBinary(CONFIG_BINARY_FILE, heapBefore) || loadConfigBinary(CONFIG_BINARY_TMP_FILE, heapBefore)) {
+    addDefaultItem(config);
+    assignItemId(config.items.back());
+  } else if (loadConfigJson(CONFIG_FILE, heapBefore)) {
+    Serial.println("Converting " CONFIG_FILE " to " CONFIG_BINARY_FILE "...");
+    ensureItemIds(config);
+    if (saveConfig()) SPIFFS.remove(CONFIG_FILE);
+  } else {
+    Serial.println("⚠️ Config file missing or corrupted. Resetting...");
+    resetConfig();
+    configLoadStats.format = "default";
+    configLoadStats.items = countItems(config);
+    return;
   }
   
-  file.close();
+  configLoadStats.items = countItems(config);
   Serial.println("✅ Config loaded successfully!");
   Serial.println("Number of display items: " + String(config.items.size()));
+  Serial.printf("Config load: %s, %u bytes, read %u us, decode %u us, %u bytes heap\n",
+                configLoadStats.format, (unsigned)configLoadStats.bytes, configLoadStats.readUs,
+                configLoadStats.decodeUs, configLoadStats.heapUsed);
 }
 
-void saveConfig() {
-  File file = SPIFFS.open(CONFIG_FILE, "w");
+
+bool writeConfigFile(const std::vector<uint8_t>& data) {
+  int64_t start = esp_timer_get_time();
+  
+  // Write a new file and swap it in, so a reset mid-write keeps the old one
+  File file = SPIFFS.open(CONFIG_BINARY_TMP_FILE, "w");
   if (!file) {
     Serial.println("⚠️ Failed to open config file for writing!");
-    return;
+    return false;
   }
+  bool ok = !data.empty() && file.write(data.data(), data.size()) == data.size();
+  file.close();
   
-  JsonDocument doc;
-  
-  // Save global settings
-  doc["displayOn"] = config.displayOn;
-  doc["loopItems"] = config.loopItems;
-  
-  // Create items array
-  JsonArray itemsArray = doc.createNestedArray("items");
-  
-  // Add each item
-  for (const DisplayItem& item : config.items) {
-    JsonObject itemObj = itemsArray.createNestedObject();
-    
-    // Save common parameters
-    itemObj["mode"] = item.mode;
-    itemObj["invert"] = item.invert;
-    itemObj["brightness"] = item.brightness;
-    itemObj["duration"] = item.duration;
-    itemObj["playCount"] = item.playCount;
-    itemObj["maxPlays"] = item.maxPlays;
-    itemObj["deleteAfterPlay"] = item.deleteAfterPlay;
-    
-    // Save mode-specific parameters
-    if (item.mode == "text") {
-      itemObj["text"] = item.text;
-      itemObj["alignment"] = item.alignment;
-      itemObj["scrollSpeed"] = item.scrollSpeed;
-      itemObj["pauseTime"] = item.pauseTime;
-    }
-    else if (item.mode == "twinkle") {
-      itemObj["twinkleDensity"] = item.twinkleDensity;
-      itemObj["twinkleMinSpeed"] = item.twinkleMinSpeed;
-      itemObj["twinkleMaxSpeed"] = item.twinkleMaxSpeed;
-    }
-    else if (item.mode == "knightrider") {
-      itemObj["knightRiderSpeed"] = item.knightRiderSpeed;
-      itemObj["knightRiderTailLength"] = item.knightRiderTailLength;
-    }
-    else if (item.mode == "pong") {
-      itemObj["pongSpeed"] = item.pongSpeed;
-      itemObj["pongBallSpeedX"] = item.pongBallSpeedX;
-      itemObj["pongBallSpeedY"] = item.pongBallSpeedY;
-    }
-    else if (item.mode == "sinewave") {
-      itemObj["sineWaveSpeed"] = item.sineWaveSpeed;
-      itemObj["sineWaveAmplitude"] = item.sineWaveAmplitude;
-      itemObj["sineWavePhases"] = item.sineWavePhases;
-    }
+  if (ok) {
+    SPIFFS.remove(CONFIG_BINARY_FILE);
+    ok = SPIFFS.rename(CONFIG_BINARY_TMP_FILE, CONFIG_BINARY_FILE);
   }
-  
-  if (serializeJson(doc, file) == 0) {
+  if (!ok) {
     Serial.println("⚠️ Failed to write to config file!");
   } else {
     Serial.println("✅ Config saved!");
+    postEvent(EVENT_CONFIG_CHANGED);
   }
   
-  file.close();
+  metricsObserve(metrics.configSave, (uint32_t)(esp_timer_get_time() - start));
+  return ok;
+}
+
+bool saveConfig() {
+  // The next generation, with a new empty change log to go with it
+  uint16_t generation = configLogStats.generation + 1;
+  std::vector<uint8_t> data;
+  encodeConfigBinary(config, data, generation);
+  return writeConfigFile(data) && startConfigLog(generation);
 }
 
 // In config.cpp, update the resetConfig function to set a default duration
@@ -193,19 +224,21 @@ void resetConfig() {
   // Clear the configuration
   config.displayOn = true;
   config.loopItems = true;
+  config.frameRate = DEFAULT_FRAME_RATE;
+  config.realtimeTimeout = REALTIME_TIMEOUT_MS;
   config.currentItemIndex = 0;
   config.itemStartTime = 0;
+  config.startCol = 0;
+  config.width = FRAME_COLS;
+  config.zones.clear();
   config.items.clear();
   
   // Add default text item
   DisplayItem textItem;
-  textItem.mode = "text";
   textItem.text = "Connect to " + securityConfig.apName + " WiFi - Go to 192.168.4.1";
   textItem.alignment = PA_SCROLL_LEFT;
   textItem.invert = false;
   textItem.brightness = DEFAULT_BRIGHTNESS;
-  textItem.scrollSpeed = DEFAULT_SCROLL_SPEED;
-  textItem.pauseTime = DEFAULT_PAUSE_TIME;
   textItem.duration = 10000;  // 10 seconds default duration
   textItem.playCount = 0;
   textItem.maxPlays = 0;
@@ -215,12 +248,9 @@ void resetConfig() {
   
   // Add a twinkle effect item
   DisplayItem twinkleItem;
-  twinkleItem.mode = "twinkle";
+  twinkleItem.setMode(MODE_TWINKLE);
   twinkleItem.invert = false;
   twinkleItem.brightness = DEFAULT_BRIGHTNESS;
-  twinkleItem.twinkleDensity = DEFAULT_TWINKLE_DENSITY;
-  twinkleItem.twinkleMinSpeed = DEFAULT_TWINKLE_MIN_SPEED;
-  twinkleItem.twinkleMaxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
   twinkleItem.duration = 5000;  // 5 seconds
   twinkleItem.playCount = 0;
   twinkleItem.maxPlays = 0;
@@ -230,11 +260,9 @@ void resetConfig() {
   
   // Add a Knight Rider effect item
   DisplayItem knightRiderItem;
-  knightRiderItem.mode = "knightrider";
+  knightRiderItem.setMode(MODE_KNIGHTRIDER);
   knightRiderItem.invert = false;
   knightRiderItem.brightness = DEFAULT_BRIGHTNESS;
-  knightRiderItem.knightRiderSpeed = 50;
-  knightRiderItem.knightRiderTailLength = 3;
   knightRiderItem.duration = 5000;  // 5 seconds
   knightRiderItem.playCount = 0;
   knightRiderItem.maxPlays = 0;
@@ -242,6 +270,7 @@ void resetConfig() {
   
   config.items.push_back(knightRiderItem);
   
+  ensureItemIds(config);
   saveConfig();
 }
 
@@ -311,7 +340,7 @@ void changeApiKey(String newKey) {
 }
 void factoryReset() {
   Serial.println("⚠️ FACTORY RESET INITIATED ⚠️");
-  updateInProgress = true;
+  stopConfigSaves();   // A late write-behind save would bring the config back
   
   // Set the factory reset flag to prevent immediate reset on next boot
   Serial.println("Setting factory reset flag...");
@@ -421,6 +450,18 @@ void factoryReset() {
       Serial.printf("WARNING: Config file %s does not exist\n", CONFIG_FILE);
     }
     
+    // The binary config, a save that was being swapped in and the change log
+    const char* binaryFiles[] = {CONFIG_BINARY_FILE, CONFIG_BINARY_TMP_FILE, CONFIG_LOG_FILE};
+    for (const char* path : binaryFiles) {
+      if (SPIFFS.exists(path)) {
+        if (SPIFFS.remove(path)) {
+          Serial.printf("Successfully removed %s\n", path);
+        } else {
+          Serial.printf("ERROR: Failed to remove %s\n", path);
+        }
+      }
+    }
+    
     if (SPIFFS.exists(SECURITY_FILE)) {
       Serial.printf("Found security file: %s\n", SECURITY_FILE);
       try {
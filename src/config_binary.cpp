@@ -0,0 +1,413 @@
+#include "includes/config_binary.h"
+#include "includes/defaults.h"
+#include "includes/compositor.h"
+#include "includes/zones.h"
+#include "includes/utils.h"
+#include "includes/effect_registry.h"
+#include <string.h>
+
+// Initialize global variables
+ConfigLoadStats configLoadStats = {"none", 0, 0, 0, 0, 0};
+
+#define ITEM_FLAG_INVERT 0x01
+#define ITEM_FLAG_DELETE_AFTER_PLAY 0x02
+
+// Writing
+
+static void put8(std::vector<uint8_t>& out, uint32_t value) {
+  out.push_back((uint8_t)value);
+}
+
+static void put16(std::vector<uint8_t>& out, uint32_t value) {
+  out.push_back((uint8_t)value);
+  out.push_back((uint8_t)(value >> 8));
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t value) {
+  put16(out, value);
+  put16(out, value >> 16);
+}
+
+static void putFloat(std::vector<uint8_t>& out, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  put32(out, bits);
+}
+
+// Clamp a signed value into an unsigned field
+static uint32_t clampU(long value, uint32_t max) {
+  if (value < 0) return 0;
+  return (unsigned long)value > max ? max : (uint32_t)value;
+}
+
+static void putString(std::vector<uint8_t>& out, const char* value, size_t valueLength, uint32_t maxLength) {
+  uint32_t length = valueLength > maxLength ? maxLength : valueLength;
+  if (maxLength > 0xFF) put16(out, length); else put8(out, length);
+  out.insert(out.end(), (const uint8_t*)value, (const uint8_t*)value + length);
+}
+
+// Text longer than this is cut so a record always fits its u16 length
+#define MAX_STORED_TEXT 0xFF00
+
+static void writeModeParams(std::vector<uint8_t>& out, const DisplayItem& item, const ModeParams& params,
+                            EffectMode type) {
+  switch (type) {
+    case MODE_TEXT:
+      putString(out, item.text.c_str(), item.text.length(), MAX_STORED_TEXT);
+      put8(out, item.alignment);
+      put16(out, params.text.scrollSpeed);
+      put32(out, params.text.pauseTime);
+      break;
+    case MODE_TWINKLE:
+      put8(out, params.twinkle.density);
+      put16(out, params.twinkle.minSpeed);
+      put16(out, params.twinkle.maxSpeed);
+      break;
+    case MODE_KNIGHTRIDER:
+      put16(out, params.knightRider.speed);
+      put8(out, params.knightRider.tailLength);
+      break;
+    case MODE_PONG:
+      put16(out, params.pong.speed);
+      putFloat(out, params.pong.ballSpeedX);
+      putFloat(out, params.pong.ballSpeedY);
+      break;
+    case MODE_SINEWAVE:
+      put16(out, params.sineWave.speed);
+      put8(out, params.sineWave.amplitude);
+      put8(out, params.sineWave.phases);
+      break;
+    case MODE_LIFE:
+      put16(out, params.life.birth);
+      put16(out, params.life.survive);
+      put16(out, params.life.speed);
+      put8(out, params.life.density);
+      put8(out, params.life.elementary);
+      put8(out, params.life.wolfram);
+      break;
+    case MODE_BITMAP:
+    case MODE_ANIMATION:
+      putString(out, item.file(), strlen(item.file()), 0xFF);
+      put16(out, params.frames.frameDelay);
+      put8(out, item.alignment);
+      break;
+    default:
+      break;
+  }
+}
+
+void encodeItem(std::vector<uint8_t>& out, const DisplayItem& item) {
+  EffectMode type = item.mode;
+  put8(out, type);
+  size_t lengthAt = out.size();
+  put16(out, 0);   // Record length, filled in below
+
+  put32(out, item.id);
+  put8(out, (item.invert ? ITEM_FLAG_INVERT : 0) | (item.deleteAfterPlay ? ITEM_FLAG_DELETE_AFTER_PLAY : 0));
+  put8(out, item.brightness);
+  put32(out, item.duration);
+  put16(out, item.playCount);
+  put16(out, item.maxPlays);
+
+  if (type == MODE_LAYERS) {
+    LayerList layers = item.layers();
+    put8(out, layers.size());
+    for (const DisplayLayer& layer : layers) {
+      put8(out, layer.mode);
+      put8(out, layer.op);
+    }
+    // Layers of one mode share its parameters: one set per distinct mode
+    uint32_t paramsWritten = 0;
+    for (const DisplayLayer& layer : layers) {
+      if (layer.mode >= 32 || (paramsWritten & (1UL << layer.mode))) continue;
+      paramsWritten |= 1UL << layer.mode;
+      writeModeParams(out, item, *item.paramsFor(layer.mode), layer.mode);
+    }
+  } else if (type == MODE_UNKNOWN) {
+    put8(out, 0);   // Empty mode name, kept for older readers; no parameters
+  } else {
+    writeModeParams(out, item, item.params, type);
+  }
+
+  size_t length = out.size() - lengthAt - 2;
+  out[lengthAt] = (uint8_t)length;
+  out[lengthAt + 1] = (uint8_t)(length >> 8);
+}
+
+static void writeItems(std::vector<uint8_t>& out, const std::vector<DisplayItem>& items) {
+  put16(out, clampU(items.size(), 0xFFFF));
+  size_t written = 0;
+  for (const DisplayItem& item : items) {
+    if (written++ == 0xFFFF) break;
+    encodeItem(out, item);
+  }
+}
+
+static void writeZoneHeader(std::vector<uint8_t>& out, const DisplayZone& zone) {
+  put16(out, zone.startCol);
+  put16(out, zone.width);
+}
+
+size_t encodeConfigBinary(const DisplayConfig& cfg, std::vector<uint8_t>& out, uint16_t generation) {
+  out.clear();
+  out.reserve(CONFIG_BINARY_HEADER_BYTES + 64 + 32 * cfg.items.size());
+  out.resize(CONFIG_BINARY_HEADER_BYTES);
+
+  put8(out, cfg.displayOn);
+  put8(out, cfg.loopItems);
+  put16(out, cfg.frameRate);
+  put16(out, cfg.realtimeTimeout);
+  put32(out, cfg.nextItemId);
+  writeZoneHeader(out, cfg);
+  writeItems(out, cfg.items);
+
+  put8(out, cfg.zones.size());
+  for (const DisplayZone& zone : cfg.zones) {
+    putString(out, zone.name.c_str(), zone.name.length(), 0xFF);
+    writeZoneHeader(out, zone);
+    put8(out, zone.loopItems);
+    writeItems(out, zone.items);
+  }
+
+  // Header last: it carries the payload length and CRC
+  size_t payload = out.size() - CONFIG_BINARY_HEADER_BYTES;
+  uint32_t crc = crc32Update(0, out.data() + CONFIG_BINARY_HEADER_BYTES, payload);
+  uint8_t* header = out.data();
+  memcpy(header, CONFIG_BINARY_MAGIC, 4);
+  header[4] = CONFIG_BINARY_VERSION;
+  header[5] = 0;   // Flags, none yet
+  header[6] = (uint8_t)generation;
+  header[7] = (uint8_t)(generation >> 8);
+  for (uint8_t i = 0; i < 4; i++) {
+    header[8 + i] = (uint8_t)(payload >> (8 * i));
+    header[12 + i] = (uint8_t)(crc >> (8 * i));
+  }
+  return out.size();
+}
+
+// Reading. A read past the end returns zeros and clears ok, so callers
+// check once per record rather than after every field.
+
+typedef struct {
+  const uint8_t* pos;
+  const uint8_t* end;
+  bool ok;
+  uint8_t version;   // Format being read
+} Reader;
+
+static bool need(Reader& r, size_t bytes) {
+  if (r.ok && (size_t)(r.end - r.pos) >= bytes) return true;
+  r.ok = false;
+  return false;
+}
+
+static uint8_t get8(Reader& r) {
+  if (!need(r, 1)) return 0;
+  return *r.pos++;
+}
+
+static uint16_t get16(Reader& r) {
+  if (!need(r, 2)) return 0;
+  uint16_t value = r.pos[0] | (r.pos[1] << 8);
+  r.pos += 2;
+  return value;
+}
+
+static uint32_t get32(Reader& r) {
+  uint32_t low = get16(r);
+  return low | ((uint32_t)get16(r) << 16);
+}
+
+static float getFloat(Reader& r) {
+  uint32_t bits = get32(r);
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static void getString(Reader& r, String& value, bool wide) {
+  size_t length = wide ? get16(r) : get8(r);
+  value = "";
+  if (length == 0 || !need(r, length)) return;
+  value.reserve(length);
+  value.concat((const char*)r.pos, length);
+  r.pos += length;
+}
+
+// Text goes straight from the buffer into the pool
+static void getPooledText(Reader& r, PooledText& value) {
+  size_t length = get16(r);
+  value = "";
+  if (length == 0 || !need(r, length)) return;
+  value.set((const char*)r.pos, length);
+  r.pos += length;
+}
+
+static void readModeParams(Reader& r, DisplayItem& item, ModeParams& params, EffectMode type) {
+  switch (type) {
+    case MODE_TEXT:
+      getPooledText(r, item.text);
+      item.alignment = get8(r);
+      params.text.scrollSpeed = get16(r);
+      params.text.pauseTime = get32(r);
+      break;
+    case MODE_TWINKLE:
+      params.twinkle.density = get8(r);
+      params.twinkle.minSpeed = get16(r);
+      params.twinkle.maxSpeed = get16(r);
+      break;
+    case MODE_KNIGHTRIDER:
+      params.knightRider.speed = get16(r);
+      params.knightRider.tailLength = get8(r);
+      break;
+    case MODE_PONG:
+      params.pong.speed = get16(r);
+      params.pong.ballSpeedX = getFloat(r);
+      params.pong.ballSpeedY = getFloat(r);
+      break;
+    case MODE_SINEWAVE:
+      params.sineWave.speed = get16(r);
+      params.sineWave.amplitude = get8(r);
+      params.sineWave.phases = get8(r);
+      break;
+    case MODE_LIFE:
+      params.life.birth = get16(r);
+      params.life.survive = get16(r);
+      params.life.speed = get16(r);
+      params.life.density = get8(r);
+      params.life.elementary = get8(r);
+      params.life.wolfram = get8(r);
+      break;
+    case MODE_BITMAP:
+    case MODE_ANIMATION: {
+      String file;
+      getString(r, file, false);
+      item.setFile(file);
+      params.frames.frameDelay = get16(r);
+      item.alignment = get8(r);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Read one item record; false if it was skipped (unknown type) or malformed
+static bool readItem(Reader& r, DisplayItem& item) {
+  uint8_t type = get8(r);
+  uint16_t length = get16(r);
+  if (!need(r, length)) return false;
+
+  Reader record = {r.pos, r.pos + length, true, r.version};
+  r.pos += length;
+  if (type >= MODE_COUNT && type != MODE_UNKNOWN) {
+    Serial.println("⚠️ Unknown item type " + String(type) + " in config, skipping");
+    return false;
+  }
+
+  item.id = record.version >= 2 ? get32(record) : 0;   // Version 1 had no IDs; assigned after loading
+  uint8_t flags = get8(record);
+  item.invert = flags & ITEM_FLAG_INVERT;
+  item.deleteAfterPlay = flags & ITEM_FLAG_DELETE_AFTER_PLAY;
+  item.brightness = get8(record);
+  item.duration = get32(record);
+  item.playCount = get16(record);
+  item.maxPlays = get16(record);
+
+  item.setMode((EffectMode)type);
+  if (type == MODE_LAYERS) {
+    uint8_t count = get8(record);
+    for (uint8_t i = 0; i < count && record.ok; i++) {
+      EffectMode layerMode = (EffectMode)get8(record);
+      uint8_t op = get8(record);
+      if (effectHas(layerMode, EFFECT_LAYER)) item.addLayer(layerMode, op);
+    }
+    uint32_t read = 0;
+    for (const DisplayLayer& layer : item.layers()) {
+      if (read & (1UL << layer.mode)) continue;
+      read |= 1UL << layer.mode;
+      readModeParams(record, item, *item.paramsFor(layer.mode), layer.mode);
+    }
+  } else if (type == MODE_UNKNOWN) {
+    String name;
+    getString(record, name, false);   // Name of a mode a build did not know; no longer kept
+  } else {
+    readModeParams(record, item, item.params, item.mode);
+  }
+
+  if (!record.ok) {
+    Serial.println("⚠️ Truncated " + String(effectModeName(item.mode)) + " item in config, skipping");
+    return false;
+  }
+  return true;
+}
+
+static bool readItems(Reader& r, std::vector<DisplayItem>& items) {
+  uint16_t count = get16(r);
+  items.clear();
+  items.reserve(count);
+  for (uint16_t i = 0; i < count && r.ok; i++) {
+    items.emplace_back();
+    if (!readItem(r, items.back())) items.pop_back();
+  }
+  return r.ok;
+}
+
+bool decodeItem(const uint8_t* data, size_t length, DisplayItem& item) {
+  Reader r = {data, data + length, true, CONFIG_BINARY_VERSION};
+  return readItem(r, item) && r.pos == r.end;
+}
+
+bool checkConfigBinary(const uint8_t* data, size_t length) {
+  if (length < CONFIG_BINARY_HEADER_BYTES || memcmp(data, CONFIG_BINARY_MAGIC, 4) != 0) return false;
+  if (data[4] < 1 || data[4] > CONFIG_BINARY_VERSION) {
+    Serial.println("⚠️ Config format version " + String(data[4]) + " not supported");
+    return false;
+  }
+
+  uint32_t payload = 0, crc = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    payload |= (uint32_t)data[8 + i] << (8 * i);
+    crc |= (uint32_t)data[12 + i] << (8 * i);
+  }
+  if (payload != length - CONFIG_BINARY_HEADER_BYTES) return false;
+  return crc32Update(0, data + CONFIG_BINARY_HEADER_BYTES, payload) == crc;
+}
+
+uint16_t configBinaryGeneration(const uint8_t* data) {
+  return data[6] | (data[7] << 8);
+}
+
+bool decodeConfigBinary(const uint8_t* data, size_t length, DisplayConfig& cfg) {
+  if (!checkConfigBinary(data, length)) return false;
+
+  Reader r = {data + CONFIG_BINARY_HEADER_BYTES, data + length, true, data[4]};
+  cfg.displayOn = get8(r);
+  cfg.loopItems = get8(r);
+  cfg.frameRate = get16(r);
+  cfg.realtimeTimeout = constrain(get16(r), REALTIME_MIN_TIMEOUT_MS, REALTIME_MAX_TIMEOUT_MS);
+  cfg.nextItemId = r.version >= 2 ? get32(r) : 1;
+  cfg.startCol = get16(r);
+  cfg.width = get16(r);
+  cfg.currentItemIndex = 0;
+  cfg.itemStartTime = 0;
+  sanitizeZone(cfg);
+  if (!readItems(r, cfg.items)) return false;
+
+  uint8_t zones = get8(r);
+  cfg.zones.clear();
+  for (uint8_t i = 0; i < zones && r.ok; i++) {
+    DisplayZone zone;
+    getString(r, zone.name, false);
+    zone.startCol = get16(r);
+    zone.width = get16(r);
+    zone.loopItems = get8(r);
+    zone.currentItemIndex = 0;
+    zone.itemStartTime = 0;
+    if (!readItems(r, zone.items)) return false;
+    if (cfg.zones.size() + 1 >= MAX_ZONES) continue;
+    sanitizeZone(zone);
+    cfg.zones.push_back(std::move(zone));
+  }
+  return r.ok;
+}
@@ -0,0 +1,176 @@
+#include "includes/config_edit.h"
+#include "includes/defaults.h"
+#include "includes/render_task.h"
+#include "includes/deferred_response.h"
+#include "freertos/semphr.h"
+#include <atomic>
+
+// Initialize global variables
+ConfigEditStats configEditStats;
+
+enum ConfigEditState {
+  EDIT_FREE,       // Web server task may claim it
+  EDIT_QUEUED,     // Waiting for the render task
+  EDIT_DONE        // Run; reply waiting for the web server task
+};
+
+typedef struct {
+  std::atomic<uint8_t> state;
+  uint32_t id;                       // Tells a reused slot from the one a response was made for
+  bool abandoned;                    // Client gone; the main loop frees the slot once the edit has run
+  ConfigEditFunction edit;
+  ConfigEditResult result;
+} ConfigEditSlot;
+
+// Slots are claimed on the web server task and run on the render task.
+// A done slot is freed on the web server task by its reply, or on the
+// main loop task if its client went away first. id and abandoned, and
+// freeing a done slot, are guarded by slotsLock, which both take.
+static ConfigEditSlot slots[CONFIG_EDIT_SLOTS];
+static SemaphoreHandle_t slotsLock = NULL;
+static uint32_t nextId = 1;
+
+// Free a done slot; slotsLock held. The edit's closure is moved to edit
+// so that whatever it captured (e.g. the items it replaced) is freed
+// after the lock is given back, and never on the render task.
+static void releaseSlot(ConfigEditSlot& s, ConfigEditFunction& edit) {
+  edit = std::move(s.edit);
+  s.edit = nullptr;
+  s.result.reply.clear();
+  s.id = 0;
+  s.abandoned = false;
+  s.state.store(EDIT_FREE, std::memory_order_release);
+}
+
+// Take the result out of the slot and free it. False if the slot has
+// been reused or its edit has not run yet.
+static bool takeResult(uint8_t slot, uint32_t id, ConfigEditFunction& edit, int& status, String& body) {
+  ConfigEditSlot& s = slots[slot];
+  xSemaphoreTake(slotsLock, portMAX_DELAY);
+  bool done = s.id == id && s.state.load(std::memory_order_acquire) == EDIT_DONE;
+  if (done) {
+    status = s.result.status;
+    serializeJson(s.result.reply, body);
+    releaseSlot(s, edit);
+  }
+  xSemaphoreGive(slotsLock);
+  return done;
+}
+
+// The reply to a posted edit (see deferred_response.h). If the client
+// goes before the edit has run, the slot is marked abandoned for the
+// main loop to free.
+class ConfigEditResponse : public DeferredResponse {
+ public:
+  ConfigEditResponse(uint8_t slot, uint32_t id) : slot(slot), id(id) {}
+
+  ~ConfigEditResponse() {
+    if (replied()) return;
+    ConfigEditSlot& s = slots[slot];
+    ConfigEditFunction edit;
+    xSemaphoreTake(slotsLock, portMAX_DELAY);
+    if (s.id == id) {
+      configEditStats.abandoned++;
+      if (s.state.load(std::memory_order_acquire) == EDIT_DONE) {
+        releaseSlot(s, edit);
+      } else {
+        s.abandoned = true;
+      }
+    }
+    xSemaphoreGive(slotsLock);
+  }
+
+ protected:
+  AsyncWebServerResponse* poll() override {
+    ConfigEditFunction edit;
+    int status;
+    String body;
+    if (!takeResult(slot, id, edit, status, body)) return NULL;
+    return new AsyncBasicResponse(status, "application/json", body);
+  }
+
+ private:
+  uint8_t slot;
+  uint32_t id;
+};
+
+void initConfigEdits() {
+  slotsLock = xSemaphoreCreateMutex();
+}
+
+void configEditError(ConfigEditResult& result, int status, const char* message) {
+  result.status = status;
+  result.reply.clear();
+  result.reply["error"] = message;
+}
+
+void postConfigEdit(AsyncWebServerRequest* request, ConfigEditFunction edit) {
+  uint8_t slot = 0;
+  while (slot < CONFIG_EDIT_SLOTS && slots[slot].state.load(std::memory_order_acquire) != EDIT_FREE) {
+    slot++;
+  }
+  if (slot == CONFIG_EDIT_SLOTS) {
+    configEditStats.busy++;
+    request->send(503, "application/json", "{\"error\":\"Too many pending changes, try again\"}");
+    return;
+  }
+
+  ConfigEditSlot& s = slots[slot];
+  uint32_t id = nextId++;
+  xSemaphoreTake(slotsLock, portMAX_DELAY);
+  s.id = id;
+  s.abandoned = false;
+  xSemaphoreGive(slotsLock);
+
+  s.edit = std::move(edit);
+  s.result.status = 200;
+  s.result.reply.clear();
+  s.result.changed = false;
+  s.result.reload = false;
+  s.state.store(EDIT_QUEUED, std::memory_order_release);
+
+  if (!postRenderCommand(RENDER_CMD_EDIT_CONFIG, NULL, slot)) {
+    xSemaphoreTake(slotsLock, portMAX_DELAY);
+    s.id = 0;
+    xSemaphoreGive(slotsLock);
+    s.edit = nullptr;
+    s.state.store(EDIT_FREE, std::memory_order_release);
+    configEditStats.busy++;
+    request->send(503, "application/json", "{\"error\":\"Too many pending changes, try again\"}");
+    return;
+  }
+
+  configEditStats.posted++;
+  request->send(new ConfigEditResponse(slot, id));
+}
+
+void runConfigEdit(uint8_t slot, bool& changed, bool& reload) {
+  if (slot >= CONFIG_EDIT_SLOTS) return;
+  ConfigEditSlot& s = slots[slot];
+  if (s.state.load(std::memory_order_acquire) != EDIT_QUEUED) return;
+
+  s.edit(s.result);
+  changed |= s.result.changed;
+  reload |= s.result.reload;
+  configEditStats.applied++;
+  s.state.store(EDIT_DONE, std::memory_order_release);
+}
+
+void pumpConfigEdits() {
+  for (uint8_t slot = 0; slot < CONFIG_EDIT_SLOTS; slot++) {
+    ConfigEditSlot& s = slots[slot];
+    if (s.state.load(std::memory_order_acquire) != EDIT_DONE) continue;
+
+    ConfigEditFunction edit;
+    xSemaphoreTake(slotsLock, portMAX_DELAY);
+    if (s.abandoned && s.state.load(std::memory_order_acquire) == EDIT_DONE) releaseSlot(s, edit);
+    xSemaphoreGive(slotsLock);
+  }
+}
+
+uint32_t configEditPollMs() {
+  for (uint8_t slot = 0; slot < CONFIG_EDIT_SLOTS; slot++) {
+    if (slots[slot].state.load(std::memory_order_relaxed) != EDIT_FREE) return CONFIG_EDIT_POLL_MS;
+  }
+  return UINT32_MAX;
+}
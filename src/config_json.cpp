@@ -0,0 +1,132 @@
+#include "includes/config.h"
+#include "includes/defaults.h"
+#include "includes/zones.h"
+#include "includes/effect_registry.h"
+
+// The JSON form of the config: the import/export format
+// (/download_config, /upload_config) and the old /config.json. The
+// on-flash format is config_binary.cpp.
+
+// Load a JSON array of items (the primary playlist or a zone's)
+static void loadItems(std::vector<DisplayItem>& items, JsonArray array) {
+  items.clear();
+  
+  for (JsonObject itemObj : array) {
+    DisplayItem item;
+    
+    // Load item settings
+    item.id = itemObj["id"] | 0;
+    String mode = itemObj["mode"].as<String>();
+    item.setMode(mode.length() == 0 ? MODE_TEXT : effectModeFromName(mode));  // Default mode
+    
+    // Load mode-specific parameters
+    parseEffectParams(item, itemObj);
+    
+    // Load common parameters
+    item.invert = itemObj["invert"] | false;
+    item.brightness = itemObj["brightness"] | DEFAULT_BRIGHTNESS;
+    item.duration = itemObj["duration"] | 0;  // Default: show forever
+    item.playCount = itemObj["playCount"] | 0;
+    item.maxPlays = itemObj["maxPlays"] | 0;  // 0 = unlimited plays
+    item.deleteAfterPlay = itemObj["deleteAfterPlay"] | false;
+    
+    // Add to items array
+    items.push_back(std::move(item));
+  }
+}
+
+// Write items into a JSON array
+static void saveItems(JsonArray itemsArray, const std::vector<DisplayItem>& items) {
+  // Add each item
+  for (const DisplayItem& item : items) {
+    JsonObject itemObj = itemsArray.createNestedObject();
+    
+    // Save common parameters
+    itemObj["id"] = item.id;
+    itemObj["mode"] = effectModeName(item.mode);
+    itemObj["invert"] = item.invert;
+    itemObj["brightness"] = item.brightness;
+    itemObj["duration"] = item.duration;
+    itemObj["playCount"] = item.playCount;
+    itemObj["maxPlays"] = item.maxPlays;
+    itemObj["deleteAfterPlay"] = item.deleteAfterPlay;
+    
+    // Save mode-specific parameters
+    serializeEffectParams(itemObj, item);
+  }
+}
+
+void configFromJson(JsonDocument& doc, DisplayConfig& cfg) {
+  // Load global settings
+  cfg.displayOn = doc["displayOn"] | true;
+  cfg.loopItems = doc["loopItems"] | true;
+  cfg.frameRate = doc["frameRate"] | DEFAULT_FRAME_RATE;
+  cfg.realtimeTimeout = constrain(doc["realtimeTimeout"] | REALTIME_TIMEOUT_MS,
+                                  REALTIME_MIN_TIMEOUT_MS, REALTIME_MAX_TIMEOUT_MS);
+  cfg.currentItemIndex = 0;  // Always start with the first item
+  cfg.itemStartTime = 0;
+  
+  // Clear existing items
+  cfg.items.clear();
+  
+  // Load items array
+  if (doc["items"].is<JsonArray>()) {
+    loadItems(cfg.items, doc["items"].as<JsonArray>());
+  }
+  
+  // Primary zone columns (the whole chain unless zones are defined)
+  cfg.startCol = doc["startCol"] | 0;
+  cfg.width = doc["width"] | FRAME_COLS;
+  sanitizeZone(cfg);
+  
+  // Extra zones
+  cfg.zones.clear();
+  if (doc["zones"].is<JsonArray>()) {
+    for (JsonObject zoneObj : doc["zones"].as<JsonArray>()) {
+      if (cfg.zones.size() + 1 >= MAX_ZONES) {
+        Serial.println("⚠️ Too many zones, ignoring the rest");
+        break;
+      }
+      
+      DisplayZone zone;
+      zone.name = zoneObj["name"] | "";
+      zone.startCol = zoneObj["startCol"] | 0;
+      zone.width = zoneObj["width"] | 0;
+      zone.loopItems = zoneObj["loopItems"] | true;
+      zone.currentItemIndex = 0;
+      zone.itemStartTime = 0;
+      if (zoneObj["items"].is<JsonArray>()) {
+        loadItems(zone.items, zoneObj["items"].as<JsonArray>());
+      }
+      sanitizeZone(zone);
+      cfg.zones.push_back(zone);
+    }
+  }
+  
+  // If no items were loaded, add a default item
+  addDefaultItem(cfg);
+}
+
+void configToJson(const DisplayConfig& cfg, JsonDocument& doc) {
+  // Save global settings
+  doc["displayOn"] = cfg.displayOn;
+  doc["loopItems"] = cfg.loopItems;
+  doc["frameRate"] = cfg.frameRate;
+  doc["realtimeTimeout"] = cfg.realtimeTimeout;
+  
+  // Create items array
+  saveItems(doc.createNestedArray("items"), cfg.items);
+  
+  // Primary zone columns and extra zones
+  doc["startCol"] = cfg.startCol;
+  doc["width"] = cfg.width;
+  JsonArray zonesArray = doc.createNestedArray("zones");
+  for (const DisplayZone& zone : cfg.zones) {
+    JsonObject zoneObj = zonesArray.createNestedObject();
+    zoneObj["name"] = zone.name;
+    zoneObj["startCol"] = zone.startCol;
+    zoneObj["width"] = zone.width;
+    zoneObj["loopItems"] = zone.loopItems;
+    saveItems(zoneObj.createNestedArray("items"), zone.items);
+  }
+}
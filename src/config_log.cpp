@@ -0,0 +1,205 @@
+#include "includes/config_log.h"
+#include "includes/config_binary.h"
+#include "includes/persistence.h"
+#include "includes/events.h"
+#include "includes/utils.h"
+#include <esp_timer.h>
+#include <string.h>
+
+// Initialize global variables
+ConfigLogStats configLogStats;
+
+static bool logStarted = false;   // The file on flash follows the current config file
+
+// Build a record (op, length, payload, CRC) and hand it to persistence.
+// Only the render task builds records, so one buffer serves them all.
+static std::vector<uint8_t> record;
+
+static void beginRecord(uint8_t op) {
+  record.clear();
+  record.push_back(op);
+  record.push_back(0);
+  record.push_back(0);
+}
+
+static void endRecord() {
+  size_t payload = record.size() - 3;
+  record[1] = (uint8_t)payload;
+  record[2] = (uint8_t)(payload >> 8);
+  uint32_t crc = crc32Update(0, record.data(), record.size());
+  for (uint8_t i = 0; i < 4; i++) record.push_back((uint8_t)(crc >> (8 * i)));
+  queueLogRecord(record.data(), record.size());
+  configLogStats.records++;
+}
+
+void logItemAdded(uint8_t zone, DisplayItem& item) {
+  assignItemId(item);
+  beginRecord(LOG_ITEM_ADD);
+  record.push_back(zone);
+  encodeItem(record, item);
+  endRecord();
+}
+
+void logItemUpdated(const DisplayItem& item) {
+  beginRecord(LOG_ITEM_UPDATE);
+  encodeItem(record, item);
+  endRecord();
+}
+
+void logItemDeleted(uint32_t id) {
+  beginRecord(LOG_ITEM_DELETE);
+  for (uint8_t i = 0; i < 4; i++) record.push_back((uint8_t)(id >> (8 * i)));
+  endRecord();
+}
+
+// Find an item by ID in any zone
+static DisplayItem* findItem(DisplayConfig& cfg, uint32_t id, std::vector<DisplayItem>** items, size_t* index) {
+  for (uint8_t zone = 0; zone <= cfg.zones.size(); zone++) {
+    std::vector<DisplayItem>& list = zone == 0 ? cfg.items : cfg.zones[zone - 1].items;
+    for (size_t i = 0; i < list.size(); i++) {
+      if (list[i].id != id) continue;
+      if (items) *items = &list;
+      if (index) *index = i;
+      return &list[i];
+    }
+  }
+  return NULL;
+}
+
+// Apply one record; false if its payload does not decode
+static bool applyRecord(DisplayConfig& cfg, uint8_t op, const uint8_t* payload, size_t length) {
+  switch (op) {
+    case LOG_ITEM_ADD: {
+      DisplayItem item;
+      if (length < 1 || !decodeItem(payload + 1, length - 1, item)) return false;
+      uint8_t zone = payload[0];
+      if (zone > cfg.zones.size()) zone = 0;   // Zone since removed by a full save
+      if (findItem(cfg, item.id, NULL, NULL) != NULL) return true;   // Already in the config
+      if (item.id >= cfg.nextItemId) cfg.nextItemId = item.id + 1;
+      (zone == 0 ? cfg.items : cfg.zones[zone - 1].items).push_back(std::move(item));
+      return true;
+    }
+    case LOG_ITEM_UPDATE: {
+      DisplayItem item;
+      if (!decodeItem(payload, length, item)) return false;
+      DisplayItem* current = findItem(cfg, item.id, NULL, NULL);
+      if (current != NULL) *current = std::move(item);
+      return true;
+    }
+    case LOG_ITEM_DELETE: {
+      if (length != 4) return false;
+      uint32_t id = payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24);
+      std::vector<DisplayItem>* items;
+      size_t index;
+      if (findItem(cfg, id, &items, &index) != NULL) items->erase(items->begin() + index);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool replayConfigLog(DisplayConfig& cfg, uint16_t generation) {
+  configLogStats.generation = generation;
+  configLogStats.replayed = 0;
+  configLogStats.torn = false;
+  configLogStats.bytes = 0;
+  logStarted = false;
+
+  File file = SPIFFS.open(CONFIG_LOG_FILE, "r");
+  if (!file) return true;
+  size_t size = file.size();
+  uint8_t header[CONFIG_LOG_HEADER_BYTES];
+  if (size < CONFIG_LOG_HEADER_BYTES || file.read(header, sizeof(header)) != sizeof(header) ||
+      memcmp(header, CONFIG_LOG_MAGIC, 4) != 0 || (header[4] | (header[5] << 8)) != generation) {
+    // Left from before the config file was last written: its changes are in it
+    file.close();
+    return true;
+  }
+
+  size_t length = size - CONFIG_LOG_HEADER_BYTES;
+  uint8_t* data = (uint8_t*)malloc(length > 0 ? length : 1);
+  if (data == NULL) {
+    file.close();
+    Serial.println("❌ No memory to replay the config log");
+    return false;
+  }
+  bool ok = file.read(data, length) == length;
+  file.close();
+
+  size_t pos = 0;
+  while (ok && pos < length) {
+    if (length - pos < 7) { ok = false; break; }
+    uint8_t op = data[pos];
+    size_t payload = data[pos + 1] | (data[pos + 2] << 8);
+    if (length - pos < 7 + payload) { ok = false; break; }
+
+    const uint8_t* crcBytes = data + pos + 3 + payload;
+    uint32_t crc = crcBytes[0] | (crcBytes[1] << 8) | (crcBytes[2] << 16) | ((uint32_t)crcBytes[3] << 24);
+    if (crc32Update(0, data + pos, 3 + payload) != crc || !applyRecord(cfg, op, data + pos + 3, payload)) {
+      ok = false;
+      break;
+    }
+    configLogStats.replayed++;
+    pos += 7 + payload;
+  }
+  free(data);
+
+  configLogStats.bytes = size;
+  configLogStats.torn = !ok;
+  if (!ok) {
+    Serial.println("⚠️ Config log damaged after " + String(configLogStats.replayed) + " record(s)");
+    return false;
+  }
+
+  logStarted = true;   // Keep appending to it
+  if (configLogStats.replayed > 0) {
+    Serial.println("✅ Replayed " + String(configLogStats.replayed) + " config change(s)");
+  }
+  return true;
+}
+
+bool startConfigLog(uint16_t generation) {
+  logStarted = false;
+  File file = SPIFFS.open(CONFIG_LOG_FILE, "w");
+  if (!file) {
+    Serial.println("⚠️ Failed to start the config log!");
+    return false;
+  }
+  uint8_t header[CONFIG_LOG_HEADER_BYTES] = {0};
+  memcpy(header, CONFIG_LOG_MAGIC, 4);
+  header[4] = (uint8_t)generation;
+  header[5] = (uint8_t)(generation >> 8);
+  bool ok = file.write(header, sizeof(header)) == sizeof(header);
+  file.close();
+
+  if (ok) {
+    logStarted = true;
+    configLogStats.generation = generation;
+    configLogStats.bytes = sizeof(header);
+  }
+  return ok;
+}
+
+bool appendConfigLog(const uint8_t* data, size_t length) {
+  if (!logStarted) return false;
+
+  int64_t start = esp_timer_get_time();
+  File file = SPIFFS.open(CONFIG_LOG_FILE, "a");
+  bool ok = file && file.write(data, length) == length;
+  if (file) file.close();
+  if (!ok) {
+    // A partial record would hide everything after it; only a full save fixes that
+    logStarted = false;
+    configLogStats.failures++;
+    Serial.println("⚠️ Failed to append to the config log!");
+    return false;
+  }
+
+  uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+  configLogStats.appends++;
+  configLogStats.bytes += length;
+  configLogStats.lastAppendUs = us;
+  if (us > configLogStats.maxAppendUs) configLogStats.maxAppendUs = us;
+  postEvent(EVENT_CONFIG_CHANGED);
+  return true;
+}
@@ -1,6 +1,9 @@
 #include "includes/display.h"
 #include "includes/defaults.h"
+#include "includes/display_backend.h"
 #include "includes/effects.h"
+#include "includes/framebuffer.h"
+#include "includes/grayscale.h"
 #include "includes/utils.h"
 
 // Initialize global display object
@@ -12,19 +15,15 @@ void initDisplay() {
   disp.setIntensity(DEFAULT_BRIGHTNESS);
   disp.setSpeed(DEFAULT_SCROLL_SPEED);
   disp.setPause(DEFAULT_PAUSE_TIME);
+  initDisplayBackend();
   
   // Clear the display and any potential garbage
   disp.displayClear();
   
-  // Clear display buffer more thoroughly
-  for (uint8_t row = 0; row < 8; row++) {
-    for (uint8_t col = 0; col < MAX_DEVICES * 8; col++) {
-      disp.getGraphicObject()->setPoint(row, col, false);
-    }
-  }
-  
-  // Force update to ensure clean state
-  disp.getGraphicObject()->update();
+  // Clear display buffer more thoroughly: resend every row register blank
+  fbClear();
+  fbInvalidate();
+  fbFlush();
   
   // Small delayWithWatchdog to ensure display is ready
   delayWithWatchdog(50);
@@ -32,15 +31,10 @@ void initDisplay() {
   // Show a simple "Starting" message
   disp.setTextAlignment(PA_CENTER);
   disp.print("Starting");
+  fbSyncFromDriver();
 }
 
-void clearDisplayForModeChange(String oldMode, String newMode) {
-  // Ensure we have valid modes even if empty strings are passed
-  if (oldMode.length() == 0) oldMode = "unknown";
-  if (newMode.length() == 0) newMode = "text";  // Default to text mode if empty
-  
-  //Serial.println("Mode changing from " + oldMode + " to " + newMode);
-  
+void clearDisplayForModeChange(EffectMode oldMode, EffectMode newMode) {
   // Complete reset of the display
   disp.displayClear();
   disp.setTextAlignment(PA_CENTER);  // Reset to a standard alignment
@@ -48,23 +42,15 @@ void clearDisplayForModeChange(String oldMode, String newMode) {
   // Force display refresh and wait for it to complete
   disp.displayReset();
   
+  // The chain no longer matches the frame buffer; start the next effect from blank
+  grayStop();
+  grayClear();
+  fbClear();
+  fbInvalidate();
+  
   // If coming from twinkle mode, we need to do additional cleanup
-  if (oldMode == "twinkle") {
-    // Explicitly zero out every LED to ensure nothing is left behind
-    for (uint8_t row = 0; row < matrixRows; row++) {
-      for (uint8_t col = 0; col < matrixCols; col++) {
-        disp.getGraphicObject()->setPoint(row, col, false);
-      }
-    }
-    
-    // Force the display to refresh completely
-    disp.getGraphicObject()->clear();
-    disp.getGraphicObject()->update();  // Use update() instead of refreshDisplay()
-    
-    // Reset all twinkle states
-    for (int i = 0; i < MAX_ACTIVE_TWINKLES; i++) {
-      twinkleStates[i].active = false;
-    }
+  if (oldMode == MODE_TWINKLE) {
+    initTwinkleStates();
   }
   
 
@@ -90,6 +76,7 @@ void scrollPortalAddress() {
     if (disp.displayAnimate()) {
       disp.displayReset();
     }
+    fbSyncFromDriver();
     yield(); // Allow WiFiManager to process
   }
 }
@@ -109,4 +96,5 @@ void showUpdatingMessage() {
   
   // Force display refresh
   disp.getGraphicObject()->update();
+  fbSyncFromDriver();
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "includes/display_backend.h"
+#include "includes/defaults.h"
+#include "includes/display.h"
+
+static Max72xxBackend max72xxBackend;
+static SpiDmaBackend spiDmaBackend;
+static DisplayBackend* activeBackend = &max72xxBackend;
+
+bool Max72xxBackend::begin() {
+  // disp.begin() already set up SPI and the chain
+  return true;
+}
+
+void Max72xxBackend::sendRows(const PackedFrame& frame, uint8_t rowMask) {
+  MD_MAX72XX* mx = disp.getGraphicObject();
+
+  // Batch the row writes and let the driver latch each changed row once
+  mx->control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    if (!(rowMask & (1 << row))) continue;
+
+    for (uint8_t dev = 0; dev < MAX_DEVICES; dev++) {
+      mx->setRow(dev, row, frame.bytes[row][dev]);
+    }
+  }
+
+  mx->update();
+  mx->control(MD_MAX72XX::UPDATE, MD_MAX72XX::ON);
+}
+
+void initDisplayBackend() {
+  activeBackend = &max72xxBackend;
+
+  if (DISPLAY_SPI_DMA_ENABLED) {
+    if (spiDmaBackend.begin()) {
+      activeBackend = &spiDmaBackend;
+    } else {
+      Serial.println("⚠️ SPI DMA backend unavailable, using MD_MAX72XX");
+    }
+  }
+
+  if (activeBackend == &max72xxBackend) {
+    max72xxBackend.begin();
+  }
+  Serial.printf("✅ Display backend: %s\n", activeBackend->name());
+}
+
+DisplayBackend* getDisplayBackend() {
+  return activeBackend;
+}
@@ -0,0 +1,210 @@
+#include "includes/config.h"
+#include "includes/defaults.h"
+#include <new>
+
+// Initialize global variables
+DisplayItemStats displayItemStats;
+
+void initModeParams(EffectMode mode, ModeParams& params) {
+  memset(&params, 0, sizeof(params));
+  switch (mode) {
+    case MODE_TEXT:
+      params.text.scrollSpeed = DEFAULT_SCROLL_SPEED;
+      params.text.pauseTime = DEFAULT_PAUSE_TIME;
+      break;
+    case MODE_TWINKLE:
+      params.twinkle.density = DEFAULT_TWINKLE_DENSITY;
+      params.twinkle.minSpeed = DEFAULT_TWINKLE_MIN_SPEED;
+      params.twinkle.maxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
+      break;
+    case MODE_KNIGHTRIDER:
+      params.knightRider.speed = DEFAULT_KNIGHTRIDER_SPEED;
+      params.knightRider.tailLength = DEFAULT_KNIGHTRIDER_TAIL;
+      break;
+    case MODE_PONG:
+      params.pong.speed = DEFAULT_PONG_SPEED;
+      params.pong.ballSpeedX = DEFAULT_PONG_BALL_SPEED_X;
+      params.pong.ballSpeedY = DEFAULT_PONG_BALL_SPEED_Y;
+      break;
+    case MODE_SINEWAVE:
+      params.sineWave.speed = DEFAULT_SINEWAVE_SPEED;
+      params.sineWave.amplitude = DEFAULT_SINEWAVE_AMPLITUDE;
+      params.sineWave.phases = DEFAULT_SINEWAVE_PHASES;
+      break;
+    case MODE_LIFE:
+      params.life.birth = DEFAULT_LIFE_BIRTH;
+      params.life.survive = DEFAULT_LIFE_SURVIVE;
+      params.life.speed = DEFAULT_LIFE_SPEED;
+      params.life.density = DEFAULT_LIFE_DENSITY;
+      break;
+    default:
+      break;   // Frames start with no file and the file's own delay
+  }
+}
+
+static ModeParams defaultParams(EffectMode mode) {
+  ModeParams params;
+  initModeParams(mode, params);
+  return params;
+}
+
+static const ModeParams defaultText = defaultParams(MODE_TEXT);
+static const ModeParams defaultTwinkle = defaultParams(MODE_TWINKLE);
+
+static inline bool isFrameMode(EffectMode mode) {
+  return mode == MODE_BITMAP || mode == MODE_ANIMATION;
+}
+
+DisplayItem::DisplayItem()
+    : id(0), duration(0), playCount(0), maxPlays(0), mode(MODE_TEXT),
+      brightness(DEFAULT_BRIGHTNESS), alignment(PA_SCROLL_LEFT), invert(false),
+      deleteAfterPlay(false) {
+  initModeParams(MODE_TEXT, params);
+  displayItemStats.items++;
+}
+
+DisplayItem::DisplayItem(const DisplayItem& other)
+    : id(other.id), duration(other.duration), text(other.text), playCount(other.playCount),
+      maxPlays(other.maxPlays), mode(other.mode), brightness(other.brightness),
+      alignment(other.alignment), invert(other.invert), deleteAfterPlay(other.deleteAfterPlay) {
+  copyParams(other);
+  displayItemStats.items++;
+}
+
+DisplayItem::DisplayItem(DisplayItem&& other)
+    : id(other.id), duration(other.duration), text(std::move(other.text)), playCount(other.playCount),
+      maxPlays(other.maxPlays), mode(other.mode), brightness(other.brightness),
+      alignment(other.alignment), invert(other.invert), deleteAfterPlay(other.deleteAfterPlay),
+      params(other.params) {
+  // Take the file or layer stack; other is left a plain text item
+  other.mode = MODE_TEXT;
+  initModeParams(MODE_TEXT, other.params);
+  displayItemStats.items++;
+}
+
+DisplayItem& DisplayItem::operator=(const DisplayItem& other) {
+  if (this == &other) return *this;
+  releaseParams();
+  id = other.id;
+  duration = other.duration;
+  text = other.text;
+  playCount = other.playCount;
+  maxPlays = other.maxPlays;
+  mode = other.mode;
+  brightness = other.brightness;
+  alignment = other.alignment;
+  invert = other.invert;
+  deleteAfterPlay = other.deleteAfterPlay;
+  copyParams(other);
+  return *this;
+}
+
+DisplayItem& DisplayItem::operator=(DisplayItem&& other) {
+  if (this == &other) return *this;
+  releaseParams();
+  id = other.id;
+  duration = other.duration;
+  text = std::move(other.text);
+  playCount = other.playCount;
+  maxPlays = other.maxPlays;
+  mode = other.mode;
+  brightness = other.brightness;
+  alignment = other.alignment;
+  invert = other.invert;
+  deleteAfterPlay = other.deleteAfterPlay;
+  params = other.params;
+  other.mode = MODE_TEXT;
+  initModeParams(MODE_TEXT, other.params);
+  return *this;
+}
+
+DisplayItem::~DisplayItem() {
+  releaseParams();
+  displayItemStats.items--;
+}
+
+void DisplayItem::copyParams(const DisplayItem& other) {
+  params = other.params;
+  if (isFrameMode(mode)) {
+    textPoolRetain(params.frames.file);
+  } else if (mode == MODE_LAYERS && other.params.layers != NULL) {
+    params.layers = new (std::nothrow) LayerStack(*other.params.layers);
+    if (params.layers) displayItemStats.layerStacks++;
+  }
+}
+
+void DisplayItem::releaseParams() {
+  if (isFrameMode(mode)) {
+    textPoolRelease(params.frames.file);
+  } else if (mode == MODE_LAYERS && params.layers != NULL) {
+    delete params.layers;
+    displayItemStats.layerStacks--;
+  }
+  params.layers = NULL;
+}
+
+void DisplayItem::setMode(EffectMode newMode) {
+  releaseParams();
+  mode = newMode;
+  initModeParams(newMode, params);
+  if (newMode == MODE_LAYERS) {
+    params.layers = new (std::nothrow) LayerStack();
+    if (params.layers) displayItemStats.layerStacks++;
+  }
+  alignment = isFrameMode(newMode) ? (uint8_t)PA_CENTER : (uint8_t)PA_SCROLL_LEFT;
+}
+
+ModeParams* DisplayItem::paramsFor(EffectMode forMode) {
+  return const_cast<ModeParams*>(static_cast<const DisplayItem*>(this)->paramsFor(forMode));
+}
+
+const ModeParams* DisplayItem::paramsFor(EffectMode forMode) const {
+  if (mode == forMode) return mode == MODE_LAYERS ? NULL : &params;
+  if (mode != MODE_LAYERS || params.layers == NULL) return NULL;
+  const LayerStack& stack = *params.layers;
+  for (uint8_t i = 0; i < stack.count; i++) {
+    if (stack.layers[i].mode == forMode) return &stack.params[i];
+  }
+  return NULL;
+}
+
+const TextParams& DisplayItem::textParams() const {
+  const ModeParams* own = paramsFor(MODE_TEXT);
+  return own ? own->text : defaultText.text;
+}
+
+const TwinkleParams& DisplayItem::twinkle() const {
+  const ModeParams* own = paramsFor(MODE_TWINKLE);
+  return own ? own->twinkle : defaultTwinkle.twinkle;
+}
+
+const char* DisplayItem::file() const {
+  return isFrameMode(mode) ? textPoolData(params.frames.file) : "";
+}
+
+void DisplayItem::setFile(const String& name) {
+  if (!isFrameMode(mode)) return;
+  TextEntry* stored = textPoolStore(name.c_str(), name.length());
+  textPoolRelease(params.frames.file);
+  params.frames.file = stored;
+}
+
+LayerList DisplayItem::layers() const {
+  if (mode != MODE_LAYERS || params.layers == NULL) return LayerList{NULL, 0};
+  return LayerList{params.layers->layers, params.layers->count};
+}
+
+bool DisplayItem::addLayer(EffectMode layerMode, uint8_t op) {
+  if (mode != MODE_LAYERS || params.layers == NULL) return false;
+  LayerStack& stack = *params.layers;
+  if (stack.count >= MAX_ITEM_LAYERS) return false;
+  stack.layers[stack.count].mode = layerMode;
+  stack.layers[stack.count].op = op;
+  initModeParams(layerMode, stack.params[stack.count]);
+  stack.count++;
+  return true;
+}
+
+void DisplayItem::clearLayers() {
+  if (mode == MODE_LAYERS && params.layers != NULL) params.layers->count = 0;
+}
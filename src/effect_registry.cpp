@@ -0,0 +1,182 @@
+#include "includes/effect_registry.h"
+#include "includes/effects.h"
+#include "includes/compositor.h"
+#include "includes/defaults.h"
+
+// Alignment from its name (API) or its PA_ value (saved configs)
+static int parseAlignment(JsonVariant value, int fallback, bool scrolling) {
+  if (value.is<int>()) return value.as<int>();
+  if (!value.is<const char*>()) return fallback;
+
+  String name = value.as<String>();
+  if (name == "left") return PA_LEFT;
+  if (name == "right") return PA_RIGHT;
+  if (name == "center") return PA_CENTER;
+  if (scrolling && name == "scroll_left") return PA_SCROLL_LEFT;
+  if (scrolling && name == "scroll_right") return PA_SCROLL_RIGHT;
+  return fallback;
+}
+
+// Parsers leave fields missing from obj as they are: setMode() has reset
+// them to defaults for a new item, and PATCH keeps the rest
+static void parseText(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  if (!obj["text"].isNull()) {
+    item.text = obj["text"].as<String>();
+  } else if (item.text.length() == 0) {
+    item.text = "New Item";
+  }
+  item.alignment = parseAlignment(obj["alignment"], item.alignment, true);
+  params.text.scrollSpeed = obj["scrollSpeed"] | params.text.scrollSpeed;
+  params.text.pauseTime = obj["pauseTime"] | params.text.pauseTime;
+}
+
+static void serializeText(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  obj["text"] = item.text.c_str();
+  obj["alignment"] = item.alignment;
+  obj["scrollSpeed"] = params.text.scrollSpeed;
+  obj["pauseTime"] = params.text.pauseTime;
+}
+
+static void parseTwinkle(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  params.twinkle.density = obj["twinkleDensity"] | params.twinkle.density;
+  params.twinkle.minSpeed = obj["twinkleMinSpeed"] | params.twinkle.minSpeed;
+  params.twinkle.maxSpeed = obj["twinkleMaxSpeed"] | params.twinkle.maxSpeed;
+}
+
+static void serializeTwinkle(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  obj["twinkleDensity"] = params.twinkle.density;
+  obj["twinkleMinSpeed"] = params.twinkle.minSpeed;
+  obj["twinkleMaxSpeed"] = params.twinkle.maxSpeed;
+}
+
+static void parseKnightRider(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  params.knightRider.speed = obj["knightRiderSpeed"] | params.knightRider.speed;
+  params.knightRider.tailLength = obj["knightRiderTailLength"] | params.knightRider.tailLength;
+}
+
+static void serializeKnightRider(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  obj["knightRiderSpeed"] = params.knightRider.speed;
+  obj["knightRiderTailLength"] = params.knightRider.tailLength;
+}
+
+static void parsePong(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  params.pong.speed = obj["pongSpeed"] | params.pong.speed;
+  params.pong.ballSpeedX = obj["pongBallSpeedX"] | params.pong.ballSpeedX;
+  params.pong.ballSpeedY = obj["pongBallSpeedY"] | params.pong.ballSpeedY;
+}
+
+static void serializePong(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  obj["pongSpeed"] = params.pong.speed;
+  obj["pongBallSpeedX"] = params.pong.ballSpeedX;
+  obj["pongBallSpeedY"] = params.pong.ballSpeedY;
+}
+
+static void parseSineWave(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  params.sineWave.speed = obj["sineWaveSpeed"] | params.sineWave.speed;
+  params.sineWave.amplitude = obj["sineWaveAmplitude"] | params.sineWave.amplitude;
+  params.sineWave.phases = obj["sineWavePhases"] | params.sineWave.phases;
+}
+
+static void serializeSineWave(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  obj["sineWaveSpeed"] = params.sineWave.speed;
+  obj["sineWaveAmplitude"] = params.sineWave.amplitude;
+  obj["sineWavePhases"] = params.sineWave.phases;
+}
+
+// Rule as text ("B3/S23", "W110"); an unreadable one keeps the current rule
+static void parseLife(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  if (!obj["lifeRule"].isNull()) {
+    String rule = obj["lifeRule"].as<String>();
+    if (!parseLifeRule(rule.c_str(), params.life)) {
+      Serial.println("⚠️ Unknown life rule: '" + rule + "', ignored");
+    }
+  }
+  params.life.speed = obj["lifeSpeed"] | params.life.speed;
+  params.life.density = obj["lifeDensity"] | params.life.density;
+}
+
+static void serializeLife(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  char rule[24];
+  formatLifeRule(params.life, rule, sizeof(rule));
+  obj["lifeRule"] = String(rule);
+  obj["lifeSpeed"] = params.life.speed;
+  obj["lifeDensity"] = params.life.density;
+}
+
+// Bitmap and animation items: a frame file uploaded through /animations
+static void parseFrames(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  if (!obj["file"].isNull()) item.setFile(obj["file"].as<String>());
+  params.frames.frameDelay = obj["frameDelay"] | params.frames.frameDelay;
+  item.alignment = parseAlignment(obj["alignment"], item.alignment, false);
+}
+
+static void serializeFrames(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  obj["file"] = item.file();
+  obj["frameDelay"] = params.frames.frameDelay;
+  obj["alignment"] = item.alignment;
+}
+
+// Layered items: the layer list, then the parameters of each layer mode,
+// which every layer of that mode draws with
+static void parseLayered(DisplayItem& item, ModeParams& params, JsonObject obj) {
+  if (obj["layers"].is<JsonArray>()) {
+    parseLayers(item, obj["layers"].as<JsonArray>());
+  }
+  for (const DisplayLayer& layer : item.layers()) {
+    ModeParams* layerParams = item.paramsFor(layer.mode);
+    if (layerParams) effectTable[layer.mode].parse(item, *layerParams, obj);
+  }
+}
+
+static void serializeLayered(JsonObject obj, const DisplayItem& item, const ModeParams& params) {
+  writeLayers(obj, item);
+  uint32_t written = 0;
+  for (const DisplayLayer& layer : item.layers()) {
+    if (written & (1UL << layer.mode)) continue;
+    written |= 1UL << layer.mode;
+    effectTable[layer.mode].serialize(obj, item, *item.paramsFor(layer.mode));
+  }
+}
+
+// In EffectMode order
+const EffectInfo effectTable[MODE_COUNT] = {
+  // name         flags                        init                  update                   parse             serialize
+  {"text",        EFFECT_LAYER | EFFECT_TEXT,  NULL,                 NULL,                    parseText,        serializeText},
+  {"twinkle",     EFFECT_LAYER | EFFECT_GRAY,  initTwinkleStates,    updateTwinkleEffect,     parseTwinkle,     serializeTwinkle},
+  {"knightrider", EFFECT_LAYER | EFFECT_GRAY,  initKnightRiderState, updateKnightRiderEffect, parseKnightRider, serializeKnightRider},
+  {"pong",        EFFECT_LAYER,                initPongState,        updatePongEffect,        parsePong,        serializePong},
+  {"sinewave",    EFFECT_LAYER | EFFECT_GRAY,  initSineWaveState,    updateSineWaveEffect,    parseSineWave,    serializeSineWave},
+  {"bitmap",      EFFECT_FRAMES,               NULL,                 NULL,                    parseFrames,      serializeFrames},
+  {"animation",   EFFECT_FRAMES,               NULL,                 NULL,                    parseFrames,      serializeFrames},
+  {"layers",      0,                           NULL,                 NULL,                    parseLayered,     serializeLayered},
+  {"life",        EFFECT_LAYER,                initLifeState,        updateLifeEffect,        parseLife,        serializeLife},
+};
+
+const EffectInfo unknownEffect = {"unknown", 0, NULL, NULL, NULL, NULL};
+
+EffectMode effectModeFromName(const String& name) {
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    if (name == effectTable[mode].name) return (EffectMode)mode;
+  }
+  return MODE_UNKNOWN;
+}
+
+const char* effectModeName(EffectMode mode) {
+  return effectInfo(mode).name;
+}
+
+void parseEffectParams(DisplayItem& item, JsonObject obj) {
+  const EffectInfo& effect = effectInfo(item.mode);
+  if (effect.parse) effect.parse(item, item.params, obj);
+}
+
+void serializeEffectParams(JsonObject obj, const DisplayItem& item) {
+  const EffectInfo& effect = effectInfo(item.mode);
+  if (effect.serialize) effect.serialize(obj, item, item.params);
+}
+
+void initEffectStates() {
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    if (effectTable[mode].init) effectTable[mode].init();
+  }
+}
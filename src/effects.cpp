@@ -1,308 +1,391 @@
 #include "includes/effects.h"
 #include "includes/defaults.h"
 #include "includes/display.h"
+#include "includes/framebuffer.h"
+#include "includes/grayscale.h"
+#include "includes/zones.h"
+#include "includes/effect_registry.h"
 
 // Initialize global variables
-TwinkleState twinkleStates[MAX_ACTIVE_TWINKLES];
-PongState pongState;
-SineWaveState sineWaveState;
-KnightRiderState knightRiderState;
-
 uint8_t matrixRows = 8;
-uint8_t matrixCols=MAX_DEVICES * 8;
 
+static EffectInstance* fx = NULL;   // Instance the update functions animate
+
+// A twinkle frame is drawn here first, a byte per LED, so overlapping
+// twinkles keep the brighter with a plain max instead of a read-modify-
+// write of packed nibbles. Zones draw one after another and share it.
+static uint8_t twinkleLevels[FRAME_ROWS][FRAME_COLS];
 
 
+
+// The zone is starting over, maybe with another item: give the twinkles
+// back until it shows them again
 void initTwinkleStates() {
-  Serial.println("Initializing twinkle states array...");
-  
-  // Initialize all states to inactive
-  for (int i = 0; i < MAX_ACTIVE_TWINKLES; i++) {
-    twinkleStates[i].active = false;
-    twinkleStates[i].startTime = 0;
-    twinkleStates[i].duration = 0;
-    twinkleStates[i].maxBrightness = 0;
-    twinkleStates[i].row = 0;
-    twinkleStates[i].col = 0;
-  }
-  
-  Serial.println("✅ Twinkle states initialized successfully");
+  free(fx->twinkles);
+  fx->twinkles = NULL;
+  fx->twinkleCapacity = 0;
+  fx->twinkleCount = 0;
+  fx->twinkleLastUpdate = 0;
+}
+
+// Room for a twinkle on every LED of the zone
+static bool reserveTwinkles() {
+  uint16_t capacity = FRAME_ROWS * fx->cols;
+  if (fx->twinkles != NULL && fx->twinkleCapacity == capacity) return true;
+
+  free(fx->twinkles);
+  fx->twinkles = (TwinkleState*)malloc(sizeof(TwinkleState) * capacity);
+  fx->twinkleCapacity = (fx->twinkles != NULL) ? capacity : 0;
+  fx->twinkleCount = 0;
+  return fx->twinkles != NULL;
 }
 
 void updateTwinkleEffect(const DisplayItem& item) {
-  if (item.mode != "twinkle") return;
-  
   // Get current time
   unsigned long currentTime = millis();
+  uint16_t now = (uint16_t)currentTime;
   
-  // Clear the display buffer but don't update the display yet
-  disp.displayClear();
+  // Out of memory: a blank zone this frame
+  if (!reserveTwinkles()) {
+    grayClearColumns(fx->firstCol, fx->cols);
+    return;
+  }
   
   // Cap twinkle values to reasonable ranges to prevent crashes
-  int safeDensity = constrain(item.twinkleDensity, 1, 50);
-  int safeMinSpeed = constrain(item.twinkleMinSpeed, 10, 1000);
-  int safeMaxSpeed = constrain(item.twinkleMaxSpeed, safeMinSpeed, 2000);
-  
-  // 1. Start new twinkles for inactive slots
-  int inactiveCount = 0;
-  
-  // First count how many inactive slots we have
-  for (int i = 0; i < MAX_ACTIVE_TWINKLES; i++) {
-    if (!twinkleStates[i].active) {
-      inactiveCount++;
-    }
+  int safeDensity = constrain(item.twinkle().density, 1, 50);
+  int safeMinSpeed = constrain(item.twinkle().minSpeed, 10, 1000);
+  int safeMaxSpeed = constrain(item.twinkle().maxSpeed, safeMinSpeed, TWINKLE_MAX_DURATION);
+  
+  // Not drawn for longer than any twinkle lasts (e.g. another item was
+  // showing): they have all ended, and their 16-bit start times may have
+  // wrapped around
+  if (currentTime - fx->twinkleLastUpdate >= TWINKLE_MAX_DURATION) {
+    fx->twinkleCount = 0;
   }
+  fx->twinkleLastUpdate = currentTime;
   
-  // Calculate how many new twinkles to create based on density
+  // 1. Start new twinkles in the free entries after the running ones
   int newTwinkles = safeDensity / 5;  // Adjust this divisor to control density
-  newTwinkles = constrain(newTwinkles, 0, inactiveCount);
+  newTwinkles = constrain(newTwinkles, 0, fx->twinkleCapacity - fx->twinkleCount);
   
-  // Activate new twinkles in random positions
   for (int i = 0; i < newTwinkles; i++) {
-    // Find an inactive slot
-    int slot = -1;
-    for (int j = 0; j < MAX_ACTIVE_TWINKLES; j++) {
-      if (!twinkleStates[j].active) {
-        slot = j;
-        break;
-      }
+    TwinkleState& twinkle = fx->twinkles[fx->twinkleCount++];
+    twinkle.startTime = now;
+    // Random duration between minSpeed and maxSpeed
+    twinkle.duration = random(safeMinSpeed, safeMaxSpeed + 1);
+    twinkle.rate = (FIXED_HALF_TURN << TWINKLE_RATE_SHIFT) / twinkle.duration;
+    // Random max brightness between 5 and DEFAULT_MAX_INTENSITY
+    twinkle.maxBrightness = random(5, DEFAULT_MAX_INTENSITY + 1);
+    // Random position on the matrix
+    twinkle.row = random(matrixRows);
+    twinkle.col = random(fx->cols);
+  }
+  
+  // 2. Update the running twinkles. Byte writes could alias the instance,
+  // so its fields are read once, before the loop.
+  TwinkleState* twinkles = fx->twinkles;
+  uint16_t count = fx->twinkleCount;
+  uint16_t firstCol = fx->firstCol;
+  uint16_t cols = fx->cols;
+  uint8_t rows = min(matrixRows, (uint8_t)FRAME_ROWS);
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) memset(twinkleLevels[row], 0, cols);
+  
+  uint16_t i = 0;
+  while (i < count) {
+    TwinkleState& twinkle = twinkles[i];
+    uint16_t elapsed = now - twinkle.startTime;
+    
+    // Finished: the last running twinkle takes its place
+    if (elapsed >= twinkle.duration) {
+      twinkle = twinkles[--count];
+      continue;
     }
+    i++;
+    
+    // Fade in and out along half a sine wave, 0 to 1 to 0 over the
+    // duration. The falling quarter mirrors the rising one, folded with
+    // abs() rather than a branch as half the twinkles are on either side;
+    // the nearest table entry is within 1/20 of a level of the curve.
+    int32_t angle = ((uint32_t)elapsed * twinkle.rate) >> TWINKLE_RATE_SHIFT;
+    uint16_t fromEdge = FIXED_QUARTER_TURN - abs(angle - (int32_t)FIXED_QUARTER_TURN);
+    uint8_t level = q16Round(fixedSineQuarterNearest(fromEdge) * twinkle.maxBrightness);
     
-    if (slot >= 0) {
-      twinkleStates[slot].active = true;
-      twinkleStates[slot].startTime = currentTime;
-      // Random duration between minSpeed and maxSpeed
-      twinkleStates[slot].duration = random(safeMinSpeed, safeMaxSpeed + 1);
-      // Random max brightness between 5 and DEFAULT_MAX_INTENSITY
-      twinkleStates[slot].maxBrightness = random(5, DEFAULT_MAX_INTENSITY + 1);
-      // Random position on the matrix
-      twinkleStates[slot].row = random(matrixRows);
-      twinkleStates[slot].col = random(matrixCols);
+    // Overlapping twinkles keep the brighter of the two
+    if (twinkle.row < rows && twinkle.col < cols) {
+      uint8_t& led = twinkleLevels[twinkle.row][twinkle.col];
+      led = max(led, level);
     }
   }
+  fx->twinkleCount = count;
   
-  // 2. Update currently active twinkles
-  for (int i = 0; i < MAX_ACTIVE_TWINKLES; i++) {
-    if (twinkleStates[i].active) {
-      unsigned long elapsed = currentTime - twinkleStates[i].startTime;
-      
-      // Check if twinkle has completed its cycle
-      if (elapsed >= twinkleStates[i].duration) {
-        twinkleStates[i].active = false;
-        continue;
-      }
-      
-      // Calculate current brightness based on time elapsed
-      float progress = (float)elapsed / twinkleStates[i].duration;
-      float brightness = 0;
-      
-      // Fade in and out using a sine wave
-      // sin(π * progress) gives a value from 0 to 1 to 0 as progress goes from 0 to 1
-      brightness = sin(PI * progress) * twinkleStates[i].maxBrightness;
-      
-      // Set the LED with the calculated brightness
-      if (brightness > 0) {
-        // Check if the row and column are valid
-        if (twinkleStates[i].row < matrixRows && twinkleStates[i].col < matrixCols) {
-          // Using a simulated brightness by controlling whether the LED is on
-          if (random(DEFAULT_MAX_INTENSITY) < brightness) {
-            disp.getGraphicObject()->setPoint(twinkleStates[i].row, twinkleStates[i].col, true);
-          }
-        }
-      }
-    }
-  }
+  // Nothing is sent until the frame is committed
+  graySetColumns(twinkleLevels, firstCol, cols);
 }
 
 
 void initKnightRiderState() {
-  Serial.println("Initializing Knight Rider effect...");
-  knightRiderState.position = 0;
-  knightRiderState.direction = 1;
-  knightRiderState.lastUpdateTime = 0;
-  knightRiderState.updateInterval = 50; // ms between updates
-  knightRiderState.tailLength = 8;      // how many LEDs in the "tail"
-  Serial.println("✅ Knight Rider effect initialized successfully");
+  fx->knightRider.position = 0;
+  fx->knightRider.direction = 1;
+  fx->knightRider.lastUpdateTime = 0;
+  fx->knightRider.updateInterval = 50; // ms between updates
+  fx->knightRider.tailLength = 8;      // how many LEDs in the "tail"
 }
 
 void updateKnightRiderEffect(const DisplayItem& item) {
-  if (item.mode != "knightrider") return;
-  
   unsigned long currentTime = millis();
   
   // Only update at specified intervals
-  if (currentTime - knightRiderState.lastUpdateTime < knightRiderState.updateInterval) {
+  if (currentTime - fx->knightRider.lastUpdateTime < fx->knightRider.updateInterval) {
     return;
   }
   
-  // Clear the display buffer
-  disp.displayClear();
+  // Clear the intensity buffer
+  grayClearColumns(fx->firstCol, fx->cols);
   
   // Update position
-  knightRiderState.position += knightRiderState.direction;
+  fx->knightRider.position += fx->knightRider.direction;
   
   // Check if we need to change direction
-  if (knightRiderState.position >= matrixCols - 1) {
-    knightRiderState.direction = -1;
-    knightRiderState.position = matrixCols - 1;
-  } else if (knightRiderState.position <= 0) {
-    knightRiderState.direction = 1;
-    knightRiderState.position = 0;
+  if (fx->knightRider.position >= fx->cols - 1) {
+    fx->knightRider.direction = -1;
+    fx->knightRider.position = fx->cols - 1;
+  } else if (fx->knightRider.position <= 0) {
+    fx->knightRider.direction = 1;
+    fx->knightRider.position = 0;
   }
   
+  // Full brightness for the main point, fading linearly along the tail
+  q16_16 fullLevel = q16FromInt(GRAY_MAX_LEVEL);
+  q16_16 fadeStep = q16Mul(fullLevel, q16Reciprocal(q16FromInt(fx->knightRider.tailLength)));
+  
   // Draw the "eye" and its tail
-  for (int i = 0; i < knightRiderState.tailLength; i++) {
-    int pos = knightRiderState.position - (i * knightRiderState.direction);
+  for (int i = 0; i < fx->knightRider.tailLength; i++) {
+    int pos = fx->knightRider.position - (i * fx->knightRider.direction);
     
     // Check if position is within the matrix
-    if (pos >= 0 && pos < matrixCols) {
+    if (pos >= 0 && pos < fx->cols) {
       // Progressively dimmer tail (only middle row lit for a line effect)
       int row = matrixRows / 2;
-      // For the main point
-      if (i == 0) {
-        disp.getGraphicObject()->setPoint(row, pos, true);
-      } 
-      // For the tail, we randomly turn on based on distance
-      else if (random(i + 1) == 0) {
-        disp.getGraphicObject()->setPoint(row, pos, true);
-      }
+      uint8_t level = q16Round(fullLevel - fadeStep * i);
+      graySetPixel(row, fx->firstCol + pos, level);
     }
   }
   
-  knightRiderState.lastUpdateTime = currentTime;
+  fx->knightRider.lastUpdateTime = currentTime;
 }
 
 void initPongState() {
-  Serial.println("Initializing Pong effect...");
-  pongState.x = matrixCols / 2;
-  pongState.y = matrixRows / 2;
-  pongState.speedX = 0.5;  // Slower speed for smoother movement
-  pongState.speedY = 0.25;
-  pongState.lastUpdateTime = 0;
-  pongState.updateInterval = 100; // ms between updates
-  Serial.println("✅ Pong effect initialized successfully");
+  fx->pong.x = q16FromInt(fx->cols / 2);
+  fx->pong.y = q16FromInt(matrixRows / 2);
+  fx->pong.speedX = Q16_FROM_FLOAT(0.5);  // Slower speed for smoother movement
+  fx->pong.speedY = Q16_FROM_FLOAT(0.25);
+  fx->pong.lastUpdateTime = 0;
+  fx->pong.updateInterval = 100; // ms between updates
 }
 
 void updatePongEffect(const DisplayItem& item) {
-  if (item.mode != "pong") return;
-  
   unsigned long currentTime = millis();
   
   // Only update at specified intervals
-  if (currentTime - pongState.lastUpdateTime < pongState.updateInterval) {
+  if (currentTime - fx->pong.lastUpdateTime < fx->pong.updateInterval) {
     return;
   }
   
-  // Clear the display buffer
-  disp.displayClear();
+  // Clear the frame buffer
+  fbClearColumns(fx->firstCol, fx->cols);
   
   // Update position
-  pongState.x += pongState.speedX;
-  pongState.y += pongState.speedY;
+  fx->pong.x += fx->pong.speedX;
+  fx->pong.y += fx->pong.speedY;
   
   // Check for collisions with the walls
-  if (pongState.x >= matrixCols - 1) {
-    pongState.speedX = -abs(pongState.speedX); // Ensure we bounce left
-    pongState.x = matrixCols - 1;
-  } else if (pongState.x <= 0) {
-    pongState.speedX = abs(pongState.speedX); // Ensure we bounce right
-    pongState.x = 0;
+  q16_16 maxX = q16FromInt(fx->cols - 1);
+  q16_16 maxY = q16FromInt(matrixRows - 1);
+  if (fx->pong.x >= maxX) {
+    fx->pong.speedX = -abs(fx->pong.speedX); // Ensure we bounce left
+    fx->pong.x = maxX;
+  } else if (fx->pong.x <= 0) {
+    fx->pong.speedX = abs(fx->pong.speedX); // Ensure we bounce right
+    fx->pong.x = 0;
   }
   
-  if (pongState.y >= matrixRows - 1) {
-    pongState.speedY = -abs(pongState.speedY); // Ensure we bounce up
-    pongState.y = matrixRows - 1;
-  } else if (pongState.y <= 0) {
-    pongState.speedY = abs(pongState.speedY); // Ensure we bounce down
-    pongState.y = 0;
+  if (fx->pong.y >= maxY) {
+    fx->pong.speedY = -abs(fx->pong.speedY); // Ensure we bounce up
+    fx->pong.y = maxY;
+  } else if (fx->pong.y <= 0) {
+    fx->pong.speedY = abs(fx->pong.speedY); // Ensure we bounce down
+    fx->pong.y = 0;
   }
   
   // Draw the ball at its current position
-  disp.getGraphicObject()->setPoint(round(pongState.y), round(pongState.x), true);
+  fbSetPoint(q16Round(fx->pong.y), fx->firstCol + q16Round(fx->pong.x), true);
   
-  pongState.lastUpdateTime = currentTime;
+  fx->pong.lastUpdateTime = currentTime;
 }
 
 void initSineWaveState() {
-  Serial.println("Initializing Sine Wave effect...");
-  
   // Set different frequencies and amplitudes for each wave component
   for (int i = 0; i < SINE_PHASES; i++) {
-    sineWaveState.phase[i] = random(0, 628) / 100.0; // Random start phase (0-2π)
-    sineWaveState.frequency[i] = (i + 1) * 0.05;     // Different frequencies
-    sineWaveState.amplitude[i] = SINE_AMPLITUDE / (i + 1); // Decreasing amplitudes
+    fx->sine.phase[i] = random(0, 65536);        // Random start phase (0-2π)
+    fx->sine.frequency[i] = (i + 1) * FIXED_ANGLE_FROM_RADIANS(0.05); // Different frequencies
+    fx->sine.amplitude[i] = q8FromInt(SINE_AMPLITUDE / (i + 1)); // Decreasing amplitudes
   }
   
-  sineWaveState.lastUpdateTime = 0;
-  sineWaveState.updateInterval = 50; // ms between updates
-  
-  Serial.println("✅ Sine Wave effect initialized successfully");
+  fx->sine.lastUpdateTime = 0;
+  fx->sine.updateInterval = 50; // ms between updates
 }
 
 void updateSineWaveEffect(const DisplayItem& item) {
-  if (item.mode != "sinewave") return;
-  
   unsigned long currentTime = millis();
   
   // Only update at specified intervals
-  if (currentTime - sineWaveState.lastUpdateTime < sineWaveState.updateInterval) {
+  if (currentTime - fx->sine.lastUpdateTime < fx->sine.updateInterval) {
     return;
   }
   
-  // Clear the display buffer
-  disp.displayClear();
+  // Clear the intensity buffer
+  grayClearColumns(fx->firstCol, fx->cols);
   
-  // Update phases
+  // Update phases (angles wrap at a full turn by themselves)
   for (int i = 0; i < SINE_PHASES; i++) {
-    sineWaveState.phase[i] += sineWaveState.frequency[i];
-    if (sineWaveState.phase[i] > TWO_PI) {
-      sineWaveState.phase[i] -= TWO_PI;
-    }
+    fx->sine.phase[i] += fx->sine.frequency[i];
   }
   
+  // Calculate base position (middle of display)
+  q16_16 basePos = q16FromInt(matrixRows) / 2;
+  const fixed_angle colStep = FIXED_ANGLE_FROM_RADIANS(0.3);
+  
   // Draw the sine wave visualization
-  for (int col = 0; col < matrixCols; col++) {
-    // Calculate base position (middle of display)
-    float basePos = matrixRows / 2.0;
-    
+  for (int col = 0; col < fx->cols; col++) {
     // Calculate combined sine wave value for this column
-    float waveHeight = 0;
+    q16_16 waveHeight = 0;
     for (int i = 0; i < SINE_PHASES; i++) {
       // Create a sine wave with phase offset based on column
-      float colPhase = col * 0.3 + sineWaveState.phase[i];
-      waveHeight += sin(colPhase) * sineWaveState.amplitude[i];
+      fixed_angle colPhase = col * colStep + fx->sine.phase[i];
+      waveHeight += q16MulQ8(fixedSin(colPhase), fx->sine.amplitude[i]);
     }
     
     // Calculate final position
-    int rowPos = round(basePos + waveHeight);
+    int rowPos = q16Round(basePos + waveHeight);
     
     // Draw the point
     if (rowPos >= 0 && rowPos < matrixRows) {
-      disp.getGraphicObject()->setPoint(rowPos, col, true);
+      graySetPixel(rowPos, fx->firstCol + col, GRAY_MAX_LEVEL);
     }
     
-    // Draw a slightly faded second point to make the line thicker if needed
+    // Draw a faded second point to make the line thicker
     int secondaryRow = waveHeight > 0 ? rowPos - 1 : rowPos + 1;
-    if (secondaryRow >= 0 && secondaryRow < matrixRows && random(3) == 0) {
-      disp.getGraphicObject()->setPoint(secondaryRow, col, true);
+    if (secondaryRow >= 0 && secondaryRow < matrixRows) {
+      graySetPixel(secondaryRow, fx->firstCol + col, GRAY_MAX_LEVEL / 3);
     }
   }
   
-  sineWaveState.lastUpdateTime = currentTime;
+  fx->sine.lastUpdateTime = currentTime;
+}
+
+void initLifeState() {
+  fx->life.seeded = false;
+  fx->life.lastUpdateTime = 0;
+}
+
+static uint32_t lifeRuleKey(const LifeParams& life) {
+  return life.elementary ? (0x80000000UL | life.wolfram) : (life.birth | ((uint32_t)life.survive << 16));
+}
+
+static void rememberLifeGeneration(LifeState& state) {
+  state.history[state.historyNext] = lifeHash(state.grid);
+  state.historyNext = (state.historyNext + 1) % LIFE_HISTORY;
+  if (state.historyCount < LIFE_HISTORY) state.historyCount++;
+}
+
+static void seedLife(LifeState& state, const LifeParams& life) {
+  // An elementary rule starts from one row and scrolls its history up
+  uint8_t density = constrain(life.density, 0, 100);
+  lifeSeed(state.grid, fx->cols, density, life.elementary ? FRAME_ROWS - 1 : 0);
+  state.historyCount = 0;
+  state.historyNext = 0;
+  state.settled = 0;
+  state.generation = 0;
+  state.ruleKey = lifeRuleKey(life);
+  state.seeded = true;
+  rememberLifeGeneration(state);
+}
+
+void updateLifeEffect(const DisplayItem& item) {
+  const ModeParams* params = item.paramsFor(MODE_LIFE);
+  if (params == NULL) return;
+  const LifeParams& life = params->life;
+  LifeState& state = fx->life;
+  unsigned long currentTime = millis();
+  bool sameRule = state.seeded && state.ruleKey == lifeRuleKey(life);
+  
+  // Only update at specified intervals
+  if (sameRule && currentTime - state.lastUpdateTime < life.speed) {
+    return;
+  }
+  
+  if (!sameRule || state.settled >= LIFE_SETTLE_GENERATIONS || state.generation >= LIFE_MAX_GENERATIONS) {
+    seedLife(state, life);
+  } else {
+    LifeGrid next;
+    if (life.elementary) {
+      memcpy(next.rows[0], state.grid.rows[1], sizeof(next.rows[0]) * (FRAME_ROWS - 1));
+      lifeStepElementary(state.grid.rows[FRAME_ROWS - 1], next.rows[FRAME_ROWS - 1], fx->cols, life.wolfram);
+    } else {
+      lifeStep(state.grid, next, fx->cols, life.birth, life.survive);
+    }
+    state.grid = next;
+    state.generation++;
+    
+    // Died out, or the same as one of the last generations: a still life
+    // or an oscillator. Let it run a little longer, then start over.
+    uint32_t hash = lifeHash(state.grid);
+    bool repeated = lifeEmpty(state.grid);
+    for (uint8_t i = 0; i < state.historyCount && !repeated; i++) {
+      repeated = state.history[i] == hash;
+    }
+    state.settled = repeated ? state.settled + 1 : 0;
+    rememberLifeGeneration(state);
+  }
+  
+  lifeDraw(state.grid, fx->firstCol, fx->cols);
+  state.lastUpdateTime = currentTime;
+}
+
+void selectEffects(EffectInstance* instance) {
+  fx = instance;
+}
+
+EffectInstance* currentEffects() {
+  return fx;
+}
+
+void resetEffects(EffectInstance* instance, uint16_t firstCol, uint16_t cols) {
+  EffectInstance* previous = fx;
+  fx = instance;
+  fx->firstCol = firstCol;
+  fx->cols = cols;
+
+  initEffectStates();
+
+  fx = (previous != NULL) ? previous : instance;
 }
 
 // Add these to your initialization function
 void initializeEffects() {
-  initTwinkleStates();
-  initKnightRiderState();
-  initPongState();
-  initSineWaveState();
+  initGrayscale();
+
+  // One effect instance per zone, each starting out full width
+  for (uint8_t i = 0; i < MAX_ZONES; i++) {
+    resetEffects(&zoneRuntime(i)->effects, 0, FRAME_COLS);
+  }
+  selectEffects(&zoneRuntime(0)->effects);
+
+  Serial.println("✅ Effects initialized");
 }
 
 // Add these to your main update loop
 void updateEffects(const DisplayItem& item) {
-  updateTwinkleEffect(item);
-  updateKnightRiderEffect(item);
-  updatePongEffect(item);
-  updateSineWaveEffect(item);
+  const EffectInfo& effect = effectInfo(item.mode);
+  if (effect.update) effect.update(item);
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "includes/events.h"
+#include "includes/defaults.h"
+#include "includes/wifi_manager.h"
+#include "includes/metrics.h"
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include "freertos/queue.h"
+
+// Initialize global variables
+EventStats eventStats;
+
+static AsyncWebSocket ws("/ws");
+static QueueHandle_t eventQueue = NULL;
+
+// Every broadcast is serialized here once; the library shares one copy of
+// the message between all clients
+static char eventBuffer[EVENT_BUFFER_SIZE];
+
+static const char* const eventNames[] = {
+  "itemStarted", "itemEnded", "configChanged", "wifi", "heapLow"
+};
+
+static size_t formatEvent(char* out, size_t size, const DeviceEvent& event) {
+  const char* name = event.type <= EVENT_HEAP_LOW ? eventNames[event.type] : "unknown";
+  int len;
+
+  switch (event.type) {
+    case EVENT_ITEM_STARTED:
+    case EVENT_ITEM_ENDED:
+      len = snprintf(out, size, "{\"event\":\"%s\",\"zone\":%u,\"index\":%d,\"playCount\":%u%s,\"t\":%lu}",
+                     name, event.zone, event.index, event.playCount,
+                     event.value ? ",\"deleted\":true" : "", (unsigned long)event.timeMs);
+      break;
+    case EVENT_WIFI:
+      len = snprintf(out, size, "{\"event\":\"%s\",\"status\":%ld,\"connected\":%s,\"t\":%lu}",
+                     name, (long)event.value, event.value == WL_CONNECTED ? "true" : "false",
+                     (unsigned long)event.timeMs);
+      break;
+    case EVENT_HEAP_LOW:
+      len = snprintf(out, size, "{\"event\":\"%s\",\"freeHeap\":%ld,\"t\":%lu}",
+                     name, (long)event.value, (unsigned long)event.timeMs);
+      break;
+    default:
+      len = snprintf(out, size, "{\"event\":\"%s\",\"t\":%lu}", name, (unsigned long)event.timeMs);
+      break;
+  }
+
+  if (len < 0) return 0;
+  return (size_t)len < size ? (size_t)len : size - 1;
+}
+
+// What the hello reports, as the render task last saw it
+typedef struct {
+  bool displayOn;
+  int index;
+  uint32_t items;
+  uint32_t zones;
+} HelloState;
+
+static HelloState helloState;
+static portMUX_TYPE helloLock = portMUX_INITIALIZER_UNLOCKED;
+
+void publishHelloState() {
+  HelloState state;
+  state.displayOn = config.displayOn;
+  state.index = config.currentItemIndex;
+  state.items = config.items.size();
+  state.zones = config.zones.size() + 1;
+
+  portENTER_CRITICAL(&helloLock);
+  helloState = state;
+  portEXIT_CRITICAL(&helloLock);
+}
+
+// Runs on the web server task, for the new client only
+static void sendHello(AsyncWebSocketClient* client) {
+  portENTER_CRITICAL(&helloLock);
+  HelloState state = helloState;
+  portEXIT_CRITICAL(&helloLock);
+
+  char hello[EVENT_BUFFER_SIZE];
+  int len = snprintf(hello, sizeof(hello),
+                     "{\"event\":\"hello\",\"displayOn\":%s,\"index\":%d,\"items\":%u,\"zones\":%u,\"t\":%lu}",
+                     state.displayOn ? "true" : "false", state.index,
+                     (unsigned)state.items, (unsigned)state.zones, millis());
+  if (len > 0 && (size_t)len < sizeof(hello)) client->text(hello, len);
+}
+
+static void onSocketEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client,
+                          AwsEventType type, void* arg, uint8_t* data, size_t len) {
+  if (type == WS_EVT_CONNECT) {
+    Serial.printf("WebSocket client %u connected\n", client->id());
+    sendHello(client);
+  } else if (type == WS_EVT_DISCONNECT) {
+    Serial.printf("WebSocket client %u disconnected\n", client->id());
+  }
+  // Clients have nothing to say; incoming data is ignored
+}
+
+void setupEventSocket(AsyncWebServer& server) {
+  eventQueue = xQueueCreate(EVENT_QUEUE_SIZE, sizeof(DeviceEvent));
+  if (eventQueue == NULL) {
+    Serial.println("❌ Failed to create event queue");
+    return;
+  }
+
+  ws.onEvent(onSocketEvent);
+  // Browsers cannot set headers on a WebSocket, so use ?api_key=
+  ws.setFilter(validateApiKey);
+  server.addHandler(&ws);
+  Serial.println("✅ Event socket ready on /ws");
+}
+
+void postEvent(DeviceEventType type, uint8_t zone, int16_t index, uint16_t playCount, int32_t value) {
+  if (eventQueue == NULL) return;
+
+  DeviceEvent event;
+  event.type = type;
+  event.zone = zone;
+  event.index = index;
+  event.playCount = playCount;
+  event.value = value;
+  event.timeMs = millis();
+
+  if (xQueueSend(eventQueue, &event, 0) == pdTRUE) {
+    eventStats.posted++;
+  } else {
+    eventStats.dropped++;
+  }
+}
+
+static void broadcast(const DeviceEvent& event) {
+  size_t len = formatEvent(eventBuffer, sizeof(eventBuffer), event);
+  if (len == 0 || ws.count() == 0) return;
+  ws.textAll(eventBuffer, len);
+  eventStats.broadcasts++;
+}
+
+// WiFi and heap are polled here rather than hooked, so their events come
+// from the same task as everything else that touches the socket
+static void checkWiFiAndHeap() {
+  static int lastWiFiStatus = -1;
+  static bool heapLow = false;
+
+  static bool everConnected = false;
+
+  int status = WiFi.status();
+  if (status != lastWiFiStatus) {
+    if (lastWiFiStatus != -1) postEvent(EVENT_WIFI, 0, -1, 0, status);
+    if (status == WL_CONNECTED) {
+      if (everConnected) metricsCount(metrics.wifiReconnects);
+      everConnected = true;
+    }
+    lastWiFiStatus = status;
+  }
+
+  // Warn once on the way down; re-arm only after a clear recovery
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (!heapLow && freeHeap < HEAP_WARNING_BYTES) {
+    heapLow = true;
+    Serial.printf("⚠️ Free heap low: %u bytes\n", freeHeap);
+    postEvent(EVENT_HEAP_LOW, 0, -1, 0, freeHeap);
+  } else if (heapLow && freeHeap > HEAP_WARNING_BYTES + HEAP_WARNING_BYTES / 4) {
+    heapLow = false;
+  }
+}
+
+void pumpEvents(uint32_t waitMs) {
+  if (eventQueue == NULL) {
+    vTaskDelay(pdMS_TO_TICKS(waitMs));
+    return;
+  }
+
+  DeviceEvent event;
+  if (xQueueReceive(eventQueue, &event, pdMS_TO_TICKS(waitMs)) == pdTRUE) {
+    do {
+      broadcast(event);
+    } while (xQueueReceive(eventQueue, &event, 0) == pdTRUE);
+  }
+
+  checkWiFiAndHeap();
+  ws.cleanupClients();
+  eventStats.clients = ws.count();
+}
@@ -0,0 +1,39 @@
+#include "includes/font.h"
+#include <string.h>
+
+// Layout checks, evaluated by the compiler on every build. Expected widths
+// match `python3 tools/gen_font_atlas.py --measure TEXT`.
+static_assert(fontTextWidth("", 1) == 0, "empty text");
+static_assert(fontTextWidth("Hello", 1) == 21, "proportional ASCII");
+static_assert(fontTextWidth("Hello", 0) == 17, "no spacing");
+static_assert(fontTextWidth("Tea", 1) == 14, "T kerns against lowercase");
+static_assert(fontTextWidth("Café", 1) == 19, "UTF-8 Latin-1 letter");
+static_assert(fontTextWidth("Caf\xE9", 1) == 19, "raw Latin-1 byte");
+static_assert(fontTextWidth("→ 5°C", 1) == 24, "arrows and symbols");
+static_assert(fontTextWidth("▌▌", 1) == 16, "block elements join");
+static_assert(fontTextWidth("\xF0\x9F\x98\x80", 1) == 5, "uncovered code point shows one box");
+
+size_t fontRender(const char* text, uint8_t spacing, uint8_t* out, size_t maxCols) {
+  size_t col = 0;
+  int prev = -1;
+
+  while (*text && col < maxCols) {
+    uint16_t index = fontGlyphIndex(fontNextCodepoint(text));
+    const FontGlyph& glyph = FONT_GLYPHS[index];
+
+    if (prev >= 0) {
+      size_t gap = fontGap(prev, index, spacing);
+      if (gap > maxCols - col) gap = maxCols - col;
+      memset(out + col, 0, gap);
+      col += gap;
+    }
+
+    size_t width = glyph.width;
+    if (width > maxCols - col) width = maxCols - col;
+    memcpy(out + col, &FONT_COLUMNS[glyph.offset], width);
+    col += width;
+    prev = index;
+  }
+
+  return col;
+}
@@ -0,0 +1,123 @@
+#include "includes/frame_clock.h"
+#include <esp_timer.h>
+#include <atomic>
+#include "freertos/task.h"
+
+// Initialize global variables
+FrameClockStats frameClockStats;
+
+static esp_timer_handle_t frameTimer = NULL;
+static TaskHandle_t frameTask = NULL;
+static std::atomic<uint32_t> pendingTicks(0);
+static uint32_t framePeriodUs = 0;
+static int64_t frameStartUs = 0;
+static int64_t fpsWindowStartUs = 0;
+static unsigned long fpsWindowFrames = 0;
+
+// Runs in the esp_timer task: just wake the render task
+static void onFrameTick(void* arg) {
+  pendingTicks.fetch_add(1);
+  if (frameTask != NULL) {
+    xTaskNotify(frameTask, FRAME_CLOCK_NOTIFY_BIT, eSetBits);
+  }
+}
+
+static uint16_t clampFrameRate(uint16_t fps) {
+  return constrain(fps, MIN_FRAME_RATE, MAX_FRAME_RATE);
+}
+
+void initFrameClock(uint16_t fps) {
+  frameTask = xTaskGetCurrentTaskHandle();
+
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = onFrameTick;
+  timerArgs.arg = NULL;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "frame_clock";
+
+  esp_err_t err = esp_timer_create(&timerArgs, &frameTimer);
+  if (err != ESP_OK) {
+    Serial.printf("⚠️ Failed to create frame timer: %s\n", esp_err_to_name(err));
+    frameTimer = NULL;
+    setFrameRate(fps);
+    return;
+  }
+
+  resetFrameClockStats();
+  setFrameRate(fps);
+  Serial.printf("✅ Frame clock started at %d FPS\n", frameClockStats.targetFps);
+}
+
+void setFrameRate(uint16_t fps) {
+  fps = clampFrameRate(fps);
+  frameClockStats.targetFps = fps;
+  framePeriodUs = 1000000UL / fps;
+
+  if (frameTimer == NULL) return;
+
+  esp_timer_stop(frameTimer);  // Fails harmlessly if the timer is not running yet
+  esp_timer_start_periodic(frameTimer, framePeriodUs);
+}
+
+TaskHandle_t getRenderTaskHandle() {
+  return frameTask;
+}
+
+uint32_t waitForRenderEvent() {
+  uint32_t bits = 0;
+
+  if (frameTimer == NULL) {
+    // No timer available, fall back to a plain delay
+    vTaskDelay(pdMS_TO_TICKS(1000 / frameClockStats.targetFps));
+    bits = FRAME_CLOCK_NOTIFY_BIT;
+  } else {
+    xTaskNotifyWait(0, RENDER_NOTIFY_ALL_BITS, &bits, portMAX_DELAY);
+  }
+
+  if (!(bits & FRAME_CLOCK_NOTIFY_BIT)) return bits;
+
+  int64_t now = esp_timer_get_time();
+
+  // More than one tick since the last frame means we overran a deadline
+  uint32_t ticks = pendingTicks.exchange(0);
+  if (ticks > 1) {
+    frameClockStats.missedDeadlines += ticks - 1;
+  }
+
+  // Jitter: how far this frame start is from one period after the previous one
+  if (frameStartUs != 0) {
+    int64_t period = now - frameStartUs;
+    int64_t expected = (int64_t)framePeriodUs * (ticks > 0 ? ticks : 1);
+    uint32_t jitter = (uint32_t)(period > expected ? period - expected : expected - period);
+
+    frameClockStats.jitterUs = jitter;
+    frameClockStats.avgJitterUs = (frameClockStats.avgJitterUs * 7 + jitter) / 8;
+    if (jitter > frameClockStats.maxJitterUs) frameClockStats.maxJitterUs = jitter;
+  }
+  frameStartUs = now;
+
+  // Achieved frame rate over one-second windows
+  fpsWindowFrames++;
+  if (now - fpsWindowStartUs >= 1000000) {
+    frameClockStats.achievedFps = fpsWindowFrames * 1000000.0f / (now - fpsWindowStartUs);
+    fpsWindowStartUs = now;
+    fpsWindowFrames = 0;
+  }
+
+  frameClockStats.frames++;
+  return bits;
+}
+
+void frameDone() {
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - frameStartUs);
+  frameClockStats.frameTimeUs = elapsed;
+  if (elapsed > frameClockStats.maxFrameTimeUs) frameClockStats.maxFrameTimeUs = elapsed;
+}
+
+void resetFrameClockStats() {
+  uint16_t fps = frameClockStats.targetFps;
+  memset(&frameClockStats, 0, sizeof(frameClockStats));
+  frameClockStats.targetFps = fps;
+  fpsWindowStartUs = esp_timer_get_time();
+  fpsWindowFrames = 0;
+}
@@ -0,0 +1,273 @@
+#include "includes/framebuffer.h"
+#include "includes/display.h"
+#include "includes/display_backend.h"
+#include "includes/metrics.h"
+#include <esp_timer.h>
+
+// Initialize global variables
+PackedFrame frameBuffer;
+FrameStats frameStats;
+
+// What the chain is currently showing, and which (row, device) bytes
+// have been written since the last flush
+static PackedFrame sentFrame;
+static uint32_t dirtyDevices[FRAME_ROWS];   // Bit d set = device d touched on this row
+static uint8_t dirtyRows = 0;               // Bit r set = row r has dirty devices
+static bool fullFlushNeeded = true;         // Chain contents unknown, resend everything
+static bool driverOwnsDisplay = true;       // Parola drew last (fbInvalidate until the next fbFlush)
+static PackedFrame* target = &frameBuffer;  // Frame the drawing calls write to
+
+static inline void markDirty(uint8_t row, uint8_t device) {
+  if (target != &frameBuffer) return;
+  dirtyDevices[row] |= (1UL << device);
+  dirtyRows |= (1 << row);
+}
+
+void fbClear() {
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint8_t dev = 0; dev < MAX_DEVICES; dev++) {
+      if (target->bytes[row][dev] != 0) {
+        target->bytes[row][dev] = 0;
+        markDirty(row, dev);
+      }
+    }
+  }
+}
+
+void fbClearColumns(uint16_t firstCol, uint16_t cols) {
+  PackedFrame mask;
+  fbColumnMask(mask, firstCol, cols);
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint8_t dev = 0; dev < MAX_DEVICES; dev++) {
+      uint8_t value = target->bytes[row][dev] & ~mask.bytes[row][dev];
+      if (value != target->bytes[row][dev]) {
+        target->bytes[row][dev] = value;
+        markDirty(row, dev);
+      }
+    }
+  }
+}
+
+void fbSetPoint(uint8_t row, uint16_t col, bool on) {
+  if (row >= FRAME_ROWS || col >= FRAME_COLS) return;
+
+  uint8_t dev = col / 8;
+  uint8_t mask = 1 << (col % 8);
+  uint8_t old = target->bytes[row][dev];
+  uint8_t value = on ? (old | mask) : (old & ~mask);
+
+  if (value != old) {
+    target->bytes[row][dev] = value;
+    markDirty(row, dev);
+  }
+}
+
+bool fbGetPoint(uint8_t row, uint16_t col) {
+  if (row >= FRAME_ROWS || col >= FRAME_COLS) return false;
+  return target->bytes[row][col / 8] & (1 << (col % 8));
+}
+
+void fbSetRowByte(uint8_t row, uint8_t device, uint8_t value) {
+  if (row >= FRAME_ROWS || device >= MAX_DEVICES) return;
+
+  if (target->bytes[row][device] != value) {
+    target->bytes[row][device] = value;
+    markDirty(row, device);
+  }
+}
+
+uint8_t fbGetRowByte(uint8_t row, uint8_t device) {
+  if (row >= FRAME_ROWS || device >= MAX_DEVICES) return 0;
+  return target->bytes[row][device];
+}
+
+void fbDrawColumns(const uint8_t* columns, int32_t width, int32_t left,
+                   uint16_t firstCol, uint16_t cols, bool invert) {
+  if (firstCol >= FRAME_COLS || cols == 0) return;
+  if (firstCol + cols > FRAME_COLS) cols = FRAME_COLS - firstCol;
+
+  uint16_t endCol = firstCol + cols;
+
+  for (uint8_t dev = firstCol / 8; dev <= (endCol - 1) / 8; dev++) {
+    uint8_t rows[FRAME_ROWS] = {0};
+    uint8_t keep = 0;   // Bits of this device outside the zone
+
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      uint16_t col = dev * 8 + bit;
+      if (col < firstCol || col >= endCol) {
+        keep |= (1 << bit);
+        continue;
+      }
+
+      // Column 0 of the chain is the rightmost on screen
+      int32_t x = endCol - 1 - col;
+      int32_t i = x - left;
+      uint8_t column = (i >= 0 && i < width) ? columns[i] : 0;
+      if (invert) column = ~column;
+      if (column == 0) continue;
+
+      for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+        if (column & (1 << row)) rows[row] |= (1 << bit);
+      }
+    }
+
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      uint8_t value = keep ? ((fbGetRowByte(row, dev) & keep) | rows[row]) : rows[row];
+      fbSetRowByte(row, dev, value);
+    }
+  }
+}
+
+void fbColumnMask(PackedFrame& mask, uint16_t firstCol, uint16_t cols) {
+  memset(&mask, 0, sizeof(mask));
+
+  uint16_t end = firstCol + cols;
+  if (end > FRAME_COLS) end = FRAME_COLS;
+
+  for (uint16_t col = firstCol; col < end; col++) {
+    mask.bytes[0][col / 8] |= (1 << (col % 8));
+  }
+  for (uint8_t row = 1; row < FRAME_ROWS; row++) {
+    memcpy(mask.bytes[row], mask.bytes[0], FRAME_ROW_BYTES);
+  }
+}
+
+void fbSetTarget(PackedFrame* frame) {
+  target = (frame != NULL) ? frame : &frameBuffer;
+}
+
+void fbSetFrame(const PackedFrame& frame) {
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint8_t word = 0; word < FRAME_ROW_WORDS; word++) {
+      if (frameBuffer.words[row][word] == frame.words[row][word]) continue;
+      frameBuffer.words[row][word] = frame.words[row][word];
+
+      for (uint8_t dev = word * 4; dev < word * 4 + 4 && dev < MAX_DEVICES; dev++) {
+        dirtyDevices[row] |= (1UL << dev);
+      }
+      dirtyRows |= (1 << row);
+    }
+  }
+}
+
+void fbInvalidate() {
+  fullFlushNeeded = true;
+  driverOwnsDisplay = true;
+}
+
+static size_t flushChangedRows();
+
+size_t fbFlush() {
+  driverOwnsDisplay = false;
+  return flushChangedRows();
+}
+
+void fbSnapshot(PackedFrame& out) {
+  if (!driverOwnsDisplay) {
+    memcpy(&out, &frameBuffer, sizeof(out));
+    return;
+  }
+
+  memset(&out, 0, sizeof(out));
+  MD_MAX72XX* mx = disp.getGraphicObject();
+  for (uint16_t col = 0; col < FRAME_COLS; col++) {
+    uint8_t column = mx->getColumn(col);
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      if (column & (1 << row)) out.bytes[row][col / 8] |= (1 << (col % 8));
+    }
+  }
+}
+
+void fbSyncFromDriver() {
+  DisplayBackend* backend = getDisplayBackend();
+  if (!backend->mirrorsDriver()) return;
+
+  // Brightness changes go through Parola even in effect modes
+  backend->setIntensity(disp.getIntensity());
+  if (!driverOwnsDisplay) return;
+
+  // Copy Parola's buffer a column at a time (bit r = row r)
+  MD_MAX72XX* mx = disp.getGraphicObject();
+  for (uint16_t col = 0; col < FRAME_COLS; col++) {
+    uint8_t column = mx->getColumn(col);
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      fbSetPoint(row, col, column & (1 << row));
+    }
+  }
+
+  flushChangedRows();
+}
+
+static size_t flushChangedRows() {
+  frameStats.flushes++;
+
+  if (fullFlushNeeded) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      dirtyDevices[row] = (MAX_DEVICES >= 32) ? 0xFFFFFFFFUL : ((1UL << MAX_DEVICES) - 1);
+    }
+    dirtyRows = 0xFF;
+  }
+
+  if (dirtyRows == 0) {
+    frameStats.lastFrameBytes = 0;
+    return 0;
+  }
+
+  size_t bytesSent = 0;
+  uint8_t changedRows = 0;
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    if (!(dirtyRows & (1 << row))) continue;
+
+    bool rowChanged = false;
+    uint32_t devices = dirtyDevices[row];
+
+    for (uint8_t dev = 0; devices != 0; dev++, devices >>= 1) {
+      if (!(devices & 1)) continue;
+
+      uint8_t value = frameBuffer.bytes[row][dev];
+      // A byte that was cleared and redrawn to the same value costs nothing
+      if (!fullFlushNeeded && value == sentFrame.bytes[row][dev]) continue;
+
+      sentFrame.bytes[row][dev] = value;
+      rowChanged = true;
+    }
+
+    // The chain is a shift register: every latch clocks a full packet
+    // (devices without a change get a no-op)
+    if (rowChanged) {
+      changedRows |= (1 << row);
+      bytesSent += MAX7219_PACKET_BYTES;
+      frameStats.rowsSent++;
+    }
+
+    dirtyDevices[row] = 0;
+  }
+
+  if (changedRows != 0) {
+    // CPU time only: a DMA backend returns while the rows are still going out
+    int64_t start = esp_timer_get_time();
+    getDisplayBackend()->sendRows(frameBuffer, changedRows);
+    uint32_t sendUs = (uint32_t)(esp_timer_get_time() - start);
+
+    frameStats.lastSendUs = sendUs;
+    if (sendUs > frameStats.maxSendUs) frameStats.maxSendUs = sendUs;
+    metricsObserve(metrics.spiFlush, sendUs);
+  }
+
+  dirtyRows = 0;
+  fullFlushNeeded = false;
+
+  if (bytesSent > 0) frameStats.framesSent++;
+  frameStats.bytesSent += bytesSent;
+  metricsAdd(metrics.spiBytes, metrics.spiBytesWraps, bytesSent);
+  frameStats.lastFrameBytes = bytesSent;
+  if (bytesSent > frameStats.maxFrameBytes) frameStats.maxFrameBytes = bytesSent;
+
+  return bytesSent;
+}
+
+void fbResetStats() {
+  memset(&frameStats, 0, sizeof(frameStats));
+}
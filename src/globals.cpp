@@ -3,7 +3,6 @@
 
 // Global preferences
 Preferences preferences;
-bool updateInProgress = false;
 bool apiSetupDone = false;
 
 
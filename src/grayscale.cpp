@@ -0,0 +1,229 @@
+#include "includes/grayscale.h"
+#include "includes/defaults.h"
+#include "includes/frame_clock.h"
+#include <esp_timer.h>
+#include "freertos/task.h"
+
+// Shortest plane timer we schedule when the render task has fallen behind
+#define GRAY_MIN_TIMER_US 50
+
+// Initialize global variables
+GrayFrame grayBuffer;
+
+static PackedFrame grayPlanes[GRAY_PLANES];  // Bit plane n of every pixel, packed like the frame buffer
+static GrayFrame* grayTarget = &grayBuffer;  // Buffer the drawing calls write to
+static bool grayDirty = false;               // Intensity buffer changed since the planes were sliced
+static bool grayRunning = false;             // Plane timer is cycling planes onto the chain
+static uint8_t nextPlane = 0;
+static int64_t planeDeadlineUs = 0;          // Ideal start time of the next plane
+static esp_timer_handle_t planeTimer = NULL;
+
+// Runs in the esp_timer task: hand the plane switch to the render task
+static void onPlaneTick(void* arg) {
+  TaskHandle_t task = getRenderTaskHandle();
+  if (task != NULL) {
+    xTaskNotify(task, GRAY_PLANE_NOTIFY_BIT, eSetBits);
+  }
+}
+
+void initGrayscale() {
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = onPlaneTick;
+  timerArgs.arg = NULL;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "gray_planes";
+
+  esp_err_t err = esp_timer_create(&timerArgs, &planeTimer);
+  if (err != ESP_OK) {
+    Serial.printf("⚠️ Failed to create grayscale plane timer: %s\n", esp_err_to_name(err));
+    planeTimer = NULL;
+  }
+
+  grayClear();
+  Serial.println("✅ Grayscale renderer initialized");
+}
+
+void graySetTarget(GrayFrame* target) {
+  grayTarget = (target != NULL) ? target : &grayBuffer;
+}
+
+void grayClear() {
+  memset(*grayTarget, 0, sizeof(GrayFrame));
+  if (grayTarget == &grayBuffer) grayDirty = true;
+}
+
+void grayClearColumns(uint16_t firstCol, uint16_t cols) {
+  if (firstCol == 0 && cols >= FRAME_COLS) {
+    grayClear();
+    return;
+  }
+
+  uint16_t end = firstCol + cols;
+  if (end > FRAME_COLS) end = FRAME_COLS;
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = firstCol; col < end; col++) {
+      graySetPixel(row, col, 0);
+    }
+  }
+}
+
+void graySetPixel(uint8_t row, uint16_t col, uint8_t level) {
+  if (row >= FRAME_ROWS || col >= FRAME_COLS) return;
+  if (level > GRAY_MAX_LEVEL) level = GRAY_MAX_LEVEL;
+
+  uint8_t& pair = (*grayTarget)[row][col / 2];
+  uint8_t value = (col & 1) ? ((pair & 0x0F) | (level << 4)) : ((pair & 0xF0) | level);
+
+  if (value != pair) {
+    pair = value;
+    if (grayTarget == &grayBuffer) grayDirty = true;
+  }
+}
+
+uint8_t grayGetPixel(uint8_t row, uint16_t col) {
+  if (row >= FRAME_ROWS || col >= FRAME_COLS) return 0;
+  uint8_t pair = (*grayTarget)[row][col / 2];
+  return (col & 1) ? (pair >> 4) : (pair & 0x0F);
+}
+
+void graySetColumns(const uint8_t levels[FRAME_ROWS][FRAME_COLS], uint16_t firstCol, uint16_t cols) {
+  if (firstCol >= FRAME_COLS) return;
+  if (cols > FRAME_COLS - firstCol) cols = FRAME_COLS - firstCol;
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    const uint8_t* src = levels[row];
+    uint8_t* pairs = (*grayTarget)[row];
+    uint16_t x = 0;
+    uint16_t col = firstCol;
+
+    // An odd first column shares its byte with the zone to the left
+    if ((col & 1) && x < cols) {
+      pairs[col / 2] = (pairs[col / 2] & 0x0F) | ((src[x++] & 0x0F) << 4);
+      col++;
+    }
+
+    // Eight levels into four pairs at a time: each odd byte shifted down
+    // next to its even one, then the pair bytes gathered (little-endian,
+    // as the ESP32 is)
+    for (; x + 8 <= cols; x += 8, col += 8) {
+      uint64_t bytes;
+      memcpy(&bytes, src + x, sizeof(bytes));
+      bytes &= 0x0F0F0F0F0F0F0F0FULL;
+      bytes = (bytes | (bytes >> 4)) & 0x00FF00FF00FF00FFULL;
+      bytes = (bytes | (bytes >> 8)) & 0x0000FFFF0000FFFFULL;
+      uint32_t packed = (uint32_t)(bytes | (bytes >> 16));
+      memcpy(pairs + col / 2, &packed, sizeof(packed));
+    }
+    for (; x + 1 < cols; x += 2, col += 2) {
+      pairs[col / 2] = (src[x] & 0x0F) | ((src[x + 1] & 0x0F) << 4);
+    }
+
+    // And an odd last one with the zone to the right
+    if (x < cols) pairs[col / 2] = (pairs[col / 2] & 0xF0) | (src[x] & 0x0F);
+  }
+  if (grayTarget == &grayBuffer) grayDirty = true;
+}
+
+// Split a 4bpp buffer into one packed 1bpp frame per bit
+void graySlice(const GrayFrame& src, PackedFrame planes[GRAY_PLANES]) {
+  memset(planes, 0, sizeof(PackedFrame) * GRAY_PLANES);
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint8_t dev = 0; dev < MAX_DEVICES; dev++) {
+      // One device byte covers four intensity bytes
+      const uint8_t* pairs = &src[row][dev * 4];
+
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        uint8_t level = (bit & 1) ? (pairs[bit / 2] >> 4) : (pairs[bit / 2] & 0x0F);
+        if (level == 0) continue;
+
+        for (uint8_t plane = 0; plane < GRAY_PLANES; plane++) {
+          if (level & (1 << plane)) {
+            planes[plane].bytes[row][dev] |= (1 << bit);
+          }
+        }
+      }
+    }
+  }
+}
+
+static void showPlane(uint8_t plane) {
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint8_t dev = 0; dev < MAX_DEVICES; dev++) {
+      fbSetRowByte(row, dev, grayPlanes[plane].bytes[row][dev]);
+    }
+  }
+  // Planes that match what is already latched cost no SPI traffic
+  fbFlush();
+}
+
+// Show the sliced planes: start the plane timer, or threshold without it
+static void startPlanes() {
+  if (planeTimer == NULL) {
+    // No plane timer: fall back to thresholding at half intensity
+    showPlane(GRAY_PLANES - 1);
+    return;
+  }
+
+  if (!grayRunning) {
+    grayRunning = true;
+    nextPlane = 0;
+    planeDeadlineUs = esp_timer_get_time();
+    grayEmitNextPlane();
+  }
+}
+
+void grayCommit() {
+  if (grayDirty) {
+    graySlice(grayBuffer, grayPlanes);
+    grayDirty = false;
+  }
+  startPlanes();
+}
+
+void grayCommitPlanes(const PackedFrame planes[GRAY_PLANES]) {
+  memcpy(grayPlanes, planes, sizeof(grayPlanes));
+  // grayPlanes no longer match grayBuffer
+  grayDirty = true;
+  startPlanes();
+}
+
+void grayStop() {
+  if (!grayRunning) return;
+
+  grayRunning = false;
+  if (planeTimer != NULL) {
+    esp_timer_stop(planeTimer);
+  }
+}
+
+bool grayIsRunning() {
+  return grayRunning;
+}
+
+const PackedFrame& grayPlane(uint8_t plane) {
+  return grayPlanes[plane < GRAY_PLANES ? plane : GRAY_PLANES - 1];
+}
+
+void grayEmitNextPlane() {
+  // A tick can still be pending after grayStop()
+  if (!grayRunning) return;
+
+  uint8_t plane = nextPlane;
+  showPlane(plane);
+  nextPlane = (plane + 1) % GRAY_PLANES;
+
+  // Schedule against the ideal timeline so flush time does not skew the weights
+  planeDeadlineUs += (int64_t)GRAYSCALE_BCM_UNIT_US << plane;
+  int64_t now = esp_timer_get_time();
+  int64_t delay = planeDeadlineUs - now;
+
+  if (delay < GRAY_MIN_TIMER_US) {
+    // Fell behind (long frame); resync rather than rushing through planes
+    planeDeadlineUs = now + GRAY_MIN_TIMER_US;
+    delay = GRAY_MIN_TIMER_US;
+  }
+
+  esp_timer_start_once(planeTimer, delay);
+}
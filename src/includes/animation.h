@@ -0,0 +1,87 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "config.h"
+#include "framebuffer.h"
+
+// Bitmap and animation items play a frame file from SPIFFS. Frames are
+// read and decoded one at a time as they come due, so only the current
+// frame is ever held in RAM, however long the animation is.
+//
+// File layout (little-endian):
+//   0   "LEDA"
+//   4   u8   version (ANIMATION_VERSION)
+//   5   u8   reserved
+//   6   u16  width in columns (1..FRAME_COLS)
+//   8   u16  frame count
+//   10  u16  frame delay in ms
+//   12  frames, each: u8 type, u16 payload length, payload
+//
+// A frame is one byte per column (bit r = row r, first byte leftmost).
+// Payloads are stored raw, PackBits RLE, or PackBits RLE of the XOR with
+// the previous frame. tools/make_animation.py builds these files.
+
+#define ANIMATION_MAGIC "LEDA"
+#define ANIMATION_VERSION 1
+#define ANIMATION_HEADER_BYTES 12
+#define ANIMATION_MAX_PAYLOAD (FRAME_COLS * 2)
+#define ANIMATION_DIR "/anim/"
+#define ANIMATION_EXT ".anim"
+#define ANIMATION_MAX_NAME 20          // SPIFFS paths are limited to 31 characters
+
+enum AnimationFrameType {
+  ANIM_FRAME_RAW,     // width bytes as-is
+  ANIM_FRAME_RLE,     // PackBits
+  ANIM_FRAME_DELTA    // PackBits of frame XOR previous frame
+};
+
+typedef struct {
+  uint16_t width;
+  uint16_t frameCount;
+  uint16_t frameDelay;
+} AnimationHeader;
+
+// Playback state for one zone
+typedef struct {
+  File file;
+  AnimationHeader header;
+  uint8_t frame[FRAME_COLS];     // Current frame
+  uint16_t frameIndex;           // Frame in frame[]
+  unsigned long frameTime;       // When the current frame was shown
+  bool open;
+} AnimationPlayer;
+
+typedef struct {
+  unsigned long framesDecoded;
+  unsigned long bytesRead;
+  unsigned long decodeErrors;
+  uint32_t lastDecodeUs;
+  uint32_t maxDecodeUs;
+} AnimationStats;
+
+extern AnimationStats animationStats;
+
+// Names are 1..ANIMATION_MAX_NAME of [A-Za-z0-9_-]
+bool animationNameValid(const String& name);
+String animationPath(const String& name);
+
+// Read and check a file's header. Returns false with a reason on error.
+bool animationReadHeader(File& file, AnimationHeader& header, String& error);
+
+// Check the header and that every frame record fits the file, without
+// decoding anything. Used on upload so a bad file never reaches playback.
+bool animationValidate(File& file, AnimationHeader& header, String& error);
+
+// Open an item's file and decode its first frame
+bool animationOpen(AnimationPlayer& player, const String& name);
+void animationClose(AnimationPlayer& player);
+
+// Step to the frame due now (animations only; bitmaps keep frame 0)
+void animationUpdate(AnimationPlayer& player, const DisplayItem& item);
+
+// Draw the current frame into frame columns [firstCol, firstCol + cols),
+// placed by the item's alignment
+void animationDraw(const AnimationPlayer& player, const DisplayItem& item,
+                   uint16_t firstCol = 0, uint16_t cols = FRAME_COLS);
+
+#endif // ANIMATION_H
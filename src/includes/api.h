@@ -6,4 +6,11 @@
 // Function declarations
 void setupApiEndpoints();
 
+// Main loop: restart once /reboot or /manual_factory_reset has replied
+// and pending config changes are written
+void pumpRestart();
+
+// How long the main loop may wait before pumpRestart() is due again
+uint32_t restartPollMs();
+
 #endif // API_H
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "grayscale.h"
+#include "text_raster.h"
+
+// Layered items ("layers" mode): each layer renders into its own packed
+// frame (or intensity buffer for grayscale effects), then the stack is
+// combined bottom-up with word-wide OR/XOR/AND-NOT on the packed rows.
+// With any grayscale layer the combine runs once per bit plane, binary
+// layers counting as full intensity.
+
+typedef struct {
+  uint8_t layers;               // Layers in the current item
+  unsigned long composites;     // Frames composited since the item started
+  uint32_t lastCompositeUs;     // Time to combine the layers (not to draw them)
+  uint32_t maxCompositeUs;
+  uint32_t avgCompositeUs;
+  uint32_t lastFrameUs;         // Drawing every layer plus combining
+  uint32_t maxFrameUs;
+} CompositorStats;
+
+// Per-layer render buffers (one set per zone). Effects that only redraw
+// on their own interval keep their last frame here.
+typedef struct {
+  PackedFrame frames[MAX_ITEM_LAYERS];   // Binary layers
+  GrayFrame gray[MAX_ITEM_LAYERS];       // Grayscale layers
+} LayerBuffers;
+
+extern CompositorStats compositorStats;
+
+// Parse a "layers" JSON array into the item's layers, making it a layered
+// item with default layer parameters if it was not one. Unknown modes and
+// ops are skipped with a warning. Returns the number of layers kept.
+size_t parseLayers(DisplayItem& item, JsonArray layers);
+
+// Add the item's layers to its JSON object
+void writeLayers(JsonObject itemObj, const DisplayItem& item);
+
+// Clear all layer buffers; call when a layered item becomes current
+void resetLayers(LayerBuffers& buffers, const DisplayItem& item);
+
+// Draw and combine one frame of a layered item with the selected effect
+// instance, text layers drawn from raster. Returns true if the result is
+// grayscale (all of planes) or false if it is binary (planes[0] only).
+bool composeLayers(const DisplayItem& item, LayerBuffers& buffers, const TextRaster& raster,
+                   PackedFrame planes[GRAY_PLANES]);
+
+// Compose one frame of a layered item and commit it to the chain
+void renderLayers(const DisplayItem& item, LayerBuffers& buffers, const TextRaster& raster);
+
+#endif // COMPOSITOR_H
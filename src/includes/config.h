@@ -11,6 +11,7 @@
 #include "SPI.h"
 #include <ESPmDNS.h>
 #include <vector>
+#include "display_item.h"
 
 // Forward declarations for classes we'll use
 class WiFiManager;
@@ -23,64 +24,39 @@ class AsyncWebServerRequest;
 #define CS_PIN 5
 
 // Config file locations
-#define CONFIG_FILE "/config.json"
+#define CONFIG_FILE "/config.json"               // JSON config, imported once if there is no binary one
+#define CONFIG_BINARY_FILE "/config.bin"          // See config_binary.h
+#define CONFIG_BINARY_TMP_FILE "/config.bin.tmp"  // New file while a save swaps it in
+#define CONFIG_LOG_FILE "/config.log"             // Item changes since CONFIG_BINARY_FILE, see config_log.h
 #define SECURITY_FILE "/security.json"
 
 // External declarations for shared objects
 extern MD_Parola disp;
 extern AsyncWebServer server;
 extern Preferences preferences;
-extern bool updateInProgress;
 
 
-// Define a structure for a single display item
-struct DisplayItem {
-  String mode;              // "text" or "twinkle"
-  String text;              // Text content (for text mode)
-  int alignment;            // Text alignment
-  bool invert;              // Whether display is inverted
-  int brightness;           // Display brightness (0-15)
-  int scrollSpeed;          // Text scroll speed
-  int pauseTime;            // Pause time at end of scroll
-  unsigned long duration;   // How long to show this item (ms, 0 = forever)
-  int playCount;            // Number of times item has been played
-  int maxPlays;             // Maximum times to play (0 = unlimited)
-  bool deleteAfterPlay;     // Whether to delete after playing
-
-
-  // Twinkle effect parameters
-  int twinkleDensity;       // Twinkle density (for twinkle mode)
-  int twinkleMinSpeed;      // Min twinkle speed (for twinkle mode)
-  int twinkleMaxSpeed;      // Max twinkle speed (for twinkle mode)
-
-  // Knight Rider effect parameters
-  int knightRiderSpeed;     // Update interval in ms
-  int knightRiderTailLength; // Length of the tail
-  
-  // Pong effect parameters
-  int pongSpeed;            // Update interval in ms
-  float pongBallSpeedX;     // Horizontal ball speed
-  float pongBallSpeedY;     // Vertical ball speed
-  
-  // Sine wave effect parameters
-  int sineWaveSpeed;        // Update interval in ms
-  int sineWaveAmplitude;    // Wave amplitude
-  int sineWavePhases;       // Number of overlapping waves
-};
-
-
-
-
-
-// Main configuration structure with array of display items
-struct DisplayConfig {
-  bool displayOn;           // Global display on/off
+// A column range of the chain with its own playlist
+struct DisplayZone {
+  String name;              // Label for the API
+  uint16_t startCol;        // First column, counted from the left edge
+  uint16_t width;           // Columns in the zone
   bool loopItems;           // Whether to loop through items
   int currentItemIndex;     // Current item being displayed
   unsigned long itemStartTime; // When current item started
   std::vector<DisplayItem> items; // Array of display items
 };
 
+// Main configuration structure. The config itself is the primary zone
+// (full width unless other zones are defined); extra zones share the chain.
+struct DisplayConfig : DisplayZone {
+  bool displayOn;           // Global display on/off
+  uint16_t frameRate;       // Render frames per second
+  uint16_t realtimeTimeout; // ms without a UDP frame before the playlist resumes
+  uint32_t nextItemId = 1;  // Next item ID to hand out; IDs are never reused
+  std::vector<DisplayZone> zones; // Extra zones beside the primary one
+};
+
 // Structure for temporary IP display mode
 struct TempIPConfig {
   bool active;              // Whether this temporary config is active
@@ -104,7 +80,13 @@ extern bool textNeedsUpdate;
 
 // Function declarations
 void loadConfig();
-void saveConfig();
+bool saveConfig();                       // Synchronous; at runtime use requestConfigSave()
+bool writeConfigFile(const std::vector<uint8_t>& data);
+void configFromJson(JsonDocument& doc, DisplayConfig& cfg);   // Import/export format
+void configToJson(const DisplayConfig& cfg, JsonDocument& doc);
+void addDefaultItem(DisplayConfig& cfg);   // Only if it has no items
+void assignItemId(DisplayItem& item);    // Render task (or before it starts); no-op if it has one
+void ensureItemIds(DisplayConfig& cfg);
 void resetConfig();
 void loadSecurityConfig();
 void saveSecurityConfig();
@@ -0,0 +1,70 @@
+#ifndef CONFIG_BINARY_H
+#define CONFIG_BINARY_H
+
+#include "config.h"
+
+// On-flash config format (CONFIG_BINARY_FILE).
+//
+// Loading the JSON config built a JsonDocument of the whole file before
+// copying it into the items, which set the peak heap at boot and took
+// most of the load time. The binary form is read with one sequential
+// read and decoded straight into the items. JSON stays the import/export
+// format (/download_config, /upload_config) and an old /config.json is
+// imported once on the first boot.
+//
+// Little-endian throughout:
+//   header   "LBCF", u8 version, u8 flags, u16 generation,
+//            u32 payload bytes, u32 CRC-32 of the payload
+//   payload  u8 displayOn, u8 loopItems, u16 frameRate, u16 realtimeTimeout,
+//            u32 nextItemId, u16 startCol, u16 width, items, u8 extra
+//            zones, then per zone:
+//            str8 name, u16 startCol, u16 width, u8 loopItems, items
+//   items    u16 count, then per item: u8 type, u16 record bytes, record
+//   record   u32 id, u8 flags (invert, deleteAfterPlay), u8 brightness,
+//            u32 duration, u16 playCount, u16 maxPlays, then only the
+//            parameters of the item's mode; "layers" records list
+//            u8 count + (u8 type, u8 op) per layer, then the parameters
+//            of each distinct layer mode
+// The type is the item's EffectMode (config.h); an unknown (0xFF) record
+// holds only a str8 mode name, written empty. Strings are a length (u8 or
+// u16) and the bytes, no terminator. The record length lets a reader skip
+// item types it does not know. The generation pairs the file with the
+// change log written after it (see config_log.h). Version 1 had no item
+// IDs or nextItemId.
+
+#define CONFIG_BINARY_MAGIC "LBCF"
+#define CONFIG_BINARY_VERSION 2
+#define CONFIG_BINARY_HEADER_BYTES 16
+
+typedef struct {
+  const char* format;           // "binary", "json" or "default"
+  size_t bytes;                 // File size
+  size_t items;                 // Items in every zone
+  uint32_t readUs;              // Reading the file
+  uint32_t decodeUs;            // Parsing it into the config
+  uint32_t heapUsed;            // Free heap taken by the load (buffer, parser, items)
+} ConfigLoadStats;
+
+extern ConfigLoadStats configLoadStats;
+
+// Encode cfg (globals, primary zone, extra zones) into out, header included.
+// Returns the size.
+size_t encodeConfigBinary(const DisplayConfig& cfg, std::vector<uint8_t>& out, uint16_t generation);
+
+// Check the header, version, length and CRC of an encoded config
+bool checkConfigBinary(const uint8_t* data, size_t length);
+
+// Generation of a checked config
+uint16_t configBinaryGeneration(const uint8_t* data);
+
+// Append one item record (type, length, fields) to out
+void encodeItem(std::vector<uint8_t>& out, const DisplayItem& item);
+
+// Decode exactly one item record of the current version
+bool decodeItem(const uint8_t* data, size_t length, DisplayItem& item);
+
+// Decode an encoded config into cfg. Returns false, leaving cfg partly
+// filled, if the data does not check out or a record is malformed.
+bool decodeConfigBinary(const uint8_t* data, size_t length, DisplayConfig& cfg);
+
+#endif // CONFIG_BINARY_H
@@ -0,0 +1,66 @@
+#ifndef CONFIG_EDIT_H
+#define CONFIG_EDIT_H
+
+#include "config.h"
+#include <functional>
+
+// Changes to the config from the web API.
+//
+// The render task owns config.items and the zones: it holds references
+// into them while it draws. A handler therefore never changes them
+// itself. It parses and validates the request on the web server task,
+// then posts an edit: a function that makes the change. The render task
+// runs every edit queued since the last frame as one batch between
+// frames, reloads the current item and asks for one save for the whole
+// batch (see persistence.h), and marks each edit done with its reply.
+// The request itself is only ever touched on the web server task, which
+// picks the reply up the next time it polls the connection, so a reply
+// can take up to about half a second after its edit has run. A client
+// that disconnects in the meantime still has its edit applied; only the
+// reply is dropped. Reads that walk the item
+// list (GET /items) go the same way so they see it between frames.
+
+typedef struct {
+  int status;              // HTTP status of the reply
+  JsonDocument reply;      // Reply body
+  bool changed;            // Config was changed and needs saving
+  bool reload;             // Current item must be reapplied
+} ConfigEditResult;
+
+typedef std::function<void(ConfigEditResult&)> ConfigEditFunction;
+
+typedef struct {
+  unsigned long posted;
+  unsigned long applied;
+  unsigned long batches;        // Frames that applied at least one edit
+  unsigned long busy;           // Refused with 503: every slot pending
+  unsigned long abandoned;      // Client gone before its reply
+  uint32_t largestBatch;
+  uint32_t lastBatchUs;         // Render task time for the last batch, save included
+  uint32_t maxBatchUs;
+} ConfigEditStats;
+
+extern ConfigEditStats configEditStats;
+
+// Create the slot lock; call before the web server starts
+void initConfigEdits();
+
+// Web server task: queue edit for the render task and reply to request
+// with its result once it has run. Replies 503 itself if too many edits
+// are already pending.
+void postConfigEdit(AsyncWebServerRequest* request, ConfigEditFunction edit);
+
+// Render task, from the render command queue: run the edit in slot,
+// adding its changed/reload flags to the batch
+void runConfigEdit(uint8_t slot, bool& changed, bool& reload);
+
+// Main loop: free the slots of edits whose client went away before they ran
+void pumpConfigEdits();
+
+// How long the main loop may wait before pumpConfigEdits() is due again
+uint32_t configEditPollMs();
+
+// Set a JSON error reply
+void configEditError(ConfigEditResult& result, int status, const char* message);
+
+#endif // CONFIG_EDIT_H
@@ -0,0 +1,71 @@
+#ifndef CONFIG_LOG_H
+#define CONFIG_LOG_H
+
+#include "config.h"
+
+// Append-only change log beside CONFIG_BINARY_FILE.
+//
+// Adding or deleting one item used to rewrite the whole config. Item
+// adds, updates and deletes are instead appended to CONFIG_LOG_FILE as
+// small records keyed by item ID, so a write costs the size of the
+// change. Boot loads the config file, then replays the log over it.
+// Everything else (zones, globals, replacing the playlist) still saves the
+// whole config, and so does compaction once the log passes
+// CONFIG_LOG_COMPACT_BYTES: the full save starts a new, empty log.
+//
+// Crash safety: the log header carries the generation of the config file
+// it follows. A full save writes the config with the next generation,
+// then starts the new log, so a reset between the two leaves an old log
+// that boot ignores (its changes are in the new config). Each record has
+// its own CRC; replay stops at a torn record and boot compacts at once.
+//
+//   header   "LBLG", u16 generation, u16 reserved
+//   record   u8 op, u16 payload bytes, payload, u32 CRC-32 of op, length
+//            and payload
+//   add      u8 zone (0 = primary), item record (config_binary.h),
+//            appended to the zone
+//   update   item record, replacing the item with its ID
+//   delete   u32 item ID
+
+#define CONFIG_LOG_MAGIC "LBLG"
+#define CONFIG_LOG_HEADER_BYTES 8
+
+enum ConfigLogOp {
+  LOG_ITEM_ADD = 1,
+  LOG_ITEM_UPDATE = 2,
+  LOG_ITEM_DELETE = 3
+};
+
+typedef struct {
+  uint16_t generation;          // Of the config file the log follows
+  size_t bytes;                 // Current log size
+  unsigned long replayed;       // Records applied at boot
+  bool torn;                    // Boot found a damaged record
+  unsigned long records;        // Records appended since boot
+  unsigned long appends;        // File appends (a batch of records each)
+  unsigned long failures;
+  unsigned long compactions;    // Full saves asked for because the log grew
+  uint32_t lastAppendUs;
+  uint32_t maxAppendUs;
+} ConfigLogStats;
+
+extern ConfigLogStats configLogStats;
+
+// Render task: record a change just made to the config. The record is
+// written by the main loop with the next persistence pump.
+void logItemAdded(uint8_t zone, DisplayItem& item);   // Assigns the ID if needed
+void logItemUpdated(const DisplayItem& item);
+void logItemDeleted(uint32_t id);
+
+// Boot: apply CONFIG_LOG_FILE to cfg if it follows the config of this
+// generation. Returns false if a damaged record cut the replay short.
+bool replayConfigLog(DisplayConfig& cfg, uint16_t generation);
+
+// Main loop (or boot): start an empty log for a config just written
+bool startConfigLog(uint16_t generation);
+
+// Main loop: append records. False if the file write failed or no log
+// matching the config file was started; the caller then saves it all.
+bool appendConfigLog(const uint8_t* data, size_t length);
+
+#endif // CONFIG_LOG_H
@@ -5,6 +5,7 @@
 #define DEFAULT_BRIGHTNESS 5
 #define DEFAULT_SCROLL_SPEED 50  // Lower value = faster scrolling
 #define DEFAULT_PAUSE_TIME 2000  // Pause time in milliseconds at the end of scrolling
+#define DEFAULT_FRAME_RATE 50    // Render frames per second, driven by the frame clock
 
 // Default twinkle parameters
 #define DEFAULT_TWINKLE_DENSITY 15     // Higher = more LEDs active (percentage, 0-100)
@@ -12,6 +13,61 @@
 #define DEFAULT_TWINKLE_MAX_SPEED 300  // Maximum LED cycle speed (ms)
 #define DEFAULT_MAX_INTENSITY 15       // Maximum brightness level (0-15)
 
+// Default parameters of the other effects
+#define DEFAULT_KNIGHTRIDER_SPEED 50   // Update interval (ms)
+#define DEFAULT_KNIGHTRIDER_TAIL 3     // Tail length (columns)
+#define DEFAULT_PONG_SPEED 100         // Update interval (ms)
+#define DEFAULT_PONG_BALL_SPEED_X 0.5f // Columns per update
+#define DEFAULT_PONG_BALL_SPEED_Y 0.25f
+#define DEFAULT_SINEWAVE_SPEED 50      // Update interval (ms)
+#define DEFAULT_SINEWAVE_AMPLITUDE 3   // Rows
+#define DEFAULT_SINEWAVE_PHASES 3      // Overlapping waves
+#define DEFAULT_LIFE_BIRTH (1 << 3)    // B3/S23, Conway's Life
+#define DEFAULT_LIFE_SURVIVE ((1 << 2) | (1 << 3))
+#define DEFAULT_LIFE_SPEED 120         // Update interval (ms per generation)
+#define DEFAULT_LIFE_DENSITY 35        // Percentage of cells alive in a new seed
+
+// Render task (owns the display, kept off the network core)
+#define RENDER_TASK_CORE 1
+#define RENDER_TASK_PRIORITY 3
+#define RENDER_TASK_STACK 8192
+#define RENDER_QUEUE_SIZE 16           // Pending web-layer commands (power of two)
+#define CONFIG_EDIT_SLOTS 8            // API config changes waiting to be applied or answered
+#define CONFIG_EDIT_POLL_MS 5          // Main loop poll while changes are pending
+
+// Write-behind config saving (see persistence.h)
+#define CONFIG_SAVE_QUIET_MS 1000      // Save once the config has not changed for this long
+#define CONFIG_SAVE_MAX_DELAY_MS 5000  // ...or at the latest this long after the first change
+#define CONFIG_FLUSH_TIMEOUT_MS 3000   // How long /flush and reboot wait for the write
+#define API_RESTART_DELAY_MS 1500      // Time for the reply and "REBOOTING" before an API restart
+#define CONFIG_LOG_COMPACT_BYTES 8192  // Rewrite the config and start a new change log past this size
+
+// Display transport
+#define DISPLAY_SPI_DMA_ENABLED false  // Send frames with queued ESP32 SPI DMA instead of MD_MAX72XX
+#define DISPLAY_SPI_CLOCK_HZ 10000000  // MAX7219 tops out at 10MHz
+
+// Text rendering
+#define TEXT_RASTER_MAX_COLS 4096      // Widest text raster (one byte per column)
+#define TEXT_POOL_PAGE_BYTES 1024      // Item text is packed into pages of this size (see text_pool.h)
+
+// Grayscale rendering
+#define GRAYSCALE_BCM_UNIT_US 500      // Display time of the least significant bit plane (us)
+
+// Realtime UDP streaming (see realtime_packet.h)
+#define REALTIME_UDP_ENABLED true
+#define REALTIME_UDP_PORT 4048
+#define REALTIME_TIMEOUT_MS 2500       // Back to the playlist after this long without a packet
+#define REALTIME_MIN_TIMEOUT_MS 100
+#define REALTIME_MAX_TIMEOUT_MS 60000
+
+// WebSocket event channel (/ws)
+#define EVENT_QUEUE_SIZE 32            // Events waiting for the main loop to broadcast
+#define EVENT_BUFFER_SIZE 160          // Longest serialized event
+#define HEAP_WARNING_BYTES 24576       // Send a heapLow event when free heap drops below this
+
+// Web API
+#define MAX_REQUEST_BODY_BYTES 32768   // Largest JSON body accepted; buffered whole before parsing
+
 // Power-cycle reset parameters
 #define RESET_WINDOW_MS 30000          // Window of time for multiple resets (30 seconds)
 #define RESET_COUNT_THRESHOLD 3        // Number of resets required to factory reset
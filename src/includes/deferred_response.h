@@ -0,0 +1,54 @@
+#ifndef DEFERRED_RESPONSE_H
+#define DEFERRED_RESPONSE_H
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+// A reply that is not known yet when the handler returns, for work done
+// on another task (a config edit on the render task, a config write on
+// the main loop).
+//
+// The handler sends one of these at once instead of waiting. It writes
+// nothing until poll() hands it the real reply: the web server calls
+// _ack() on its own task each time it polls the connection (about every
+// 500 ms), so the request is only ever touched on that task and the
+// handler never blocks it. The web server deletes the response once the
+// reply is sent or the client has gone.
+class DeferredResponse : public AsyncWebServerResponse {
+ public:
+  DeferredResponse() : reply(NULL) {}
+  virtual ~DeferredResponse() { delete reply; }
+
+  void _respond(AsyncWebServerRequest* request) override {
+    _state = RESPONSE_HEADERS;
+    check(request);
+  }
+
+  size_t _ack(AsyncWebServerRequest* request, size_t len, uint32_t time) override {
+    if (reply != NULL) return reply->_ack(request, len, time);
+    check(request);
+    return 0;
+  }
+
+  bool _finished() const override { return reply != NULL && reply->_finished(); }
+  bool _failed() const override { return reply != NULL && reply->_failed(); }
+  bool _sourceValid() const override { return true; }
+
+ protected:
+  // Web server task: the reply once the work is done, NULL until then
+  virtual AsyncWebServerResponse* poll() = 0;
+
+  // Whether the real reply has been handed over
+  bool replied() const { return reply != NULL; }
+
+ private:
+  AsyncWebServerResponse* reply;
+
+  void check(AsyncWebServerRequest* request) {
+    reply = poll();
+    if (reply != NULL) reply->_respond(request);
+  }
+};
+
+#endif // DEFERRED_RESPONSE_H
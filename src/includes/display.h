@@ -8,7 +8,7 @@ extern MD_Parola disp;
 
 // Function declarations
 void initDisplay();
-void clearDisplayForModeChange(String oldMode, String newMode);
+void clearDisplayForModeChange(EffectMode oldMode, EffectMode newMode);
 void updateDisplay();
 void scrollPortalAddress();
 void showUpdatingMessage();
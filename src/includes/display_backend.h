@@ -0,0 +1,50 @@
+#ifndef DISPLAY_BACKEND_H
+#define DISPLAY_BACKEND_H
+
+#include "framebuffer.h"
+
+// How frame buffer rows get to the MAX7219 chain. fbFlush() works out
+// which rows changed and hands them to the active backend.
+class DisplayBackend {
+ public:
+  virtual ~DisplayBackend() {}
+
+  // Set up the transport; false if it cannot be used on this board
+  virtual bool begin() = 0;
+  virtual const char* name() const = 0;
+
+  // Send every row whose bit is set in rowMask. May return before the
+  // bytes are on the wire; the frame is copied before returning.
+  virtual void sendRows(const PackedFrame& frame, uint8_t rowMask) = 0;
+
+  // True when MD_Parola's own writes no longer reach the chain, so its
+  // buffer and intensity have to be mirrored through this backend
+  virtual bool mirrorsDriver() const { return false; }
+  virtual void setIntensity(uint8_t level) {}
+};
+
+// Blocking byte-at-a-time writes through MD_MAX72XX (the default)
+class Max72xxBackend : public DisplayBackend {
+ public:
+  bool begin();
+  const char* name() const { return "md_max72xx"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask);
+};
+
+// Whole rows built into DMA memory and sent as queued ESP32 SPI
+// transactions, so the next frame renders while this one goes out
+class SpiDmaBackend : public DisplayBackend {
+ public:
+  bool begin();
+  const char* name() const { return "spi_dma"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask);
+  bool mirrorsDriver() const { return true; }
+  void setIntensity(uint8_t level);
+};
+
+// Pick the backend (DISPLAY_SPI_DMA_ENABLED) after disp.begin(), falling
+// back to MD_MAX72XX if the DMA transport cannot start
+void initDisplayBackend();
+DisplayBackend* getDisplayBackend();
+
+#endif // DISPLAY_BACKEND_H
@@ -0,0 +1,185 @@
+#ifndef DISPLAY_ITEM_H
+#define DISPLAY_ITEM_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "text_pool.h"
+
+// One playlist item: a small common header plus the parameters of its
+// own mode only.
+//
+// Items used to carry two Strings and the parameters of every effect
+// whatever their mode, about 160 bytes each before their text. The
+// parameter blocks now share a union tagged by the mode, text and file
+// names live in the text pool (text_pool.h), and a layered item keeps its
+// layers and their parameters in one block of its own. Change the mode
+// with setMode(), which swaps the parameter block for the new mode's
+// defaults.
+
+// How a layer is combined with the layers below it
+enum LayerOp {
+  LAYER_OP_OR,       // Light the layer's pixels
+  LAYER_OP_XOR,      // Toggle pixels under the layer
+  LAYER_OP_ANDNOT    // Mask: clear pixels under the layer
+};
+
+// What an item shows. Names, flags and handlers are in effect_registry.h;
+// the values double as item type tags on flash (config_binary.h), so add
+// new modes at the end and never renumber.
+enum EffectMode : uint8_t {
+  MODE_TEXT = 0,
+  MODE_TWINKLE = 1,
+  MODE_KNIGHTRIDER = 2,
+  MODE_PONG = 3,
+  MODE_SINEWAVE = 4,
+  MODE_BITMAP = 5,
+  MODE_ANIMATION = 6,
+  MODE_LAYERS = 7,
+  MODE_LIFE = 8,
+  MODE_COUNT,
+  MODE_UNKNOWN = 0xFF       // A mode name this firmware does not know
+};
+
+#define MAX_ITEM_LAYERS 4
+
+// One layer of a layered item
+struct DisplayLayer {
+  EffectMode mode;          // MODE_TEXT or an effect
+  uint8_t op;               // LayerOp
+};
+
+typedef struct {
+  uint16_t scrollSpeed;     // ms per column
+  uint16_t rasterBytes;     // Memory the raster takes while the item is current (runtime only)
+  uint32_t pauseTime;       // Pause at the end of a scroll (ms)
+  uint32_t rasterUs;        // Time taken to rasterize the text (runtime only)
+} TextParams;
+
+typedef struct {
+  uint8_t density;          // Percentage of LEDs lit
+  uint16_t minSpeed;        // Shortest twinkle (ms)
+  uint16_t maxSpeed;        // Longest twinkle (ms)
+} TwinkleParams;
+
+typedef struct {
+  uint16_t speed;           // Update interval (ms)
+  uint8_t tailLength;
+} KnightRiderParams;
+
+typedef struct {
+  uint16_t speed;           // Update interval (ms)
+  float ballSpeedX;
+  float ballSpeedY;
+} PongParams;
+
+typedef struct {
+  uint16_t speed;           // Update interval (ms)
+  uint8_t amplitude;        // Rows
+  uint8_t phases;           // Overlapping waves
+} SineWaveParams;
+
+typedef struct {
+  TextEntry* file;          // Pooled animation name (see animation.h), owned by the item
+  uint16_t frameDelay;      // ms per frame, 0 = the file's own delay
+} FrameParams;
+
+typedef struct {
+  uint16_t birth;           // Bit n: a dead cell with n live neighbours is born
+  uint16_t survive;         // Bit n: a live cell with n live neighbours survives
+  uint16_t speed;           // Update interval (ms per generation)
+  uint8_t density;          // Percentage of cells alive in a new seed
+  uint8_t wolfram;          // Elementary rule, if elementary
+  bool elementary;          // One row per generation instead of birth/survive (life.h)
+} LifeParams;
+
+struct LayerStack;
+
+// Parameters of one mode, selected by the item's mode
+union ModeParams {
+  TextParams text;
+  TwinkleParams twinkle;
+  KnightRiderParams knightRider;
+  PongParams pong;
+  SineWaveParams sineWave;
+  FrameParams frames;       // MODE_BITMAP, MODE_ANIMATION
+  LifeParams life;
+  LayerStack* layers;       // MODE_LAYERS; NULL if it could not be allocated
+};
+
+// Layers of a layered item, bottom first. params[i] belongs to the first
+// layer of each mode; later layers of the same mode draw with it.
+struct LayerStack {
+  uint8_t count;
+  DisplayLayer layers[MAX_ITEM_LAYERS];
+  ModeParams params[MAX_ITEM_LAYERS];
+};
+
+// Read-only view of a layer stack
+struct LayerList {
+  const DisplayLayer* first;
+  uint8_t count;
+
+  const DisplayLayer* begin() const { return first; }
+  const DisplayLayer* end() const { return first + count; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const DisplayLayer& operator[](size_t index) const { return first[index]; }
+};
+
+struct DisplayItem {
+  uint32_t id;              // Stable ID for the change log and API, 0 until assigned
+  uint32_t duration;        // How long to show this item (ms, 0 = forever)
+  PooledText text;          // Text content (text mode and text layers)
+  uint16_t playCount;       // Number of times item has been played
+  uint16_t maxPlays;        // Maximum times to play (0 = unlimited)
+  EffectMode mode;          // Read only: change it with setMode()
+  uint8_t brightness;       // Display brightness (0-15)
+  uint8_t alignment;        // textPosition_t, for text and frames
+  bool invert : 1;          // Whether display is inverted
+  bool deleteAfterPlay : 1; // Whether to delete after playing
+  ModeParams params;        // Of mode; use paramsFor() for a mode a layer draws
+
+  DisplayItem();
+  DisplayItem(const DisplayItem& other);
+  DisplayItem(DisplayItem&& other);
+  DisplayItem& operator=(const DisplayItem& other);
+  DisplayItem& operator=(DisplayItem&& other);
+  ~DisplayItem();
+
+  // Switch to another mode, its parameters and alignment set to defaults
+  void setMode(EffectMode newMode);
+
+  // Parameters the item draws a mode with: its own, or for a layered item
+  // those of its first layer in that mode. NULL if it does not draw it.
+  ModeParams* paramsFor(EffectMode forMode);
+  const ModeParams* paramsFor(EffectMode forMode) const;
+
+  // The same, defaults if the item does not draw the mode
+  const TextParams& textParams() const;
+  const TwinkleParams& twinkle() const;
+
+  // Frame file of a bitmap or animation item, "" for other modes
+  const char* file() const;
+  void setFile(const String& name);
+
+  // Layers of a layered item, empty for other modes
+  LayerList layers() const;
+  bool addLayer(EffectMode layerMode, uint8_t op);   // False if not layered or full
+  void clearLayers();
+
+ private:
+  void copyParams(const DisplayItem& other);
+  void releaseParams();
+};
+
+typedef struct {
+  std::atomic<uint32_t> items;        // DisplayItems in memory (playlists and copies being edited)
+  std::atomic<uint32_t> layerStacks;
+} DisplayItemStats;
+
+extern DisplayItemStats displayItemStats;
+
+// Defaults of a mode's parameters (none for MODE_LAYERS or unknown modes)
+void initModeParams(EffectMode mode, ModeParams& params);
+
+#endif // DISPLAY_ITEM_H
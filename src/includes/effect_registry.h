@@ -0,0 +1,52 @@
+#ifndef EFFECT_REGISTRY_H
+#define EFFECT_REGISTRY_H
+
+#include "config.h"
+
+// Every item mode in one table, indexed by EffectMode (config.h).
+//
+// Mode names are resolved to an EffectMode once, when an item is parsed.
+// The frame loop, zone setup, layers and the config readers and writers
+// then look the mode up here instead of comparing names every frame. To
+// add an effect: an EffectMode value, its functions and a row in
+// effectTable (effect_registry.cpp), in the same order as the enum.
+
+#define EFFECT_GRAY 0x01      // Draws 4-bit intensity (grayBuffer), not the packed frame
+#define EFFECT_LAYER 0x02     // Can be a layer of a "layers" item
+#define EFFECT_FRAMES 0x04    // Plays a frame file from ANIMATION_DIR
+#define EFFECT_TEXT 0x08      // Draws the item's text raster
+
+typedef struct {
+  const char* name;                                   // Mode name in the API and JSON config
+  uint8_t flags;                                      // EFFECT_*
+  void (*init)();                                     // Restart its state in the selected effect instance
+  void (*update)(const DisplayItem& item);            // Draw a frame in the selected instance's columns
+  void (*parse)(DisplayItem& item, ModeParams& params, JsonObject obj);   // Read the parameters in obj
+  void (*serialize)(JsonObject obj, const DisplayItem& item, const ModeParams& params);   // Write them
+} EffectInfo;
+
+extern const EffectInfo effectTable[MODE_COUNT];
+extern const EffectInfo unknownEffect;   // MODE_UNKNOWN: draws nothing, has no parameters
+
+static inline const EffectInfo& effectInfo(EffectMode mode) {
+  return mode < MODE_COUNT ? effectTable[mode] : unknownEffect;
+}
+
+static inline bool effectHas(EffectMode mode, uint8_t flag) {
+  return (effectInfo(mode).flags & flag) != 0;
+}
+
+// Mode for a name, MODE_UNKNOWN if there is none
+EffectMode effectModeFromName(const String& name);
+const char* effectModeName(EffectMode mode);
+
+// Read or write the parameters of an item's mode; for a "layers" item the
+// layer list and the parameters of each layer mode. Reading leaves those
+// missing from obj as they are, so set the mode first.
+void parseEffectParams(DisplayItem& item, JsonObject obj);
+void serializeEffectParams(JsonObject obj, const DisplayItem& item);
+
+// Restart every effect in the selected effect instance
+void initEffectStates();
+
+#endif // EFFECT_REGISTRY_H
@@ -2,19 +2,29 @@
 #define EFFECTS_H
 
 #include "config.h"
-// Define max number of concurrent twinkles
-#define MAX_ACTIVE_TWINKLES 100  // Adjust based on your needs
+#include "framebuffer.h"
+#include "fixed_math.h"
+#include "life.h"
+#define TWINKLE_MAX_DURATION 2000   // ms, upper bound of twinkleMaxSpeed
+#define TWINKLE_RATE_SHIFT 4        // Fraction bits of TwinkleState.rate; fits down to 8 ms
 #define SINE_SAMPLES 64     // Number of samples in the wave
 #define SINE_AMPLITUDE 3    // Maximum height of the wave (in LEDs)
 #define SINE_PHASES 3       // Number of different sine waves to combine
+#define LIFE_HISTORY 16             // Generations compared to spot a repeat (longest period caught)
+#define LIFE_SETTLE_GENERATIONS 24  // Shown once it repeats or dies out, before reseeding
+#define LIFE_MAX_GENERATIONS 1500   // Reseed anyway: gliders on a torus only repeat after hundreds
 
+// One running twinkle. Running ones are kept packed at the front of the
+// array, so starting one takes the next free entry and ending one moves
+// the last into its place. Times are the low 16 bits of millis(): a
+// twinkle never outlives TWINKLE_MAX_DURATION.
 typedef struct {
-  bool active;            // Whether this LED is currently twinkling
-  unsigned long startTime; // When this twinkle started
-  unsigned long duration;  // How long this twinkle lasts (ms)
-  uint8_t maxBrightness;  // Maximum brightness this twinkle will reach (0-15)
+  uint16_t startTime;     // When this twinkle started
+  uint16_t duration;      // How long this twinkle lasts (ms)
+  uint16_t rate;          // Fade angle per ms, FIXED_HALF_TURN over the duration (<< TWINKLE_RATE_SHIFT)
+  uint16_t col;           // Column position of this twinkle
   uint8_t row;            // Row position of this twinkle
-  uint8_t col;            // Column position of this twinkle
+  uint8_t maxBrightness;  // Maximum brightness this twinkle will reach (0-15)
 } TwinkleState;
 
 typedef struct {
@@ -26,32 +36,62 @@ typedef struct {
 } KnightRiderState;
 
 typedef struct {
-  float x;          // x position (can be fractional for smooth movement)
-  float y;          // y position
-  float speedX;     // horizontal speed
-  float speedY;     // vertical speed
+  q16_16 x;         // x position (can be fractional for smooth movement)
+  q16_16 y;         // y position
+  q16_16 speedX;    // horizontal speed, columns per update
+  q16_16 speedY;    // vertical speed, rows per update
   unsigned long lastUpdateTime;
   int updateInterval;
 } PongState;
 
 
 typedef struct {
-  float phase[SINE_PHASES];    // Current phase of each sine wave
-  float frequency[SINE_PHASES]; // Frequency of each sine wave
-  float amplitude[SINE_PHASES]; // Amplitude of each sine wave
+  fixed_angle phase[SINE_PHASES];     // Current phase of each sine wave
+  fixed_angle frequency[SINE_PHASES]; // Phase step of each sine wave per update
+  q8_8 amplitude[SINE_PHASES];        // Amplitude of each sine wave (rows)
   unsigned long lastUpdateTime;
   int updateInterval;
 } SineWaveState;
 
+typedef struct {
+  LifeGrid grid;
+  uint32_t history[LIFE_HISTORY];   // Hashes of the last generations, a ring
+  uint8_t historyCount;
+  uint8_t historyNext;
+  uint16_t settled;                 // Generations since it died out or started repeating
+  uint16_t generation;              // Since the last seed
+  uint32_t ruleKey;                 // Rule the grid was seeded for; a new one reseeds
+  bool seeded;
+  unsigned long lastUpdateTime;
+} LifeState;
+
+// All effect state for one zone, plus the frame columns it draws into
+typedef struct {
+  TwinkleState* twinkles;           // One per LED of the zone, allocated while it shows twinkles
+  uint16_t twinkleCapacity;
+  uint16_t twinkleCount;            // Running twinkles, twinkles[0..count-1]
+  unsigned long twinkleLastUpdate;  // millis() of the last twinkle frame
+  PongState pong;
+  SineWaveState sine;
+  KnightRiderState knightRider;
+  LifeState life;
+  uint16_t firstCol;      // Lowest frame column of the zone
+  uint16_t cols;          // Zone width; effects animate across 0..cols-1
+} EffectInstance;
+
 // External variables for effects
-extern TwinkleState twinkleStates[MAX_ACTIVE_TWINKLES];
-extern PongState pongState;
-extern SineWaveState sineWaveState;
 extern uint8_t matrixRows;
-extern uint8_t matrixCols;
 
 
 // Function declarations
+
+// The update functions below animate the selected instance
+void selectEffects(EffectInstance* instance);
+EffectInstance* currentEffects();
+
+// Set an instance's columns and restart all of its effects
+void resetEffects(EffectInstance* instance, uint16_t firstCol, uint16_t cols);
+
 void initTwinkleStates();
 void updateTwinkleEffect(const DisplayItem& item);
 
@@ -64,6 +104,9 @@ void updatePongEffect(const DisplayItem& item);
 void initSineWaveState();
 void updateSineWaveEffect(const DisplayItem& item);
 
+void initLifeState();
+void updateLifeEffect(const DisplayItem& item);
+
 void initializeEffects();
 void updateEffects(const DisplayItem& item);
 
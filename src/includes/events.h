@@ -0,0 +1,60 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "config.h"
+
+// Push channel on /ws: state changes are sent to every connected WebSocket
+// client as one compact JSON object per message, e.g.
+//   {"event":"itemStarted","zone":0,"index":2,"playCount":3,"t":81234}
+//
+// Any task may post an event; posting never blocks and only copies a few
+// bytes into a queue. The main loop task drains the queue, serializes each
+// event once into a shared buffer and broadcasts it to all clients.
+// A client is sent a "hello" snapshot of the current state when it
+// connects, from a copy the render task publishes after each frame, since
+// the item list is only safe to read there. Connecting needs the API key
+// like any other endpoint.
+
+enum DeviceEventType {
+  EVENT_ITEM_STARTED,     // index/playCount of the item now showing
+  EVENT_ITEM_ENDED,       // index/playCount of the item that finished; value 1 = deleted
+  EVENT_CONFIG_CHANGED,   // Settings or items were saved
+  EVENT_WIFI,             // value = WiFi status (WL_CONNECTED = 3)
+  EVENT_HEAP_LOW          // value = free heap in bytes
+};
+
+typedef struct {
+  uint8_t type;           // DeviceEventType
+  uint8_t zone;
+  int16_t index;
+  uint16_t playCount;
+  int32_t value;
+  uint32_t timeMs;        // millis() when posted
+} DeviceEvent;
+
+typedef struct {
+  unsigned long posted;
+  unsigned long dropped;      // Queue was full
+  unsigned long broadcasts;   // Messages sent to clients
+  uint32_t clients;
+} EventStats;
+
+extern EventStats eventStats;
+
+// Register /ws on the web server and create the event queue
+void setupEventSocket(AsyncWebServer& server);
+
+// Queue an event for broadcast. Safe from any task; drops it if the queue
+// is full (or before setupEventSocket).
+void postEvent(DeviceEventType type, uint8_t zone = 0, int16_t index = -1,
+               uint16_t playCount = 0, int32_t value = 0);
+
+// Render task, after each frame (and once before it starts): copy what a
+// new client's hello reports
+void publishHelloState();
+
+// Main loop: wait up to waitMs for events and broadcast them, then check
+// WiFi and heap for changes worth reporting
+void pumpEvents(uint32_t waitMs);
+
+#endif // EVENTS_H
@@ -0,0 +1,126 @@
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <stdint.h>
+
+// Integer math kernels for the effects, which run every frame on every
+// column of the chain. The ESP32's FPU is single precision and slow at
+// sin(); these are table lookups, multiplies and shifts.
+//
+//   q8_8     int16_t, 8 integer bits and 8 fraction bits (-128 to 127.996)
+//   q16_16   int32_t, 16 and 16 (-32768 to 32767.99998)
+//   angle    uint16_t, 65536 to a full turn, so it wraps by itself
+
+typedef int16_t q8_8;
+typedef int32_t q16_16;
+typedef uint16_t fixed_angle;
+
+#define Q8_ONE 0x100
+#define Q16_ONE 0x10000
+#define FIXED_HALF_TURN 0x8000U
+#define FIXED_QUARTER_TURN 0x4000U
+
+// Constants written in floating point; for initializers, not per-frame code
+#define Q8_FROM_FLOAT(x) ((q8_8)((x) * Q8_ONE + ((x) < 0 ? -0.5 : 0.5)))
+#define Q16_FROM_FLOAT(x) ((q16_16)((x) * Q16_ONE + ((x) < 0 ? -0.5 : 0.5)))
+#define FIXED_ANGLE_FROM_RADIANS(r) ((fixed_angle)(int32_t)((r) * (65536.0 / 6.283185307179586) + 0.5))
+
+static inline q8_8 q8FromInt(int16_t x) { return x * Q8_ONE; }
+static inline q16_16 q16FromInt(int32_t x) { return x * Q16_ONE; }
+static inline q16_16 q16FromQ8(q8_8 x) { return (q16_16)x * Q8_ONE; }
+static inline int32_t q16Floor(q16_16 x) { return x >> 16; }
+static inline int32_t q16Round(q16_16 x) { return (x + Q16_ONE / 2) >> 16; }
+
+static inline q16_16 q16Mul(q16_16 a, q16_16 b) {
+  return (q16_16)(((int64_t)a * b) >> 16);
+}
+
+// a * b for a Q8.8 factor, e.g. an amplitude
+static inline q16_16 q16MulQ8(q16_16 a, q8_8 b) {
+  return (q16_16)(((int64_t)a * b) >> 8);
+}
+
+// 1 / x with one 32-bit divide (a Q16.16 divide needs a 64-bit one).
+// Low by at most one step; |x| must be above 1/32768.
+static inline q16_16 q16Reciprocal(q16_16 x) {
+  uint32_t magnitude = x < 0 ? -(uint32_t)x : (uint32_t)x;
+  if (magnitude < 2) return INT32_MAX;
+  q16_16 r = (q16_16)(0xFFFFFFFFUL / magnitude);
+  return x < 0 ? -r : r;
+}
+
+// sin(PI / 2 * i / 256), i = 0..256, scaled to 65535
+inline constexpr uint16_t FIXED_SINE_QUARTER[257] = {
+      0,   402,   804,  1206,  1608,  2010,  2412,  2814,  3216,  3617,  4019,  4420,
+   4821,  5222,  5623,  6023,  6424,  6824,  7224,  7623,  8022,  8421,  8820,  9218,
+   9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391, 12785, 13180, 13573, 13966,
+  14359, 14751, 15143, 15534, 15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+  19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699, 22078, 22457, 22834, 23210,
+  23586, 23961, 24335, 24708, 25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+  28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538, 30893, 31248, 31600, 31952,
+  32303, 32652, 33000, 33347, 33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+  36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716, 39040, 39362, 39683, 40002,
+  40320, 40636, 40951, 41264, 41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+  44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056, 46341, 46624, 46906, 47186,
+  47464, 47741, 48015, 48288, 48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+  50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398, 52639, 52878, 53114, 53349,
+  53581, 53812, 54040, 54267, 54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+  56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607, 57798, 57986, 58172, 58356,
+  58538, 58718, 58896, 59071, 59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+  60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568, 61705, 61839, 61971, 62101,
+  62228, 62353, 62476, 62596, 62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+  63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197, 64277, 64354, 64429, 64501,
+  64571, 64639, 64704, 64766, 64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+  65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436, 65457, 65476, 65492, 65505,
+  65516, 65525, 65531, 65535, 65535,
+};
+
+// Quarter-wave lookup, linearly interpolated; x = 0..FIXED_QUARTER_TURN
+static inline int32_t fixedSineQuarter(uint16_t x) {
+  uint16_t i = x >> 6;
+  if (i >= 256) return FIXED_SINE_QUARTER[256];
+  int32_t a = FIXED_SINE_QUARTER[i];
+  int32_t b = FIXED_SINE_QUARTER[i + 1];
+  return a + (((b - a) * (int32_t)(x & 63)) >> 6);
+}
+
+// Same, at the nearest table entry instead of interpolating: off from
+// float by under 1/320, for per-pixel levels where that is below a step.
+// x = 0..FIXED_QUARTER_TURN rounds to entries 0..256, so no clamp.
+static inline int32_t fixedSineQuarterNearest(uint16_t x) {
+  return FIXED_SINE_QUARTER[(x + 32) >> 6];
+}
+
+// sin and cos in Q16.16; off from float by under 1/16000
+static inline q16_16 fixedSin(fixed_angle angle) {
+  uint16_t within = angle & (FIXED_QUARTER_TURN - 1);
+  switch (angle >> 14) {
+    case 0:  return fixedSineQuarter(within);
+    case 1:  return fixedSineQuarter(FIXED_QUARTER_TURN - within);
+    case 2:  return -fixedSineQuarter(within);
+    default: return -fixedSineQuarter(FIXED_QUARTER_TURN - within);
+  }
+}
+
+static inline q16_16 fixedCos(fixed_angle angle) {
+  return fixedSin(angle + FIXED_QUARTER_TURN);
+}
+
+// a + (b - a) * t, t in Q16.16 from 0 to 1
+static inline q16_16 q16Lerp(q16_16 a, q16_16 b, q16_16 t) {
+  return a + q16Mul(b - a, t);
+}
+
+// Same for 8-bit values, t from 0 to 256
+static inline uint8_t lerp8(uint8_t a, uint8_t b, uint16_t t) {
+  return a + (((int32_t)b - a) * t >> 8);
+}
+
+// Easing curves, t in Q16.16 from 0 to 1
+static inline q16_16 q16EaseIn(q16_16 t) { return q16Mul(t, t); }
+static inline q16_16 q16EaseOut(q16_16 t) { return q16Mul(t, 2 * Q16_ONE - t); }
+static inline q16_16 q16EaseInOut(q16_16 t) {   // Smoothstep: 3t^2 - 2t^3
+  return q16Mul(q16Mul(t, t), 3 * Q16_ONE - 2 * t);
+}
+
+#endif // FIXED_MATH_H
@@ -0,0 +1,94 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <stddef.h>
+#include "font_atlas.h"
+
+// Proportional 8-row font for the text rasterizer. The glyph tables in
+// font_atlas.h are generated by tools/gen_font_atlas.py and cover ASCII,
+// Latin-1, arrows and block elements; anything else shows as a box.
+//
+// Text is UTF-8. Bytes that do not form a valid sequence are taken as
+// Latin-1, so configs saved before UTF-8 support keep their accents.
+// Layout is constexpr and never allocates: a text's exact width is known
+// in one pass before anything is drawn.
+
+// Decode the code point at s and step s past it. s must not point at the
+// terminator; a truncated sequence stops at it without reading beyond.
+constexpr uint32_t fontNextCodepoint(const char*& s) {
+  uint8_t lead = (uint8_t)s[0];
+  if (lead < 0x80) {
+    s++;
+    return lead;
+  }
+
+  uint8_t len = (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : (lead & 0xF8) == 0xF0 ? 4 : 0;
+  uint32_t cp = lead & (0x7F >> len);
+  for (uint8_t i = 1; i < len; i++) {
+    uint8_t b = (uint8_t)s[i];
+    if ((b & 0xC0) != 0x80) {
+      len = 0;
+      break;
+    }
+    cp = (cp << 6) | (b & 0x3F);
+  }
+
+  // Overlong forms and surrogates are malformed as well
+  bool valid = (len == 2 && cp >= 0x80) ||
+               (len == 3 && cp >= 0x800 && (cp < 0xD800 || cp > 0xDFFF)) ||
+               (len == 4 && cp >= 0x10000 && cp <= 0x10FFFF);
+  if (!valid) {
+    s++;
+    return lead;
+  }
+
+  s += len;
+  return cp;
+}
+
+constexpr uint16_t fontGlyphIndex(uint32_t cp) {
+  for (const FontRange& range : FONT_RANGES) {
+    if (cp >= range.first && cp - range.first < range.count) {
+      return range.glyph + (cp - range.first);
+    }
+  }
+  return FONT_FALLBACK_GLYPH;
+}
+
+constexpr bool fontKerned(uint16_t left, uint16_t right) {
+  uint16_t key = (uint16_t)(left << 8 | right);
+  size_t lo = 0;
+  size_t hi = sizeof(FONT_KERN_PAIRS) / sizeof(FONT_KERN_PAIRS[0]);
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (FONT_KERN_PAIRS[mid] == key) return true;
+    if (FONT_KERN_PAIRS[mid] < key) lo = mid + 1; else hi = mid;
+  }
+  return false;
+}
+
+// Dark columns between two glyphs
+constexpr uint8_t fontGap(uint16_t left, uint16_t right, uint8_t spacing) {
+  if (FONT_GLYPHS[left].flags & FONT_GLYPHS[right].flags & FONT_FLAG_JOIN) return 0;
+  if (spacing > 0 && fontKerned(left, right)) return spacing - 1;
+  return spacing;
+}
+
+// Width of a text in columns, spacing columns between characters
+constexpr uint32_t fontTextWidth(const char* text, uint8_t spacing) {
+  uint32_t width = 0;
+  int prev = -1;
+  while (*text) {
+    uint16_t glyph = fontGlyphIndex(fontNextCodepoint(text));
+    if (prev >= 0) width += fontGap(prev, glyph, spacing);
+    width += FONT_GLYPHS[glyph].width;
+    prev = glyph;
+  }
+  return width;
+}
+
+// Draw a text as one byte per column (bit r = row r), laid out exactly as
+// fontTextWidth() measures it. Stops after maxCols; returns columns written.
+size_t fontRender(const char* text, uint8_t spacing, uint8_t* out, size_t maxCols);
+
+#endif // FONT_H
@@ -0,0 +1,317 @@
+// Generated by tools/gen_font_atlas.py - edit the glyphs there, not here.
+#ifndef FONT_ATLAS_H
+#define FONT_ATLAS_H
+
+#include <stdint.h>
+
+#define FONT_HEIGHT 8
+#define FONT_GLYPH_COUNT 222
+#define FONT_FALLBACK_GLYPH 221
+#define FONT_MAX_GLYPH_WIDTH 8
+#define FONT_FLAG_JOIN 0x01   // No gap between two joining glyphs
+
+typedef struct {
+  uint16_t offset;   // First column in FONT_COLUMNS
+  uint8_t width;
+  uint8_t flags;
+} FontGlyph;
+
+typedef struct {
+  uint32_t first;    // First code point
+  uint16_t count;
+  uint16_t glyph;    // Glyph of the first code point
+} FontRange;
+
+// One byte per column, bit r = row r
+inline constexpr uint8_t FONT_COLUMNS[] = {
+  0x00, 0x00,   // U+0020
+  0x5F,   // U+0021
+  0x03, 0x00, 0x03,   // U+0022
+  0x14, 0x7F, 0x14, 0x7F, 0x14,   // U+0023
+  0x24, 0x2A, 0x7F, 0x2A, 0x12,   // U+0024
+  0x23, 0x13, 0x08, 0x64, 0x62,   // U+0025
+  0x36, 0x49, 0x55, 0x22, 0x50,   // U+0026
+  0x03,   // U+0027
+  0x3E, 0x41,   // U+0028
+  0x41, 0x3E,   // U+0029
+  0x14, 0x08, 0x3E, 0x08, 0x14,   // U+002A
+  0x08, 0x08, 0x3E, 0x08, 0x08,   // U+002B
+  0x80, 0x60,   // U+002C
+  0x08, 0x08, 0x08, 0x08,   // U+002D
+  0x40,   // U+002E
+  0x20, 0x10, 0x08, 0x04, 0x02,   // U+002F
+  0x3E, 0x51, 0x49, 0x45, 0x3E,   // U+0030
+  0x42, 0x7F, 0x40,   // U+0031
+  0x42, 0x61, 0x51, 0x49, 0x46,   // U+0032
+  0x21, 0x41, 0x45, 0x4B, 0x31,   // U+0033
+  0x18, 0x14, 0x12, 0x7F, 0x10,   // U+0034
+  0x27, 0x45, 0x45, 0x45, 0x39,   // U+0035
+  0x3C, 0x4A, 0x49, 0x49, 0x30,   // U+0036
+  0x01, 0x71, 0x09, 0x05, 0x03,   // U+0037
+  0x36, 0x49, 0x49, 0x49, 0x36,   // U+0038
+  0x06, 0x49, 0x49, 0x29, 0x1E,   // U+0039
+  0x24,   // U+003A
+  0x80, 0x64,   // U+003B
+  0x08, 0x14, 0x22, 0x41,   // U+003C
+  0x14, 0x14, 0x14, 0x14,   // U+003D
+  0x41, 0x22, 0x14, 0x08,   // U+003E
+  0x02, 0x01, 0x51, 0x09, 0x06,   // U+003F
+  0x32, 0x49, 0x79, 0x41, 0x3E,   // U+0040
+  0x7E, 0x09, 0x09, 0x09, 0x7E,   // U+0041
+  0x7F, 0x49, 0x49, 0x49, 0x36,   // U+0042
+  0x3E, 0x41, 0x41, 0x41, 0x22,   // U+0043
+  0x7F, 0x41, 0x41, 0x22, 0x1C,   // U+0044
+  0x7F, 0x49, 0x49, 0x49, 0x41,   // U+0045
+  0x7F, 0x09, 0x09, 0x09, 0x01,   // U+0046
+  0x3E, 0x41, 0x49, 0x49, 0x7A,   // U+0047
+  0x7F, 0x08, 0x08, 0x08, 0x7F,   // U+0048
+  0x41, 0x7F, 0x41,   // U+0049
+  0x20, 0x40, 0x41, 0x3F, 0x01,   // U+004A
+  0x7F, 0x08, 0x14, 0x22, 0x41,   // U+004B
+  0x7F, 0x40, 0x40, 0x40, 0x40,   // U+004C
+  0x7F, 0x02, 0x0C, 0x02, 0x7F,   // U+004D
+  0x7F, 0x04, 0x08, 0x10, 0x7F,   // U+004E
+  0x3E, 0x41, 0x41, 0x41, 0x3E,   // U+004F
+  0x7F, 0x09, 0x09, 0x09, 0x06,   // U+0050
+  0x3E, 0x41, 0x51, 0x21, 0x5E,   // U+0051
+  0x7F, 0x09, 0x19, 0x29, 0x46,   // U+0052
+  0x46, 0x49, 0x49, 0x49, 0x31,   // U+0053
+  0x01, 0x01, 0x7F, 0x01, 0x01,   // U+0054
+  0x3F, 0x40, 0x40, 0x40, 0x3F,   // U+0055
+  0x1F, 0x20, 0x40, 0x20, 0x1F,   // U+0056
+  0x3F, 0x40, 0x38, 0x40, 0x3F,   // U+0057
+  0x63, 0x14, 0x08, 0x14, 0x63,   // U+0058
+  0x03, 0x04, 0x78, 0x04, 0x03,   // U+0059
+  0x61, 0x51, 0x49, 0x45, 0x43,   // U+005A
+  0x7F, 0x41,   // U+005B
+  0x02, 0x04, 0x08, 0x10, 0x20,   // U+005C
+  0x41, 0x7F,   // U+005D
+  0x04, 0x02, 0x01, 0x02, 0x04,   // U+005E
+  0x80, 0x80, 0x80, 0x80,   // U+005F
+  0x01, 0x02,   // U+0060
+  0x20, 0x54, 0x54, 0x78,   // U+0061
+  0x7F, 0x48, 0x44, 0x38,   // U+0062
+  0x38, 0x44, 0x44, 0x28,   // U+0063
+  0x38, 0x44, 0x48, 0x7F,   // U+0064
+  0x38, 0x54, 0x54, 0x58,   // U+0065
+  0x04, 0x7E, 0x05,   // U+0066
+  0x18, 0xA4, 0xA4, 0x7C,   // U+0067
+  0x7F, 0x08, 0x04, 0x78,   // U+0068
+  0x7A,   // U+0069
+  0x80, 0x80, 0x7A,   // U+006A
+  0x7F, 0x10, 0x28, 0x44,   // U+006B
+  0x3F, 0x40,   // U+006C
+  0x7C, 0x04, 0x78, 0x04, 0x78,   // U+006D
+  0x7C, 0x08, 0x04, 0x78,   // U+006E
+  0x38, 0x44, 0x44, 0x38,   // U+006F
+  0xFC, 0x24, 0x24, 0x18,   // U+0070
+  0x18, 0x24, 0x24, 0xFC,   // U+0071
+  0x7C, 0x08, 0x04, 0x04,   // U+0072
+  0x48, 0x54, 0x54, 0x24,   // U+0073
+  0x04, 0x3F, 0x44,   // U+0074
+  0x3C, 0x40, 0x20, 0x7C,   // U+0075
+  0x1C, 0x20, 0x40, 0x20, 0x1C,   // U+0076
+  0x3C, 0x40, 0x30, 0x40, 0x3C,   // U+0077
+  0x44, 0x28, 0x10, 0x28, 0x44,   // U+0078
+  0x1C, 0xA0, 0xA0, 0x7C,   // U+0079
+  0x44, 0x64, 0x54, 0x4C,   // U+007A
+  0x08, 0x36, 0x41,   // U+007B
+  0x7F,   // U+007C
+  0x41, 0x36, 0x08,   // U+007D
+  0x08, 0x04, 0x08, 0x10, 0x08,   // U+007E
+  0x00, 0x00,   // U+00A0
+  0x7D,   // U+00A1
+  0x1C, 0x22, 0x7F, 0x22, 0x22,   // U+00A2
+  0x48, 0x3E, 0x49, 0x41, 0x22,   // U+00A3
+  0x22, 0x1C, 0x14, 0x1C, 0x22,   // U+00A4
+  0x15, 0x16, 0x7C, 0x16, 0x15,   // U+00A5
+  0x77,   // U+00A6
+  0x4A, 0x55, 0x55, 0x29,   // U+00A7
+  0x01, 0x00, 0x01,   // U+00A8
+  0x3E, 0x41, 0x49, 0x55, 0x55, 0x41, 0x3E,   // U+00A9
+  0x1D, 0x15, 0x1E,   // U+00AA
+  0x08, 0x14, 0x2A, 0x14, 0x22,   // U+00AB
+  0x04, 0x04, 0x04, 0x04, 0x1C,   // U+00AC
+  0x08, 0x08, 0x08,   // U+00AD
+  0x3E, 0x41, 0x7D, 0x55, 0x69, 0x41, 0x3E,   // U+00AE
+  0x01, 0x01, 0x01, 0x01,   // U+00AF
+  0x02, 0x05, 0x02,   // U+00B0
+  0x44, 0x44, 0x5F, 0x44, 0x44,   // U+00B1
+  0x09, 0x0D, 0x0A,   // U+00B2
+  0x11, 0x15, 0x0A,   // U+00B3
+  0x02, 0x01,   // U+00B4
+  0xFC, 0x20, 0x20, 0x1C,   // U+00B5
+  0x06, 0x0F, 0x7F, 0x01, 0x7F,   // U+00B6
+  0x08,   // U+00B7
+  0x80, 0x40,   // U+00B8
+  0x02, 0x0F,   // U+00B9
+  0x12, 0x15, 0x12,   // U+00BA
+  0x22, 0x14, 0x2A, 0x14, 0x08,   // U+00BB
+  0x27, 0x10, 0x08, 0x24, 0x32, 0x79, 0x20,   // U+00BC
+  0x27, 0x10, 0x08, 0x04, 0x6A, 0x59, 0x40,   // U+00BD
+  0x25, 0x17, 0x08, 0x24, 0x32, 0x79, 0x20,   // U+00BE
+  0x30, 0x48, 0x45, 0x40, 0x20,   // U+00BF
+  0x78, 0x15, 0x16, 0x14, 0x78,   // U+00C0
+  0x78, 0x16, 0x15, 0x14, 0x78,   // U+00C1
+  0x78, 0x16, 0x15, 0x16, 0x78,   // U+00C2
+  0x7A, 0x15, 0x16, 0x15, 0x78,   // U+00C3
+  0x78, 0x16, 0x14, 0x16, 0x78,   // U+00C4
+  0x78, 0x17, 0x17, 0x14, 0x78,   // U+00C5
+  0x7E, 0x09, 0x7F, 0x49, 0x49,   // U+00C6
+  0x3E, 0x41, 0xC1, 0x41, 0x22,   // U+00C7
+  0x7C, 0x55, 0x56, 0x54, 0x44,   // U+00C8
+  0x7C, 0x56, 0x55, 0x54, 0x44,   // U+00C9
+  0x7C, 0x56, 0x55, 0x56, 0x44,   // U+00CA
+  0x7C, 0x56, 0x54, 0x56, 0x44,   // U+00CB
+  0x45, 0x7E, 0x44,   // U+00CC
+  0x46, 0x7D, 0x44,   // U+00CD
+  0x46, 0x7D, 0x46,   // U+00CE
+  0x46, 0x7C, 0x46,   // U+00CF
+  0x08, 0x7F, 0x49, 0x49, 0x22, 0x1C,   // U+00D0
+  0x7E, 0x09, 0x12, 0x21, 0x7C,   // U+00D1
+  0x38, 0x45, 0x46, 0x44, 0x38,   // U+00D2
+  0x38, 0x46, 0x45, 0x44, 0x38,   // U+00D3
+  0x38, 0x46, 0x45, 0x46, 0x38,   // U+00D4
+  0x3A, 0x45, 0x46, 0x45, 0x38,   // U+00D5
+  0x38, 0x46, 0x44, 0x46, 0x38,   // U+00D6
+  0x22, 0x14, 0x08, 0x14, 0x22,   // U+00D7
+  0x7E, 0x61, 0x5D, 0x43, 0x3F,   // U+00D8
+  0x3C, 0x41, 0x42, 0x40, 0x3C,   // U+00D9
+  0x3C, 0x42, 0x41, 0x40, 0x3C,   // U+00DA
+  0x3C, 0x42, 0x41, 0x42, 0x3C,   // U+00DB
+  0x3C, 0x42, 0x40, 0x42, 0x3C,   // U+00DC
+  0x04, 0x0A, 0x71, 0x08, 0x04,   // U+00DD
+  0x7F, 0x12, 0x12, 0x12, 0x0C,   // U+00DE
+  0x7E, 0x01, 0x49, 0x36,   // U+00DF
+  0x20, 0x55, 0x56, 0x78,   // U+00E0
+  0x20, 0x56, 0x55, 0x78,   // U+00E1
+  0x22, 0x55, 0x56, 0x78,   // U+00E2
+  0x22, 0x55, 0x56, 0x79,   // U+00E3
+  0x22, 0x54, 0x56, 0x78,   // U+00E4
+  0x20, 0x57, 0x57, 0x78,   // U+00E5
+  0x24, 0x54, 0x38, 0x54, 0x58,   // U+00E6
+  0x38, 0x44, 0xC4, 0x28,   // U+00E7
+  0x38, 0x55, 0x56, 0x58,   // U+00E8
+  0x38, 0x56, 0x55, 0x58,   // U+00E9
+  0x3A, 0x55, 0x56, 0x58,   // U+00EA
+  0x3A, 0x54, 0x56, 0x58,   // U+00EB
+  0x01, 0x7E, 0x00,   // U+00EC
+  0x02, 0x7D, 0x00,   // U+00ED
+  0x02, 0x7D, 0x02,   // U+00EE
+  0x02, 0x7C, 0x02,   // U+00EF
+  0x35, 0x4A, 0x4D, 0x38,   // U+00F0
+  0x7E, 0x09, 0x06, 0x79,   // U+00F1
+  0x38, 0x45, 0x46, 0x38,   // U+00F2
+  0x38, 0x46, 0x45, 0x38,   // U+00F3
+  0x3A, 0x45, 0x46, 0x38,   // U+00F4
+  0x3A, 0x45, 0x46, 0x39,   // U+00F5
+  0x3A, 0x44, 0x46, 0x38,   // U+00F6
+  0x08, 0x08, 0x2A, 0x08, 0x08,   // U+00F7
+  0x78, 0x74, 0x4C, 0x3C,   // U+00F8
+  0x3C, 0x41, 0x22, 0x7C,   // U+00F9
+  0x3C, 0x42, 0x21, 0x7C,   // U+00FA
+  0x3E, 0x41, 0x22, 0x7C,   // U+00FB
+  0x3E, 0x40, 0x22, 0x7C,   // U+00FC
+  0x1C, 0xA2, 0xA1, 0x7C,   // U+00FD
+  0xFF, 0x24, 0x24, 0x18,   // U+00FE
+  0x1E, 0xA0, 0xA2, 0x7C,   // U+00FF
+  0x08, 0x1C, 0x2A, 0x08, 0x08,   // U+2190
+  0x04, 0x02, 0x7F, 0x02, 0x04,   // U+2191
+  0x08, 0x08, 0x2A, 0x1C, 0x08,   // U+2192
+  0x10, 0x20, 0x7F, 0x20, 0x10,   // U+2193
+  0x08, 0x1C, 0x2A, 0x08, 0x2A, 0x1C, 0x08,   // U+2194
+  0x36, 0x6B, 0x36,   // U+2195
+  0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F,   // U+2580
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,   // U+2581
+  0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0,   // U+2582
+  0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0,   // U+2583
+  0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0,   // U+2584
+  0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8,   // U+2585
+  0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,   // U+2586
+  0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE,   // U+2587
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   // U+2588
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00,   // U+2589
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,   // U+258A
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00,   // U+258B
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,   // U+258C
+  0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00,   // U+258D
+  0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // U+258E
+  0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // U+258F
+  0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,   // U+2590
+  0x11, 0x44, 0x11, 0x44, 0x11, 0x44, 0x11, 0x44,   // U+2591
+  0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA,   // U+2592
+  0x55, 0xFF, 0x55, 0xFF, 0x55, 0xFF, 0x55, 0xFF,   // U+2593
+  0x10, 0x18, 0x1C, 0x18, 0x10,   // U+25B2
+  0x7F, 0x3E, 0x1C, 0x08,   // U+25B6
+  0x04, 0x0C, 0x1C, 0x0C, 0x04,   // U+25BC
+  0x08, 0x1C, 0x3E, 0x7F,   // U+25C0
+  0x7F, 0x41, 0x41, 0x41, 0x7F,   // fallback
+};
+
+inline constexpr FontGlyph FONT_GLYPHS[FONT_GLYPH_COUNT] = {
+  {0, 2, 0}, {2, 1, 0}, {3, 3, 0}, {6, 5, 0}, {11, 5, 0}, {16, 5, 0},
+  {21, 5, 0}, {26, 1, 0}, {27, 2, 0}, {29, 2, 0}, {31, 5, 0}, {36, 5, 0},
+  {41, 2, 0}, {43, 4, 0}, {47, 1, 0}, {48, 5, 0}, {53, 5, 0}, {58, 3, 0},
+  {61, 5, 0}, {66, 5, 0}, {71, 5, 0}, {76, 5, 0}, {81, 5, 0}, {86, 5, 0},
+  {91, 5, 0}, {96, 5, 0}, {101, 1, 0}, {102, 2, 0}, {104, 4, 0}, {108, 4, 0},
+  {112, 4, 0}, {116, 5, 0}, {121, 5, 0}, {126, 5, 0}, {131, 5, 0}, {136, 5, 0},
+  {141, 5, 0}, {146, 5, 0}, {151, 5, 0}, {156, 5, 0}, {161, 5, 0}, {166, 3, 0},
+  {169, 5, 0}, {174, 5, 0}, {179, 5, 0}, {184, 5, 0}, {189, 5, 0}, {194, 5, 0},
+  {199, 5, 0}, {204, 5, 0}, {209, 5, 0}, {214, 5, 0}, {219, 5, 0}, {224, 5, 0},
+  {229, 5, 0}, {234, 5, 0}, {239, 5, 0}, {244, 5, 0}, {249, 5, 0}, {254, 2, 0},
+  {256, 5, 0}, {261, 2, 0}, {263, 5, 0}, {268, 4, 0}, {272, 2, 0}, {274, 4, 0},
+  {278, 4, 0}, {282, 4, 0}, {286, 4, 0}, {290, 4, 0}, {294, 3, 0}, {297, 4, 0},
+  {301, 4, 0}, {305, 1, 0}, {306, 3, 0}, {309, 4, 0}, {313, 2, 0}, {315, 5, 0},
+  {320, 4, 0}, {324, 4, 0}, {328, 4, 0}, {332, 4, 0}, {336, 4, 0}, {340, 4, 0},
+  {344, 3, 0}, {347, 4, 0}, {351, 5, 0}, {356, 5, 0}, {361, 5, 0}, {366, 4, 0},
+  {370, 4, 0}, {374, 3, 0}, {377, 1, 0}, {378, 3, 0}, {381, 5, 0}, {386, 2, 0},
+  {388, 1, 0}, {389, 5, 0}, {394, 5, 0}, {399, 5, 0}, {404, 5, 0}, {409, 1, 0},
+  {410, 4, 0}, {414, 3, 0}, {417, 7, 0}, {424, 3, 0}, {427, 5, 0}, {432, 5, 0},
+  {437, 3, 0}, {440, 7, 0}, {447, 4, 0}, {451, 3, 0}, {454, 5, 0}, {459, 3, 0},
+  {462, 3, 0}, {465, 2, 0}, {467, 4, 0}, {471, 5, 0}, {476, 1, 0}, {477, 2, 0},
+  {479, 2, 0}, {481, 3, 0}, {484, 5, 0}, {489, 7, 0}, {496, 7, 0}, {503, 7, 0},
+  {510, 5, 0}, {515, 5, 0}, {520, 5, 0}, {525, 5, 0}, {530, 5, 0}, {535, 5, 0},
+  {540, 5, 0}, {545, 5, 0}, {550, 5, 0}, {555, 5, 0}, {560, 5, 0}, {565, 5, 0},
+  {570, 5, 0}, {575, 3, 0}, {578, 3, 0}, {581, 3, 0}, {584, 3, 0}, {587, 6, 0},
+  {593, 5, 0}, {598, 5, 0}, {603, 5, 0}, {608, 5, 0}, {613, 5, 0}, {618, 5, 0},
+  {623, 5, 0}, {628, 5, 0}, {633, 5, 0}, {638, 5, 0}, {643, 5, 0}, {648, 5, 0},
+  {653, 5, 0}, {658, 5, 0}, {663, 4, 0}, {667, 4, 0}, {671, 4, 0}, {675, 4, 0},
+  {679, 4, 0}, {683, 4, 0}, {687, 4, 0}, {691, 5, 0}, {696, 4, 0}, {700, 4, 0},
+  {704, 4, 0}, {708, 4, 0}, {712, 4, 0}, {716, 3, 0}, {719, 3, 0}, {722, 3, 0},
+  {725, 3, 0}, {728, 4, 0}, {732, 4, 0}, {736, 4, 0}, {740, 4, 0}, {744, 4, 0},
+  {748, 4, 0}, {752, 4, 0}, {756, 5, 0}, {761, 4, 0}, {765, 4, 0}, {769, 4, 0},
+  {773, 4, 0}, {777, 4, 0}, {781, 4, 0}, {785, 4, 0}, {789, 4, 0}, {793, 5, 0},
+  {798, 5, 0}, {803, 5, 0}, {808, 5, 0}, {813, 7, 0}, {820, 3, 0}, {823, 8, 1},
+  {831, 8, 1}, {839, 8, 1}, {847, 8, 1}, {855, 8, 1}, {863, 8, 1}, {871, 8, 1},
+  {879, 8, 1}, {887, 8, 1}, {895, 8, 1}, {903, 8, 1}, {911, 8, 1}, {919, 8, 1},
+  {927, 8, 1}, {935, 8, 1}, {943, 8, 1}, {951, 8, 1}, {959, 8, 1}, {967, 8, 1},
+  {975, 8, 1}, {983, 5, 0}, {988, 4, 0}, {992, 5, 0}, {997, 4, 0}, {1001, 5, 0},
+};
+
+inline constexpr FontRange FONT_RANGES[] = {
+  {0x0020, 95, 0},
+  {0x00A0, 96, 95},
+  {0x2190, 6, 191},
+  {0x2580, 20, 197},
+  {0x25B2, 1, 217},
+  {0x25B6, 1, 218},
+  {0x25BC, 1, 219},
+  {0x25C0, 1, 220},
+};
+
+// Sorted (left << 8 | right) glyph pairs set one column tighter
+inline constexpr uint16_t FONT_KERN_PAIRS[] = {
+  0x020C, 0x020D, 0x020E, 0x0241, 0x0243, 0x0244, 0x0245, 0x0247, 0x024F, 0x0251,
+  0x0253, 0x070C, 0x070D, 0x070E, 0x0741, 0x0743, 0x0744, 0x0745, 0x0747, 0x074F,
+  0x0751, 0x0753, 0x170C, 0x170D, 0x170E, 0x1741, 0x1743, 0x1744, 0x1745, 0x1747,
+  0x174F, 0x1751, 0x1753, 0x260C, 0x260D, 0x260E, 0x261A, 0x2641, 0x2643, 0x2644,
+  0x2645, 0x2647, 0x264D, 0x264E, 0x264F, 0x2650, 0x2651, 0x2652, 0x2653, 0x2655,
+  0x2656, 0x2657, 0x2658, 0x2659, 0x265A, 0x300C, 0x300E, 0x3041, 0x340C, 0x340D,
+  0x340E, 0x341A, 0x3441, 0x3443, 0x3444, 0x3445, 0x3447, 0x344D, 0x344E, 0x344F,
+  0x3450, 0x3451, 0x3452, 0x3453, 0x3455, 0x3456, 0x3457, 0x3458, 0x3459, 0x345A,
+  0x360C, 0x360E, 0x370C, 0x390C, 0x390D, 0x390E, 0x3941, 0x3943, 0x3944, 0x3945,
+  0x3947, 0x394F, 0x3951, 0x3953, 0x460C, 0x460E, 0x4641, 0x520C, 0x520E, 0x5217,
+  0x5234, 0x5241,
+};
+
+#endif // FONT_ATLAS_H
@@ -0,0 +1,47 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <Arduino.h>
+
+// Task notification bits that wake the render task
+#define FRAME_CLOCK_NOTIFY_BIT (1UL << 0)   // Frame timer tick
+#define RENDER_NOTIFY_ALL_BITS 0xFFFFFFFFUL
+
+// Frame rate limits (frames per second)
+#define MIN_FRAME_RATE 1
+#define MAX_FRAME_RATE 200
+
+typedef struct {
+  uint16_t targetFps;           // Configured frame rate
+  float achievedFps;            // Frames rendered over the last measurement window
+  unsigned long frames;         // Frames rendered since boot
+  unsigned long missedDeadlines; // Ticks that fired while the previous frame was still rendering
+  uint32_t jitterUs;            // Deviation of the last frame start from the ideal period
+  uint32_t avgJitterUs;         // Smoothed jitter
+  uint32_t maxJitterUs;         // Worst jitter since the stats were reset
+  uint32_t frameTimeUs;         // Time spent rendering the last frame
+  uint32_t maxFrameTimeUs;      // Worst render time since the stats were reset
+} FrameClockStats;
+
+extern FrameClockStats frameClockStats;
+
+// Start the periodic frame timer; the calling task is the one woken each frame
+void initFrameClock(uint16_t fps);
+
+// Change the frame rate on the fly (safe to call from any task)
+void setFrameRate(uint16_t fps);
+
+// Block until the render task is notified (frame tick or any other render
+// event), letting the CPU idle in between. Returns the notification bits;
+// frame statistics are updated when FRAME_CLOCK_NOTIFY_BIT is among them.
+uint32_t waitForRenderEvent();
+
+// Task woken by the frame clock and other render events
+TaskHandle_t getRenderTaskHandle();
+
+// Mark the end of the frame's work, for render time and deadline tracking
+void frameDone();
+
+void resetFrameClockStats();
+
+#endif // FRAME_CLOCK_H
@@ -0,0 +1,79 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "config.h"
+
+// Geometry of the MAX7219 chain
+#define FRAME_ROWS 8
+#define FRAME_COLS (MAX_DEVICES * 8)
+#define FRAME_ROW_WORDS ((MAX_DEVICES + 3) / 4)
+#define FRAME_ROW_BYTES (FRAME_ROW_WORDS * 4)
+#define MAX7219_PACKET_BYTES (MAX_DEVICES * 2)   // One opcode/data pair per device per latch
+
+// Bit-packed 1bpp frame. One byte per device per row, bit n of a byte is
+// column (device * 8 + n) - the same layout as a MAX7219 digit register,
+// so a row byte goes to the chain unchanged. Rows are padded to whole
+// 32-bit words so row operations can work a word at a time.
+typedef union {
+  uint8_t bytes[FRAME_ROWS][FRAME_ROW_BYTES];
+  uint32_t words[FRAME_ROWS][FRAME_ROW_WORDS];
+} PackedFrame;
+
+// Flush statistics, reset whenever the displayed item changes
+typedef struct {
+  unsigned long flushes;        // Calls to fbFlush()
+  unsigned long framesSent;     // Flushes that pushed at least one row
+  unsigned long rowsSent;       // Row packets latched into the chain
+  unsigned long bytesSent;      // SPI bytes pushed down the chain
+  unsigned long lastFrameBytes; // Bytes pushed by the most recent flush
+  unsigned long maxFrameBytes;  // Largest single flush
+  uint32_t lastSendUs;          // CPU time the backend took to send the last changed frame
+  uint32_t maxSendUs;
+} FrameStats;
+
+extern PackedFrame frameBuffer;
+extern FrameStats frameStats;
+
+// Drawing into the off-screen frame (no SPI traffic)
+void fbClear();
+void fbClearColumns(uint16_t firstCol, uint16_t cols);
+void fbSetPoint(uint8_t row, uint16_t col, bool on);
+bool fbGetPoint(uint8_t row, uint16_t col);
+void fbSetRowByte(uint8_t row, uint8_t device, uint8_t value);
+uint8_t fbGetRowByte(uint8_t row, uint8_t device);
+
+// Draw a strip of column bytes (bit r = row r, first byte leftmost on
+// screen) into frame columns [firstCol, firstCol + cols), with strip column
+// 0 at zone x = left. Zone columns the strip does not cover are cleared.
+void fbDrawColumns(const uint8_t* columns, int32_t width, int32_t left,
+                   uint16_t firstCol, uint16_t cols, bool invert);
+
+// Bits of frame columns [firstCol, firstCol + cols) in every row
+void fbColumnMask(PackedFrame& mask, uint16_t firstCol, uint16_t cols);
+
+// Redirect the drawing calls above into another frame, e.g. a compositor
+// layer (NULL = frameBuffer). Only frameBuffer is tracked for flushing.
+void fbSetTarget(PackedFrame* target);
+
+// Copy a whole frame into frameBuffer, marking only the bytes that differ
+void fbSetFrame(const PackedFrame& frame);
+
+// Forget what the chain is showing, so the next flush resends every row.
+// Call this after anything other than fbFlush() has written to the display.
+void fbInvalidate();
+
+// Push the row registers that changed since the last flush.
+// Returns the number of SPI bytes sent.
+size_t fbFlush();
+
+// What the chain is showing: frameBuffer, or Parola's buffer if it drew
+// last. Render task only.
+void fbSnapshot(PackedFrame& out);
+
+// For backends that bypass MD_MAX72XX's SPI writes: copy Parola's buffer
+// and intensity to the chain. Call once per frame; no-op otherwise.
+void fbSyncFromDriver();
+
+void fbResetStats();
+
+#endif // FRAMEBUFFER_H
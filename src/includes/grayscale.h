@@ -0,0 +1,57 @@
+#ifndef GRAYSCALE_H
+#define GRAYSCALE_H
+
+#include "framebuffer.h"
+
+// 4-bit intensity per pixel, shown as binary code modulation: bit plane n
+// is held on the chain for 2^n time units, so a pixel of level L is lit
+// for L/15 of every cycle.
+#define GRAY_PLANES 4
+#define GRAY_MAX_LEVEL ((1 << GRAY_PLANES) - 1)
+#define GRAY_CYCLE_UNITS GRAY_MAX_LEVEL
+
+// Task notification bit set by the plane timer
+#define GRAY_PLANE_NOTIFY_BIT (1UL << 1)
+
+// Two pixels per byte, even column in the low nibble
+typedef uint8_t GrayFrame[FRAME_ROWS][FRAME_COLS / 2];
+
+extern GrayFrame grayBuffer;
+
+void initGrayscale();
+
+// Redirect drawing into another intensity buffer (NULL = grayBuffer)
+void graySetTarget(GrayFrame* target);
+
+// Drawing into the intensity buffer
+void grayClear();
+void grayClearColumns(uint16_t firstCol, uint16_t cols);
+void graySetPixel(uint8_t row, uint16_t col, uint8_t level);
+uint8_t grayGetPixel(uint8_t row, uint16_t col);
+
+// Set columns [firstCol, firstCol + cols) from one level byte per pixel,
+// levels[row][x] for column firstCol + x, each 0-GRAY_MAX_LEVEL: for
+// effects that draw a whole zone unpacked and then store it at once
+void graySetColumns(const uint8_t levels[FRAME_ROWS][FRAME_COLS], uint16_t firstCol, uint16_t cols);
+
+// Slice the intensity buffer into bit planes and keep cycling them onto the
+// chain until grayStop(). Call once per frame after drawing.
+void grayCommit();
+
+// Split an intensity buffer into bit planes without touching the chain
+void graySlice(const GrayFrame& src, PackedFrame planes[GRAY_PLANES]);
+
+// Like grayCommit(), but cycle planes built elsewhere (e.g. composited)
+void grayCommitPlanes(const PackedFrame planes[GRAY_PLANES]);
+
+// Stop plane cycling so binary content (or Parola) owns the frame buffer
+void grayStop();
+bool grayIsRunning();
+
+// Bit plane being cycled (planes of the last commit), e.g. for previews
+const PackedFrame& grayPlane(uint8_t plane);
+
+// Push the next bit plane; called by the render task on GRAY_PLANE_NOTIFY_BIT
+void grayEmitNextPlane();
+
+#endif // GRAYSCALE_H
@@ -0,0 +1,35 @@
+#ifndef ITEM_INDEX_H
+#define ITEM_INDEX_H
+
+#include "config.h"
+
+// Item ID -> (zone, slot) hash index, for the /items/{id} endpoints.
+//
+// Open addressing over a power-of-two table at most half full, so a
+// lookup is a hash and a probe or two instead of a walk over every zone's
+// playlist. Render task only, like the item lists it points into. Code
+// that adds, removes or reorders items calls invalidateItemIndex() and
+// the next lookup rebuilds it (O(items), once per batch of changes). A hit
+// is also checked against the item it points at, so a missed invalidation
+// costs a rebuild, not a wrong item.
+
+typedef struct {
+  unsigned long lookups;
+  unsigned long misses;         // IDs not found
+  unsigned long rebuilds;
+  uint16_t capacity;            // Table slots
+  uint16_t items;               // Items indexed at the last rebuild
+  uint8_t maxProbe;             // Longest probe sequence at the last rebuild
+  uint32_t lastRebuildUs;
+} ItemIndexStats;
+
+extern ItemIndexStats itemIndexStats;
+
+// Find an item by ID in any zone; NULL if there is none. zone and slot,
+// if given, receive where it is (zone as in zoneAt()).
+DisplayItem* findItemById(uint32_t id, uint8_t* zone = NULL, uint16_t* slot = NULL);
+
+// Item lists changed; rebuild before the next lookup
+void invalidateItemIndex();
+
+#endif // ITEM_INDEX_H
@@ -0,0 +1,49 @@
+#ifndef LIFE_H
+#define LIFE_H
+
+#include "config.h"
+#include "framebuffer.h"
+
+// Cellular automata on packed row words, for the "life" effect.
+//
+// A grid is laid out like a PackedFrame row: bit b of word w is cell
+// w * 32 + b, and bits past the grid's width stay clear. A generation
+// works on whole words, 32 cells per operation, instead of counting each
+// cell's neighbours: rows are shifted one cell each way and the
+// neighbour counts are added bit-sliced with full adders, so bit n of
+// each sum word belongs to cell n. Both edges wrap around, making the
+// grid a torus cols wide and FRAME_ROWS high.
+//
+// Rules are Life-like ("B3/S23" and relatives) or Wolfram's elementary
+// rules ("W30", "W110"), which evolve a single row.
+
+typedef struct {
+  uint32_t rows[FRAME_ROWS][FRAME_ROW_WORDS];
+} LifeGrid;
+
+// One generation of a Life-like rule over the whole grid. Bit n of birth
+// (survive) set = a dead (live) cell with n live neighbours is alive next.
+// out must not be in.
+void lifeStep(const LifeGrid& in, LifeGrid& out, uint16_t cols, uint16_t birth, uint16_t survive);
+
+// One generation of an elementary rule: out from in, one row cols wide.
+// A cell's left neighbour is the one to its left on screen (cell + 1, as
+// column 0 of the chain is the rightmost).
+void lifeStepElementary(const uint32_t* in, uint32_t* out, uint16_t cols, uint8_t rule);
+
+// Fill rows [firstRow, FRAME_ROWS) with density percent live cells and
+// clear the rest. Density 0 lights only the middle cell of the last row.
+void lifeSeed(LifeGrid& grid, uint16_t cols, uint8_t density, uint8_t firstRow);
+
+bool lifeEmpty(const LifeGrid& grid);
+uint32_t lifeHash(const LifeGrid& grid);
+
+// Draw the grid into frame columns [firstCol, firstCol + cols)
+void lifeDraw(const LifeGrid& grid, uint16_t firstCol, uint16_t cols);
+
+// "B3/S23" (digits 0-8 in either part, case-insensitive) or "W0".."W255".
+// False, leaving params as they were, if text is neither.
+bool parseLifeRule(const char* text, LifeParams& params);
+void formatLifeRule(const LifeParams& params, char* out, size_t size);
+
+#endif // LIFE_H
@@ -11,9 +11,6 @@
 // Check system memory usage
 void checkSystemMemory(int force);
 
-// Handle system update process
-bool handleUpdateProcess();
-
 // Handle IP display mode
 bool handleIpDisplayMode();
 
@@ -21,25 +18,25 @@ bool handleIpDisplayMode();
 bool checkDisplayActive();
 
 // Validate current item settings
-void validateCurrentItem();
+void validateCurrentItem(DisplayZone& zone);
 
 // Check if it's time to move to the next item
-bool checkForItemTransition();
+bool checkForItemTransition(DisplayZone& zone);
 
 // Process item transition - handles item switching, deletion if needed
-void processItemTransition();
+void processItemTransition(DisplayZone& zone);
 
 // Handle item deletion if needed
-bool handleItemDeletion();
+bool handleItemDeletion(DisplayZone& zone);
 
 // Create a default item when none exist
-void createDefaultItem();
+void createDefaultItem(DisplayZone& zone);
 
 // Move to the next item in the playlist
-void moveToNextItem();
+void moveToNextItem(DisplayZone& zone);
 
 // Handle display mode transition, updating settings as needed
-void handleDisplayModeTransition(const String& oldMode, DisplayItem& newItem);
+void handleDisplayModeTransition(DisplayZone& zone, EffectMode oldMode, DisplayItem& newItem);
 
 // Update display based on current item mode
 void updateDisplayContent();
@@ -47,6 +44,15 @@ void updateDisplayContent();
 // Update text display mode
 void updateTextDisplay(DisplayItem& currentItem);
 
+// Update a bitmap or animation item
+void updateAnimationDisplay(DisplayItem& currentItem);
+
+// Update a layered item (effects and text combined)
+void updateLayeredDisplay(DisplayItem& currentItem);
+
+// Render one frame: update checks, item transitions and display content
+void renderFrame();
+
 // Checks for wifi and api init and runs... only needs to be run once
 void wifi_api_setup();
 
@@ -0,0 +1,60 @@
+#ifndef MAX7219_PACKET_H
+#define MAX7219_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Byte-stream builders for a daisy-chained MAX7219 string. These are pure
+// functions with no Arduino dependencies so the exact bytes a backend puts
+// on the wire can be checked on the host.
+//
+// The chain is one long shift register: the first opcode/data pair clocked
+// out ends up in the device furthest from the controller, so packets are
+// built from the last device down to device 0. Everything is latched when
+// CS goes high at the end of the packet.
+
+// MAX7219 register addresses
+#define MAX7219_OP_NOOP 0x00
+#define MAX7219_OP_DIGIT0 0x01
+#define MAX7219_OP_DECODEMODE 0x09
+#define MAX7219_OP_INTENSITY 0x0A
+#define MAX7219_OP_SCANLIMIT 0x0B
+#define MAX7219_OP_SHUTDOWN 0x0C
+#define MAX7219_OP_DISPLAYTEST 0x0F
+
+static inline uint8_t max7219ReverseBits(uint8_t b) {
+  b = (uint8_t)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+  b = (uint8_t)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+  b = (uint8_t)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+  return b;
+}
+
+// Same opcode and data to every device (init, intensity, shutdown).
+// Writes devices * 2 bytes and returns that count.
+static inline size_t max7219BuildCommand(uint8_t* out, uint8_t devices, uint8_t opcode, uint8_t data) {
+  for (uint8_t i = 0; i < devices; i++) {
+    out[i * 2] = opcode;
+    out[i * 2 + 1] = data;
+  }
+  return (size_t)devices * 2;
+}
+
+// One display row for the whole chain. rowBytes[d] is device d's row in
+// the MD_MAX72XX setRow() orientation; reverseColumns/reverseRows apply the
+// module wiring (FC16 modules have their columns reversed).
+// Writes devices * 2 bytes and returns that count.
+static inline size_t max7219BuildRowPacket(uint8_t* out, uint8_t devices, uint8_t row,
+                                           const uint8_t* rowBytes,
+                                           bool reverseColumns, bool reverseRows) {
+  uint8_t digit = reverseRows ? (uint8_t)(7 - row) : row;
+
+  for (uint8_t i = 0; i < devices; i++) {
+    uint8_t dev = devices - 1 - i;   // Furthest device first
+    uint8_t value = rowBytes[dev];
+    out[i * 2] = (uint8_t)(MAX7219_OP_DIGIT0 + digit);
+    out[i * 2 + 1] = reverseColumns ? max7219ReverseBits(value) : value;
+  }
+  return (size_t)devices * 2;
+}
+
+#endif // MAX7219_PACKET_H
@@ -0,0 +1,66 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "config.h"
+#include <atomic>
+
+// Prometheus metrics served on /metrics. Everything is a fixed-size set of
+// relaxed atomic counters, so the render task, the web server and the
+// main loop can record on their hot paths without locks; the scrape reads
+// them as they are. Histograms keep non-cumulative bucket counts and a
+// microsecond sum that carries into a wrap counter instead of overflowing.
+
+#define METRICS_MAX_BUCKETS 12
+#define METRICS_MAX_ENDPOINTS 40
+#define METRICS_MAX_TIMED_REQUESTS 16
+
+typedef struct {
+  const uint32_t* bounds;                                // Bucket upper bounds in us, ascending
+  uint8_t boundCount;
+  std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1]; // Last one is +Inf
+  std::atomic<uint32_t> count;
+  std::atomic<uint32_t> sumUs;
+  std::atomic<uint32_t> sumWraps;                        // Times sumUs overflowed
+} MetricsHistogram;
+
+typedef struct {
+  const char* path;
+  const char* method;
+  MetricsHistogram latency;      // Request to reply sent; its count is the request count
+} MetricsEndpoint;
+
+typedef struct {
+  MetricsHistogram loopPeriod;   // Render tick to render tick
+  MetricsHistogram renderFrame;  // One frame: commands, drawing and flush
+  MetricsHistogram spiFlush;     // CPU time to hand changed rows to the backend
+  MetricsHistogram configSave;   // Config file write, successful or not
+  std::atomic<uint32_t> itemTransitions;
+  std::atomic<uint32_t> wifiReconnects;
+  std::atomic<uint32_t> spiBytes;       // Since boot, unlike frameStats.bytesSent
+  std::atomic<uint32_t> spiBytesWraps;  // Times spiBytes overflowed
+} Metrics;
+
+extern Metrics metrics;
+
+void initMetrics();
+
+void metricsObserve(MetricsHistogram& histogram, uint32_t us);
+
+// Register an endpoint at setup; returns its slot, or -1 when full
+int metricsRegisterEndpoint(const char* path, uint8_t method);
+void metricsRequestDone(int endpoint, uint32_t us);
+
+static inline void metricsCount(std::atomic<uint32_t>& counter) {
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Add to a byte counter that carries into wraps instead of overflowing
+static inline void metricsAdd(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& wraps, uint32_t n) {
+  uint32_t before = counter.fetch_add(n, std::memory_order_relaxed);
+  if (before + n < before) wraps.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Write every metric in Prometheus text format (version 0.0.4)
+void writeMetrics(Print& out);
+
+#endif // METRICS_H
@@ -0,0 +1,60 @@
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include "config.h"
+
+// Write-behind saving of CONFIG_BINARY_FILE.
+//
+// Changes only mark the config dirty. Once it has been quiet for
+// CONFIG_SAVE_QUIET_MS, or dirty for CONFIG_SAVE_MAX_DELAY_MS through a
+// burst of changes, the render task encodes it (config_binary.h) between
+// frames (it owns the config, so the copy is consistent) and hands that to
+// the main loop task, which does the slow SPIFFS write. A burst of
+// changes costs one write. requestConfigFlush() skips the wait, for
+// /flush and before a reboot; configDirty() tells when it is done. Single-item changes skip all that: their change log
+// records (config_log.h) are appended by the next pump.
+
+typedef struct {
+  unsigned long requests;       // Saves asked for
+  unsigned long snapshots;      // Encoded by the render task
+  unsigned long writes;         // Full config files written
+  unsigned long failures;
+  unsigned long flushes;        // Explicit flushes
+  unsigned long bytesWritten;   // Config files and log records
+  uint32_t lastSnapshotUs;      // Render task time to encode
+  uint32_t maxSnapshotUs;
+  unsigned long lastWriteMs;    // millis() of the last write, 0 = none yet
+} PersistStats;
+
+extern PersistStats persistStats;
+
+// Create the change log lock; call before the render task starts
+void initPersistence();
+
+// Mark the config as changed; any task
+void requestConfigSave();
+
+// Render task: queue an encoded change log record for the main loop
+void queueLogRecord(const uint8_t* data, size_t length);
+
+// Render task, once per frame: hand over a snapshot when a save is due
+void persistTick();
+
+// Main loop: write a snapshot the render task handed over, then queued
+// change log records
+void pumpPersistence();
+
+// How long the main loop may wait before pumpPersistence() is due again
+uint32_t persistPollMs();
+
+// Save at the next frame rather than after the delay; any task. Returns
+// at once: the write is done once configDirty() is false.
+void requestConfigFlush();
+
+// Drop pending and future saves (factory reset is deleting the file)
+void stopConfigSaves();
+
+// Any change not yet written
+bool configDirty();
+
+#endif // PERSISTENCE_H
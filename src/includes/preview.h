@@ -0,0 +1,48 @@
+#ifndef PREVIEW_H
+#define PREVIEW_H
+
+#include "framebuffer.h"
+
+// Remote preview of what the chain is showing.
+//
+// The render task captures the frame at most PREVIEW_MAX_FPS times a
+// second into a seqlocked snapshot. The main loop task sends it to each
+// /preview WebSocket client at the rate that client asked for
+// (?fps=N on connect, or a text message "N" later) as binary packets in
+// the realtime format (realtime_packet.h): a full frame first, then deltas
+// of the changed rows, and nothing at all while the frame is unchanged.
+// Clients that are still busy with the last packet skip frames rather
+// than queueing them.
+//
+// GET /snapshot returns one frame as PBM (lit = 1) or PNG (lit = white),
+// optionally scaled up.
+
+#define PREVIEW_MAX_CLIENTS 4
+#define PREVIEW_MAX_FPS 25
+#define PREVIEW_DEFAULT_FPS 10
+
+typedef struct {
+  uint32_t clients;
+  unsigned long captures;      // Frames snapshotted by the render task
+  unsigned long framesSent;    // Packets sent, all clients
+  unsigned long fullFrames;    // ...of which were full frames
+  unsigned long bytesSent;
+  unsigned long skippedBusy;   // Frames a client was too busy to take
+  unsigned long snapshots;     // /snapshot requests served
+} PreviewStats;
+
+extern PreviewStats previewStats;
+
+// Register /preview and /snapshot
+void setupPreview(AsyncWebServer& server);
+
+// Render task, once per frame after the chain is updated
+void previewCapture();
+
+// Main loop: send due frames to preview clients
+void pumpPreview();
+
+// How long the main loop may wait before pumpPreview() is due again
+uint32_t previewPollMs();
+
+#endif // PREVIEW_H
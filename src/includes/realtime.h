@@ -0,0 +1,44 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include "config.h"
+#include "framebuffer.h"
+#include "realtime_packet.h"
+
+// Realtime streaming: frames sent to REALTIME_UDP_PORT (format in
+// realtime_packet.h) go straight to the chain, taking over from the
+// playlist. The playlist resumes once no packet has arrived for
+// config.realtimeTimeout ms, or at once when the sender releases.
+//
+// The UDP task assembles frames into a triple buffer and the render task
+// takes the newest one each tick, so neither side waits on the other and
+// nothing is allocated per packet. A frame that arrives before the last
+// one was shown replaces it.
+
+typedef struct {
+  unsigned long packets;        // Datagrams received
+  unsigned long frames;         // Full frames accepted
+  unsigned long deltas;         // Delta frames applied
+  unsigned long lost;           // Sequence numbers skipped by the stream
+  unsigned long outOfOrder;     // Late or duplicate frames, dropped
+  unsigned long staleDeltas;    // Deltas against a frame we do not have, dropped
+  unsigned long badPackets;     // Wrong magic, type or length
+  unsigned long overwritten;    // Frames replaced before the render task took them
+  unsigned long shown;          // Frames pushed to the chain
+  uint32_t lastLatencyUs;       // Packet received to frame flushed
+  uint32_t maxLatencyUs;
+  uint16_t lastSeq;
+  bool active;                  // Stream currently owns the display
+} RealtimeStats;
+
+extern RealtimeStats realtimeStats;
+
+// Start listening (no-op unless REALTIME_UDP_ENABLED). Call once WiFi is up.
+void initRealtime();
+
+// Render task: if a stream is live, flush its newest frame and return
+// true so the playlist is skipped this tick. Hands back to the playlist
+// when the stream times out or is released.
+bool realtimeRender();
+
+#endif // REALTIME_H
@@ -0,0 +1,167 @@
+#ifndef REALTIME_PACKET_H
+#define REALTIME_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Wire format of the realtime UDP stream, also used for the /preview
+// WebSocket. Pure functions with no Arduino dependencies, so
+// tools/realtime_sender.py and the firmware can be checked against the
+// same layout on the host.
+//
+// Every datagram starts with a 12-byte header (little-endian):
+//   0   "LR"
+//   2   u8   type (RealtimePacketType)
+//   3   u8   flags (REALTIME_FLAG_*)
+//   4   u16  sequence number, +1 per frame, wrapping
+//   6   u16  base sequence (delta frames: the frame the delta applies to)
+//   8   u32  sender timestamp, echoed back untouched in acks
+//
+// Payloads:
+//   FULL     rows * devices bytes, row-major. Byte d of row r is device d's
+//            digit register for that row: bit n = frame column d * 8 + n.
+//   DELTA    u8 row mask, then devices bytes for each row whose bit is set
+//            (lowest row first). Rows not in the mask are unchanged.
+//   RELEASE  empty: stop streaming and go back to the playlist now.
+//
+// An ack is the request's 12-byte header with magic "LA" and the same
+// type, sequence and timestamp; it is only sent when REALTIME_FLAG_ACK is set.
+
+#define REALTIME_HEADER_BYTES 12
+#define REALTIME_MAGIC_0 'L'
+#define REALTIME_MAGIC_1 'R'
+#define REALTIME_ACK_MAGIC_1 'A'
+
+#define REALTIME_FLAG_ACK 0x01   // Reply with an ack (loss/latency tests)
+
+enum RealtimePacketType {
+  REALTIME_PACKET_FULL,
+  REALTIME_PACKET_DELTA,
+  REALTIME_PACKET_RELEASE
+};
+
+typedef struct {
+  uint8_t type;
+  uint8_t flags;
+  uint16_t seq;
+  uint16_t baseSeq;
+  uint32_t timestamp;
+  const uint8_t* payload;
+  size_t payloadLength;
+} RealtimePacket;
+
+static inline uint16_t realtimeRead16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t realtimeRead32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint8_t realtimePopCount(uint8_t b) {
+  uint8_t n = 0;
+  for (; b; b &= (uint8_t)(b - 1)) n++;
+  return n;
+}
+
+// Check the header and that the payload has the size its type needs for a
+// chain of `devices` devices. The payload is not copied.
+static inline bool realtimeParse(const uint8_t* data, size_t length, uint8_t devices,
+                                 RealtimePacket& packet) {
+  if (length < REALTIME_HEADER_BYTES) return false;
+  if (data[0] != REALTIME_MAGIC_0 || data[1] != REALTIME_MAGIC_1) return false;
+
+  packet.type = data[2];
+  packet.flags = data[3];
+  packet.seq = realtimeRead16(data + 4);
+  packet.baseSeq = realtimeRead16(data + 6);
+  packet.timestamp = realtimeRead32(data + 8);
+  packet.payload = data + REALTIME_HEADER_BYTES;
+  packet.payloadLength = length - REALTIME_HEADER_BYTES;
+
+  switch (packet.type) {
+    case REALTIME_PACKET_FULL:
+      return packet.payloadLength == (size_t)8 * devices;
+    case REALTIME_PACKET_DELTA:
+      return packet.payloadLength >= 1 &&
+             packet.payloadLength == 1 + (size_t)realtimePopCount(packet.payload[0]) * devices;
+    case REALTIME_PACKET_RELEASE:
+      return packet.payloadLength == 0;
+    default:
+      return false;
+  }
+}
+
+// Frames missing between `last` and `seq`: 0 when in order, negative when
+// seq is a duplicate or arrived late (up to half the sequence space behind)
+static inline int32_t realtimeSeqGap(uint16_t last, uint16_t seq) {
+  int16_t diff = (int16_t)(uint16_t)(seq - last);
+  return diff - 1;
+}
+
+// Apply a parsed FULL or DELTA payload to a row-major frame whose rows are
+// rowStride bytes apart (the first `devices` bytes of each row are used)
+static inline void realtimeApply(const RealtimePacket& packet, uint8_t* rows, size_t rowStride,
+                                 uint8_t devices) {
+  if (packet.type == REALTIME_PACKET_FULL) {
+    for (uint8_t row = 0; row < 8; row++) {
+      memcpy(rows + row * rowStride, packet.payload + row * devices, devices);
+    }
+    return;
+  }
+
+  uint8_t mask = packet.payload[0];
+  const uint8_t* src = packet.payload + 1;
+  for (uint8_t row = 0; row < 8; row++) {
+    if (!(mask & (1 << row))) continue;
+    memcpy(rows + row * rowStride, src, devices);
+    src += devices;
+  }
+}
+
+// Build the packet that turns `previous` into `rows` (both row-major,
+// rowStride apart): a DELTA of the changed rows, or a FULL frame when
+// previous is NULL or the delta would not be smaller. out needs
+// REALTIME_HEADER_BYTES + 8 * devices bytes. Returns the packet length,
+// or 0 if nothing changed.
+static inline size_t realtimeEncode(uint8_t* out, const uint8_t* rows, const uint8_t* previous,
+                                    size_t rowStride, uint8_t devices, uint16_t seq,
+                                    uint32_t timestamp) {
+  uint8_t mask = 0;
+  if (previous != NULL) {
+    for (uint8_t row = 0; row < 8; row++) {
+      if (memcmp(rows + row * rowStride, previous + row * rowStride, devices) != 0) mask |= 1 << row;
+    }
+    if (mask == 0) return 0;
+  }
+
+  bool full = previous == NULL || 1 + (size_t)realtimePopCount(mask) * devices >= (size_t)8 * devices;
+  uint16_t base = full ? seq : (uint16_t)(seq - 1);
+
+  out[0] = REALTIME_MAGIC_0;
+  out[1] = REALTIME_MAGIC_1;
+  out[2] = full ? REALTIME_PACKET_FULL : REALTIME_PACKET_DELTA;
+  out[3] = 0;
+  out[4] = seq & 0xFF;
+  out[5] = seq >> 8;
+  out[6] = base & 0xFF;
+  out[7] = base >> 8;
+  for (uint8_t i = 0; i < 4; i++) out[8 + i] = (timestamp >> (8 * i)) & 0xFF;
+
+  uint8_t* dst = out + REALTIME_HEADER_BYTES;
+  if (!full) *dst++ = mask;
+  for (uint8_t row = 0; row < 8; row++) {
+    if (!full && !(mask & (1 << row))) continue;
+    memcpy(dst, rows + row * rowStride, devices);
+    dst += devices;
+  }
+  return dst - out;
+}
+
+// Turn a request header into its ack in place (first 12 bytes only)
+static inline void realtimeMakeAck(uint8_t* header) {
+  header[1] = REALTIME_ACK_MAGIC_1;
+}
+
+#endif // REALTIME_PACKET_H
@@ -0,0 +1,41 @@
+#ifndef RENDER_TASK_H
+#define RENDER_TASK_H
+
+#include "config.h"
+
+#define RENDER_COMMAND_TEXT_LEN 96
+
+// Requests from the web layer to the render task, which owns the display
+enum RenderCommandType {
+  RENDER_CMD_RELOAD_ITEM,   // Current item (or its settings) changed: reapply and redraw
+  RENDER_CMD_SHOW_IP,       // Scroll the connection info for IP_DISPLAY_DURATION
+  RENDER_CMD_SHOW_MESSAGE,  // Show a static message (e.g. before a reboot)
+  RENDER_CMD_EDIT_CONFIG    // Run a config edit from the API (see config_edit.h)
+};
+
+typedef struct {
+  RenderCommandType type;
+  unsigned long postedUs;               // When the command was queued, for latency stats
+  char text[RENDER_COMMAND_TEXT_LEN];   // Message for SHOW_IP / SHOW_MESSAGE
+  uint8_t edit;                         // Config edit slot for EDIT_CONFIG
+} RenderCommand;
+
+typedef struct {
+  unsigned long commandsApplied;
+  unsigned long commandsDropped;        // Queue was full when posting
+  uint32_t lastCommandLatencyUs;        // Post-to-apply delay of the last command
+  uint32_t maxCommandLatencyUs;
+  uint8_t core;                         // Core the render task runs on
+  uint32_t stackHighWater;              // Unused stack (bytes) at last check
+} RenderTaskStats;
+
+extern RenderTaskStats renderTaskStats;
+
+// Start the render task pinned to RENDER_TASK_CORE
+void startRenderTask();
+
+// Queue a command for the render task. Single producer: only the web
+// server task may call these. Returns false if the queue is full.
+bool postRenderCommand(RenderCommandType type, const char* text = NULL, uint8_t edit = 0);
+
+#endif // RENDER_TASK_H
@@ -0,0 +1,74 @@
+#ifndef REQUEST_BODY_H
+#define REQUEST_BODY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Reassembly of request bodies that the web server hands over in chunks.
+//
+// ESPAsyncWebServer calls a body handler once per TCP segment with the
+// chunk's offset (index) and the Content-Length (total), so a JSON body
+// of more than one segment must be put back together before it is parsed.
+// The buffer is sized to Content-Length on the first chunk, refused
+// outright when that is over the limit, and kept in the request's
+// _tempObject, which the server frees with the request if it is abandoned.
+// Pure functions with no Arduino dependencies so they can be checked on
+// the host.
+
+enum RequestBodyResult {
+  REQUEST_BODY_PENDING,    // Chunk stored, more to come
+  REQUEST_BODY_COMPLETE,   // Whole body is in the buffer
+  REQUEST_BODY_IGNORED,    // Chunk of a body that was refused earlier
+  REQUEST_BODY_TOO_LARGE,  // Content-Length is over the limit
+  REQUEST_BODY_NO_MEMORY,  // Could not allocate Content-Length bytes
+  REQUEST_BODY_BAD_CHUNK   // Chunk does not continue the body
+};
+
+typedef struct {
+  size_t received;
+  size_t total;
+  // total + 1 bytes of body follow, NUL-terminated once complete
+} RequestBody;
+
+static inline char* requestBodyData(void* slot) {
+  return (char*)((RequestBody*)slot + 1);
+}
+
+static inline void requestBodyRelease(void** slot) {
+  free(*slot);
+  *slot = NULL;
+}
+
+// Add one chunk to the body kept in *slot (NULL before the first chunk)
+static inline RequestBodyResult requestBodyAppend(void** slot, const uint8_t* data, size_t len,
+                                                  size_t index, size_t total, size_t maxBytes) {
+  if (index == 0) {
+    requestBodyRelease(slot);
+    if (total > maxBytes) return REQUEST_BODY_TOO_LARGE;
+
+    RequestBody* body = (RequestBody*)malloc(sizeof(RequestBody) + total + 1);
+    if (body == NULL) return REQUEST_BODY_NO_MEMORY;
+    body->received = 0;
+    body->total = total;
+    *slot = body;
+  }
+
+  RequestBody* body = (RequestBody*)*slot;
+  if (body == NULL) return REQUEST_BODY_IGNORED;
+
+  if (index != body->received || total != body->total || len > total - index) {
+    requestBodyRelease(slot);
+    return REQUEST_BODY_BAD_CHUNK;
+  }
+
+  memcpy(requestBodyData(body) + index, data, len);
+  body->received += len;
+  if (body->received < total) return REQUEST_BODY_PENDING;
+
+  requestBodyData(body)[total] = '\0';
+  return REQUEST_BODY_COMPLETE;
+}
+
+#endif // REQUEST_BODY_H
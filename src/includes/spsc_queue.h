@@ -0,0 +1,50 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring buffer.
+// Exactly one task may call push() and exactly one (other) task may call
+// pop(); neither side ever blocks. Capacity must be a power of two, and
+// one slot is kept free to tell a full queue from an empty one.
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+ public:
+  SpscQueue() : head(0), tail(0) {}
+
+  // Producer side. Returns false (and drops the item) when the queue is full.
+  bool push(const T& item) {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t next = (h + 1) & (Capacity - 1);
+    if (next == tail.load(std::memory_order_acquire)) return false;
+
+    slots[h] = item;
+    head.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false when there is nothing to read.
+  bool pop(T& item) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+
+    item = slots[t];
+    tail.store((t + 1) & (Capacity - 1), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+  }
+
+ private:
+  T slots[Capacity];
+  std::atomic<size_t> head;  // Next slot the producer writes
+  std::atomic<size_t> tail;  // Next slot the consumer reads
+};
+
+#endif // SPSC_QUEUE_H
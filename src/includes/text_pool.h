@@ -0,0 +1,70 @@
+#ifndef TEXT_POOL_H
+#define TEXT_POOL_H
+
+#include <Arduino.h>
+
+// Pooled storage for item text and frame file names.
+//
+// A String member costs every item its object plus, once set, a heap
+// block of its own with the allocator's header and spare capacity. Pooled
+// strings are packed back to back into TEXT_POOL_PAGE_BYTES pages and an
+// item keeps a pointer. Strings are immutable and reference counted, so
+// copying an item (the API edits copies) shares its text. A page is freed
+// with its last string, except the newest page, which is rewound and
+// filled again. A string too long for a page gets a page of its own.
+//
+// Any task may store or drop strings: page bookkeeping is under a mutex,
+// reference counts are atomic, and the bytes of a live string never move.
+
+struct TextEntry;
+
+typedef struct {
+  uint16_t pages;
+  uint32_t bytes;               // Pages allocated, headers included
+  uint32_t strings;             // Live strings
+  uint32_t textBytes;           // Their characters
+  unsigned long storeFailures;  // Out of memory; the text was dropped
+} TextPoolStats;
+
+extern TextPoolStats textPoolStats;
+
+// Boot, before any text is stored
+void initTextPool();
+
+// Copy data into the pool with one reference. NULL (the empty string) if
+// length is 0 or there is no memory.
+TextEntry* textPoolStore(const char* data, size_t length);
+void textPoolRetain(TextEntry* entry);
+void textPoolRelease(TextEntry* entry);
+
+// NUL-terminated; "" for NULL
+const char* textPoolData(const TextEntry* entry);
+size_t textPoolLength(const TextEntry* entry);
+
+// A reference to a pooled string, read like a String
+class PooledText {
+ public:
+  PooledText() : entry(NULL) {}
+  PooledText(const PooledText& other) : entry(other.entry) { textPoolRetain(entry); }
+  PooledText(PooledText&& other) : entry(other.entry) { other.entry = NULL; }
+  ~PooledText() { textPoolRelease(entry); }
+
+  PooledText& operator=(const PooledText& other);
+  PooledText& operator=(PooledText&& other);
+  PooledText& operator=(const String& value) { set(value.c_str(), value.length()); return *this; }
+  PooledText& operator=(const char* value) { set(value, value ? strlen(value) : 0); return *this; }
+  void set(const char* data, size_t length);
+
+  const char* c_str() const { return textPoolData(entry); }
+  size_t length() const { return textPoolLength(entry); }
+  String str() const { return String(c_str()); }
+
+  bool operator==(const PooledText& other) const;
+  bool operator==(const char* other) const;
+  bool operator!=(const PooledText& other) const { return !(*this == other); }
+
+ private:
+  TextEntry* entry;
+};
+
+#endif // TEXT_POOL_H
@@ -0,0 +1,41 @@
+#ifndef TEXT_RASTER_H
+#define TEXT_RASTER_H
+
+#include "framebuffer.h"
+#include "text_pool.h"
+#include <vector>
+
+// Text items are rasterized once, when they become current or their text
+// changes, into one byte per column (bit r = row r) using the font atlas
+// and Parola's character spacing. Each frame then copies a window of that
+// strip into the frame buffer, so the cost per frame does not depend on
+// text length.
+
+typedef struct {
+  unsigned long rasters;      // Texts rasterized
+  unsigned long cacheHits;    // Reloads that found the text already rasterized
+  uint32_t lastRasterUs;      // Time taken by the most recent rasterization
+  uint16_t width;             // Columns in the current raster
+  size_t bytes;               // Memory held by the current raster
+} TextRasterStats;
+
+// A rasterized text and its scroll clock (one per zone)
+typedef struct {
+  std::vector<uint8_t> columns;   // One byte per column of the text
+  PooledText text;                // Text the raster was built from (shares the item's)
+  bool valid;
+  unsigned long scrollStartTime;
+} TextRaster;
+
+extern TextRasterStats textRasterStats;
+
+// Make the item's text the raster's content and restart its scroll.
+// Records raster time and size on the item.
+void textRasterPrepare(TextRaster& raster, DisplayItem& item);
+
+// Draw this frame's window of the raster into frame columns
+// [firstCol, firstCol + cols), leaving the rest of the frame alone
+void textRasterDraw(const TextRaster& raster, const DisplayItem& item,
+                    uint16_t firstCol = 0, uint16_t cols = FRAME_COLS);
+
+#endif // TEXT_RASTER_H
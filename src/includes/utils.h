@@ -1,8 +1,13 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdint.h>
+#include <stddef.h>
 
 void delayWithWatchdog(unsigned long delayTime);
 
+// CRC-32 (zlib/PNG polynomial); pass 0 to start, the last result to continue
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef ZONES_H
+#define ZONES_H
+
+#include "config.h"
+#include "effects.h"
+#include "text_raster.h"
+#include "compositor.h"
+#include "animation.h"
+
+// Display zones: the chain split into column ranges, each running its own
+// playlist. Zone 0 is the primary config (config.items and friends); the
+// rest come from config.zones. Every zone draws into its columns of one
+// shared frame, which is flushed (or plane-cycled) once per tick.
+
+#define MAX_ZONES 4
+
+// Render state that is not persisted, one per zone
+typedef struct {
+  EffectInstance effects;
+  TextRaster text;
+  LayerBuffers layers;
+  AnimationPlayer animation;
+  EffectMode activeMode = MODE_UNKNOWN;   // Mode the zone was last set up for
+  uint16_t firstCol;      // Frame columns it was set up for
+  uint16_t cols;
+  bool reload;            // Set up the current item again on the next frame
+} ZoneRuntime;
+
+// Zones in use: the primary one plus config.zones, capped at MAX_ZONES
+uint8_t zoneCount();
+
+// Zone 0 is config itself
+DisplayZone& zoneAt(uint8_t index);
+ZoneRuntime* zoneRuntime(uint8_t index);
+
+// Index of a zone, or -1 if it is not one of the active zones
+int zoneIndexOf(const DisplayZone& zone);
+
+// Clamp a zone's columns to the chain; width 0 means "to the right end"
+void sanitizeZone(DisplayZone& zone);
+
+// First frame column of a zone (frame column 0 is the rightmost on screen)
+uint16_t zoneFirstCol(const DisplayZone& zone);
+
+// Render one frame of every zone and commit it to the chain
+void renderZones();
+
+#endif // ZONES_H
@@ -0,0 +1,99 @@
+#include "includes/item_index.h"
+#include "includes/zones.h"
+#include <esp_timer.h>
+
+// Initialize global variables
+ItemIndexStats itemIndexStats;
+
+typedef struct {
+  uint32_t id;       // 0 = empty
+  uint8_t zone;
+  uint16_t slot;
+} ItemIndexEntry;
+
+static std::vector<ItemIndexEntry> table;
+static uint8_t tableBits = 0;
+static bool valid = false;
+
+// Fibonacci hashing: IDs are sequential, the multiply spreads them
+static inline uint32_t bucketOf(uint32_t id) {
+  return (uint32_t)(id * 2654435769u) >> (32 - tableBits);
+}
+
+static void rebuild() {
+  int64_t start = esp_timer_get_time();
+  size_t items = 0;
+  for (uint8_t zone = 0; zone < zoneCount(); zone++) items += zoneAt(zone).items.size();
+
+  // At most half full
+  tableBits = 4;
+  while ((1UL << tableBits) < items * 2) tableBits++;
+  table.assign(1UL << tableBits, ItemIndexEntry{0, 0, 0});
+
+  uint32_t mask = (1UL << tableBits) - 1;
+  uint8_t maxProbe = 0;
+  for (uint8_t zone = 0; zone < zoneCount(); zone++) {
+    const std::vector<DisplayItem>& list = zoneAt(zone).items;
+    for (size_t slot = 0; slot < list.size(); slot++) {
+      uint32_t id = list[slot].id;
+      if (id == 0) continue;
+      uint32_t bucket = bucketOf(id);
+      uint8_t probe = 1;
+      while (table[bucket].id != 0 && table[bucket].id != id) {
+        bucket = (bucket + 1) & mask;
+        probe++;
+      }
+      if (table[bucket].id == id) continue;   // Duplicate ID: the first one wins
+      table[bucket] = ItemIndexEntry{id, zone, (uint16_t)slot};
+      if (probe > maxProbe) maxProbe = probe;
+    }
+  }
+
+  valid = true;
+  itemIndexStats.rebuilds++;
+  itemIndexStats.capacity = table.size();
+  itemIndexStats.items = items;
+  itemIndexStats.maxProbe = maxProbe;
+  itemIndexStats.lastRebuildUs = (uint32_t)(esp_timer_get_time() - start);
+}
+
+// Probe for id; the entry, or NULL once an empty bucket shows it is absent
+static const ItemIndexEntry* probe(uint32_t id) {
+  uint32_t mask = (1UL << tableBits) - 1;
+  for (uint32_t bucket = bucketOf(id), n = 0; n <= mask; bucket = (bucket + 1) & mask, n++) {
+    if (table[bucket].id == id) return &table[bucket];
+    if (table[bucket].id == 0) return NULL;
+  }
+  return NULL;
+}
+
+DisplayItem* findItemById(uint32_t id, uint8_t* zone, uint16_t* slot) {
+  itemIndexStats.lookups++;
+  if (id == 0) {
+    itemIndexStats.misses++;
+    return NULL;
+  }
+
+  for (uint8_t attempt = 0; attempt < 2; attempt++) {
+    if (!valid) rebuild();
+
+    const ItemIndexEntry* entry = probe(id);
+    if (entry != NULL && entry->zone < zoneCount()) {
+      std::vector<DisplayItem>& list = zoneAt(entry->zone).items;
+      if (entry->slot < list.size() && list[entry->slot].id == id) {
+        if (zone) *zone = entry->zone;
+        if (slot) *slot = entry->slot;
+        return &list[entry->slot];
+      }
+    }
+    if (entry == NULL && attempt == 0 && valid) break;   // A current index is sure of a miss
+    valid = false;   // Stale entry: rebuild and look again
+  }
+
+  itemIndexStats.misses++;
+  return NULL;
+}
+
+void invalidateItemIndex() {
+  valid = false;
+}
@@ -0,0 +1,246 @@
+#include "includes/life.h"
+
+// Bits of each row word inside a grid cols wide
+static inline void wordMasks(uint16_t cols, uint32_t mask[FRAME_ROW_WORDS]) {
+  for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+    int32_t bits = (int32_t)cols - w * 32;
+    mask[w] = bits >= 32 ? 0xFFFFFFFFUL : (bits > 0 ? (1UL << bits) - 1 : 0);
+  }
+}
+
+// Cell c - 1 at bit c; cell 0 gets the last cell
+static inline void shiftPrev(const uint32_t* in, uint32_t* out, uint16_t cols, const uint32_t* mask) {
+  uint16_t last = cols - 1;
+  uint32_t carry = (in[last / 32] >> (last % 32)) & 1;
+  for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+    out[w] = ((in[w] << 1) | carry) & mask[w];
+    carry = in[w] >> 31;
+  }
+}
+
+// Cell c + 1 at bit c; the last cell gets cell 0. Bits past the width are
+// clear in in, so nothing shifts down into the last cell but the wrap.
+static inline void shiftNext(const uint32_t* in, uint32_t* out, uint16_t cols) {
+  uint16_t last = cols - 1;
+  for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+    uint32_t above = (w + 1 < FRAME_ROW_WORDS) ? in[w + 1] : 0;
+    out[w] = (in[w] >> 1) | (above << 31);
+  }
+  out[last / 32] |= (in[0] & 1) << (last % 32);
+}
+
+void lifeStep(const LifeGrid& in, LifeGrid& out, uint16_t cols, uint16_t birth, uint16_t survive) {
+  if (cols == 0 || cols > FRAME_COLS) return;
+
+  uint32_t mask[FRAME_ROW_WORDS];
+  wordMasks(cols, mask);
+
+  // Each row's cells summed with their left and right neighbours, 0-3 as
+  // two bit planes
+  uint32_t sum0[FRAME_ROWS][FRAME_ROW_WORDS];
+  uint32_t sum1[FRAME_ROWS][FRAME_ROW_WORDS];
+  for (uint8_t r = 0; r < FRAME_ROWS; r++) {
+    uint32_t prev[FRAME_ROW_WORDS], next[FRAME_ROW_WORDS];
+    shiftPrev(in.rows[r], prev, cols, mask);
+    shiftNext(in.rows[r], next, cols);
+    for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+      uint32_t a = prev[w], b = in.rows[r][w], c = next[w];
+      sum0[r][w] = a ^ b ^ c;
+      sum1[r][w] = (a & b) | (c & (a ^ b));
+    }
+  }
+
+  // Adding three rows of those gives the 3x3 block count, 0-9, cell
+  // included. A live cell has one neighbour fewer than its block count,
+  // so it survives on survive bit (count - 1). Only the counts the rule
+  // uses are tested: B3/S23 is counts 3 and 4.
+  uint16_t liveCounts = (survive << 1) & 0x3FF;
+  uint16_t deadCounts = birth & 0x1FF;
+  uint32_t countBits[10][4];   // Per count: the value of each sum plane, all ones or zero
+  uint32_t liveSel[10], deadSel[10];
+  uint8_t terms = 0;
+  for (uint8_t count = 0; count < 10; count++) {
+    if (((liveCounts | deadCounts) & (1 << count)) == 0) continue;
+    for (uint8_t bit = 0; bit < 4; bit++) countBits[terms][bit] = (count & (1 << bit)) ? 0xFFFFFFFFUL : 0;
+    liveSel[terms] = (liveCounts & (1 << count)) ? 0xFFFFFFFFUL : 0;
+    deadSel[terms] = (deadCounts & (1 << count)) ? 0xFFFFFFFFUL : 0;
+    terms++;
+  }
+
+  for (uint8_t r = 0; r < FRAME_ROWS; r++) {
+    uint8_t above = (r + FRAME_ROWS - 1) % FRAME_ROWS;
+    uint8_t below = (r + 1) % FRAME_ROWS;
+    for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+      uint32_t x0 = sum0[above][w], y0 = sum0[r][w], z0 = sum0[below][w];
+      uint32_t x1 = sum1[above][w], y1 = sum1[r][w], z1 = sum1[below][w];
+
+      // Ones, and the carry into the twos
+      uint32_t s0 = x0 ^ y0 ^ z0;
+      uint32_t carry = (x0 & y0) | (z0 & (x0 ^ y0));
+      // Twos: three planes and the carry, up to four twos
+      uint32_t twos = x1 ^ y1 ^ z1;
+      uint32_t fours = (x1 & y1) | (z1 & (x1 ^ y1));
+      uint32_t s1 = twos ^ carry;
+      uint32_t moreFours = twos & carry;
+      uint32_t s2 = fours ^ moreFours;
+      uint32_t s3 = fours & moreFours;
+
+      uint32_t cell = in.rows[r][w];
+      uint32_t alive = 0;
+      for (uint8_t t = 0; t < terms; t++) {
+        uint32_t is = ~((s0 ^ countBits[t][0]) | (s1 ^ countBits[t][1]) |
+                        (s2 ^ countBits[t][2]) | (s3 ^ countBits[t][3]));
+        alive |= is & ((cell & liveSel[t]) | (~cell & deadSel[t]));
+      }
+      out.rows[r][w] = alive & mask[w];
+    }
+  }
+}
+
+void lifeStepElementary(const uint32_t* in, uint32_t* out, uint16_t cols, uint8_t rule) {
+  if (cols == 0 || cols > FRAME_COLS) return;
+
+  uint32_t mask[FRAME_ROW_WORDS];
+  wordMasks(cols, mask);
+  uint32_t right[FRAME_ROW_WORDS], left[FRAME_ROW_WORDS];
+  shiftPrev(in, right, cols, mask);
+  shiftNext(in, left, cols);
+
+  // The rule's output for neighbourhood (left, cell, right) = n is bit n.
+  // Select it with a tree of muxes on right, then cell, then left.
+  uint32_t out0[8];
+  for (uint8_t n = 0; n < 8; n++) out0[n] = (rule & (1 << n)) ? 0xFFFFFFFFUL : 0;
+
+  for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+    uint32_t l = left[w], c = in[w], r = right[w];
+    uint32_t a0 = (r & out0[1]) | (~r & out0[0]);
+    uint32_t a1 = (r & out0[3]) | (~r & out0[2]);
+    uint32_t a2 = (r & out0[5]) | (~r & out0[4]);
+    uint32_t a3 = (r & out0[7]) | (~r & out0[6]);
+    uint32_t b0 = (c & a1) | (~c & a0);
+    uint32_t b1 = (c & a3) | (~c & a2);
+    out[w] = ((l & b1) | (~l & b0)) & mask[w];
+  }
+}
+
+void lifeSeed(LifeGrid& grid, uint16_t cols, uint8_t density, uint8_t firstRow) {
+  memset(&grid, 0, sizeof(grid));
+  if (cols == 0 || cols > FRAME_COLS) return;
+
+  if (density == 0) {
+    uint16_t middle = cols / 2;
+    grid.rows[FRAME_ROWS - 1][middle / 32] = 1UL << (middle % 32);
+    return;
+  }
+  for (uint8_t r = firstRow; r < FRAME_ROWS; r++) {
+    for (uint16_t col = 0; col < cols; col++) {
+      if (random(100) < density) grid.rows[r][col / 32] |= 1UL << (col % 32);
+    }
+  }
+}
+
+bool lifeEmpty(const LifeGrid& grid) {
+  const uint32_t* words = &grid.rows[0][0];
+  uint32_t any = 0;
+  for (size_t i = 0; i < FRAME_ROWS * FRAME_ROW_WORDS; i++) any |= words[i];
+  return any == 0;
+}
+
+// FNV-1a over the words
+uint32_t lifeHash(const LifeGrid& grid) {
+  const uint32_t* words = &grid.rows[0][0];
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < FRAME_ROWS * FRAME_ROW_WORDS; i++) {
+    hash = (hash ^ words[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+// Cells [first, first + 8) of a row; cells outside the grid are dead
+static inline uint8_t rowByte(const uint32_t* row, int32_t first) {
+  if (first < 0) return (uint8_t)(row[0] << -first);
+  uint8_t w = first / 32;
+  if (w >= FRAME_ROW_WORDS) return 0;
+  uint64_t window = row[w];
+  if (w + 1 < FRAME_ROW_WORDS) window |= (uint64_t)row[w + 1] << 32;
+  return (uint8_t)(window >> (first % 32));
+}
+
+void lifeDraw(const LifeGrid& grid, uint16_t firstCol, uint16_t cols) {
+  if (firstCol >= FRAME_COLS || cols == 0) return;
+  if (firstCol + cols > FRAME_COLS) cols = FRAME_COLS - firstCol;
+  uint16_t endCol = firstCol + cols;
+
+  for (uint8_t dev = firstCol / 8; dev <= (endCol - 1) / 8; dev++) {
+    // Bits of this device inside the zone
+    uint8_t zone = 0xFF;
+    if (dev * 8 < firstCol) zone &= 0xFF << (firstCol - dev * 8);
+    if (dev * 8 + 8 > endCol) zone &= 0xFF >> (dev * 8 + 8 - endCol);
+
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      uint8_t cells = rowByte(grid.rows[row], (int32_t)dev * 8 - firstCol);
+      fbSetRowByte(row, dev, (fbGetRowByte(row, dev) & ~zone) | (cells & zone));
+    }
+  }
+}
+
+bool parseLifeRule(const char* text, LifeParams& params) {
+  if (text == NULL) return false;
+
+  if (*text == 'W' || *text == 'w') {
+    char* end;
+    long rule = strtol(text + 1, &end, 10);
+    if (end == text + 1 || *end != '\0' || rule < 0 || rule > 255) return false;
+    params.elementary = true;
+    params.wolfram = rule;
+    return true;
+  }
+
+  uint16_t birth = 0, survive = 0;
+  uint16_t* part = NULL;
+  bool sawBirth = false, sawSurvive = false;
+  for (const char* p = text; *p; p++) {
+    char c = toupper(*p);
+    if (c == 'B' && !sawBirth) {
+      part = &birth;
+      sawBirth = true;
+    } else if (c == 'S' && !sawSurvive) {
+      part = &survive;
+      sawSurvive = true;
+    } else if (c == '/' && part != NULL) {
+      part = NULL;
+    } else if (c >= '0' && c <= '8' && part != NULL) {
+      *part |= 1 << (c - '0');
+    } else {
+      return false;
+    }
+  }
+  if (!sawBirth || !sawSurvive) return false;
+
+  params.elementary = false;
+  params.birth = birth;
+  params.survive = survive;
+  return true;
+}
+
+void formatLifeRule(const LifeParams& params, char* out, size_t size) {
+  if (size == 0) return;
+  if (params.elementary) {
+    snprintf(out, size, "W%u", params.wolfram);
+    return;
+  }
+
+  char rule[24];
+  size_t n = 0;
+  rule[n++] = 'B';
+  for (uint8_t count = 0; count <= 8; count++) {
+    if (params.birth & (1 << count)) rule[n++] = '0' + count;
+  }
+  rule[n++] = '/';
+  rule[n++] = 'S';
+  for (uint8_t count = 0; count <= 8; count++) {
+    if (params.survive & (1 << count)) rule[n++] = '0' + count;
+  }
+  rule[n] = '\0';
+  snprintf(out, size, "%s", rule);
+}
@@ -3,8 +3,27 @@
 #include "includes/wifi_manager.h"
 #include "includes/api.h"
 #include "includes/defaults.h"
+#include "includes/framebuffer.h"
+#include "includes/grayscale.h"
+#include "includes/text_raster.h"
+#include "includes/compositor.h"
+#include "includes/zones.h"
+#include "includes/animation.h"
+#include "includes/realtime.h"
+#include "includes/events.h"
+#include "includes/metrics.h"
+#include "includes/config_log.h"
+#include "includes/item_index.h"
+#include "includes/effect_registry.h"
 #include <esp_task_wdt.h>
 
+// Parola is about to write to the chain directly: stop grayscale plane
+// cycling and make the next frame buffer flush resend everything
+static void handOverToParola() {
+  grayStop();
+  fbInvalidate();
+}
+
 // Check system memory usage
 void checkSystemMemory(int force=0) {
     static unsigned long lastMemCheck = 0;
@@ -15,18 +34,6 @@ void checkSystemMemory(int force=0) {
 
   }
   
-  // Handle system update process
-  bool handleUpdateProcess() {
-    if (updateInProgress) {
-      // Display the updating message
-      disp.displayClear();
-      disp.setTextAlignment(PA_CENTER);
-      disp.print("UPDATING");
-      return true; // Skip the rest of the loop while updating
-    }
-    return false;
-  }
-  
   // Handle IP display mode
   bool handleIpDisplayMode() {
     if (ipDisplayConfig.active) {
@@ -50,6 +57,7 @@ void checkSystemMemory(int force=0) {
         if (disp.displayAnimate()) {
           disp.displayReset();
         }
+        handOverToParola();
         return true; // Skip the rest of the loop while in IP display mode
       }
     }
@@ -60,6 +68,7 @@ void checkSystemMemory(int force=0) {
   bool checkDisplayActive() {
     if (!config.displayOn || config.items.empty()) {
       disp.displayClear();
+      handOverToParola();
       return false;
     }
     
@@ -72,9 +81,9 @@ void checkSystemMemory(int force=0) {
   }
   
   // Validate current item settings
-  void validateCurrentItem() {
+  void validateCurrentItem(DisplayZone& zone) {
     // Get current item
-    DisplayItem& currentItem = config.items[config.currentItemIndex];
+    DisplayItem& currentItem = zone.items[zone.currentItemIndex];
     
     // If item has no duration set, give it a default duration
     if (currentItem.duration <= 0) {
@@ -84,18 +93,18 @@ void checkSystemMemory(int force=0) {
   }
   
   // Check if it's time to move to the next item
-  bool checkForItemTransition() {
-    DisplayItem& currentItem = config.items[config.currentItemIndex];
+  bool checkForItemTransition(DisplayZone& zone) {
+    DisplayItem& currentItem = zone.items[zone.currentItemIndex];
     unsigned long currentTime = millis();
     
-    if (config.itemStartTime > 0 && 
-        currentTime - config.itemStartTime > currentItem.duration) {
+    if (zone.itemStartTime > 0 && 
+        currentTime - zone.itemStartTime > currentItem.duration) {
       
-      unsigned long itemDuration = currentTime - config.itemStartTime;
+      unsigned long itemDuration = currentTime - zone.itemStartTime;
 
       char buffer[100];  // Adjust size based on expected message length
       snprintf(buffer, sizeof(buffer), "Item %d duration elapsed: %dms, Target duration: %dms",
-               config.currentItemIndex, itemDuration, currentItem.duration);
+               zone.currentItemIndex, itemDuration, currentItem.duration);
       Serial.println(buffer);
 
       return true;
@@ -104,43 +113,54 @@ void checkSystemMemory(int force=0) {
   }
   
   // Process item transition - handles item switching, deletion if needed
-  void processItemTransition() {
+  void processItemTransition(DisplayZone& zone) {
     // Get current item
-    DisplayItem& currentItem = config.items[config.currentItemIndex];
+    DisplayItem& currentItem = zone.items[zone.currentItemIndex];
     
     // Save the current mode before changing
-    String oldMode = currentItem.mode;
+    EffectMode oldMode = currentItem.mode;
     
     // Increment play count for the current item
-    config.items[config.currentItemIndex].playCount++;
+    zone.items[zone.currentItemIndex].playCount++;
+    metricsCount(metrics.itemTransitions);
+    
+    int zoneSlot = zoneIndexOf(zone);
+    uint8_t zoneIndex = zoneSlot > 0 ? zoneSlot : 0;
+    int16_t endedIndex = zone.currentItemIndex;
+    uint16_t endedPlays = currentItem.playCount;
     
     // Check if the item should be deleted after reaching max plays
-    if (handleItemDeletion()) {
+    if (handleItemDeletion(zone)) {
       // Item was deleted, nothing more to do for this transition
+      postEvent(EVENT_ITEM_ENDED, zoneIndex, endedIndex, endedPlays, 1);
+      postEvent(EVENT_ITEM_STARTED, zoneIndex, zone.currentItemIndex,
+                zone.items[zone.currentItemIndex].playCount);
       return;
     }
+    postEvent(EVENT_ITEM_ENDED, zoneIndex, endedIndex, endedPlays);
     
     // Move to the next item
-    moveToNextItem();
+    moveToNextItem(zone);
     
     // Get the new item
-    DisplayItem& newItem = config.items[config.currentItemIndex];
+    DisplayItem& newItem = zone.items[zone.currentItemIndex];
+    postEvent(EVENT_ITEM_STARTED, zoneIndex, zone.currentItemIndex, newItem.playCount);
     
     // Handle display mode transition
-    handleDisplayModeTransition(oldMode, newItem);
+    handleDisplayModeTransition(zone, oldMode, newItem);
     /*
     // Log info about the item switch
     char buffer[128];  // Adjust size based on expected message length
     snprintf(buffer, sizeof(buffer), "Switched to item %d: Mode=%s%s",
-             config.currentItemIndex, newItem.mode.c_str(),
-             (newItem.mode == "text") ? (", Text='" + newItem.text + "'").c_str() : "");
+             config.currentItemIndex, effectModeName(newItem.mode),
+             (newItem.mode == MODE_TEXT) ? (", Text='" + newItem.text.str() + "'").c_str() : "");
     Serial.println(buffer);
     */
   }
   
   // Handle item deletion if needed
-  bool handleItemDeletion() {
-    DisplayItem& currentItem = config.items[config.currentItemIndex];
+  bool handleItemDeletion(DisplayZone& zone) {
+    DisplayItem& currentItem = zone.items[zone.currentItemIndex];
     bool shouldDelete = false;
     
     if (currentItem.deleteAfterPlay) {
@@ -154,20 +174,19 @@ void checkSystemMemory(int force=0) {
       Serial.println("Deleting item after reaching max plays");
       
       // Delete the current item
-      config.items.erase(config.items.begin() + config.currentItemIndex);
+      logItemDeleted(currentItem.id);
+      zone.items.erase(zone.items.begin() + zone.currentItemIndex);
+      invalidateItemIndex();
       
       // Don't increment the index since we've removed an item
       // But make sure we're not out of bounds
-      if (config.currentItemIndex >= config.items.size()) {
-        config.currentItemIndex = 0;
+      if (zone.currentItemIndex >= zone.items.size()) {
+        zone.currentItemIndex = 0;
       }
       
-      // Save the updated config
-      saveConfig();
-      
       // Check if we have any items left
-      if (config.items.empty()) {
-        createDefaultItem();
+      if (zone.items.empty()) {
+        createDefaultItem(zone);
       }
       
       return true;
@@ -177,68 +196,76 @@ void checkSystemMemory(int force=0) {
   }
   
   // Create a default item when none exist
-  void createDefaultItem() {
-    Serial.println("No items left after deletion");
+  void createDefaultItem(DisplayZone& zone) {
+    Serial.println("No items left, adding the default item");
     
     // Add a default item so we always have something to display
     DisplayItem defaultItem;
-    defaultItem.mode = "text";
     defaultItem.text = "ESP32 LED Display";
     defaultItem.alignment = PA_SCROLL_LEFT;
     defaultItem.invert = false;
     defaultItem.brightness = DEFAULT_BRIGHTNESS;
-    defaultItem.scrollSpeed = DEFAULT_SCROLL_SPEED;
-    defaultItem.pauseTime = DEFAULT_PAUSE_TIME;
-    defaultItem.twinkleDensity = DEFAULT_TWINKLE_DENSITY;
-    defaultItem.twinkleMinSpeed = DEFAULT_TWINKLE_MIN_SPEED;
-    defaultItem.twinkleMaxSpeed = DEFAULT_TWINKLE_MAX_SPEED;
     defaultItem.duration = 0;
     defaultItem.playCount = 0;
     defaultItem.maxPlays = 0;
     defaultItem.deleteAfterPlay = false;
     
-    config.items.push_back(defaultItem);
-    saveConfig();
+    zone.items.push_back(defaultItem);
+    invalidateItemIndex();
+    int zoneSlot = zoneIndexOf(zone);
+    logItemAdded(zoneSlot > 0 ? zoneSlot : 0, zone.items.back());
   }
   
   // Move to the next item in the playlist
-  void moveToNextItem() {
+  void moveToNextItem(DisplayZone& zone) {
     // Move to the next item
     
     checkSystemMemory(1);
   
-    config.currentItemIndex++;
+    zone.currentItemIndex++;
     
     // Loop back to the beginning if needed
-    if (config.currentItemIndex >= config.items.size()) {
-      if (config.loopItems) {
-        config.currentItemIndex = 0;
+    if (zone.currentItemIndex >= zone.items.size()) {
+      if (zone.loopItems) {
+        zone.currentItemIndex = 0;
       } else {
-        config.currentItemIndex = config.items.size() - 1;  // Stay on last item
+        zone.currentItemIndex = zone.items.size() - 1;  // Stay on last item
       }
     }
   }
   
   // Handle display mode transition, updating settings as needed
-  void handleDisplayModeTransition(const String& oldMode, DisplayItem& newItem) {
+  void handleDisplayModeTransition(DisplayZone& zone, EffectMode oldMode, DisplayItem& newItem) {
+    if (!config.zones.empty()) {
+      // Zones share the chain: restart only this zone's content
+      int index = zoneIndexOf(zone);
+      if (index == 0) disp.setIntensity(newItem.brightness);
+      if (index >= 0) zoneRuntime(index)->reload = true;
+      zone.itemStartTime = millis();
+      return;
+    }
+    
     // Clear the display for mode change if needed
     if (oldMode != newItem.mode) {
       clearDisplayForModeChange(oldMode, newItem.mode);
       
       // Reinitialize the display with the new item's settings
       disp.setIntensity(newItem.brightness);
-      disp.setSpeed(newItem.scrollSpeed);
-      disp.setPause(newItem.pauseTime);
+      disp.setSpeed(newItem.textParams().scrollSpeed);
+      disp.setPause(newItem.textParams().pauseTime);
     } else {
       // Even if same mode, update settings as they might be different
       disp.setIntensity(newItem.brightness);
-      disp.setSpeed(newItem.scrollSpeed);
-      disp.setPause(newItem.pauseTime);
+      disp.setSpeed(newItem.textParams().scrollSpeed);
+      disp.setPause(newItem.textParams().pauseTime);
     }
     
     // Force update with the new item
     textNeedsUpdate = true;
     config.itemStartTime = millis();
+    
+    // Per-item flush statistics
+    fbResetStats();
   }
   
   // Update display based on current item mode
@@ -246,48 +273,35 @@ void checkSystemMemory(int force=0) {
     DisplayItem& currentItem = config.items[config.currentItemIndex];
 
 
-    if (currentItem.mode == "twinkle")     updateTwinkleEffect(currentItem);     
-    if (currentItem.mode == "knightrider") updateKnightRiderEffect(currentItem); 
-    if (currentItem.mode == "pong")        updatePongEffect(currentItem);        
-    if (currentItem.mode == "sinewave")    updateSineWaveEffect(currentItem);    
-    if (currentItem.mode == "text")        updateTextDisplay(currentItem);       
+    const EffectInfo& effect = effectInfo(currentItem.mode);
+    if (effect.update)                 effect.update(currentItem);
+    if (effect.flags & EFFECT_TEXT)    updateTextDisplay(currentItem);
+    if (effect.flags & EFFECT_FRAMES)  updateAnimationDisplay(currentItem);
+    else animationClose(zoneRuntime(0)->animation);
+    if (currentItem.mode == MODE_LAYERS) {
+      // The compositor commits its own frame
+      updateLayeredDisplay(currentItem);
+      return;
+    }
+    
+    // Grayscale effects hand their planes to the plane timer; binary
+    // effects and text push only the rows that changed
+    if (effect.flags & EFFECT_GRAY) {
+      grayCommit();
+    } else {
+      grayStop();
+      fbFlush();
+    }
   }
   
   // Update text display mode
   void updateTextDisplay(DisplayItem& currentItem) {
     if (textNeedsUpdate) {
-      disp.displayClear();
-      disp.setInvert(currentItem.invert);
       disp.setIntensity(currentItem.brightness);
-      disp.setSpeed(currentItem.scrollSpeed);
-      disp.setPause(currentItem.pauseTime);
       
-      // Handle text based on alignment mode
-      if (currentItem.alignment == PA_SCROLL_LEFT) {
-        disp.displayText(currentItem.text.c_str(), PA_LEFT, currentItem.scrollSpeed, 
-                         currentItem.pauseTime, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
-        textNeedsUpdate = false;
-      } 
-      else if (currentItem.alignment == PA_SCROLL_RIGHT) {
-        disp.displayText(currentItem.text.c_str(), PA_RIGHT, currentItem.scrollSpeed, 
-                         currentItem.pauseTime, PA_SCROLL_RIGHT, PA_SCROLL_RIGHT);
-        textNeedsUpdate = false;
-      }
-      // For static text (LEFT, CENTER, RIGHT)
-      else {
-        disp.setTextAlignment((textPosition_t)currentItem.alignment);
-        
-        // If text is longer than display, use scrolling instead
-        if (currentItem.text.length() > MAX_DEVICES * 8 / 6) { 
-          Serial.println("Text too long for static display, using scroll instead");
-          disp.displayText(currentItem.text.c_str(),(textPosition_t) currentItem.alignment, 
-                          currentItem.scrollSpeed, currentItem.pauseTime, 
-                          PA_SCROLL_LEFT, PA_SCROLL_LEFT);
-        } else {
-          disp.print(currentItem.text.c_str());
-        }
-        textNeedsUpdate = false;
-      }
+      // Rasterize once; scrolling is just a window into the raster
+      textRasterPrepare(zoneRuntime(0)->text, currentItem);
+      textNeedsUpdate = false;
       
       // Set the start time for duration tracking if not already set
       if (config.itemStartTime == 0) {
@@ -295,18 +309,76 @@ void checkSystemMemory(int force=0) {
       }
     }
     
-    // Animate if needed (only required for scrolling effects)
-    if (currentItem.alignment == PA_SCROLL_LEFT || 
-        currentItem.alignment == PA_SCROLL_RIGHT || 
-        (currentItem.text.length() > MAX_DEVICES * 8 / 6)) {
-      if (disp.displayAnimate()) {
-        // Animation has finished, restart
-        disp.displayReset();
+    textRasterDraw(zoneRuntime(0)->text, currentItem);
+  }
+
+
+  // Update a bitmap or animation item, streamed from its file
+  void updateAnimationDisplay(DisplayItem& currentItem) {
+    AnimationPlayer& player = zoneRuntime(0)->animation;
+    
+    if (textNeedsUpdate) {
+      disp.setIntensity(currentItem.brightness);
+      animationOpen(player, currentItem.file());
+      textNeedsUpdate = false;
+      
+      if (config.itemStartTime == 0) {
+        config.itemStartTime = millis();
       }
     }
+    
+    animationUpdate(player, currentItem);
+    animationDraw(player, currentItem);
   }
 
 
+  // Update a layered item (effects and text combined)
+  void updateLayeredDisplay(DisplayItem& currentItem) {
+    if (textNeedsUpdate) {
+      disp.setIntensity(currentItem.brightness);
+      resetLayers(zoneRuntime(0)->layers, currentItem);
+      
+      for (const DisplayLayer& layer : currentItem.layers()) {
+        if (effectHas(layer.mode, EFFECT_TEXT)) {
+          textRasterPrepare(zoneRuntime(0)->text, currentItem);
+          break;
+        }
+      }
+      textNeedsUpdate = false;
+      
+      if (config.itemStartTime == 0) {
+        config.itemStartTime = millis();
+      }
+    }
+    
+    renderLayers(currentItem, zoneRuntime(0)->layers, zoneRuntime(0)->text);
+  }
+
+
+// Render one frame: update checks, item transitions and display content
+void renderFrame() {
+  if (realtimeRender()) return;       // A UDP stream has taken over the display
+  if (!checkDisplayActive()) return; 
+  if (handleIpDisplayMode()) return;
+  
+  // Several zones: each runs its own playlist into one shared frame
+  if (!config.zones.empty()) {
+    renderZones();
+    return;
+  }
+  
+  // Back to a single zone: the primary effects span the whole chain again
+  EffectInstance* effects = &zoneRuntime(0)->effects;
+  if (effects->firstCol != 0 || effects->cols != FRAME_COLS) {
+    resetEffects(effects, 0, FRAME_COLS);
+  }
+  
+  validateCurrentItem(config);
+
+  if (checkForItemTransition(config))  processItemTransition(config);
+  updateDisplayContent();
+}
+
 void wifi_api_setup(){
   if (WIFI_ENABLED==true) {
     if ( !isWiFiSetupComplete()) {
@@ -316,11 +388,12 @@ void wifi_api_setup(){
       
     if (!apiSetupDone) {
       setupApiEndpoints();
+      initRealtime();
       apiSetupDone = true;
       Serial.println("✅ System initialization complete");
       
       if (!config.items.empty()) {
-        Serial.println("Initialized with mode: " + config.items[0].mode);
+        Serial.println("Initialized with mode: " + String(effectModeName(config.items[0].mode)));
       } else {
         Serial.println("No display items initialized");
       }
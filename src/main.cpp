@@ -17,6 +17,12 @@
 #include "includes/globals.h"     
 #include "includes/loop_functions.h" 
 #include "includes/utils.h"
+#include "includes/render_task.h"
+#include "includes/events.h"
+#include "includes/preview.h"
+#include "includes/metrics.h"
+#include "includes/config_edit.h"
+#include "includes/persistence.h"
 
 
 
@@ -27,6 +33,8 @@ void setup() {
 
   Serial.begin(115200);
   Serial.println("\n\n--- Starting ESP32 LED Rack Bar ---");
+  initMetrics();
+  initTextPool();   // Before anything makes an item
   
   initializeEffects();
   
@@ -54,6 +62,7 @@ void setup() {
   // Load security configuration
   loadSecurityConfig();
   checkFactoryResetCondition();
+  initPersistence();
   loadConfig();
   config.itemStartTime = millis();
   initDisplay();
@@ -70,18 +79,19 @@ void setup() {
   esp_task_wdt_init(WATCHDOG_RESET_TIMEOUT, true);
   esp_task_wdt_add(NULL);
   
+  // From here on the render task owns the display
+  startRenderTask();
 }
 
 void loop() {
+  // Rendering happens in the render task; this task feeds the sockets
   //checkSystemMemory(0);
   esp_task_wdt_reset();
-  
-  if (handleUpdateProcess()) return; // Skip the rest of the loop while updating
-  if (!checkDisplayActive()) return; 
-  if (handleIpDisplayMode()) return;
-  
-  validateCurrentItem();
-
-  if (checkForItemTransition())  processItemTransition();
-  updateDisplayContent();
+  uint32_t waitMs = min(previewPollMs(), configEditPollMs());
+  waitMs = min(waitMs, restartPollMs());
+  pumpEvents(min(waitMs, persistPollMs()));
+  pumpPreview();
+  pumpPersistence();
+  pumpConfigEdits();
+  pumpRestart();
 }
\ No newline at end of file
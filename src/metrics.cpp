@@ -0,0 +1,169 @@
+#include "includes/metrics.h"
+#include "includes/frame_clock.h"
+#include "includes/persistence.h"
+#include <ESPAsyncWebServer.h>
+
+// Initialize global variables
+Metrics metrics;
+
+static MetricsEndpoint endpoints[METRICS_MAX_ENDPOINTS];
+static uint8_t endpointCount = 0;
+
+// Bucket upper bounds, microseconds
+static const uint32_t loopPeriodBounds[] = {5000, 10000, 15000, 19000, 21000, 25000, 34000, 50000, 100000, 250000};
+static const uint32_t renderBounds[] = {250, 500, 1000, 2000, 4000, 8000, 15000, 25000, 50000, 100000};
+static const uint32_t spiBounds[] = {25, 50, 100, 200, 400, 800, 1500, 3000, 6000};
+static const uint32_t saveBounds[] = {5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000};
+static const uint32_t requestBounds[] = {500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000};
+
+#define BOUNDS(b) b, (uint8_t)(sizeof(b) / sizeof(b[0]))
+
+static void setBounds(MetricsHistogram& histogram, const uint32_t* bounds, uint8_t count) {
+  histogram.bounds = bounds;
+  histogram.boundCount = count < METRICS_MAX_BUCKETS ? count : METRICS_MAX_BUCKETS;
+}
+
+void initMetrics() {
+  setBounds(metrics.loopPeriod, BOUNDS(loopPeriodBounds));
+  setBounds(metrics.renderFrame, BOUNDS(renderBounds));
+  setBounds(metrics.spiFlush, BOUNDS(spiBounds));
+  setBounds(metrics.configSave, BOUNDS(saveBounds));
+}
+
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {
+  uint8_t bucket = 0;
+  while (bucket < histogram.boundCount && us > histogram.bounds[bucket]) bucket++;
+
+  histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+  uint32_t before = histogram.sumUs.fetch_add(us, std::memory_order_relaxed);
+  if (before + us < before) histogram.sumWraps.fetch_add(1, std::memory_order_relaxed);
+}
+
+static const char* methodName(uint8_t method) {
+  switch (method) {
+    case HTTP_GET:    return "GET";
+    case HTTP_POST:   return "POST";
+    case HTTP_DELETE: return "DELETE";
+    case HTTP_PUT:    return "PUT";
+    case HTTP_PATCH:  return "PATCH";
+    default:          return "ANY";
+  }
+}
+
+int metricsRegisterEndpoint(const char* path, uint8_t method) {
+  if (endpointCount >= METRICS_MAX_ENDPOINTS) {
+    Serial.println("⚠️ Too many endpoints for metrics");
+    return -1;
+  }
+
+  MetricsEndpoint& endpoint = endpoints[endpointCount];
+  endpoint.path = path;
+  endpoint.method = methodName(method);
+  setBounds(endpoint.latency, BOUNDS(requestBounds));
+  return endpointCount++;
+}
+
+void metricsRequestDone(int endpoint, uint32_t us) {
+  if (endpoint < 0 || endpoint >= endpointCount) return;
+  metricsObserve(endpoints[endpoint].latency, us);
+}
+
+static void writeHeader(Print& out, const char* name, const char* type, const char* help) {
+  out.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Buckets, sum and count of one histogram; labels is "" or `key="value",...`
+static void writeHistogram(Print& out, const char* name, const char* labels,
+                           const MetricsHistogram& histogram) {
+  const char* sep = labels[0] ? "," : "";
+  uint32_t cumulative = 0;
+
+  for (uint8_t i = 0; i < histogram.boundCount; i++) {
+    cumulative += histogram.buckets[i].load(std::memory_order_relaxed);
+    out.printf("%s_bucket{%s%sle=\"%.6g\"} %u\n", name, labels, sep,
+               histogram.bounds[i] / 1e6, cumulative);
+  }
+  cumulative += histogram.buckets[histogram.boundCount].load(std::memory_order_relaxed);
+  out.printf("%s_bucket{%s%sle=\"+Inf\"} %u\n", name, labels, sep, cumulative);
+
+  // Retry if the sum wrapped while we were reading it
+  uint32_t wraps, sumUs;
+  do {
+    wraps = histogram.sumWraps.load(std::memory_order_relaxed);
+    sumUs = histogram.sumUs.load(std::memory_order_relaxed);
+  } while (wraps != histogram.sumWraps.load(std::memory_order_relaxed));
+  double sum = (wraps * 4294967296.0 + sumUs) / 1e6;
+
+  // Count matches the +Inf bucket, as Prometheus expects
+  if (labels[0]) {
+    out.printf("%s_sum{%s} %.6f\n%s_count{%s} %u\n", name, labels, sum, name, labels, cumulative);
+  } else {
+    out.printf("%s_sum %.6f\n%s_count %u\n", name, sum, name, cumulative);
+  }
+}
+
+static void writeSimpleHistogram(Print& out, const char* name, const char* help,
+                                 const MetricsHistogram& histogram) {
+  writeHeader(out, name, "histogram", help);
+  writeHistogram(out, name, "", histogram);
+}
+
+static void writeValue(Print& out, const char* name, const char* type, const char* help,
+                       double value) {
+  writeHeader(out, name, type, help);
+  out.printf("%s %.10g\n", name, value);
+}
+
+void writeMetrics(Print& out) {
+  writeSimpleHistogram(out, "ledbar_render_loop_period_seconds",
+                       "Time between render task frame ticks.", metrics.loopPeriod);
+  writeSimpleHistogram(out, "ledbar_render_frame_seconds",
+                       "Time to apply commands, draw and flush one frame.", metrics.renderFrame);
+  writeSimpleHistogram(out, "ledbar_spi_flush_seconds",
+                       "CPU time to hand changed rows to the display backend.", metrics.spiFlush);
+  writeSimpleHistogram(out, "ledbar_config_save_seconds",
+                       "Time to write the config file.", metrics.configSave);
+
+  writeValue(out, "ledbar_render_frames_total", "counter", "Frames rendered.",
+             frameClockStats.frames);
+  writeValue(out, "ledbar_render_missed_deadlines_total", "counter",
+             "Frame ticks skipped because a frame overran.", frameClockStats.missedDeadlines);
+  writeValue(out, "ledbar_spi_bytes_total", "counter", "Bytes sent down the chain since boot.",
+             metrics.spiBytesWraps.load(std::memory_order_relaxed) * 4294967296.0 +
+             metrics.spiBytes.load(std::memory_order_relaxed));
+
+  writeHeader(out, "ledbar_http_requests_total", "counter", "Requests handled, by endpoint.");
+  for (uint8_t i = 0; i < endpointCount; i++) {
+    out.printf("ledbar_http_requests_total{path=\"%s\",method=\"%s\"} %u\n", endpoints[i].path,
+               endpoints[i].method, endpoints[i].latency.count.load(std::memory_order_relaxed));
+  }
+
+  writeHeader(out, "ledbar_http_request_duration_seconds", "histogram",
+              "Time from the request to its connection closing after the reply, by endpoint.");
+  char labels[96];
+  for (uint8_t i = 0; i < endpointCount; i++) {
+    snprintf(labels, sizeof(labels), "path=\"%s\",method=\"%s\"", endpoints[i].path, endpoints[i].method);
+    writeHistogram(out, "ledbar_http_request_duration_seconds", labels, endpoints[i].latency);
+  }
+
+  writeValue(out, "ledbar_heap_free_bytes", "gauge", "Free heap.", ESP.getFreeHeap());
+  writeValue(out, "ledbar_heap_min_free_bytes", "gauge", "Lowest free heap since boot.",
+             ESP.getMinFreeHeap());
+  writeValue(out, "ledbar_heap_largest_free_block_bytes", "gauge",
+             "Largest block that can be allocated; far below free heap means fragmentation.",
+             ESP.getMaxAllocHeap());
+
+  writeValue(out, "ledbar_config_save_requests_total", "counter",
+             "Config changes that asked for a save.", persistStats.requests);
+  writeValue(out, "ledbar_config_writes_total", "counter", "Config file writes to flash.",
+             persistStats.writes);
+  writeValue(out, "ledbar_config_bytes_written_total", "counter", "Bytes of config written to flash.",
+             persistStats.bytesWritten);
+
+  writeValue(out, "ledbar_item_transitions_total", "counter", "Playlist item changes, all zones.",
+             metrics.itemTransitions.load(std::memory_order_relaxed));
+  writeValue(out, "ledbar_wifi_reconnects_total", "counter", "WiFi connections regained after a drop.",
+             metrics.wifiReconnects.load(std::memory_order_relaxed));
+  writeValue(out, "ledbar_uptime_seconds", "gauge", "Time since boot.", millis() / 1000.0);
+}
@@ -0,0 +1,149 @@
+#include "includes/persistence.h"
+#include "includes/defaults.h"
+#include "includes/config_binary.h"
+#include "includes/config_log.h"
+#include <esp_timer.h>
+#include "freertos/semphr.h"
+#include <atomic>
+
+// Initialize global variables
+PersistStats persistStats;
+
+static std::atomic<bool> dirty(false);
+static std::atomic<bool> flushRequested(false);
+static std::atomic<bool> stopped(false);
+static std::atomic<unsigned long> firstChangeMs(0);   // First change since the last snapshot
+static std::atomic<unsigned long> lastChangeMs(0);
+
+// Snapshot handed from the render task to the main loop. The render task
+// only fills it while snapshotReady is false; the loop only reads and
+// clears it while it is true.
+static std::vector<uint8_t> snapshot;
+static uint16_t snapshotGeneration;
+static std::atomic<bool> snapshotReady(false);
+
+// Change log records from the render task waiting for the main loop.
+// Taking a snapshot drops them (the snapshot has their changes) under the
+// same lock, and the loop only takes records while no snapshot is
+// waiting, so a record never lands in a log older than its change.
+static std::vector<uint8_t> logPending;
+static std::atomic<bool> logQueued(false);
+static SemaphoreHandle_t logLock = NULL;
+
+void initPersistence() {
+  logLock = xSemaphoreCreateMutex();
+}
+
+void queueLogRecord(const uint8_t* data, size_t length) {
+  xSemaphoreTake(logLock, portMAX_DELAY);
+  logPending.insert(logPending.end(), data, data + length);
+  logQueued.store(true, std::memory_order_release);
+  xSemaphoreGive(logLock);
+}
+
+void requestConfigSave() {
+  unsigned long now = millis();
+  lastChangeMs.store(now, std::memory_order_relaxed);
+  if (!dirty.exchange(true, std::memory_order_acq_rel)) {
+    firstChangeMs.store(now, std::memory_order_relaxed);
+  }
+  persistStats.requests++;
+}
+
+bool configDirty() {
+  return dirty.load(std::memory_order_acquire) || snapshotReady.load(std::memory_order_acquire) ||
+         logQueued.load(std::memory_order_acquire);
+}
+
+void persistTick() {
+  if (!dirty.load(std::memory_order_acquire) || stopped.load(std::memory_order_relaxed)) {
+    flushRequested.store(false, std::memory_order_relaxed);   // Nothing to snapshot
+    return;
+  }
+  if (snapshotReady.load(std::memory_order_acquire)) return;   // Last one still being written
+
+  unsigned long now = millis();
+  bool due = flushRequested.load(std::memory_order_relaxed) ||
+             now - lastChangeMs.load(std::memory_order_relaxed) >= CONFIG_SAVE_QUIET_MS ||
+             now - firstChangeMs.load(std::memory_order_relaxed) >= CONFIG_SAVE_MAX_DELAY_MS;
+  if (!due) return;
+
+  // Clear first: a change made after this point marks it dirty again
+  dirty.store(false, std::memory_order_release);
+  flushRequested.store(false, std::memory_order_relaxed);
+
+  int64_t start = esp_timer_get_time();
+  xSemaphoreTake(logLock, portMAX_DELAY);
+  snapshotGeneration = configLogStats.generation + 1;
+  encodeConfigBinary(config, snapshot, snapshotGeneration);
+  logPending.clear();
+  logQueued.store(false, std::memory_order_release);
+  xSemaphoreGive(logLock);
+  uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+
+  persistStats.snapshots++;
+  persistStats.lastSnapshotUs = us;
+  if (us > persistStats.maxSnapshotUs) persistStats.maxSnapshotUs = us;
+  snapshotReady.store(true, std::memory_order_release);
+}
+
+// Append the records queued since the last pump to the change log
+static void pumpLog() {
+  if (!logQueued.load(std::memory_order_acquire)) return;
+
+  std::vector<uint8_t> records;
+  xSemaphoreTake(logLock, portMAX_DELAY);
+  if (!snapshotReady.load(std::memory_order_acquire)) {
+    records.swap(logPending);
+    logQueued.store(false, std::memory_order_release);
+  }
+  xSemaphoreGive(logLock);
+  if (records.empty() || stopped.load(std::memory_order_relaxed)) return;
+
+  if (appendConfigLog(records.data(), records.size())) {
+    persistStats.bytesWritten += records.size();
+    persistStats.lastWriteMs = millis();
+    if (configLogStats.bytes >= CONFIG_LOG_COMPACT_BYTES) {
+      configLogStats.compactions++;
+      requestConfigSave();   // Compact: a full save starts an empty log
+    }
+  } else {
+    persistStats.failures++;
+    requestConfigSave();     // The full config has these changes too
+  }
+}
+
+void pumpPersistence() {
+  if (snapshotReady.load(std::memory_order_acquire)) {
+    if (!stopped.load(std::memory_order_relaxed)) {
+      if (writeConfigFile(snapshot) && startConfigLog(snapshotGeneration)) {
+        persistStats.writes++;
+        persistStats.bytesWritten += snapshot.size();
+        persistStats.lastWriteMs = millis();
+      } else {
+        persistStats.failures++;
+        requestConfigSave();   // Try again after the usual delay
+      }
+    }
+
+    std::vector<uint8_t>().swap(snapshot);   // Free it until the next save
+    snapshotReady.store(false, std::memory_order_release);
+  }
+
+  pumpLog();
+}
+
+uint32_t persistPollMs() {
+  return configDirty() ? CONFIG_EDIT_POLL_MS : UINT32_MAX;
+}
+
+void requestConfigFlush() {
+  persistStats.flushes++;
+  flushRequested.store(true, std::memory_order_relaxed);
+}
+
+void stopConfigSaves() {
+  stopped.store(true, std::memory_order_relaxed);
+  dirty.store(false, std::memory_order_release);
+  logQueued.store(false, std::memory_order_release);
+}
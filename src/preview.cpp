@@ -0,0 +1,334 @@
+#include "includes/preview.h"
+#include "includes/grayscale.h"
+#include "includes/realtime_packet.h"
+#include "includes/wifi_manager.h"
+#include "includes/utils.h"
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include "freertos/semphr.h"
+#include <atomic>
+
+#define PREVIEW_PACKET_BYTES (REALTIME_HEADER_BYTES + FRAME_ROWS * MAX_DEVICES)
+#define SNAPSHOT_MAX_SCALE 8
+
+// Initialize global variables
+PreviewStats previewStats;
+
+static AsyncWebSocket previewSocket("/preview");
+
+// Latest capture. The render task writes it under a sequence count that
+// is odd while the copy is in progress; readers retry if it moved.
+static PackedFrame snapshot;
+static std::atomic<uint32_t> snapshotSeq(0);
+
+typedef struct {
+  uint32_t id;              // WebSocket client id, 0 = free slot
+  uint16_t intervalMs;      // From the fps the client asked for
+  unsigned long lastSentMs;
+  uint16_t seq;
+  bool sentAny;
+  PackedFrame sent;         // Frame the client has; deltas are against it
+} PreviewClient;
+
+// Slots are claimed and freed on the web server task and used by the main
+// loop task
+static PreviewClient clients[PREVIEW_MAX_CLIENTS];
+static SemaphoreHandle_t clientsLock = NULL;
+
+static uint16_t fpsToInterval(long fps) {
+  if (fps < 1) fps = 1;
+  if (fps > PREVIEW_MAX_FPS) fps = PREVIEW_MAX_FPS;
+  return 1000 / fps;
+}
+
+void previewCapture() {
+  static unsigned long lastCapture = 0;
+  unsigned long now = millis();
+  if (now - lastCapture < 1000 / PREVIEW_MAX_FPS) return;
+  lastCapture = now;
+
+  uint32_t seq = snapshotSeq.load(std::memory_order_relaxed);
+  snapshotSeq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // Grayscale shows as its top bit plane (pixels at half intensity or more)
+  if (grayIsRunning()) {
+    memcpy(&snapshot, &grayPlane(GRAY_PLANES - 1), sizeof(snapshot));
+  } else {
+    fbSnapshot(snapshot);
+  }
+
+  snapshotSeq.store(seq + 2, std::memory_order_release);
+  previewStats.captures++;
+}
+
+static bool readSnapshot(PackedFrame& out) {
+  for (;;) {
+    uint32_t before = snapshotSeq.load(std::memory_order_acquire);
+    if (before == 0) return false;   // Nothing captured yet
+    if (before & 1) continue;
+
+    memcpy(&out, &snapshot, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (snapshotSeq.load(std::memory_order_relaxed) == before) return true;
+  }
+}
+
+static void claimClient(AsyncWebSocketClient* client, AsyncWebServerRequest* request) {
+  long fps = PREVIEW_DEFAULT_FPS;
+  if (request != NULL && request->hasParam("fps")) {
+    fps = request->getParam("fps")->value().toInt();
+  }
+
+  xSemaphoreTake(clientsLock, portMAX_DELAY);
+  for (PreviewClient& slot : clients) {
+    if (slot.id != 0) continue;
+    slot.id = client->id();
+    slot.intervalMs = fpsToInterval(fps);
+    slot.lastSentMs = 0;
+    slot.seq = 0;
+    slot.sentAny = false;
+    xSemaphoreGive(clientsLock);
+    return;
+  }
+  xSemaphoreGive(clientsLock);
+
+  Serial.println("⚠️ Too many preview clients");
+  client->close();
+}
+
+static void releaseClient(uint32_t id) {
+  xSemaphoreTake(clientsLock, portMAX_DELAY);
+  for (PreviewClient& slot : clients) {
+    if (slot.id == id) slot.id = 0;
+  }
+  xSemaphoreGive(clientsLock);
+}
+
+// A text message with a number changes the client's frame rate
+static void setClientFps(uint32_t id, const uint8_t* data, size_t len) {
+  char text[8];
+  if (len >= sizeof(text)) return;
+  memcpy(text, data, len);
+  text[len] = '\0';
+
+  xSemaphoreTake(clientsLock, portMAX_DELAY);
+  for (PreviewClient& slot : clients) {
+    if (slot.id == id) slot.intervalMs = fpsToInterval(atol(text));
+  }
+  xSemaphoreGive(clientsLock);
+}
+
+static void onPreviewEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client,
+                           AwsEventType type, void* arg, uint8_t* data, size_t len) {
+  if (type == WS_EVT_CONNECT) {
+    claimClient(client, (AsyncWebServerRequest*)arg);
+  } else if (type == WS_EVT_DISCONNECT) {
+    releaseClient(client->id());
+  } else if (type == WS_EVT_DATA) {
+    AwsFrameInfo* info = (AwsFrameInfo*)arg;
+    if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
+      setClientFps(client->id(), data, len);
+    }
+  }
+}
+
+void pumpPreview() {
+  if (previewSocket.count() == 0) {
+    previewStats.clients = 0;
+    return;
+  }
+
+  PackedFrame frame;
+  if (!readSnapshot(frame)) return;
+
+  uint8_t packet[PREVIEW_PACKET_BYTES];
+  unsigned long now = millis();
+
+  xSemaphoreTake(clientsLock, portMAX_DELAY);
+  uint32_t active = 0;
+  for (PreviewClient& slot : clients) {
+    if (slot.id == 0) continue;
+    active++;
+    if (slot.sentAny && now - slot.lastSentMs < slot.intervalMs) continue;
+
+    AsyncWebSocketClient* client = previewSocket.client(slot.id);
+    if (client == NULL) continue;
+
+    size_t len = realtimeEncode(packet, frame.bytes[0], slot.sentAny ? slot.sent.bytes[0] : NULL,
+                                FRAME_ROW_BYTES, MAX_DEVICES, slot.seq, now);
+    if (len == 0) continue;   // Unchanged: nothing to send
+
+    if (!client->canSend()) {
+      previewStats.skippedBusy++;
+      continue;
+    }
+
+    client->binary(packet, len);
+    memcpy(&slot.sent, &frame, sizeof(frame));
+    slot.sentAny = true;
+    slot.lastSentMs = now;
+    slot.seq++;
+
+    previewStats.framesSent++;
+    previewStats.bytesSent += len;
+    if (packet[2] == REALTIME_PACKET_FULL) previewStats.fullFrames++;
+  }
+  xSemaphoreGive(clientsLock);
+
+  previewStats.clients = active;
+  previewSocket.cleanupClients(PREVIEW_MAX_CLIENTS);
+}
+
+uint32_t previewPollMs() {
+  return previewStats.clients > 0 ? 1000 / PREVIEW_MAX_FPS : 100;
+}
+
+// Pixel at screen position (x from the left, y from the top)
+static bool screenPixel(const PackedFrame& frame, uint16_t x, uint8_t y) {
+  uint16_t col = FRAME_COLS - 1 - x;
+  return frame.bytes[y][col / 8] & (1 << (col % 8));
+}
+
+// One scaled image row, 8 pixels per byte with the leftmost in the MSB and
+// lit LEDs as 1 bits. Returns the number of bytes written.
+static size_t packImageRow(const PackedFrame& frame, uint8_t y, uint8_t scale, uint8_t* out) {
+  size_t width = (size_t)FRAME_COLS * scale;
+  size_t bytes = (width + 7) / 8;
+  memset(out, 0, bytes);
+
+  for (size_t px = 0; px < width; px++) {
+    if (screenPixel(frame, px / scale, y)) out[px / 8] |= (0x80 >> (px % 8));
+  }
+  return bytes;
+}
+
+static void writePbm(Print& out, const PackedFrame& frame, uint8_t scale) {
+  uint8_t row[FRAME_COLS * SNAPSHOT_MAX_SCALE / 8];
+  out.printf("P4\n%u %u\n", FRAME_COLS * scale, FRAME_ROWS * scale);
+  for (uint8_t y = 0; y < FRAME_ROWS; y++) {
+    size_t bytes = packImageRow(frame, y, scale, row);
+    for (uint8_t i = 0; i < scale; i++) out.write(row, bytes);
+  }
+}
+
+// Minimal PNG: 1-bit grayscale, one uncompressed deflate block
+typedef struct {
+  Print* out;
+  uint32_t crc;
+  uint32_t adlerA;
+  uint32_t adlerB;
+} PngWriter;
+
+static void pngWrite(PngWriter& png, const uint8_t* data, size_t len) {
+  png.crc = crc32Update(png.crc, data, len);
+  png.out->write(data, len);
+}
+
+static void pngWrite32(PngWriter& png, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+  pngWrite(png, bytes, 4);
+}
+
+static void pngBeginChunk(PngWriter& png, const char* type, uint32_t length) {
+  uint8_t len[4] = {(uint8_t)(length >> 24), (uint8_t)(length >> 16), (uint8_t)(length >> 8), (uint8_t)length};
+  png.out->write(len, 4);
+  png.crc = 0;
+  pngWrite(png, (const uint8_t*)type, 4);
+}
+
+static void pngEndChunk(PngWriter& png) {
+  uint32_t crc = png.crc;
+  uint8_t bytes[4] = {(uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc};
+  png.out->write(bytes, 4);
+}
+
+// Image data, also fed to the zlib checksum
+static void pngWriteData(PngWriter& png, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    png.adlerA = (png.adlerA + data[i]) % 65521;
+    png.adlerB = (png.adlerB + png.adlerA) % 65521;
+  }
+  pngWrite(png, data, len);
+}
+
+static void writePng(Print& out, const PackedFrame& frame, uint8_t scale) {
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  uint32_t width = FRAME_COLS * scale;
+  uint32_t height = FRAME_ROWS * scale;
+  size_t rowBytes = (width + 7) / 8;
+  size_t raw = height * (1 + rowBytes);   // Filter byte + pixels per row
+
+  PngWriter png = {&out, 0, 1, 0};
+  out.write(signature, sizeof(signature));
+
+  pngBeginChunk(png, "IHDR", 13);
+  pngWrite32(png, width);
+  pngWrite32(png, height);
+  const uint8_t format[5] = {1, 0, 0, 0, 0};   // 1-bit grayscale, no interlace
+  pngWrite(png, format, sizeof(format));
+  pngEndChunk(png);
+
+  // zlib header, one stored block, adler32
+  pngBeginChunk(png, "IDAT", 2 + 5 + raw + 4);
+  const uint8_t zlib[7] = {0x78, 0x01, 0x01, (uint8_t)raw, (uint8_t)(raw >> 8),
+                           (uint8_t)~raw, (uint8_t)(~raw >> 8)};
+  pngWrite(png, zlib, sizeof(zlib));
+
+  uint8_t row[1 + FRAME_COLS * SNAPSHOT_MAX_SCALE / 8];
+  row[0] = 0;   // No filter
+  for (uint8_t y = 0; y < FRAME_ROWS; y++) {
+    size_t bytes = packImageRow(frame, y, scale, row + 1);
+    for (uint8_t i = 0; i < scale; i++) pngWriteData(png, row, 1 + bytes);
+  }
+  pngWrite32(png, (png.adlerB << 16) | png.adlerA);
+  pngEndChunk(png);
+
+  pngBeginChunk(png, "IEND", 0);
+  pngEndChunk(png);
+}
+
+static_assert(FRAME_ROWS * SNAPSHOT_MAX_SCALE * (1 + FRAME_COLS * SNAPSHOT_MAX_SCALE / 8) < 65536,
+              "PNG snapshot must fit one stored deflate block");
+
+void setupPreview(AsyncWebServer& server) {
+  clientsLock = xSemaphoreCreateMutex();
+  memset(clients, 0, sizeof(clients));
+
+  previewSocket.onEvent(onPreviewEvent);
+  previewSocket.setFilter(validateApiKey);
+  server.addHandler(&previewSocket);
+
+  server.on("/snapshot", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!validateApiKey(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized. Valid API key required.\"}");
+      return;
+    }
+
+    PackedFrame frame;
+    if (!readSnapshot(frame)) {
+      request->send(503, "application/json", "{\"error\":\"No frame rendered yet\"}");
+      return;
+    }
+
+    String format = request->hasParam("format") ? request->getParam("format")->value() : "pbm";
+    long scale = request->hasParam("scale") ? request->getParam("scale")->value().toInt() : 1;
+    scale = constrain(scale, 1, SNAPSHOT_MAX_SCALE);
+
+    if (format == "png") {
+      AsyncResponseStream* response = request->beginResponseStream("image/png");
+      writePng(*response, frame, scale);
+      request->send(response);
+    } else if (format == "pbm") {
+      AsyncResponseStream* response = request->beginResponseStream("image/x-portable-bitmap");
+      writePbm(*response, frame, scale);
+      request->send(response);
+    } else {
+      request->send(400, "application/json", "{\"error\":\"format must be pbm or png\"}");
+      return;
+    }
+    previewStats.snapshots++;
+  });
+
+  Serial.println("✅ Preview stream ready on /preview");
+}
@@ -0,0 +1,158 @@
+#include "includes/realtime.h"
+#include "includes/defaults.h"
+#include "includes/grayscale.h"
+#include <AsyncUDP.h>
+#include <esp_timer.h>
+#include <atomic>
+
+#define SLOT_MASK 0x03
+#define SLOT_FRESH 0x04   // Middle slot holds a frame the reader has not taken
+
+// Initialize global variables
+RealtimeStats realtimeStats;
+
+static AsyncUDP udp;
+
+// Triple buffer. The writer (UDP task) owns slots[back], the reader
+// (render task) owns slots[front]; they swap with the middle slot.
+static PackedFrame slots[3];
+static uint32_t slotReceivedUs[3];
+static std::atomic<uint8_t> middle(1);
+static uint8_t back = 0;
+static uint8_t front = 2;
+
+// Writer state: the stream as received so far, which deltas apply to
+static uint8_t streamRows[FRAME_ROWS][MAX_DEVICES];
+static bool haveFrame = false;
+static bool haveSeq = false;
+static uint16_t frameSeq = 0;     // Sequence number of streamRows
+static uint16_t lastSeq = 0;      // Highest sequence number seen
+
+static std::atomic<uint32_t> lastPacketMs(0);
+static std::atomic<bool> streaming(false);
+
+// Reader state
+static bool showing = false;
+
+static void publishFrame(uint32_t receivedUs) {
+  PackedFrame& slot = slots[back];
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    memcpy(slot.bytes[row], streamRows[row], MAX_DEVICES);
+  }
+  slotReceivedUs[back] = receivedUs;
+
+  uint8_t previous = middle.exchange(back | SLOT_FRESH, std::memory_order_acq_rel);
+  if (previous & SLOT_FRESH) realtimeStats.overwritten++;
+  back = previous & SLOT_MASK;
+}
+
+static void sendAck(AsyncUDPPacket& udpPacket) {
+  uint8_t ack[REALTIME_HEADER_BYTES];
+  memcpy(ack, udpPacket.data(), REALTIME_HEADER_BYTES);
+  realtimeMakeAck(ack);
+  udpPacket.write(ack, sizeof(ack));
+}
+
+// Runs on the UDP task
+static void handlePacket(AsyncUDPPacket& udpPacket) {
+  uint32_t receivedUs = (uint32_t)esp_timer_get_time();
+  realtimeStats.packets++;
+
+  RealtimePacket packet;
+  if (!realtimeParse(udpPacket.data(), udpPacket.length(), MAX_DEVICES, packet)) {
+    realtimeStats.badPackets++;
+    return;
+  }
+  if (packet.flags & REALTIME_FLAG_ACK) sendAck(udpPacket);
+
+  // A released or timed-out stream may restart from any sequence number
+  if (packet.type == REALTIME_PACKET_RELEASE ||
+      millis() - lastPacketMs.load(std::memory_order_relaxed) >= config.realtimeTimeout) {
+    haveFrame = false;
+    haveSeq = false;
+  }
+  if (packet.type == REALTIME_PACKET_RELEASE) {
+    streaming.store(false, std::memory_order_release);
+    return;
+  }
+
+  if (haveSeq) {
+    int32_t gap = realtimeSeqGap(lastSeq, packet.seq);
+    if (gap < 0) {
+      realtimeStats.outOfOrder++;
+      return;
+    }
+    realtimeStats.lost += gap;
+  }
+  haveSeq = true;
+  lastSeq = packet.seq;
+  realtimeStats.lastSeq = packet.seq;
+
+  if (packet.type == REALTIME_PACKET_DELTA) {
+    if (!haveFrame || packet.baseSeq != frameSeq) {
+      // Its base was lost; wait for the next full frame
+      realtimeStats.staleDeltas++;
+      return;
+    }
+    realtimeStats.deltas++;
+  } else {
+    realtimeStats.frames++;
+  }
+
+  realtimeApply(packet, &streamRows[0][0], MAX_DEVICES, MAX_DEVICES);
+  haveFrame = true;
+  frameSeq = packet.seq;
+
+  publishFrame(receivedUs);
+  lastPacketMs.store(millis(), std::memory_order_release);
+  streaming.store(true, std::memory_order_release);
+}
+
+void initRealtime() {
+  if (!REALTIME_UDP_ENABLED) return;
+
+  if (!udp.listen(REALTIME_UDP_PORT)) {
+    Serial.println("❌ Failed to open realtime UDP port");
+    return;
+  }
+  udp.onPacket(handlePacket);
+  Serial.printf("✅ Realtime UDP listening on port %d\n", REALTIME_UDP_PORT);
+}
+
+bool realtimeRender() {
+  bool live = config.displayOn && streaming.load(std::memory_order_acquire) &&
+              millis() - lastPacketMs.load(std::memory_order_acquire) < config.realtimeTimeout;
+
+  if (!live) {
+    if (showing) {
+      // Stream ended: restart the current item from a clean slate
+      showing = false;
+      realtimeStats.active = false;
+      textNeedsUpdate = true;
+      config.itemStartTime = millis();
+      Serial.println("Realtime stream ended - back to the playlist");
+    }
+    return false;
+  }
+
+  if (!showing) {
+    showing = true;
+    realtimeStats.active = true;
+    grayStop();
+    fbInvalidate();   // The playlist may have drawn through Parola
+    Serial.println("Realtime stream started");
+  }
+
+  if (middle.load(std::memory_order_acquire) & SLOT_FRESH) {
+    front = middle.exchange(front, std::memory_order_acq_rel) & SLOT_MASK;
+    fbSetFrame(slots[front]);
+    fbFlush();
+
+    uint32_t latency = (uint32_t)esp_timer_get_time() - slotReceivedUs[front];
+    realtimeStats.lastLatencyUs = latency;
+    if (latency > realtimeStats.maxLatencyUs) realtimeStats.maxLatencyUs = latency;
+    realtimeStats.shown++;
+  }
+
+  return true;
+}
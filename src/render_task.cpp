@@ -0,0 +1,187 @@
+#include "includes/render_task.h"
+#include "includes/defaults.h"
+#include "includes/config_edit.h"
+#include "includes/events.h"
+#include "includes/persistence.h"
+#include "includes/item_index.h"
+#include "includes/display.h"
+#include "includes/frame_clock.h"
+#include "includes/grayscale.h"
+#include "includes/loop_functions.h"
+#include "includes/preview.h"
+#include "includes/metrics.h"
+#include "includes/spsc_queue.h"
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+#include "freertos/task.h"
+
+// Initialize global variables
+RenderTaskStats renderTaskStats;
+
+static SpscQueue<RenderCommand, RENDER_QUEUE_SIZE> renderQueue;
+static TaskHandle_t renderTask = NULL;
+static EffectMode activeMode = MODE_UNKNOWN;   // Mode the display was last set up for
+
+bool postRenderCommand(RenderCommandType type, const char* text, uint8_t edit) {
+  RenderCommand cmd;
+  cmd.type = type;
+  cmd.postedUs = (unsigned long)esp_timer_get_time();
+  cmd.edit = edit;
+  cmd.text[0] = '\0';
+  if (text != NULL) {
+    strncpy(cmd.text, text, sizeof(cmd.text) - 1);
+    cmd.text[sizeof(cmd.text) - 1] = '\0';
+  }
+
+  if (!renderQueue.push(cmd)) {
+    renderTaskStats.commandsDropped++;
+    return false;
+  }
+  return true;
+}
+
+// Reapply the current item's display settings, clearing up after the
+// previous mode if it changed
+static void reloadCurrentItem() {
+  if (config.items.empty()) return;
+  if (config.currentItemIndex >= config.items.size()) {
+    config.currentItemIndex = 0;
+  }
+
+  DisplayItem& item = config.items[config.currentItemIndex];
+  if (activeMode != item.mode) {
+    clearDisplayForModeChange(activeMode, item.mode);
+  }
+
+  disp.setIntensity(item.brightness);
+  disp.setSpeed(item.textParams().scrollSpeed);
+  disp.setPause(item.textParams().pauseTime);
+  textNeedsUpdate = true;
+}
+
+static void applyRenderCommand(const RenderCommand& cmd, bool& configChanged, bool& reload) {
+  switch (cmd.type) {
+    case RENDER_CMD_RELOAD_ITEM:
+      reload = true;
+      break;
+
+    case RENDER_CMD_EDIT_CONFIG:
+      runConfigEdit(cmd.edit, configChanged, reload);
+      break;
+
+    case RENDER_CMD_SHOW_IP:
+      grayStop();
+      ipDisplayConfig.active = true;
+      ipDisplayConfig.text = cmd.text;
+      ipDisplayConfig.startTime = millis();
+
+      disp.displayClear();
+      disp.setTextAlignment(PA_LEFT);
+      disp.setSpeed(40);  // Slightly faster for IP message
+      disp.displayText(ipDisplayConfig.text.c_str(), PA_LEFT, 40, 1000, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+      break;
+
+    case RENDER_CMD_SHOW_MESSAGE: {
+      // Keep the message in a buffer that outlives the command for Parola
+      static char message[RENDER_COMMAND_TEXT_LEN];
+      strncpy(message, cmd.text, sizeof(message));
+      grayStop();
+      disp.displayClear();
+      disp.setTextAlignment(PA_CENTER);
+      disp.print(message);
+      break;
+    }
+  }
+
+  uint32_t latency = (uint32_t)((unsigned long)esp_timer_get_time() - cmd.postedUs);
+  renderTaskStats.lastCommandLatencyUs = latency;
+  if (latency > renderTaskStats.maxCommandLatencyUs) renderTaskStats.maxCommandLatencyUs = latency;
+  renderTaskStats.commandsApplied++;
+}
+
+// Drain everything the web layer queued since the last frame. Config
+// edits in the batch all land before the frame is drawn, with one reload
+// between them; saving is left to persistTick().
+static void applyRenderCommands() {
+  RenderCommand cmd;
+  bool configChanged = false;
+  bool reload = false;
+  uint32_t edits = 0;
+  int64_t start = esp_timer_get_time();
+
+  while (renderQueue.pop(cmd)) {
+    if (cmd.type == RENDER_CMD_EDIT_CONFIG) edits++;
+    applyRenderCommand(cmd, configChanged, reload);
+  }
+
+  if (reload) reloadCurrentItem();
+  if (configChanged) {
+    ensureItemIds(config);   // Items from replaced lists and zones
+    invalidateItemIndex();   // ...which may have been given new IDs
+    requestConfigSave();
+  }
+
+  if (edits > 0) {
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+    configEditStats.batches++;
+    configEditStats.lastBatchUs = us;
+    if (us > configEditStats.maxBatchUs) configEditStats.maxBatchUs = us;
+    if (edits > configEditStats.largestBatch) configEditStats.largestBatch = edits;
+  }
+}
+
+static void renderTaskMain(void* arg) {
+  // The frame clock and plane timer wake whichever task starts them
+  initFrameClock(config.frameRate);
+  esp_task_wdt_add(NULL);
+
+  int64_t lastTickUs = 0;
+  renderTaskStats.core = xPortGetCoreID();
+  Serial.printf("✅ Render task running on core %d\n", renderTaskStats.core);
+
+  for (;;) {
+    uint32_t events = waitForRenderEvent();
+
+    if (events & GRAY_PLANE_NOTIFY_BIT) grayEmitNextPlane();
+    if (!(events & FRAME_CLOCK_NOTIFY_BIT)) continue;
+
+    esp_task_wdt_reset();
+
+    int64_t tickUs = esp_timer_get_time();
+    if (lastTickUs != 0) metricsObserve(metrics.loopPeriod, (uint32_t)(tickUs - lastTickUs));
+    lastTickUs = tickUs;
+
+    applyRenderCommands();
+    renderFrame();
+    fbSyncFromDriver();
+    previewCapture();
+    persistTick();
+    publishHelloState();
+
+    // Item transitions change the mode without going through a command
+    if (!config.items.empty() && config.currentItemIndex < config.items.size()) {
+      activeMode = config.items[config.currentItemIndex].mode;
+    }
+
+    metricsObserve(metrics.renderFrame, (uint32_t)(esp_timer_get_time() - tickUs));
+    frameDone();
+
+    if ((frameClockStats.frames & 0xFF) == 0) {
+      renderTaskStats.stackHighWater = uxTaskGetStackHighWaterMark(NULL);
+    }
+  }
+}
+
+void startRenderTask() {
+  if (!config.items.empty() && config.currentItemIndex < config.items.size()) {
+    activeMode = config.items[config.currentItemIndex].mode;
+  }
+  publishHelloState();
+
+  BaseType_t result = xTaskCreatePinnedToCore(renderTaskMain, "render", RENDER_TASK_STACK,
+                                              NULL, RENDER_TASK_PRIORITY, &renderTask,
+                                              RENDER_TASK_CORE);
+  if (result != pdPASS) {
+    Serial.println("❌ Failed to start render task!");
+  }
+}
@@ -0,0 +1,135 @@
+#include "includes/display_backend.h"
+#include "includes/defaults.h"
+#include "includes/display.h"
+#include "includes/max7219_packet.h"
+#include <SPI.h>
+#include <driver/spi_master.h>
+#include <esp_heap_caps.h>
+
+// The chain hangs off the VSPI pins MD_MAX72XX uses, so the two backends
+// are interchangeable without rewiring
+#define DMA_SPI_HOST SPI3_HOST
+#define DMA_BATCH_BYTES (FRAME_ROWS * MAX7219_PACKET_BYTES)
+
+static spi_device_handle_t spiDevice = NULL;
+
+// Two batches: one is built while the other is on the wire
+static uint8_t* batchBuffers[2] = {NULL, NULL};
+static spi_transaction_t batchTrans[2][FRAME_ROWS];
+static uint8_t nextBatch = 0;
+static uint8_t inFlight = 0;             // Row transactions queued and not yet collected
+
+static uint8_t* commandBuffer = NULL;    // Init and intensity packets
+static uint8_t currentIntensity = 0xFF;
+
+// Collect finished transactions so their buffer can be reused
+static void waitForBatch() {
+  spi_transaction_t* done;
+  while (inFlight > 0) {
+    spi_device_get_trans_result(spiDevice, &done, portMAX_DELAY);
+    inFlight--;
+  }
+}
+
+static void sendCommand(uint8_t opcode, uint8_t data) {
+  waitForBatch();
+
+  spi_transaction_t trans = {};
+  trans.length = max7219BuildCommand(commandBuffer, MAX_DEVICES, opcode, data) * 8;
+  trans.tx_buffer = commandBuffer;
+  spi_device_polling_transmit(spiDevice, &trans);
+}
+
+bool SpiDmaBackend::begin() {
+  // Packets are built for modules whose digit registers are rows
+  if (HARDWARE_TYPE != MD_MAX72XX::FC16_HW) {
+    Serial.println("⚠️ SPI DMA backend only supports FC16 modules");
+    return false;
+  }
+
+  for (uint8_t i = 0; i < 2; i++) {
+    batchBuffers[i] = (uint8_t*)heap_caps_malloc(DMA_BATCH_BYTES, MALLOC_CAP_DMA);
+  }
+  commandBuffer = (uint8_t*)heap_caps_malloc(MAX7219_PACKET_BYTES, MALLOC_CAP_DMA);
+  if (batchBuffers[0] == NULL || batchBuffers[1] == NULL || commandBuffer == NULL) {
+    Serial.println("❌ Failed to allocate SPI DMA buffers");
+    return false;
+  }
+
+  // Take the bus away from the Arduino SPI driver. MD_MAX72XX keeps
+  // drawing into its own buffer but its transfers become no-ops.
+  SPI.end();
+
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = MOSI;
+  bus.miso_io_num = -1;
+  bus.sclk_io_num = SCK;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = DMA_BATCH_BYTES;
+
+  spi_device_interface_config_t dev = {};
+  dev.mode = 0;
+  dev.clock_speed_hz = DISPLAY_SPI_CLOCK_HZ;
+  dev.spics_io_num = CS_PIN;          // CS rising edge latches each row
+  dev.queue_size = FRAME_ROWS;
+
+  esp_err_t err = spi_bus_initialize(DMA_SPI_HOST, &bus, SPI_DMA_CH_AUTO);
+  if (err == ESP_OK) {
+    err = spi_bus_add_device(DMA_SPI_HOST, &dev, &spiDevice);
+    if (err != ESP_OK) spi_bus_free(DMA_SPI_HOST);
+  }
+
+  if (err != ESP_OK) {
+    Serial.printf("❌ SPI DMA init failed: %s\n", esp_err_to_name(err));
+    SPI.begin();   // Hand the bus back to MD_MAX72XX
+    spiDevice = NULL;
+    return false;
+  }
+
+  // Same register setup MD_MAX72XX does in begin()
+  sendCommand(MAX7219_OP_DISPLAYTEST, 0);
+  sendCommand(MAX7219_OP_SCANLIMIT, 7);
+  sendCommand(MAX7219_OP_DECODEMODE, 0);
+  sendCommand(MAX7219_OP_SHUTDOWN, 1);
+  setIntensity(disp.getIntensity());
+
+  return true;
+}
+
+void SpiDmaBackend::sendRows(const PackedFrame& frame, uint8_t rowMask) {
+  if (rowMask == 0) return;
+
+  // Build into the idle buffer while the previous batch may still be sending
+  uint8_t* buffer = batchBuffers[nextBatch];
+  spi_transaction_t* trans = batchTrans[nextBatch];
+  uint8_t count = 0;
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    if (!(rowMask & (1 << row))) continue;
+
+    uint8_t* packet = buffer + count * MAX7219_PACKET_BYTES;
+    size_t len = max7219BuildRowPacket(packet, MAX_DEVICES, row, frame.bytes[row], true, false);
+
+    memset(&trans[count], 0, sizeof(spi_transaction_t));
+    trans[count].length = len * 8;
+    trans[count].tx_buffer = packet;
+    count++;
+  }
+
+  waitForBatch();
+
+  for (uint8_t i = 0; i < count; i++) {
+    spi_device_queue_trans(spiDevice, &trans[i], portMAX_DELAY);
+  }
+  inFlight = count;
+  nextBatch ^= 1;
+}
+
+void SpiDmaBackend::setIntensity(uint8_t level) {
+  if (level > 15) level = 15;
+  if (level == currentIntensity) return;
+
+  sendCommand(MAX7219_OP_INTENSITY, level);
+  currentIntensity = level;
+}
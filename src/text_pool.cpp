@@ -0,0 +1,154 @@
+#include "includes/text_pool.h"
+#include "includes/defaults.h"
+#include "freertos/semphr.h"
+#include <atomic>
+#include <new>
+
+// Initialize global variables
+TextPoolStats textPoolStats;
+
+struct TextPage {
+  uint32_t size;                // Bytes, header included
+  uint32_t used;
+  uint32_t live;                // Strings still referenced
+};
+
+struct TextEntry {
+  TextPage* page;
+  std::atomic<uint16_t> refs;
+  uint16_t length;
+  // Characters and a NUL follow
+};
+
+static TextPage* filling = NULL;  // Page new strings go into
+static SemaphoreHandle_t poolLock = NULL;
+
+void initTextPool() {
+  poolLock = xSemaphoreCreateMutex();
+}
+
+// Entries start on TextEntry's alignment, so round both sizes up to it
+static inline size_t alignEntry(size_t bytes) {
+  return (bytes + alignof(TextEntry) - 1) & ~(alignof(TextEntry) - 1);
+}
+
+static const size_t PAGE_HEADER = alignEntry(sizeof(TextPage));
+
+static inline size_t entryBytes(size_t length) {
+  return alignEntry(sizeof(TextEntry) + length + 1);
+}
+
+static TextPage* newPage(size_t size) {
+  TextPage* page = (TextPage*)malloc(size);
+  if (page == NULL) return NULL;
+  page->size = size;
+  page->used = PAGE_HEADER;
+  page->live = 0;
+  textPoolStats.pages++;
+  textPoolStats.bytes += size;
+  return page;
+}
+
+static void freePage(TextPage* page) {
+  textPoolStats.pages--;
+  textPoolStats.bytes -= page->size;
+  free(page);
+}
+
+TextEntry* textPoolStore(const char* data, size_t length) {
+  if (data == NULL || length == 0) return NULL;
+  if (length > 0xFFFF) length = 0xFFFF;
+  size_t need = entryBytes(length);
+
+  xSemaphoreTake(poolLock, portMAX_DELAY);
+  TextPage* page = filling;
+  if (need > TEXT_POOL_PAGE_BYTES - PAGE_HEADER) {
+    page = newPage(PAGE_HEADER + need);   // A page of its own
+  } else if (page == NULL || page->size - page->used < need) {
+    // The old page is freed with its last string
+    page = newPage(TEXT_POOL_PAGE_BYTES);
+    if (page) filling = page;
+  }
+  if (page == NULL) {
+    textPoolStats.storeFailures++;
+    xSemaphoreGive(poolLock);
+    return NULL;
+  }
+
+  TextEntry* entry = new ((uint8_t*)page + page->used) TextEntry;
+  page->used += need;
+  page->live++;
+  textPoolStats.strings++;
+  textPoolStats.textBytes += length;
+  xSemaphoreGive(poolLock);
+
+  entry->page = page;
+  entry->refs.store(1, std::memory_order_relaxed);
+  entry->length = length;
+  char* chars = (char*)(entry + 1);
+  memcpy(chars, data, length);
+  chars[length] = '\0';
+  return entry;
+}
+
+void textPoolRetain(TextEntry* entry) {
+  if (entry) entry->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void textPoolRelease(TextEntry* entry) {
+  if (entry == NULL || entry->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+  xSemaphoreTake(poolLock, portMAX_DELAY);
+  TextPage* page = entry->page;
+  textPoolStats.strings--;
+  textPoolStats.textBytes -= entry->length;
+  if (--page->live == 0) {
+    if (page == filling) {
+      page->used = PAGE_HEADER;   // Fill it again rather than allocate the next one
+    } else {
+      freePage(page);
+    }
+  }
+  xSemaphoreGive(poolLock);
+}
+
+const char* textPoolData(const TextEntry* entry) {
+  return entry ? (const char*)(entry + 1) : "";
+}
+
+size_t textPoolLength(const TextEntry* entry) {
+  return entry ? entry->length : 0;
+}
+
+PooledText& PooledText::operator=(const PooledText& other) {
+  if (entry != other.entry) {
+    textPoolRetain(other.entry);
+    textPoolRelease(entry);
+    entry = other.entry;
+  }
+  return *this;
+}
+
+PooledText& PooledText::operator=(PooledText&& other) {
+  if (this != &other) {
+    textPoolRelease(entry);
+    entry = other.entry;
+    other.entry = NULL;
+  }
+  return *this;
+}
+
+void PooledText::set(const char* data, size_t length) {
+  TextEntry* stored = textPoolStore(data, length);
+  textPoolRelease(entry);
+  entry = stored;
+}
+
+bool PooledText::operator==(const PooledText& other) const {
+  if (entry == other.entry) return true;
+  return length() == other.length() && memcmp(c_str(), other.c_str(), length()) == 0;
+}
+
+bool PooledText::operator==(const char* other) const {
+  return strcmp(c_str(), other ? other : "") == 0;
+}
@@ -0,0 +1,93 @@
+#include "includes/text_raster.h"
+#include "includes/defaults.h"
+#include "includes/display.h"
+#include "includes/font.h"
+#include <esp_timer.h>
+
+// Initialize global variables
+TextRasterStats textRasterStats;
+
+static void rasterize(std::vector<uint8_t>& columns, const PooledText& text) {
+  uint8_t spacing = disp.getCharSpacing();
+
+  // Measure first so the raster is sized exactly once
+  uint32_t width = fontTextWidth(text.c_str(), spacing);
+  if (width > TEXT_RASTER_MAX_COLS) {
+    Serial.println("⚠️ Text too wide to rasterize, truncating");
+    width = TEXT_RASTER_MAX_COLS;
+  }
+
+  columns.resize(width);
+  columns.shrink_to_fit();
+  fontRender(text.c_str(), spacing, columns.data(), width);
+}
+
+void textRasterPrepare(TextRaster& raster, DisplayItem& item) {
+  raster.scrollStartTime = millis();
+
+  if (raster.valid && raster.text == item.text) {
+    textRasterStats.cacheHits++;
+    return;
+  }
+
+  int64_t start = esp_timer_get_time();
+  rasterize(raster.columns, item.text);
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+  raster.text = item.text;
+  raster.valid = true;
+
+  textRasterStats.rasters++;
+  textRasterStats.lastRasterUs = elapsed;
+  textRasterStats.width = raster.columns.size();
+  textRasterStats.bytes = raster.columns.capacity();
+
+  ModeParams* params = item.paramsFor(MODE_TEXT);
+  if (params) {
+    params->text.rasterUs = elapsed;
+    params->text.rasterBytes = raster.columns.capacity();
+  }
+}
+
+// Columns scrolled so far. The text slides in, holds for pauseTime once
+// aligned, then slides out; positions come from the clock rather than a
+// per-frame step, so any speed works at any frame rate.
+static int32_t scrollPosition(const TextRaster& raster, const DisplayItem& item,
+                              int32_t width, int32_t span) {
+  const TextParams& params = item.textParams();
+  uint32_t msPerCol = params.scrollSpeed > 0 ? params.scrollSpeed : 1;
+  uint32_t pause = params.pauseTime;
+  uint32_t inMs = span * msPerCol;
+  uint32_t outMs = width * msPerCol;
+
+  uint32_t t = (millis() - raster.scrollStartTime) % (inMs + pause + outMs);
+  if (t < inMs) return t / msPerCol;
+  if (t < inMs + pause) return span;
+  return span + (t - inMs - pause) / msPerCol;
+}
+
+void textRasterDraw(const TextRaster& raster, const DisplayItem& item,
+                    uint16_t firstCol, uint16_t cols) {
+  if (firstCol >= FRAME_COLS) return;
+  if (firstCol + cols > FRAME_COLS) cols = FRAME_COLS - firstCol;
+
+  int32_t width = raster.columns.size();
+  int32_t span = cols;
+  int32_t left;   // Zone x of the first text column
+
+  bool scrolling = item.alignment == PA_SCROLL_LEFT || item.alignment == PA_SCROLL_RIGHT ||
+                   width > span;
+
+  if (scrolling) {
+    int32_t pos = scrollPosition(raster, item, width, span);
+    left = (item.alignment == PA_SCROLL_RIGHT) ? pos - width : span - pos;
+  } else if (item.alignment == PA_CENTER) {
+    left = (span - width) / 2;
+  } else if (item.alignment == PA_RIGHT) {
+    left = span - width;
+  } else {
+    left = 0;
+  }
+
+  fbDrawColumns(raster.columns.data(), width, left, firstCol, cols, item.invert);
+}
@@ -9,4 +9,13 @@ void delayWithWatchdog(unsigned long delayTime) {
       esp_task_wdt_reset();
       delay(50); // Small delay between watchdog resets
     }
-  }
\ No newline at end of file
+  }
+
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
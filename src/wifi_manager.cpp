@@ -1,6 +1,7 @@
 #include <WiFiManager.h>
 #include "includes/wifi_manager.h"
 #include "includes/display.h"
+#include "includes/framebuffer.h"
 #include "includes/utils.h"
 #include <ESPAsyncWebServer.h>
 
@@ -115,6 +116,7 @@ void processWiFiSetup() {
         if (disp.displayAnimate()) {
           disp.displayReset();
         }
+        fbSyncFromDriver();
       }
       
       // Check for timeout
@@ -176,9 +178,6 @@ void setupPostWiFiConnection() {
   disp.setTextAlignment(PA_LEFT);
   disp.setSpeed(40);  // Slightly faster for IP message
   disp.displayText(ipDisplayConfig.text.c_str(), PA_LEFT, 40, 1000, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
-  
-  // Load the user's actual config in the background
-  loadConfig();
 }
 
 bool isWiFiSetupComplete() {
@@ -0,0 +1,182 @@
+#include "includes/zones.h"
+#include "includes/loop_functions.h"
+#include "includes/display.h"
+#include "includes/framebuffer.h"
+#include "includes/grayscale.h"
+#include "includes/effect_registry.h"
+
+static ZoneRuntime runtimes[MAX_ZONES];
+
+// Binary content of every zone; grayscale zones draw into grayBuffer
+static PackedFrame zoneFrame;
+static PackedFrame grayMask;              // Columns owned by grayscale content
+static PackedFrame layeredPlanes[GRAY_PLANES];
+static PackedFrame layeredMask;           // Columns owned by grayscale layered items
+static PackedFrame zonePlanes[GRAY_PLANES];
+static PackedFrame outPlanes[GRAY_PLANES];
+
+uint8_t zoneCount() {
+  size_t count = 1 + config.zones.size();
+  return count > MAX_ZONES ? MAX_ZONES : count;
+}
+
+DisplayZone& zoneAt(uint8_t index) {
+  if (index == 0 || index > config.zones.size()) return config;
+  return config.zones[index - 1];
+}
+
+ZoneRuntime* zoneRuntime(uint8_t index) {
+  return &runtimes[index < MAX_ZONES ? index : 0];
+}
+
+int zoneIndexOf(const DisplayZone& zone) {
+  for (uint8_t i = 0; i < zoneCount(); i++) {
+    if (&zoneAt(i) == &zone) return i;
+  }
+  return -1;
+}
+
+void sanitizeZone(DisplayZone& zone) {
+  if (zone.startCol >= FRAME_COLS) zone.startCol = FRAME_COLS - 1;
+  if (zone.width == 0 || zone.startCol + zone.width > FRAME_COLS) {
+    zone.width = FRAME_COLS - zone.startCol;
+  }
+  if (zone.currentItemIndex < 0 || zone.currentItemIndex >= (int)zone.items.size()) {
+    zone.currentItemIndex = 0;
+  }
+}
+
+uint16_t zoneFirstCol(const DisplayZone& zone) {
+  return FRAME_COLS - zone.startCol - zone.width;
+}
+
+static void orInto(PackedFrame& dst, const PackedFrame& src) {
+  uint32_t* d = &dst.words[0][0];
+  const uint32_t* s = &src.words[0][0];
+  for (size_t i = 0; i < FRAME_ROWS * FRAME_ROW_WORDS; i++) d[i] |= s[i];
+}
+
+// Replace dst's bits under mask with src's
+static void mergeInto(PackedFrame& dst, const PackedFrame& src, const PackedFrame& mask) {
+  uint32_t* d = &dst.words[0][0];
+  const uint32_t* s = &src.words[0][0];
+  const uint32_t* m = &mask.words[0][0];
+  for (size_t i = 0; i < FRAME_ROWS * FRAME_ROW_WORDS; i++) d[i] = (d[i] & ~m[i]) | (s[i] & m[i]);
+}
+
+// Start a zone's current item over in its columns
+static void setUpZone(DisplayZone& zone, ZoneRuntime& rt, uint16_t firstCol) {
+  DisplayItem& item = zone.items[zone.currentItemIndex];
+
+  resetEffects(&rt.effects, firstCol, zone.width);
+  fbSetTarget(&zoneFrame);
+  fbClearColumns(firstCol, zone.width);
+  fbSetTarget(NULL);
+  grayClearColumns(firstCol, zone.width);
+
+  bool needsText = effectHas(item.mode, EFFECT_TEXT);
+  for (const DisplayLayer& layer : item.layers()) {
+    if (effectHas(layer.mode, EFFECT_TEXT)) needsText = true;
+  }
+  if (needsText) textRasterPrepare(rt.text, item);
+  if (item.mode == MODE_LAYERS) resetLayers(rt.layers, item);
+  if (effectHas(item.mode, EFFECT_FRAMES)) {
+    animationOpen(rt.animation, item.file());
+  } else {
+    animationClose(rt.animation);
+  }
+
+  rt.activeMode = item.mode;
+  rt.firstCol = firstCol;
+  rt.cols = zone.width;
+  rt.reload = false;
+  if (zone.itemStartTime == 0) zone.itemStartTime = millis();
+}
+
+void renderZones() {
+  uint8_t count = zoneCount();
+
+  if (textNeedsUpdate) {
+    for (uint8_t i = 0; i < count; i++) runtimes[i].reload = true;
+    disp.setIntensity(config.items[config.currentItemIndex].brightness);
+    textNeedsUpdate = false;
+  }
+
+  bool anyGray = false;
+  memset(&grayMask, 0, sizeof(grayMask));
+  memset(&layeredMask, 0, sizeof(layeredMask));
+
+  for (uint8_t i = 0; i < count; i++) {
+    DisplayZone& zone = zoneAt(i);
+    ZoneRuntime& rt = runtimes[i];
+    if (zone.items.empty() || zone.width == 0) continue;
+
+    if (zone.currentItemIndex >= (int)zone.items.size()) zone.currentItemIndex = 0;
+    validateCurrentItem(zone);
+    if (checkForItemTransition(zone)) processItemTransition(zone);
+    if (zone.items.empty()) continue;
+
+    uint16_t firstCol = zoneFirstCol(zone);
+    DisplayItem& item = zone.items[zone.currentItemIndex];
+    if (rt.reload || rt.activeMode != item.mode || rt.firstCol != firstCol || rt.cols != zone.width) {
+      setUpZone(zone, rt, firstCol);
+    }
+
+    selectEffects(&rt.effects);
+    fbSetTarget(&zoneFrame);
+
+    const EffectInfo& effect = effectInfo(item.mode);
+    if (effect.flags & EFFECT_TEXT) {
+      textRasterDraw(rt.text, item, firstCol, zone.width);
+    } else if (effect.flags & EFFECT_FRAMES) {
+      animationUpdate(rt.animation, item);
+      animationDraw(rt.animation, item, firstCol, zone.width);
+    } else if (effect.flags & EFFECT_GRAY) {
+      effect.update(item);
+      PackedFrame columns;
+      fbColumnMask(columns, firstCol, zone.width);
+      orInto(grayMask, columns);
+      anyGray = true;
+    } else if (effect.update) {
+      effect.update(item);
+    } else if (item.mode == MODE_LAYERS) {
+      bool gray = composeLayers(item, rt.layers, rt.text, zonePlanes);
+      fbSetTarget(&zoneFrame);
+
+      PackedFrame columns;
+      fbColumnMask(columns, firstCol, zone.width);
+      if (gray) {
+        for (uint8_t p = 0; p < GRAY_PLANES; p++) mergeInto(layeredPlanes[p], zonePlanes[p], columns);
+        orInto(layeredMask, columns);
+        anyGray = true;
+      } else {
+        mergeInto(zoneFrame, zonePlanes[0], columns);
+      }
+    }
+  }
+
+  selectEffects(&runtimes[0].effects);
+  fbSetTarget(NULL);
+
+  if (!anyGray) {
+    fbSetFrame(zoneFrame);
+    grayStop();
+    fbFlush();
+    return;
+  }
+
+  // Grayscale zones keep their planes, layered zones theirs, and binary
+  // zones show as full intensity in every plane
+  graySlice(grayBuffer, outPlanes);
+  PackedFrame binaryMask;
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint8_t w = 0; w < FRAME_ROW_WORDS; w++) {
+      binaryMask.words[row][w] = ~(grayMask.words[row][w] | layeredMask.words[row][w]);
+    }
+  }
+  for (uint8_t p = 0; p < GRAY_PLANES; p++) {
+    mergeInto(outPlanes[p], layeredPlanes[p], layeredMask);
+    mergeInto(outPlanes[p], zoneFrame, binaryMask);
+  }
+  grayCommitPlanes(outPlanes);
+}
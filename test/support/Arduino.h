@@ -0,0 +1,139 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Just enough of the Arduino core to build the hardware-free sources on
+// the host for the native unit tests. Serial output is discarded.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define PI 3.1415926535897932384626433832795
+#define TWO_PI 6.283185307179586476925286766559
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+inline auto constrain(T x, L low, H high) -> decltype(x + low + high) {
+  return x < low ? low : (x > high ? high : x);
+}
+
+// The host clock, in microseconds. It only moves when a test sets it, so
+// anything timed by millis(), micros() or esp_timer_get_time() runs the
+// same way every time. Atomic for the tests with a second thread, which
+// keep it at the real time.
+inline std::atomic<int64_t> hostTimeUs(0);
+inline unsigned long micros() { return (unsigned long)hostTimeUs; }
+inline unsigned long millis() { return (unsigned long)(hostTimeUs / 1000); }
+inline void delay(unsigned long ms) { hostTimeUs += (int64_t)ms * 1000; }
+inline void yield() {}
+
+// Seeded like the core: the same seed gives the same sequence
+inline std::minstd_rand hostRandom;
+inline void randomSeed(unsigned long seed) { hostRandom.seed(seed); }
+inline long random(long howBig) {
+  return howBig > 0 ? (long)(hostRandom() % (unsigned long)howBig) : 0;
+}
+inline long random(long howSmall, long howBig) {
+  return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+class String {
+ public:
+  String() {}
+  String(const char* text) : s(text != NULL ? text : "") {}
+  String(const std::string& text) : s(text) {}
+  String(char c) : s(1, c) {}
+  String(int value) : s(std::to_string(value)) {}
+  String(unsigned value) : s(std::to_string(value)) {}
+  String(long value) : s(std::to_string(value)) {}
+  String(unsigned long value) : s(std::to_string(value)) {}
+
+  size_t length() const { return s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  bool isEmpty() const { return s.empty(); }
+  char operator[](size_t i) const { return s[i]; }
+  bool operator==(const String& other) const { return s == other.s; }
+  bool operator!=(const String& other) const { return s != other.s; }
+  bool operator==(const char* other) const { return s == other; }
+  bool operator!=(const char* other) const { return s != other; }
+  String& operator+=(const String& other) { s += other.s; return *this; }
+  String& operator+=(const char* other) { s += other; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  bool reserve(size_t size) { s.reserve(size); return true; }
+  bool concat(const char* text) { s += text; return true; }
+  bool concat(const char* text, size_t len) { s.append(text, len); return true; }
+  long toInt() const { return atol(s.c_str()); }
+
+ private:
+  std::string s;
+};
+
+// ArduinoJson's String support names this type too
+class StringSumHelper : public String {
+ public:
+  using String::String;
+};
+
+inline String operator+(const String& a, const String& b) { return String(std::string(a.c_str()) + b.c_str()); }
+inline String operator+(const String& a, const char* b) { return a + String(b); }
+inline String operator+(const char* a, const String& b) { return String(a) + b; }
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) { return 1; }
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+  }
+
+  size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+  size_t print(const String& text) { return print(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long value) { return print(String(value)); }
+  size_t print(unsigned long value) { return print(String(value)); }
+  size_t print(int value) { return print((long)value); }
+  size_t print(unsigned value) { return print((unsigned long)value); }
+  size_t print(double value, int digits = 2) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return print(text);
+  }
+  template <class T>
+  size_t println(const T& value) { return print(value) + println(); }
+  size_t println() { return print("\r\n"); }
+  size_t printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return n > 0 ? print(text) : 0;
+  }
+};
+
+class HardwareSerial : public Print {
+ public:
+  void begin(unsigned long) {}
+};
+
+inline HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
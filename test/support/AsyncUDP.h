@@ -0,0 +1,105 @@
+#ifndef HOST_ASYNC_UDP_H
+#define HOST_ASYNC_UDP_H
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// AsyncUDP for the native unit tests, on a host UDP socket bound to
+// loopback. A thread stands in for the UDP task: it calls the packet
+// handler for each datagram, as the device does, while the test runs
+// the render side on its own thread.
+
+class AsyncUDPPacket {
+ public:
+  AsyncUDPPacket(int sock, uint8_t* data, size_t length, const sockaddr_in& from)
+      : sock(sock), bytes(data), size(length), from(from) {}
+
+  uint8_t* data() { return bytes; }
+  size_t length() { return size; }
+
+  // Reply to the sender
+  size_t write(const uint8_t* data, size_t length) {
+    ssize_t sent = sendto(sock, data, length, 0, (const sockaddr*)&from, sizeof(from));
+    return sent < 0 ? 0 : (size_t)sent;
+  }
+
+ private:
+  int sock;
+  uint8_t* bytes;
+  size_t size;
+  sockaddr_in from;
+};
+
+typedef std::function<void(AsyncUDPPacket& packet)> AuPacketHandlerFunction;
+
+class AsyncUDP {
+ public:
+  ~AsyncUDP() { close(); }
+
+  bool listen(uint16_t port) {
+    close();
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) return false;
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(sock, (const sockaddr*)&address, sizeof(address)) < 0) {
+      ::close(sock);
+      sock = -1;
+      return false;
+    }
+    running = true;
+    task = std::thread([this]() { receive(); });
+    return true;
+  }
+
+  void onPacket(AuPacketHandlerFunction callback) {
+    std::lock_guard<std::mutex> lock(handlerLock);
+    handler = callback;
+  }
+
+  bool connected() const { return sock >= 0; }
+
+  void close() {
+    if (task.joinable()) {
+      running = false;
+      task.join();
+    }
+    if (sock >= 0) ::close(sock);
+    sock = -1;
+  }
+
+ private:
+  int sock = -1;
+  std::atomic<bool> running{false};
+  std::thread task;
+  std::mutex handlerLock;
+  AuPacketHandlerFunction handler;
+
+  // Polls so close() is seen within a few milliseconds
+  void receive() {
+    uint8_t buffer[1500];
+    while (running) {
+      pollfd ready = {sock, POLLIN, 0};
+      if (poll(&ready, 1, 5) <= 0) continue;
+      sockaddr_in from;
+      socklen_t fromLength = sizeof(from);
+      ssize_t length = recvfrom(sock, buffer, sizeof(buffer), 0, (sockaddr*)&from, &fromLength);
+      if (length < 0) continue;
+      AsyncUDPPacket packet(sock, buffer, (size_t)length, from);
+      std::lock_guard<std::mutex> lock(handlerLock);
+      if (handler) handler(packet);
+    }
+  }
+};
+
+#endif // HOST_ASYNC_UDP_H
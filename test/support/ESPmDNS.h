@@ -0,0 +1,7 @@
+#ifndef HOST_ESPMDNS_H
+#define HOST_ESPMDNS_H
+
+// config.h includes this; nothing under test touches the hardware
+#include <Arduino.h>
+
+#endif // HOST_ESPMDNS_H
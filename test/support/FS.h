@@ -0,0 +1,101 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+// SPIFFS kept in memory, so the config files can be written and read back
+// on the host. Files are byte vectors by path; a test can inspect or
+// damage them through hostFiles.
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+typedef std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> HostFileMap;
+inline HostFileMap hostFiles;
+
+class File : public Print {
+ public:
+  File() : pos(0) {}
+  File(std::shared_ptr<std::vector<uint8_t>> data, size_t pos) : data(data), pos(pos) {}
+
+  explicit operator bool() const { return data != nullptr; }
+  size_t size() const { return data ? data->size() : 0; }
+  size_t position() const { return pos; }
+  int available() { return (int)(size() - pos); }
+  void close() { data.reset(); }
+
+  bool seek(uint32_t offset) {
+    if (!data || offset > data->size()) return false;
+    pos = offset;
+    return true;
+  }
+
+  int read() {
+    if (!data || pos >= data->size()) return -1;
+    return (*data)[pos++];
+  }
+
+  size_t read(uint8_t* buffer, size_t length) {
+    if (!data) return 0;
+    size_t n = std::min(length, data->size() - pos);
+    memcpy(buffer, data->data() + pos, n);
+    pos += n;
+    return n;
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t length) override {
+    if (!data) return 0;
+    if (data->size() < pos + length) data->resize(pos + length);
+    memcpy(data->data() + pos, buffer, length);
+    pos += length;
+    return length;
+  }
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> data;
+  size_t pos;
+};
+
+namespace fs {
+
+class FS {
+ public:
+  bool begin(bool formatOnFail = false) { return true; }
+
+  File open(const char* path, const char* mode = FILE_READ) {
+    auto it = hostFiles.find(path);
+    if (mode[0] == 'r') {
+      return it != hostFiles.end() ? File(it->second, 0) : File();
+    }
+    if (mode[0] == 'w' || it == hostFiles.end()) {
+      auto data = std::make_shared<std::vector<uint8_t>>();
+      hostFiles[path] = data;
+      return File(data, 0);
+    }
+    return File(it->second, it->second->size());
+  }
+  File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+
+  bool exists(const char* path) { return hostFiles.count(path) > 0; }
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path) { return hostFiles.erase(path) > 0; }
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to) {
+    auto it = hostFiles.find(from);
+    if (it == hostFiles.end()) return false;
+    if (it->first == to) return true;
+    hostFiles[to] = it->second;
+    hostFiles.erase(from);
+    return true;
+  }
+};
+
+}  // namespace fs
+
+#endif // HOST_FS_H
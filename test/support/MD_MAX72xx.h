@@ -0,0 +1,31 @@
+#ifndef HOST_MD_MAX72XX_H
+#define HOST_MD_MAX72XX_H
+
+#include <Arduino.h>
+
+// The driver's column buffer without the chain: enough for code that
+// reads back what Parola drew. Column 0 is the rightmost, as on the chain.
+class MD_MAX72XX {
+ public:
+  enum moduleType_t { PAROLA_HW, GENERIC_HW, ICSTATION_HW, FC16_HW };
+
+  MD_MAX72XX(moduleType_t, uint8_t, uint8_t devices) : columnCount(devices * 8) {
+    columns = new uint8_t[columnCount]();
+  }
+  ~MD_MAX72XX() { delete[] columns; }
+
+  uint16_t getColumnCount() { return columnCount; }
+  uint8_t getColumn(uint16_t col) { return col < columnCount ? columns[col] : 0; }
+  bool setColumn(uint16_t col, uint8_t value) {
+    if (col >= columnCount) return false;
+    columns[col] = value;
+    return true;
+  }
+  void clear() { memset(columns, 0, columnCount); }
+
+ private:
+  uint16_t columnCount;
+  uint8_t* columns;
+};
+
+#endif // HOST_MD_MAX72XX_H
@@ -0,0 +1,27 @@
+#ifndef HOST_MD_PAROLA_H
+#define HOST_MD_PAROLA_H
+
+#include "MD_MAX72xx.h"
+
+enum textPosition_t { PA_LEFT, PA_CENTER, PA_RIGHT };
+enum textEffect_t { PA_NO_EFFECT, PA_PRINT, PA_SCROLL_UP, PA_SCROLL_DOWN, PA_SCROLL_LEFT, PA_SCROLL_RIGHT };
+
+// Parola keeps its text machinery on the device; the host only has the
+// graphic object, the intensity and the character spacing text rasters use
+class MD_Parola {
+ public:
+  MD_Parola(MD_MAX72XX::moduleType_t type, uint8_t csPin, uint8_t devices)
+      : graphics(type, csPin, devices), intensity(0) {}
+
+  MD_MAX72XX* getGraphicObject() { return &graphics; }
+  void setIntensity(uint8_t level) { intensity = level; }
+  uint8_t getIntensity() { return intensity; }
+  void displayClear() { graphics.clear(); }
+  uint8_t getCharSpacing() { return 1; }   // Parola's default
+
+ private:
+  MD_MAX72XX graphics;
+  uint8_t intensity;
+};
+
+#endif // HOST_MD_PAROLA_H
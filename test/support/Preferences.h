@@ -0,0 +1,9 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+
+// config.h declares the NVS handle; nothing under test opens it
+class Preferences {};
+
+#endif // HOST_PREFERENCES_H
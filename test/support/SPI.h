@@ -0,0 +1,7 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+// config.h includes this; nothing under test touches the hardware
+#include <Arduino.h>
+
+#endif // HOST_SPI_H
@@ -0,0 +1,7 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// config.h includes this; nothing under test touches the network
+#include <Arduino.h>
+
+#endif // HOST_WIFI_H
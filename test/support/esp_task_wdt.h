@@ -0,0 +1,7 @@
+#ifndef HOST_ESP_TASK_WDT_H
+#define HOST_ESP_TASK_WDT_H
+
+// No watchdog on the host
+inline int esp_task_wdt_reset() { return 0; }
+
+#endif // HOST_ESP_TASK_WDT_H
@@ -0,0 +1,47 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <Arduino.h>
+
+// esp_timer for the native unit tests, on the host clock (Arduino.h).
+// Timers never fire by themselves: a test reads the last one-shot delay
+// and calls the code the callback would have woken.
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef struct esp_timer* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void* arg);
+typedef enum { ESP_TIMER_TASK } esp_timer_dispatch_t;
+typedef struct {
+  esp_timer_cb_t callback;
+  void* arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char* name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+inline bool hostTimerRunning = false;
+inline uint64_t hostTimerDelayUs = 0;   // Of the last esp_timer_start_once()
+inline uint32_t hostTimerStarts = 0;
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t*, esp_timer_handle_t* handle) {
+  static char timer;
+  *handle = reinterpret_cast<esp_timer_handle_t>(&timer);
+  return ESP_OK;
+}
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t, uint64_t timeoutUs) {
+  hostTimerRunning = true;
+  hostTimerDelayUs = timeoutUs;
+  hostTimerStarts++;
+  return ESP_OK;
+}
+inline esp_err_t esp_timer_stop(esp_timer_handle_t) {
+  hostTimerRunning = false;
+  return ESP_OK;
+}
+inline const char* esp_err_to_name(esp_err_t err) { return err == ESP_OK ? "ESP_OK" : "ESP_FAIL"; }
+inline int64_t esp_timer_get_time() { return hostTimeUs; }
+
+#endif // HOST_ESP_TIMER_H
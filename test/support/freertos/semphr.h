@@ -0,0 +1,18 @@
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include <mutex>
+
+// Mutexes over std::mutex; the handle is never freed, like on the device
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::mutex(); }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t) {
+  static_cast<std::mutex*>(mutex)->lock();
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  static_cast<std::mutex*>(mutex)->unlock();
+  return pdTRUE;
+}
+
+#endif // HOST_FREERTOS_SEMPHR_H
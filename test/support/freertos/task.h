@@ -0,0 +1,11 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+// There is no render task on the host: notifications go nowhere
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return NULL; }
+inline BaseType_t xTaskNotify(TaskHandle_t, uint32_t, eNotifyAction) { return pdPASS; }
+inline void vTaskDelay(TickType_t) {}
+
+#endif // HOST_FREERTOS_TASK_H
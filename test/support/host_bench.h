@@ -0,0 +1,39 @@
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <chrono>
+
+// Wall-clock timing for the host benchmarks in the native tests. The
+// figures depend on the machine and the build flags, so only compare
+// rows of the same run; the on-device numbers are in /debug.
+
+// Nanoseconds per call of run(), the best of a few rounds of calls each
+// so a preempted round does not count
+template <typename Fn>
+inline double benchNs(uint32_t calls, Fn run, uint8_t rounds = 5) {
+  double best = 0;
+  for (uint8_t round = 0; round < rounds; round++) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; i++) run();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double ns = elapsed.count() / calls;
+    if (round == 0 || ns < best) best = ns;
+  }
+  return best;
+}
+
+// One line of a benchmark table, printed with the test output
+inline void benchReport(const char* format, ...) __attribute__((format(printf, 1, 2)));
+inline void benchReport(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  printf("  ");
+  vprintf(format, args);
+  printf("\n");
+  va_end(args);
+}
+
+#endif // HOST_BENCH_H
@@ -0,0 +1,371 @@
+#include <unity.h>
+#include "../../src/compositor.cpp"
+#include "../../src/effect_registry.cpp"
+#include "../../src/effects.cpp"
+#include "../../src/grayscale.cpp"
+#include "../../src/framebuffer.cpp"
+#include "../../src/life.cpp"
+#include "../../src/display_item.cpp"
+#include "../../src/text_pool.cpp"
+#include <host_bench.h>
+
+// Layered items (compositor.h): each layer drawn into its own buffer and
+// the stack combined bottom-up, once per bit plane when any layer is
+// grayscale. Text layers draw the raster's columns as they are, without
+// the font or scrolling; pong and the knight rider are held still with
+// hand-drawn buffers where a test needs exact pixels. The benchmark at
+// the end times 2 and 3 layer stacks.
+
+class NullBackend : public DisplayBackend {
+ public:
+  bool begin() { return true; }
+  const char* name() const { return "null"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {}
+};
+
+static NullBackend backend;
+static ZoneRuntime runtime;
+static LayerBuffers buffers;
+static TextRaster raster;
+static PackedFrame planes[GRAY_PLANES];
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() { return &backend; }
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+TaskHandle_t getRenderTaskHandle() { return NULL; }
+ZoneRuntime* zoneRuntime(uint8_t index) { return &runtime; }
+
+// Column x of the raster at zone column x, unscrolled
+void textRasterDraw(const TextRaster& raster, const DisplayItem& item, uint16_t firstCol, uint16_t cols) {
+  fbClearColumns(firstCol, cols);
+  for (uint16_t x = 0; x < cols && x < raster.columns.size(); x++) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      fbSetPoint(row, firstCol + x, raster.columns[x] & (1 << row));
+    }
+  }
+}
+
+static EffectInstance* zone() {
+  return &runtime.effects;
+}
+
+static bool lit(const PackedFrame& frame, uint8_t row, uint16_t col) {
+  return frame.bytes[row][col / 8] & (1 << (col % 8));
+}
+
+static void light(PackedFrame& frame, uint8_t row, uint16_t col) {
+  frame.bytes[row][col / 8] |= 1 << (col % 8);
+}
+
+static uint8_t levelOf(GrayFrame& gray, uint8_t row, uint16_t col) {
+  graySetTarget(&gray);
+  uint8_t level = grayGetPixel(row, col);
+  graySetTarget(NULL);
+  return level;
+}
+
+static void setLevel(GrayFrame& gray, uint8_t row, uint16_t col, uint8_t level) {
+  graySetTarget(&gray);
+  graySetPixel(row, col, level);
+  graySetTarget(NULL);
+}
+
+static DisplayItem layered(const EffectMode* modes, const uint8_t* ops, uint8_t count) {
+  DisplayItem item;
+  item.setMode(MODE_LAYERS);
+  for (uint8_t i = 0; i < count; i++) item.addLayer(modes[i], ops[i]);
+  return item;
+}
+
+// Pong and the knight rider keep what their layer buffer holds
+static void holdStill() {
+  zone()->pong.lastUpdateTime = millis();
+  zone()->knightRider.lastUpdateTime = millis();
+}
+
+// The composite worked out pixel by pixel from what each layer drew
+static void expectPerPixel(const DisplayItem& item, bool gray) {
+  LayerList layers = item.layers();
+  uint8_t planeCount = gray ? GRAY_PLANES : 1;
+  for (uint8_t p = 0; p < planeCount; p++) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      for (uint16_t col = 0; col < FRAME_COLS; col++) {
+        bool on = false;
+        for (size_t i = 0; i < layers.size(); i++) {
+          bool layerOn = effectHas(layers[i].mode, EFFECT_GRAY)
+              ? (levelOf(buffers.gray[i], row, col) >> p) & 1
+              : lit(buffers.frames[i], row, col);
+          if (layers[i].op == LAYER_OP_XOR) on ^= layerOn;
+          else if (layers[i].op == LAYER_OP_ANDNOT) on &= !layerOn;
+          else on |= layerOn;
+        }
+        char message[40];
+        snprintf(message, sizeof(message), "plane %u row %u col %u", p, row, col);
+        TEST_ASSERT_EQUAL_MESSAGE(on, lit(planes[p], row, col), message);
+      }
+    }
+  }
+}
+
+void setUp() {
+  hostTimeUs = 5000000;
+  randomSeed(3);
+  graySetTarget(NULL);
+  fbSetTarget(NULL);
+  grayStop();
+  fbClear();
+  grayClear();
+  resetEffects(zone(), 0, FRAME_COLS);
+  selectEffects(zone());
+  raster.columns.assign(FRAME_COLS, 0);
+}
+
+void tearDown() {}
+
+static void test_binary_layers_combine_bottom_up() {
+  // Text lights rows 0-3 everywhere; pong holds two points
+  raster.columns.assign(FRAME_COLS, 0x0F);
+  const EffectMode modes[] = {MODE_TEXT, MODE_PONG};
+  const uint8_t masked[] = {LAYER_OP_OR, LAYER_OP_ANDNOT};
+  DisplayItem item = layered(modes, masked, 2);
+  resetLayers(buffers, item);
+  holdStill();
+  light(buffers.frames[1], 1, 5);
+  light(buffers.frames[1], 6, 5);
+
+  // A mask only clears: the hole at row 1, nothing at row 6
+  TEST_ASSERT_FALSE(composeLayers(item, buffers, raster, planes));
+  TEST_ASSERT_FALSE(lit(planes[0], 1, 5));
+  TEST_ASSERT_FALSE(lit(planes[0], 6, 5));
+  TEST_ASSERT_TRUE(lit(planes[0], 0, 5));
+  TEST_ASSERT_TRUE(lit(planes[0], 1, 6));
+  expectPerPixel(item, false);
+
+  // XOR toggles both
+  const uint8_t toggled[] = {LAYER_OP_OR, LAYER_OP_XOR};
+  item = layered(modes, toggled, 2);
+  TEST_ASSERT_FALSE(composeLayers(item, buffers, raster, planes));
+  TEST_ASSERT_FALSE(lit(planes[0], 1, 5));
+  TEST_ASSERT_TRUE(lit(planes[0], 6, 5));
+  expectPerPixel(item, false);
+
+  // Order matters: a mask at the bottom has nothing to clear
+  const EffectMode reversed[] = {MODE_PONG, MODE_TEXT};
+  const uint8_t maskFirst[] = {LAYER_OP_ANDNOT, LAYER_OP_OR};
+  item = layered(reversed, maskFirst, 2);
+  PackedFrame pong = buffers.frames[1];
+  resetLayers(buffers, item);
+  holdStill();
+  buffers.frames[0] = pong;
+  composeLayers(item, buffers, raster, planes);
+  TEST_ASSERT_TRUE(lit(planes[0], 1, 5));
+  TEST_ASSERT_FALSE(lit(planes[0], 6, 5));
+}
+
+static void test_gray_layers_combine_per_plane() {
+  // Knight rider levels 5 and 10; text lights columns 1 and 2 of row 0
+  raster.columns[1] = 0x01;
+  raster.columns[2] = 0x01;
+  const EffectMode modes[] = {MODE_KNIGHTRIDER, MODE_TEXT};
+  const uint8_t ops[] = {LAYER_OP_OR, LAYER_OP_XOR};
+  DisplayItem item = layered(modes, ops, 2);
+  resetLayers(buffers, item);
+  holdStill();
+  setLevel(buffers.gray[0], 0, 0, 5);
+  setLevel(buffers.gray[0], 0, 1, 10);
+
+  TEST_ASSERT_TRUE(composeLayers(item, buffers, raster, planes));
+
+  // A binary layer counts as full intensity in every plane:
+  // 5 stays 5, 10 ^ 15 = 5, 0 ^ 15 = 15
+  const uint8_t expected[] = {5, 5, 15, 0};
+  for (uint16_t col = 0; col < 4; col++) {
+    uint8_t level = 0;
+    for (uint8_t p = 0; p < GRAY_PLANES; p++) level |= lit(planes[p], 0, col) << p;
+    TEST_ASSERT_EQUAL(expected[col], level);
+  }
+  expectPerPixel(item, true);
+}
+
+static void test_animated_stacks_match_per_pixel() {
+  raster.columns.assign(FRAME_COLS, 0);
+  for (uint16_t col = 0; col < FRAME_COLS; col += 3) raster.columns[col] = 0x5A;
+
+  const EffectMode binaryModes[] = {MODE_PONG, MODE_LIFE, MODE_TEXT};
+  const uint8_t binaryOps[] = {LAYER_OP_OR, LAYER_OP_XOR, LAYER_OP_ANDNOT};
+  const EffectMode grayModes[] = {MODE_TWINKLE, MODE_LIFE, MODE_SINEWAVE, MODE_TEXT};
+  const uint8_t grayOps[] = {LAYER_OP_OR, LAYER_OP_XOR, LAYER_OP_OR, LAYER_OP_ANDNOT};
+
+  DisplayItem binary = layered(binaryModes, binaryOps, 3);
+  resetLayers(buffers, binary);
+  for (uint8_t frame = 0; frame < 6; frame++) {
+    TEST_ASSERT_FALSE(composeLayers(binary, buffers, raster, planes));
+    expectPerPixel(binary, false);
+    hostTimeUs += 120000;
+  }
+  TEST_ASSERT_EQUAL(6, compositorStats.composites);
+
+  resetEffects(zone(), 0, FRAME_COLS);
+  DisplayItem gray = layered(grayModes, grayOps, 4);
+  resetLayers(buffers, gray);
+  for (uint8_t frame = 0; frame < 6; frame++) {
+    TEST_ASSERT_TRUE(composeLayers(gray, buffers, raster, planes));
+    expectPerPixel(gray, true);
+    hostTimeUs += 120000;
+  }
+}
+
+static void test_layers_draw_into_their_own_buffers() {
+  // Only the zone's columns, and never the frame or intensity buffer
+  resetEffects(zone(), 24, 16);
+  raster.columns.assign(FRAME_COLS, 0xFF);
+  const EffectMode modes[] = {MODE_TEXT, MODE_SINEWAVE};
+  const uint8_t ops[] = {LAYER_OP_OR, LAYER_OP_OR};
+  DisplayItem item = layered(modes, ops, 2);
+  resetLayers(buffers, item);
+  composeLayers(item, buffers, raster, planes);
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = 0; col < FRAME_COLS; col++) {
+      bool inside = col >= 24 && col < 40;
+      TEST_ASSERT_EQUAL(inside, lit(buffers.frames[0], row, col));
+      if (!inside) TEST_ASSERT_EQUAL(0, levelOf(buffers.gray[1], row, col));
+      TEST_ASSERT_FALSE(fbGetPoint(row, col));
+      TEST_ASSERT_EQUAL(0, grayGetPixel(row, col));
+    }
+  }
+}
+
+static void test_reset_clears_buffers_and_stats() {
+  const EffectMode modes[] = {MODE_TEXT, MODE_PONG, MODE_TWINKLE};
+  const uint8_t ops[] = {LAYER_OP_OR, LAYER_OP_OR, LAYER_OP_OR};
+  DisplayItem item = layered(modes, ops, 3);
+  memset(&buffers, 0xFF, sizeof(buffers));
+  compositorStats.composites = 9;
+  compositorStats.maxFrameUs = 1234;
+
+  resetLayers(buffers, item);
+  LayerBuffers blank;
+  memset(&blank, 0, sizeof(blank));
+  TEST_ASSERT_EQUAL_MEMORY(&blank, &buffers, sizeof(buffers));
+  TEST_ASSERT_EQUAL(3, compositorStats.layers);
+  TEST_ASSERT_EQUAL(0, compositorStats.composites);
+  TEST_ASSERT_EQUAL(0, compositorStats.maxFrameUs);
+}
+
+static void test_render_commits_the_right_way() {
+  // Binary: the frame buffer, with the plane cycle stopped
+  raster.columns[0] = 0x81;
+  const EffectMode binaryModes[] = {MODE_TEXT};
+  const uint8_t ops[] = {LAYER_OP_OR, LAYER_OP_OR};
+  DisplayItem binary = layered(binaryModes, ops, 1);
+  resetLayers(buffers, binary);
+  renderLayers(binary, buffers, raster);
+  TEST_ASSERT_FALSE(grayIsRunning());
+  TEST_ASSERT_TRUE(fbGetPoint(0, 0));
+  TEST_ASSERT_TRUE(fbGetPoint(7, 0));
+  TEST_ASSERT_FALSE(fbGetPoint(1, 0));
+
+  // Grayscale: the composited planes cycle on the chain
+  const EffectMode grayModes[] = {MODE_KNIGHTRIDER, MODE_TEXT};
+  DisplayItem gray = layered(grayModes, ops, 2);
+  resetLayers(buffers, gray);
+  holdStill();
+  setLevel(buffers.gray[0], 3, 9, 6);
+  renderLayers(gray, buffers, raster);
+  TEST_ASSERT_TRUE(grayIsRunning());
+  for (uint8_t p = 0; p < GRAY_PLANES; p++) {
+    TEST_ASSERT_EQUAL((6 >> p) & 1, lit(grayPlane(p), 3, 9));
+    TEST_ASSERT_TRUE(lit(grayPlane(p), 7, 0));
+  }
+  grayStop();
+}
+
+// The same combine with a get and a set per pixel and plane, as drawing
+// each layer straight into the frame would take
+static void combinePerPixel(const DisplayItem& item, bool gray) {
+  LayerList layers = item.layers();
+  uint8_t planeCount = gray ? GRAY_PLANES : 1;
+  for (uint8_t p = 0; p < planeCount; p++) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      for (uint16_t col = 0; col < FRAME_COLS; col++) {
+        bool on = false;
+        for (size_t i = 0; i < layers.size(); i++) {
+          bool layerOn;
+          if (effectHas(layers[i].mode, EFFECT_GRAY)) {
+            graySetTarget(&buffers.gray[i]);
+            layerOn = (grayGetPixel(row, col) >> p) & 1;
+          } else {
+            fbSetTarget(&buffers.frames[i]);
+            layerOn = fbGetPoint(row, col);
+          }
+          if (layers[i].op == LAYER_OP_XOR) on ^= layerOn;
+          else if (layers[i].op == LAYER_OP_ANDNOT) on &= !layerOn;
+          else on |= layerOn;
+        }
+        fbSetTarget(&planes[p]);
+        fbSetPoint(row, col, on);
+      }
+    }
+  }
+  graySetTarget(NULL);
+  fbSetTarget(NULL);
+}
+
+// Frame cost of 2 and 3 layer stacks, binary and grayscale: the whole
+// frame (every layer drawn, then combined), the combine alone, and the
+// combine done per pixel for comparison
+static void test_composite_cost() {
+  typedef struct {
+    const char* name;
+    EffectMode modes[3];
+    uint8_t ops[3];
+    uint8_t count;
+  } Stack;
+  static const Stack stacks[] = {
+    {"text, pong", {MODE_TEXT, MODE_PONG}, {LAYER_OP_OR, LAYER_OP_XOR}, 2},
+    {"text, pong, life", {MODE_TEXT, MODE_PONG, MODE_LIFE}, {LAYER_OP_OR, LAYER_OP_XOR, LAYER_OP_ANDNOT}, 3},
+    {"twinkle, text", {MODE_TWINKLE, MODE_TEXT}, {LAYER_OP_OR, LAYER_OP_ANDNOT}, 2},
+    {"twinkle, sinewave, text", {MODE_TWINKLE, MODE_SINEWAVE, MODE_TEXT}, {LAYER_OP_OR, LAYER_OP_XOR, LAYER_OP_ANDNOT}, 3},
+  };
+  for (uint16_t col = 0; col < FRAME_COLS; col += 2) raster.columns[col] = 0x3C;
+
+  benchReport("stack, %-3u columns      planes  ns/frame  combine ns  per pixel ns", FRAME_COLS);
+  for (const Stack& stack : stacks) {
+    DisplayItem item = layered(stack.modes, stack.ops, stack.count);
+    resetEffects(zone(), 0, FRAME_COLS);
+    resetLayers(buffers, item);
+    bool gray = false;
+    auto frame = [&]() {
+      hostTimeUs += 20000;
+      gray = composeLayers(item, buffers, raster, planes);
+    };
+    for (uint8_t i = 0; i < 50; i++) frame();
+
+    double frameNs = benchNs(500, frame);
+    double combineNs = benchNs(2000, [&]() { combineLayers(item, buffers, planes); });
+    double perPixelNs = benchNs(20, [&]() { combinePerPixel(item, gray); });
+    expectPerPixel(item, gray);   // Left by the per-pixel combine
+    benchReport("%-24s  %6u  %8.0f  %10.0f  %12.0f", stack.name, gray ? GRAY_PLANES : 1,
+                frameNs, combineNs, perPixelNs);
+#if defined(__OPTIMIZE__) && !defined(__SANITIZE_ADDRESS__)
+    TEST_ASSERT_TRUE(combineNs * 10 < perPixelNs);
+#endif
+  }
+}
+
+int main() {
+  initTextPool();
+  initGrayscale();
+  UNITY_BEGIN();
+  RUN_TEST(test_binary_layers_combine_bottom_up);
+  RUN_TEST(test_gray_layers_combine_per_plane);
+  RUN_TEST(test_animated_stacks_match_per_pixel);
+  RUN_TEST(test_layers_draw_into_their_own_buffers);
+  RUN_TEST(test_reset_clears_buffers_and_stats);
+  RUN_TEST(test_render_commits_the_right_way);
+  RUN_TEST(test_composite_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,560 @@
+#include <unity.h>
+#include "../../src/config_binary.cpp"
+#include "../../src/config_json.cpp"
+#include "../../src/config_log.cpp"
+#include "../../src/display_item.cpp"
+#include "../../src/text_pool.cpp"
+#include "../../src/effect_registry.cpp"
+#include "../../src/life.cpp"
+#include "../../src/utils.cpp"
+#include <host_bench.h>
+#include <new>
+
+// The binary config file (config_binary.h) and the change log replayed
+// over it (config_log.h), written to the host SPIFFS and read back, and
+// what loading it costs against the JSON it replaced
+
+// The effects themselves are not under test: the registry only needs
+// something to point at
+void initTwinkleStates() {}
+void updateTwinkleEffect(const DisplayItem& item) {}
+void initKnightRiderState() {}
+void updateKnightRiderEffect(const DisplayItem& item) {}
+void initPongState() {}
+void updatePongEffect(const DisplayItem& item) {}
+void initSineWaveState() {}
+void updateSineWaveEffect(const DisplayItem& item) {}
+void initLifeState() {}
+void updateLifeEffect(const DisplayItem& item) {}
+size_t parseLayers(DisplayItem& item, JsonArray layers) { return 0; }
+void writeLayers(JsonObject itemObj, const DisplayItem& item) {}
+void fbSetRowByte(uint8_t row, uint8_t device, uint8_t value) {}
+uint8_t fbGetRowByte(uint8_t row, uint8_t device) { return 0; }
+
+// Zone columns are kept as written
+void sanitizeZone(DisplayZone& zone) {}
+
+// Every config here has items
+void addDefaultItem(DisplayConfig& cfg) {}
+
+void postEvent(DeviceEventType type, uint8_t zone, int16_t index, uint16_t playCount, int32_t value) {}
+
+DisplayConfig config;
+
+void assignItemId(DisplayItem& item) {
+  if (item.id == 0) item.id = config.nextItemId++;
+}
+
+// Records the render task queued, for the test to append like the main loop
+static std::vector<uint8_t> queuedRecords;
+
+void queueLogRecord(const uint8_t* data, size_t length) {
+  queuedRecords.insert(queuedRecords.end(), data, data + length);
+}
+
+static bool appendQueuedRecords() {
+  bool ok = appendConfigLog(queuedRecords.data(), queuedRecords.size());
+  queuedRecords.clear();
+  return ok;
+}
+
+// Heap held on the host, for the load benchmark: every operator new and
+// the JSON documents' allocator count here. Each block starts with its
+// size. Kept out of line, or GCC pairs the malloc() and free() in here
+// with the operator new and delete of the callers and warns.
+#define HEAP_HEADER_BYTES alignof(max_align_t)
+
+static size_t heapInUse = 0;
+static size_t heapPeak = 0;
+
+__attribute__((noinline)) static void* heapTake(size_t size) {
+  uint8_t* block = (uint8_t*)malloc(HEAP_HEADER_BYTES + size);
+  if (block == NULL) return NULL;
+  memcpy(block, &size, sizeof(size));
+  heapInUse += size;
+  if (heapInUse > heapPeak) heapPeak = heapInUse;
+  return block + HEAP_HEADER_BYTES;
+}
+
+static size_t heapBlockSize(void* pointer) {
+  size_t size;
+  memcpy(&size, (uint8_t*)pointer - HEAP_HEADER_BYTES, sizeof(size));
+  return size;
+}
+
+__attribute__((noinline)) static void heapGive(void* pointer) {
+  if (pointer == NULL) return;
+  heapInUse -= heapBlockSize(pointer);
+  free((uint8_t*)pointer - HEAP_HEADER_BYTES);
+}
+
+void* operator new(size_t size) {
+  void* pointer = heapTake(size);
+  if (pointer == NULL) throw std::bad_alloc();
+  return pointer;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return heapTake(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return heapTake(size); }
+void operator delete(void* pointer) noexcept { heapGive(pointer); }
+void operator delete[](void* pointer) noexcept { heapGive(pointer); }
+void operator delete(void* pointer, size_t size) noexcept { heapGive(pointer); }
+void operator delete[](void* pointer, size_t size) noexcept { heapGive(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { heapGive(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { heapGive(pointer); }
+
+class CountingAllocator : public ArduinoJson::Allocator {
+ public:
+  void* allocate(size_t size) override { return heapTake(size); }
+  void deallocate(void* pointer) override { heapGive(pointer); }
+  void* reallocate(void* pointer, size_t size) override {
+    void* moved = heapTake(size);
+    if (moved != NULL && pointer != NULL) {
+      memcpy(moved, pointer, min(size, heapBlockSize(pointer)));
+      heapGive(pointer);
+    }
+    return moved;
+  }
+};
+
+static CountingAllocator countingAllocator;
+
+static DisplayItem textItem(uint32_t id, const char* text) {
+  DisplayItem item;
+  item.setMode(MODE_TEXT);
+  item.id = id;
+  item.text = text;
+  return item;
+}
+
+// Two zones with an item of every mode and non-default fields throughout
+static void buildConfig(DisplayConfig& cfg) {
+  cfg = DisplayConfig();
+  cfg.displayOn = true;
+  cfg.loopItems = true;
+  cfg.frameRate = 60;
+  cfg.realtimeTimeout = 5000;
+  cfg.startCol = 0;
+  cfg.width = 64;
+  cfg.nextItemId = 100;
+  cfg.items.clear();
+  cfg.zones.clear();
+
+  DisplayItem text = textItem(1, "Hello, rack");
+  text.alignment = PA_CENTER;
+  text.invert = true;
+  text.brightness = 9;
+  text.duration = 12345;
+  text.maxPlays = 3;
+  text.params.text.scrollSpeed = 33;
+  cfg.items.push_back(text);
+
+  DisplayItem twinkle;
+  twinkle.setMode(MODE_TWINKLE);
+  twinkle.id = 2;
+  twinkle.deleteAfterPlay = true;
+  twinkle.params.twinkle.density = 40;
+  twinkle.params.twinkle.minSpeed = 70;
+  twinkle.params.twinkle.maxSpeed = 900;
+  cfg.items.push_back(twinkle);
+
+  DisplayItem pong;
+  pong.setMode(MODE_PONG);
+  pong.id = 3;
+  pong.params.pong.ballSpeedX = -0.75f;
+  pong.params.pong.ballSpeedY = 1.125f;
+  cfg.items.push_back(pong);
+
+  DisplayItem life;
+  life.setMode(MODE_LIFE);
+  life.id = 4;
+  parseLifeRule("B36/S23", life.params.life);
+  cfg.items.push_back(life);
+
+  DisplayItem layers;
+  layers.setMode(MODE_LAYERS);
+  layers.id = 5;
+  layers.text = "Over the top";
+  layers.addLayer(MODE_SINEWAVE, LAYER_OP_OR);
+  layers.addLayer(MODE_TEXT, LAYER_OP_XOR);
+  layers.addLayer(MODE_SINEWAVE, LAYER_OP_ANDNOT);
+  layers.paramsFor(MODE_SINEWAVE)->sineWave.amplitude = 2;
+  layers.paramsFor(MODE_TEXT)->text.pauseTime = 777;
+  cfg.items.push_back(layers);
+
+  DisplayZone zone;
+  zone.name = "right";
+  zone.startCol = 64;
+  zone.width = 32;
+  zone.loopItems = false;
+  zone.currentItemIndex = 0;
+  zone.itemStartTime = 0;
+
+  DisplayItem animation;
+  animation.setMode(MODE_ANIMATION);
+  animation.id = 6;
+  animation.setFile("spinner");
+  animation.params.frames.frameDelay = 40;
+  zone.items.push_back(animation);
+
+  DisplayItem knightRider;
+  knightRider.setMode(MODE_KNIGHTRIDER);
+  knightRider.id = 7;
+  knightRider.params.knightRider.tailLength = 6;
+  zone.items.push_back(knightRider);
+
+  DisplayItem unknown;
+  unknown.setMode(MODE_UNKNOWN);
+  unknown.id = 8;
+  zone.items.push_back(unknown);
+  cfg.zones.push_back(zone);
+}
+
+// A primary playlist of count items, going round the kinds buildConfig
+// puts there
+static void buildPlaylist(DisplayConfig& cfg, uint16_t count) {
+  buildConfig(cfg);
+  std::vector<DisplayItem> kinds = cfg.items;
+  cfg.items.clear();
+  cfg.zones.clear();
+  for (uint16_t i = 0; i < count; i++) {
+    cfg.items.push_back(kinds[i % kinds.size()]);
+    cfg.items.back().id = i + 1;
+  }
+  cfg.nextItemId = count + 1;
+}
+
+static void encode(const DisplayConfig& cfg, std::vector<uint8_t>& out, uint16_t generation = 1) {
+  encodeConfigBinary(cfg, out, generation);
+}
+
+// Fix up the header after editing the payload of an encoded config
+static void resealConfig(std::vector<uint8_t>& data) {
+  size_t payload = data.size() - CONFIG_BINARY_HEADER_BYTES;
+  uint32_t crc = crc32Update(0, data.data() + CONFIG_BINARY_HEADER_BYTES, payload);
+  for (uint8_t i = 0; i < 4; i++) {
+    data[8 + i] = (uint8_t)(payload >> (8 * i));
+    data[12 + i] = (uint8_t)(crc >> (8 * i));
+  }
+}
+
+static std::vector<uint32_t> itemIds(const std::vector<DisplayItem>& items) {
+  std::vector<uint32_t> ids;
+  for (const DisplayItem& item : items) ids.push_back(item.id);
+  return ids;
+}
+
+void setUp() {
+  hostFiles.clear();
+  queuedRecords.clear();
+  buildConfig(config);
+}
+
+void tearDown() {}
+
+static void test_round_trip_keeps_every_field() {
+  std::vector<uint8_t> data;
+  encode(config, data, 7);
+  TEST_ASSERT_TRUE(checkConfigBinary(data.data(), data.size()));
+  TEST_ASSERT_EQUAL(7, configBinaryGeneration(data.data()));
+
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(data.data(), data.size(), cfg));
+
+  TEST_ASSERT_TRUE(cfg.displayOn);
+  TEST_ASSERT_EQUAL(60, cfg.frameRate);
+  TEST_ASSERT_EQUAL(5000, cfg.realtimeTimeout);
+  TEST_ASSERT_EQUAL(100, cfg.nextItemId);
+  TEST_ASSERT_EQUAL(64, cfg.width);
+  TEST_ASSERT_EQUAL(5, cfg.items.size());
+
+  const DisplayItem& text = cfg.items[0];
+  TEST_ASSERT_EQUAL(MODE_TEXT, text.mode);
+  TEST_ASSERT_EQUAL_STRING("Hello, rack", text.text.c_str());
+  TEST_ASSERT_EQUAL(PA_CENTER, text.alignment);
+  TEST_ASSERT_TRUE(text.invert);
+  TEST_ASSERT_FALSE(text.deleteAfterPlay);
+  TEST_ASSERT_EQUAL(9, text.brightness);
+  TEST_ASSERT_EQUAL(12345, text.duration);
+  TEST_ASSERT_EQUAL(3, text.maxPlays);
+  TEST_ASSERT_EQUAL(33, text.params.text.scrollSpeed);
+
+  const DisplayItem& twinkle = cfg.items[1];
+  TEST_ASSERT_TRUE(twinkle.deleteAfterPlay);
+  TEST_ASSERT_EQUAL(40, twinkle.params.twinkle.density);
+  TEST_ASSERT_EQUAL(900, twinkle.params.twinkle.maxSpeed);
+
+  TEST_ASSERT_EQUAL_FLOAT(-0.75f, cfg.items[2].params.pong.ballSpeedX);
+  TEST_ASSERT_EQUAL_FLOAT(1.125f, cfg.items[2].params.pong.ballSpeedY);
+  TEST_ASSERT_EQUAL_HEX16((1 << 3) | (1 << 6), cfg.items[3].params.life.birth);
+
+  // Layers share one parameter set per mode
+  const DisplayItem& layers = cfg.items[4];
+  TEST_ASSERT_EQUAL(3, layers.layers().size());
+  TEST_ASSERT_EQUAL(MODE_SINEWAVE, layers.layers()[2].mode);
+  TEST_ASSERT_EQUAL(LAYER_OP_ANDNOT, layers.layers()[2].op);
+  TEST_ASSERT_EQUAL(2, layers.paramsFor(MODE_SINEWAVE)->sineWave.amplitude);
+  TEST_ASSERT_EQUAL(777, layers.paramsFor(MODE_TEXT)->text.pauseTime);
+  TEST_ASSERT_EQUAL_STRING("Over the top", layers.text.c_str());
+
+  TEST_ASSERT_EQUAL(1, cfg.zones.size());
+  const DisplayZone& zone = cfg.zones[0];
+  TEST_ASSERT_EQUAL_STRING("right", zone.name.c_str());
+  TEST_ASSERT_EQUAL(64, zone.startCol);
+  TEST_ASSERT_EQUAL(32, zone.width);
+  TEST_ASSERT_FALSE(zone.loopItems);
+  TEST_ASSERT_EQUAL(3, zone.items.size());
+  TEST_ASSERT_EQUAL_STRING("spinner", zone.items[0].file());
+  TEST_ASSERT_EQUAL(40, zone.items[0].params.frames.frameDelay);
+  TEST_ASSERT_EQUAL(6, zone.items[1].params.knightRider.tailLength);
+  TEST_ASSERT_EQUAL(MODE_UNKNOWN, zone.items[2].mode);
+}
+
+static void test_reencoding_is_byte_identical() {
+  std::vector<uint8_t> first, second;
+  encode(config, first);
+
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(first.data(), first.size(), cfg));
+  encode(cfg, second);
+
+  TEST_ASSERT_EQUAL(first.size(), second.size());
+  TEST_ASSERT_EQUAL_MEMORY(first.data(), second.data(), first.size());
+}
+
+static void test_damaged_files_are_rejected() {
+  std::vector<uint8_t> data;
+  encode(config, data);
+
+  std::vector<uint8_t> flipped = data;
+  flipped[data.size() / 2] ^= 0x10;
+  TEST_ASSERT_FALSE(checkConfigBinary(flipped.data(), flipped.size()));
+
+  TEST_ASSERT_FALSE(checkConfigBinary(data.data(), data.size() - 1));
+  TEST_ASSERT_FALSE(checkConfigBinary(data.data(), CONFIG_BINARY_HEADER_BYTES - 1));
+
+  std::vector<uint8_t> future = data;
+  future[4] = CONFIG_BINARY_VERSION + 1;
+  TEST_ASSERT_FALSE(checkConfigBinary(future.data(), future.size()));
+
+  DisplayConfig cfg;
+  TEST_ASSERT_FALSE(decodeConfigBinary(flipped.data(), flipped.size(), cfg));
+}
+
+static void test_unknown_item_types_are_skipped() {
+  config.items.clear();
+  config.items.push_back(textItem(1, "first"));
+  config.items.push_back(textItem(2, "second"));
+  config.zones.clear();
+
+  // Retag the first record as a type from a newer firmware
+  std::vector<uint8_t> data;
+  encode(config, data);
+  size_t firstItem = CONFIG_BINARY_HEADER_BYTES + 14 + 2;   // Globals, item count
+  TEST_ASSERT_EQUAL(MODE_TEXT, data[firstItem]);
+  TEST_ASSERT_EQUAL(1, data[firstItem + 3]);                   // Its ID
+  data[firstItem] = 0x40;
+  resealConfig(data);
+
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(data.data(), data.size(), cfg));
+  TEST_ASSERT_EQUAL(1, cfg.items.size());
+  TEST_ASSERT_EQUAL_STRING("second", cfg.items[0].text.c_str());
+}
+
+static void test_item_records_decode_exactly() {
+  std::vector<uint8_t> record;
+  encodeItem(record, config.items[4]);
+
+  DisplayItem item;
+  TEST_ASSERT_TRUE(decodeItem(record.data(), record.size(), item));
+  TEST_ASSERT_EQUAL(5, item.id);
+  TEST_ASSERT_EQUAL(3, item.layers().size());
+
+  // Trailing bytes or a short record are malformed
+  record.push_back(0);
+  TEST_ASSERT_FALSE(decodeItem(record.data(), record.size(), item));
+  TEST_ASSERT_FALSE(decodeItem(record.data(), record.size() - 3, item));
+}
+
+static void test_log_replays_adds_updates_and_deletes() {
+  std::vector<uint8_t> data;
+  encode(config, data, 3);
+  TEST_ASSERT_TRUE(startConfigLog(3));
+
+  // Render task: edit the live config and log each change
+  DisplayItem added = textItem(0, "added");
+  logItemAdded(1, added);
+  TEST_ASSERT_EQUAL(100, added.id);
+
+  DisplayItem updated = config.items[0];
+  updated.text = "Hello again";
+  updated.params.text.scrollSpeed = 10;
+  logItemUpdated(updated);
+  logItemDeleted(3);
+  TEST_ASSERT_TRUE(appendQueuedRecords());
+  TEST_ASSERT_EQUAL(3, configLogStats.records);
+  TEST_ASSERT_EQUAL(1, configLogStats.appends);
+
+  // Boot: the config file, then the log over it
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(data.data(), data.size(), cfg));
+  TEST_ASSERT_TRUE(replayConfigLog(cfg, 3));
+  TEST_ASSERT_EQUAL(3, configLogStats.replayed);
+  TEST_ASSERT_FALSE(configLogStats.torn);
+
+  TEST_ASSERT_EQUAL_STRING("Hello again", cfg.items[0].text.c_str());
+  TEST_ASSERT_EQUAL(10, cfg.items[0].params.text.scrollSpeed);
+  std::vector<uint32_t> expected = {1, 2, 4, 5};
+  TEST_ASSERT_TRUE(itemIds(cfg.items) == expected);
+  TEST_ASSERT_EQUAL(4, cfg.zones[0].items.size());
+  TEST_ASSERT_EQUAL_STRING("added", cfg.zones[0].items[3].text.c_str());
+  TEST_ASSERT_EQUAL(101, cfg.nextItemId);
+
+  // The replayed log is kept and appended to
+  size_t logBytes = hostFiles[CONFIG_LOG_FILE]->size();
+  logItemDeleted(1);
+  TEST_ASSERT_TRUE(appendQueuedRecords());
+  TEST_ASSERT_EQUAL(logBytes + 3 + 4 + 4, hostFiles[CONFIG_LOG_FILE]->size());
+}
+
+static void test_log_of_another_generation_is_ignored() {
+  std::vector<uint8_t> data;
+  encode(config, data, 4);
+  TEST_ASSERT_TRUE(startConfigLog(3));
+  logItemDeleted(1);
+  TEST_ASSERT_TRUE(appendQueuedRecords());
+
+  // A reset between writing generation 4 and starting its log
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(data.data(), data.size(), cfg));
+  TEST_ASSERT_TRUE(replayConfigLog(cfg, 4));
+  TEST_ASSERT_EQUAL(0, configLogStats.replayed);
+  TEST_ASSERT_EQUAL(5, cfg.items.size());
+
+  // Nothing may be appended to it until a new log is started
+  logItemDeleted(2);
+  TEST_ASSERT_FALSE(appendQueuedRecords());
+}
+
+static void test_torn_record_stops_the_replay() {
+  std::vector<uint8_t> data;
+  encode(config, data, 5);
+  TEST_ASSERT_TRUE(startConfigLog(5));
+  logItemDeleted(1);
+  logItemDeleted(2);
+  TEST_ASSERT_TRUE(appendQueuedRecords());
+
+  // Power lost in the middle of the second record
+  hostFiles[CONFIG_LOG_FILE]->resize(hostFiles[CONFIG_LOG_FILE]->size() - 2);
+
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(data.data(), data.size(), cfg));
+  TEST_ASSERT_FALSE(replayConfigLog(cfg, 5));
+  TEST_ASSERT_TRUE(configLogStats.torn);
+  TEST_ASSERT_EQUAL(1, configLogStats.replayed);
+  std::vector<uint32_t> expected = {2, 3, 4, 5};
+  TEST_ASSERT_TRUE(itemIds(cfg.items) == expected);
+
+  // A full save is due; appends fail until it starts a new log
+  logItemDeleted(3);
+  TEST_ASSERT_FALSE(appendQueuedRecords());
+}
+
+static void test_replay_is_idempotent_for_adds() {
+  std::vector<uint8_t> data;
+  encode(config, data, 6);
+  TEST_ASSERT_TRUE(startConfigLog(6));
+
+  // An add for a zone a later full save removed, and one already saved
+  DisplayItem orphan = textItem(0, "orphan");
+  logItemAdded(3, orphan);
+  DisplayItem saved = config.items[1];
+  logItemAdded(0, saved);
+  TEST_ASSERT_TRUE(appendQueuedRecords());
+
+  DisplayConfig cfg;
+  TEST_ASSERT_TRUE(decodeConfigBinary(data.data(), data.size(), cfg));
+  TEST_ASSERT_TRUE(replayConfigLog(cfg, 6));
+  TEST_ASSERT_EQUAL(2, configLogStats.replayed);
+  std::vector<uint32_t> expected = {1, 2, 3, 4, 5, 100};
+  TEST_ASSERT_TRUE(itemIds(cfg.items) == expected);
+}
+
+// Load cost of either format at 10, 100 and 500 items, from the file's
+// bytes to the items: time, and the heap held at the peak, items included
+// (configLoadStats.heapUsed on the device). Loading the binary form holds
+// its file buffer, as loadConfig() reads it in one go; the JSON form is
+// streamed from the file, so only its document counts.
+static void test_load_cost_against_json() {
+  static const uint16_t sizes[] = {10, 100, 500};
+  benchReport("config load      json                           binary");
+  benchReport("items    bytes   us/load  peak heap     bytes   us/load  peak heap");
+
+  for (uint16_t count : sizes) {
+    DisplayConfig cfg;
+    buildPlaylist(cfg, count);
+    std::vector<uint8_t> binary;
+    encode(cfg, binary);
+    std::string json;
+    {
+      JsonDocument doc;
+      configToJson(cfg, doc);
+      serializeJson(doc, json);
+    }
+
+    DisplayConfig loaded;
+    bool parsed = true;
+    auto loadJson = [&]() {
+      JsonDocument doc(&countingAllocator);
+      parsed = !deserializeJson(doc, json.data(), json.size()) && parsed;
+      configFromJson(doc, loaded);
+    };
+    auto loadBinary = [&]() {
+      uint8_t* data = (uint8_t*)heapTake(binary.size());
+      memcpy(data, binary.data(), binary.size());   // The one read
+      parsed = decodeConfigBinary(data, binary.size(), loaded) && parsed;
+      heapGive(data);
+    };
+
+    // Heap held at the peak, into an empty config as at boot
+    auto peakHeap = [&](auto load) {
+      loaded = DisplayConfig();
+      size_t before = heapInUse;
+      heapPeak = before;
+      load();
+      TEST_ASSERT_EQUAL(count, loaded.items.size());
+      return heapPeak - before;
+    };
+    size_t jsonPeak = peakHeap(loadJson);
+    size_t binaryPeak = peakHeap(loadBinary);
+    TEST_ASSERT_TRUE(parsed);
+
+    double jsonNs = benchNs(2000 / count + 2, loadJson);
+    double binaryNs = benchNs(2000 / count + 2, loadBinary);
+    benchReport("%5u  %7zu  %8.1f  %9zu   %7zu  %8.1f  %9zu", count,
+                json.size(), jsonNs / 1000, jsonPeak, binary.size(), binaryNs / 1000, binaryPeak);
+
+    TEST_ASSERT_TRUE(binary.size() < json.size());
+    TEST_ASSERT_TRUE(binaryPeak < jsonPeak);
+#if defined(__OPTIMIZE__) && !defined(__SANITIZE_ADDRESS__)
+    TEST_ASSERT_TRUE(binaryNs < jsonNs);
+#endif
+  }
+}
+
+int main() {
+  initTextPool();
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_keeps_every_field);
+  RUN_TEST(test_reencoding_is_byte_identical);
+  RUN_TEST(test_damaged_files_are_rejected);
+  RUN_TEST(test_unknown_item_types_are_skipped);
+  RUN_TEST(test_item_records_decode_exactly);
+  RUN_TEST(test_log_replays_adds_updates_and_deletes);
+  RUN_TEST(test_log_of_another_generation_is_ignored);
+  RUN_TEST(test_torn_record_stops_the_replay);
+  RUN_TEST(test_replay_is_idempotent_for_adds);
+  RUN_TEST(test_load_cost_against_json);
+  return UNITY_END();
+}
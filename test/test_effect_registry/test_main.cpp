@@ -0,0 +1,362 @@
+#include <unity.h>
+#include "../../src/effect_registry.cpp"
+#include "../../src/effects.cpp"
+#include "../../src/grayscale.cpp"
+#include "../../src/framebuffer.cpp"
+#include "../../src/life.cpp"
+#include "../../src/display_item.cpp"
+#include "../../src/text_pool.cpp"
+#include <host_bench.h>
+
+// The effect table (effect_registry.h): names and modes, the flags each
+// mode is handled by, and that the frame loop and zone setup reach each
+// effect's own functions through it. Parameter reading is only checked
+// with an empty object; the JSON itself is ArduinoJson's. The benchmark
+// at the end times the dispatch against what it replaced.
+
+class NullBackend : public DisplayBackend {
+ public:
+  bool begin() { return true; }
+  const char* name() const { return "null"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {}
+};
+
+static NullBackend backend;
+static ZoneRuntime runtime;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() { return &backend; }
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+TaskHandle_t getRenderTaskHandle() { return NULL; }
+ZoneRuntime* zoneRuntime(uint8_t index) { return &runtime; }
+size_t parseLayers(DisplayItem& item, JsonArray layers) { return 0; }
+void writeLayers(JsonObject itemObj, const DisplayItem& item) {}
+
+// The zone every test draws in: columns 16-31
+#define ZONE_FIRST_COL 16
+#define ZONE_COLS 16
+
+static const char* const modeNames[MODE_COUNT] = {
+  "text", "twinkle", "knightrider", "pong", "sinewave", "bitmap", "animation", "layers", "life",
+};
+
+static EffectInstance* zone() {
+  return &runtime.effects;
+}
+
+// Lit pixels of either buffer, inside and outside the zone
+typedef struct {
+  uint16_t grayInside, grayOutside;
+  uint16_t frameInside, frameOutside;
+} Drawn;
+
+static Drawn drawn() {
+  Drawn count = {0, 0, 0, 0};
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = 0; col < FRAME_COLS; col++) {
+      bool inside = col >= ZONE_FIRST_COL && col < ZONE_FIRST_COL + ZONE_COLS;
+      if (grayGetPixel(row, col) > 0) (inside ? count.grayInside : count.grayOutside)++;
+      if (fbGetPoint(row, col)) (inside ? count.frameInside : count.frameOutside)++;
+    }
+  }
+  return count;
+}
+
+// A dozen frames of an item of this mode, far enough apart for every
+// effect to move on each one
+static Drawn runFrames(EffectMode mode) {
+  DisplayItem item;
+  item.setMode(mode);
+  grayClear();
+  fbClear();
+  resetEffects(zone(), ZONE_FIRST_COL, ZONE_COLS);
+
+  Drawn total = {0, 0, 0, 0};
+  for (uint8_t frame = 0; frame < 12; frame++) {
+    updateEffects(item);
+    Drawn now = drawn();
+    total.grayInside += now.grayInside;
+    total.grayOutside += now.grayOutside;
+    total.frameInside += now.frameInside;
+    total.frameOutside += now.frameOutside;
+    hostTimeUs += 150000;
+  }
+  return total;
+}
+
+void setUp() {
+  hostTimeUs = 5000000;
+  randomSeed(1);
+  graySetTarget(NULL);
+  fbSetTarget(NULL);
+  selectEffects(zone());
+}
+
+void tearDown() {}
+
+static void test_names_and_modes_round_trip() {
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    TEST_ASSERT_EQUAL_STRING(modeNames[mode], effectModeName((EffectMode)mode));
+    TEST_ASSERT_EQUAL(mode, effectModeFromName(String(modeNames[mode])));
+  }
+}
+
+static void test_unknown_names_and_modes() {
+  TEST_ASSERT_EQUAL(MODE_UNKNOWN, effectModeFromName(String("plasma")));
+  TEST_ASSERT_EQUAL(MODE_UNKNOWN, effectModeFromName(String("")));
+  TEST_ASSERT_EQUAL(MODE_UNKNOWN, effectModeFromName(String("Text")));   // Names are exact
+
+  // Out of the table, including values a newer firmware saved
+  for (uint16_t mode = MODE_COUNT; mode <= 0xFF; mode++) {
+    const EffectInfo& effect = effectInfo((EffectMode)mode);
+    TEST_ASSERT_EQUAL_PTR(&unknownEffect, &effect);
+    TEST_ASSERT_EQUAL_STRING("unknown", effectModeName((EffectMode)mode));
+    TEST_ASSERT_FALSE(effectHas((EffectMode)mode, EFFECT_LAYER | EFFECT_GRAY | EFFECT_FRAMES | EFFECT_TEXT));
+  }
+  TEST_ASSERT_NULL(unknownEffect.update);
+  TEST_ASSERT_NULL(unknownEffect.parse);
+}
+
+static void test_flags_match_what_each_mode_does() {
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    const EffectInfo& effect = effectTable[mode];
+    TEST_ASSERT_NOT_NULL(effect.parse);
+    TEST_ASSERT_NOT_NULL(effect.serialize);
+
+    // Drawn by its update function, unless it is text, frames or layers
+    bool drawnByUpdate = !(effect.flags & (EFFECT_TEXT | EFFECT_FRAMES)) && mode != MODE_LAYERS;
+    TEST_ASSERT_EQUAL(drawnByUpdate, effect.update != NULL);
+    TEST_ASSERT_EQUAL(effect.update != NULL, effect.init != NULL);
+
+    // Intensity effects are layers; frame files are not
+    if (effect.flags & EFFECT_GRAY) TEST_ASSERT_TRUE(effect.flags & EFFECT_LAYER);
+    if (effect.flags & EFFECT_FRAMES) TEST_ASSERT_FALSE(effect.flags & EFFECT_LAYER);
+  }
+  TEST_ASSERT_TRUE(effectHas(MODE_TEXT, EFFECT_TEXT));
+  TEST_ASSERT_TRUE(effectHas(MODE_TWINKLE, EFFECT_GRAY));
+  TEST_ASSERT_TRUE(effectHas(MODE_KNIGHTRIDER, EFFECT_GRAY));
+  TEST_ASSERT_TRUE(effectHas(MODE_SINEWAVE, EFFECT_GRAY));
+  TEST_ASSERT_FALSE(effectHas(MODE_PONG, EFFECT_GRAY));
+  TEST_ASSERT_FALSE(effectHas(MODE_LIFE, EFFECT_GRAY));
+  TEST_ASSERT_TRUE(effectHas(MODE_BITMAP, EFFECT_FRAMES));
+  TEST_ASSERT_TRUE(effectHas(MODE_ANIMATION, EFFECT_FRAMES));
+  TEST_ASSERT_FALSE(effectHas(MODE_LAYERS, EFFECT_LAYER));   // Layers do not nest
+}
+
+static void test_update_reaches_each_effect() {
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    Drawn total = runFrames((EffectMode)mode);
+    char message[32];
+    snprintf(message, sizeof(message), "mode %s", modeNames[mode]);
+
+    // Nothing is drawn outside the zone, and only into the buffer the
+    // flags name
+    TEST_ASSERT_EQUAL_MESSAGE(0, total.grayOutside, message);
+    TEST_ASSERT_EQUAL_MESSAGE(0, total.frameOutside, message);
+    if (effectTable[mode].update == NULL) {
+      TEST_ASSERT_EQUAL_MESSAGE(0, total.grayInside + total.frameInside, message);
+    } else if (effectHas((EffectMode)mode, EFFECT_GRAY)) {
+      TEST_ASSERT_TRUE_MESSAGE(total.grayInside > 0, message);
+      TEST_ASSERT_EQUAL_MESSAGE(0, total.frameInside, message);
+    } else {
+      TEST_ASSERT_TRUE_MESSAGE(total.frameInside > 0, message);
+      TEST_ASSERT_EQUAL_MESSAGE(0, total.grayInside, message);
+    }
+  }
+
+  // An item saved by a newer firmware shows nothing
+  Drawn total = runFrames(MODE_UNKNOWN);
+  TEST_ASSERT_EQUAL(0, total.grayInside + total.grayOutside + total.frameInside + total.frameOutside);
+}
+
+static void test_init_restarts_every_effect_of_the_selected_instance() {
+  EffectInstance other;
+  memset(&other, 0, sizeof(other));
+  resetEffects(&other, 0, 8);
+  resetEffects(zone(), ZONE_FIRST_COL, ZONE_COLS);
+
+  // Run every effect in this zone for a while
+  DisplayItem items[MODE_COUNT];
+  for (uint8_t frame = 0; frame < 5; frame++) {
+    for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+      if (frame == 0) items[mode].setMode((EffectMode)mode);
+      updateEffects(items[mode]);
+    }
+    hostTimeUs += 150000;
+  }
+  TEST_ASSERT_NOT_EQUAL(0, zone()->knightRider.position);
+  TEST_ASSERT_TRUE(zone()->life.seeded);
+  TEST_ASSERT_NOT_NULL(zone()->twinkles);
+
+  initEffectStates();
+  TEST_ASSERT_EQUAL(0, zone()->knightRider.position);
+  TEST_ASSERT_EQUAL(1, zone()->knightRider.direction);
+  TEST_ASSERT_EQUAL(q16FromInt(ZONE_COLS / 2), zone()->pong.x);
+  TEST_ASSERT_EQUAL(0, zone()->pong.lastUpdateTime);
+  TEST_ASSERT_EQUAL(0, zone()->sine.lastUpdateTime);
+  TEST_ASSERT_FALSE(zone()->life.seeded);
+  TEST_ASSERT_NULL(zone()->twinkles);
+  TEST_ASSERT_EQUAL(0, zone()->twinkleCount);
+  TEST_ASSERT_EQUAL(ZONE_FIRST_COL, zone()->firstCol);
+  TEST_ASSERT_EQUAL(ZONE_COLS, zone()->cols);
+
+  // Another zone's instance is not touched
+  TEST_ASSERT_EQUAL(q16FromInt(4), other.pong.x);
+  TEST_ASSERT_EQUAL(0, other.firstCol);
+  TEST_ASSERT_EQUAL(8, other.cols);
+}
+
+static void test_reset_effects_keeps_the_selection() {
+  EffectInstance other;
+  memset(&other, 0, sizeof(other));
+  resetEffects(&other, 40, 24);
+
+  TEST_ASSERT_EQUAL_PTR(zone(), currentEffects());
+  TEST_ASSERT_EQUAL(40, other.firstCol);
+  TEST_ASSERT_EQUAL(24, other.cols);
+  TEST_ASSERT_EQUAL(q16FromInt(12), other.pong.x);
+}
+
+static void test_parse_reaches_each_mode() {
+  // Missing parameters keep the mode's defaults
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    if (mode == MODE_LAYERS) continue;
+    DisplayItem item;
+    item.setMode((EffectMode)mode);
+    ModeParams defaults = item.params;
+    parseEffectParams(item, JsonObject());
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &item.params, sizeof(defaults));
+  }
+
+  // Only the text parser names a new item
+  DisplayItem text;
+  text.setMode(MODE_TEXT);
+  parseEffectParams(text, JsonObject());
+  TEST_ASSERT_EQUAL_STRING("New Item", text.text.c_str());
+
+  DisplayItem pong;
+  pong.setMode(MODE_PONG);
+  parseEffectParams(pong, JsonObject());
+  TEST_ASSERT_EQUAL(0, pong.text.length());
+
+  // No parser for an unknown mode: nothing to read, nothing changes
+  DisplayItem unknown;
+  unknown.setMode(MODE_UNKNOWN);
+  parseEffectParams(unknown, JsonObject());
+  TEST_ASSERT_EQUAL(0, unknown.text.length());
+}
+
+// Dispatch with hooks that only count, leaving out the effects' own work
+static uint32_t dispatched[MODE_COUNT];
+
+template <EffectMode mode>
+__attribute__((noinline)) static void countFrame(const DisplayItem& item) {
+  dispatched[mode]++;
+}
+
+// The registry's way: a row per mode, looked up and called
+static const EffectInfo countingTable[MODE_COUNT] = {
+  {"text", 0, NULL, NULL, NULL, NULL},
+  {"twinkle", 0, NULL, countFrame<MODE_TWINKLE>, NULL, NULL},
+  {"knightrider", 0, NULL, countFrame<MODE_KNIGHTRIDER>, NULL, NULL},
+  {"pong", 0, NULL, countFrame<MODE_PONG>, NULL, NULL},
+  {"sinewave", 0, NULL, countFrame<MODE_SINEWAVE>, NULL, NULL},
+  {"bitmap", 0, NULL, NULL, NULL, NULL},
+  {"animation", 0, NULL, NULL, NULL, NULL},
+  {"layers", 0, NULL, NULL, NULL, NULL},
+  {"life", 0, NULL, countFrame<MODE_LIFE>, NULL, NULL},
+};
+
+static void registryDispatch(const DisplayItem& item) {
+  const EffectInfo& effect = item.mode < MODE_COUNT ? countingTable[item.mode] : unknownEffect;
+  if (effect.update) effect.update(item);
+}
+
+static void switchDispatch(const DisplayItem& item) {
+  switch (item.mode) {
+    case MODE_TWINKLE: countFrame<MODE_TWINKLE>(item); break;
+    case MODE_KNIGHTRIDER: countFrame<MODE_KNIGHTRIDER>(item); break;
+    case MODE_PONG: countFrame<MODE_PONG>(item); break;
+    case MODE_SINEWAVE: countFrame<MODE_SINEWAVE>(item); break;
+    case MODE_LIFE: countFrame<MODE_LIFE>(item); break;
+    default: break;
+  }
+}
+
+// What updateDisplayContent did before the registry: the mode kept as a
+// String, compared against each name, and again by the effect itself
+template <EffectMode mode>
+__attribute__((noinline)) static void countNamedFrame(const String& itemMode) {
+  if (itemMode != modeNames[mode]) return;
+  dispatched[mode]++;
+}
+
+static void nameChainDispatch(const String& itemMode) {
+  if (itemMode == "twinkle")     countNamedFrame<MODE_TWINKLE>(itemMode);
+  if (itemMode == "knightrider") countNamedFrame<MODE_KNIGHTRIDER>(itemMode);
+  if (itemMode == "pong")        countNamedFrame<MODE_PONG>(itemMode);
+  if (itemMode == "sinewave")    countNamedFrame<MODE_SINEWAVE>(itemMode);
+  if (itemMode == "text")        dispatched[MODE_TEXT]++;
+}
+
+// One frame each of the five modes the name chain knew
+static void test_dispatch_cost() {
+  static const EffectMode modes[] = {MODE_TEXT, MODE_TWINKLE, MODE_KNIGHTRIDER, MODE_PONG, MODE_SINEWAVE};
+  const uint8_t count = sizeof(modes) / sizeof(modes[0]);
+  DisplayItem items[count];
+  String names[count];
+  for (uint8_t i = 0; i < count; i++) {
+    items[i].setMode(modes[i]);
+    names[i] = modeNames[modes[i]];
+  }
+  auto registryFrames = [&]() { for (const DisplayItem& item : items) registryDispatch(item); };
+  auto switchFrames = [&]() { for (const DisplayItem& item : items) switchDispatch(item); };
+  auto nameFrames = [&]() { for (const String& name : names) nameChainDispatch(name); };
+
+  // The counting table has an update where effectTable does
+  for (uint8_t mode = 0; mode < MODE_COUNT; mode++) {
+    TEST_ASSERT_EQUAL_STRING(effectTable[mode].name, countingTable[mode].name);
+    TEST_ASSERT_EQUAL(effectTable[mode].update != NULL, countingTable[mode].update != NULL);
+  }
+
+  // Each reaches every mode's hook once, text included for the chain
+  uint32_t once[MODE_COUNT] = {0};
+  for (uint8_t i = 1; i < count; i++) once[modes[i]] = 1;
+  memset(dispatched, 0, sizeof(dispatched));
+  registryFrames();
+  TEST_ASSERT_EQUAL_MEMORY(once, dispatched, sizeof(once));
+  memset(dispatched, 0, sizeof(dispatched));
+  switchFrames();
+  TEST_ASSERT_EQUAL_MEMORY(once, dispatched, sizeof(once));
+  memset(dispatched, 0, sizeof(dispatched));
+  nameFrames();
+  once[MODE_TEXT] = 1;
+  TEST_ASSERT_EQUAL_MEMORY(once, dispatched, sizeof(once));
+
+  double registryNs = benchNs(100000, registryFrames) / count;
+  double switchNs = benchNs(100000, switchFrames) / count;
+  double nameNs = benchNs(100000, nameFrames) / count;
+  benchReport("dispatch, per item and frame     ns");
+  benchReport("registry (table, indirect call)  %5.1f", registryNs);
+  benchReport("switch on the mode               %5.1f", switchNs);
+  benchReport("String name chain (before)       %5.1f", nameNs);
+#if defined(__OPTIMIZE__) && !defined(__SANITIZE_ADDRESS__)
+  TEST_ASSERT_TRUE(registryNs * 2 < nameNs);
+#endif
+}
+
+int main() {
+  initTextPool();
+  UNITY_BEGIN();
+  RUN_TEST(test_names_and_modes_round_trip);
+  RUN_TEST(test_unknown_names_and_modes);
+  RUN_TEST(test_flags_match_what_each_mode_does);
+  RUN_TEST(test_update_reaches_each_effect);
+  RUN_TEST(test_init_restarts_every_effect_of_the_selected_instance);
+  RUN_TEST(test_reset_effects_keeps_the_selection);
+  RUN_TEST(test_parse_reaches_each_mode);
+  RUN_TEST(test_dispatch_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,181 @@
+#include <unity.h>
+#include "../../src/effect_registry.cpp"
+#include "../../src/effects.cpp"
+#include "../../src/grayscale.cpp"
+#include "../../src/framebuffer.cpp"
+#include "../../src/life.cpp"
+#include "../../src/display_item.cpp"
+#include "../../src/text_pool.cpp"
+#include "../../src/text_raster.cpp"
+#include "../../src/font.cpp"
+#include <host_bench.h>
+
+// SPI traffic of each effect through the frame buffer (framebuffer.h):
+// every effect runs on the whole chain for ten seconds of frames, the way
+// updateDisplayContent() shows it, and the bytes each frame pushes are
+// counted. Binary effects and text flush once per frame; grayscale ones
+// hand their planes to the plane timer, which is run for the frame's
+// length, so their figure includes the plane switches. A copy of the chain
+// built from the rows actually sent has to match the frame every time.
+
+#define TRAFFIC_FRAMES (10 * DEFAULT_FRAME_RATE)
+#define FRAME_PERIOD_US (1000000 / DEFAULT_FRAME_RATE)
+#define FULL_FRAME_BYTES (FRAME_ROWS * MAX7219_PACKET_BYTES)   // What every frame cost before
+
+// Keeps what the chain shows, from the rows each send latches
+class ChainBackend : public DisplayBackend {
+ public:
+  PackedFrame chain;
+
+  bool begin() { return true; }
+  const char* name() const { return "chain"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      if (rowMask & (1 << row)) memcpy(chain.bytes[row], frame.bytes[row], FRAME_ROW_BYTES);
+    }
+  }
+};
+
+static ChainBackend backend;
+static ZoneRuntime runtime;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() { return &backend; }
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+TaskHandle_t getRenderTaskHandle() { return NULL; }
+ZoneRuntime* zoneRuntime(uint8_t index) { return &runtime; }
+size_t parseLayers(DisplayItem& item, JsonArray layers) { return 0; }
+void writeLayers(JsonObject itemObj, const DisplayItem& item) {}
+
+typedef struct {
+  unsigned long frames;
+  unsigned long framesSent;   // Frames that pushed anything
+  unsigned long bytes;
+  unsigned long maxBytes;
+  unsigned long rows;
+} Traffic;
+
+static bool chainShowsFrame() {
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    if (memcmp(backend.chain.bytes[row], frameBuffer.bytes[row], MAX_DEVICES) != 0) return false;
+  }
+  return true;
+}
+
+// Plane switches due up to the end of this frame, on the timer's schedule
+static void runPlanesUntil(int64_t frameEndUs) {
+  while (grayIsRunning() && hostTimerRunning && hostTimeUs + (int64_t)hostTimerDelayUs <= frameEndUs) {
+    hostTimeUs += hostTimerDelayUs;
+    hostTimerRunning = false;
+    grayEmitNextPlane();
+    TEST_ASSERT_TRUE(chainShowsFrame());
+  }
+  hostTimeUs = frameEndUs;
+}
+
+// Ten seconds of one item on the whole chain, starting from a blank one
+static Traffic runEffect(DisplayItem& item) {
+  grayStop();
+  grayClear();
+  fbClear();
+  fbInvalidate();
+  fbFlush();
+  resetEffects(&runtime.effects, 0, FRAME_COLS);
+  const EffectInfo& effect = effectInfo(item.mode);
+  if (effect.flags & EFFECT_TEXT) textRasterPrepare(runtime.text, item);
+  fbResetStats();
+
+  Traffic traffic;
+  memset(&traffic, 0, sizeof(traffic));
+  for (uint32_t frame = 0; frame < TRAFFIC_FRAMES; frame++) {
+    int64_t frameEndUs = hostTimeUs + FRAME_PERIOD_US;
+    unsigned long bytesBefore = frameStats.bytesSent;
+    unsigned long rowsBefore = frameStats.rowsSent;
+
+    if (effect.update) effect.update(item);
+    if (effect.flags & EFFECT_TEXT) textRasterDraw(runtime.text, item);
+    if (effect.flags & EFFECT_GRAY) {
+      grayCommit();
+    } else {
+      grayStop();
+      fbFlush();
+      TEST_ASSERT_TRUE(chainShowsFrame());
+    }
+    runPlanesUntil(frameEndUs);
+
+    unsigned long bytes = frameStats.bytesSent - bytesBefore;
+    traffic.frames++;
+    if (bytes > 0) traffic.framesSent++;
+    traffic.bytes += bytes;
+    traffic.rows += frameStats.rowsSent - rowsBefore;
+    if (bytes > traffic.maxBytes) traffic.maxBytes = bytes;
+  }
+  grayStop();
+  return traffic;
+}
+
+static void report(const char* name, const Traffic& traffic) {
+  benchReport("%-12s %7.1f %5lu %6.2f %5.1f%%  %5.1f%%", name,
+              (double)traffic.bytes / traffic.frames, traffic.maxBytes,
+              (double)traffic.rows / traffic.frames,
+              100.0 * traffic.framesSent / traffic.frames,
+              100.0 * traffic.bytes / ((double)traffic.frames * FULL_FRAME_BYTES));
+}
+
+void setUp() {
+  hostTimeUs = 5000000;
+  randomSeed(1);
+  graySetTarget(NULL);
+  fbSetTarget(NULL);
+  selectEffects(&runtime.effects);
+}
+
+void tearDown() {}
+
+// Binary effects and text: only the rows that changed, once per frame
+static void test_binary_effects_send_only_changed_rows() {
+  static const EffectMode modes[] = {MODE_TEXT, MODE_PONG, MODE_LIFE};
+  benchReport("per frame, %d frames       bytes   max   rows  sent   of full resend", TRAFFIC_FRAMES);
+  for (EffectMode mode : modes) {
+    DisplayItem item;
+    item.setMode(mode);
+    if (mode == MODE_TEXT) item.text = "Packed frame buffer, dirty rows only";
+    Traffic traffic = runEffect(item);
+    report(effectModeName(mode), traffic);
+
+    // Never more than a full frame, and on average well under one
+    TEST_ASSERT_LESS_OR_EQUAL(FULL_FRAME_BYTES, traffic.maxBytes);
+    TEST_ASSERT_GREATER_THAN(0, traffic.bytes);
+    TEST_ASSERT_LESS_THAN(traffic.frames * FULL_FRAME_BYTES / 2, traffic.bytes);
+  }
+}
+
+// Grayscale effects: each plane switch resends the rows where the next
+// plane differs, several times a frame, so these cost more than a full
+// resend per frame did. Dirty rows only keep a switch to what differs.
+static void test_gray_effects_through_the_plane_timer() {
+  static const EffectMode modes[] = {MODE_TWINKLE, MODE_KNIGHTRIDER, MODE_SINEWAVE};
+  benchReport("per frame, %d frames       bytes   max   rows  sent   of full resend", TRAFFIC_FRAMES);
+  for (EffectMode mode : modes) {
+    DisplayItem item;
+    item.setMode(mode);
+    Traffic traffic = runEffect(item);
+    report(effectModeName(mode), traffic);
+
+    TEST_ASSERT_GREATER_THAN(0, traffic.bytes);
+    // A plane switch pushes at most a full frame
+    unsigned long switchesPerFrame = FRAME_PERIOD_US / GRAYSCALE_BCM_UNIT_US + 1;
+    TEST_ASSERT_LESS_OR_EQUAL(switchesPerFrame * FULL_FRAME_BYTES, traffic.maxBytes);
+  }
+}
+
+int main() {
+  initTextPool();
+  initGrayscale();
+  UNITY_BEGIN();
+  RUN_TEST(test_binary_effects_send_only_changed_rows);
+  RUN_TEST(test_gray_effects_through_the_plane_timer);
+  return UNITY_END();
+}
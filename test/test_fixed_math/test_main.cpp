@@ -0,0 +1,185 @@
+#include <unity.h>
+#include <math.h>
+#include "fixed_math.h"
+
+// The fixed-point kernels (fixed_math.h) against double precision, to the
+// error bounds their comments promise
+
+static const double STEP = 1.0 / Q16_ONE;   // One Q16.16 step
+
+static double toDouble(q16_16 x) {
+  return (double)x / Q16_ONE;
+}
+
+// Deterministic spread of values over the whole int32 range
+static uint32_t nextValue(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_conversions() {
+  TEST_ASSERT_EQUAL(0x180, Q8_FROM_FLOAT(1.5));
+  TEST_ASSERT_EQUAL(-0x180, Q8_FROM_FLOAT(-1.5));
+  TEST_ASSERT_EQUAL(0x8000, Q16_FROM_FLOAT(0.5));
+  TEST_ASSERT_EQUAL(-0x4000, Q16_FROM_FLOAT(-0.25));
+  TEST_ASSERT_EQUAL(1, Q16_FROM_FLOAT(STEP * 0.6));   // Rounded, not truncated
+  TEST_ASSERT_EQUAL(5 * Q16_ONE, q16FromInt(5));
+  TEST_ASSERT_EQUAL(-3 * Q8_ONE, q8FromInt(-3));
+  TEST_ASSERT_EQUAL(Q16_FROM_FLOAT(-1.5), q16FromQ8(Q8_FROM_FLOAT(-1.5)));
+  TEST_ASSERT_EQUAL(FIXED_HALF_TURN, FIXED_ANGLE_FROM_RADIANS(M_PI));
+  TEST_ASSERT_EQUAL(FIXED_QUARTER_TURN, FIXED_ANGLE_FROM_RADIANS(M_PI / 2));
+}
+
+static void test_floor_and_round() {
+  TEST_ASSERT_EQUAL(2, q16Floor(Q16_FROM_FLOAT(2.99)));
+  TEST_ASSERT_EQUAL(-3, q16Floor(Q16_FROM_FLOAT(-2.01)));
+  TEST_ASSERT_EQUAL(3, q16Round(Q16_FROM_FLOAT(2.5)));
+  TEST_ASSERT_EQUAL(2, q16Round(Q16_FROM_FLOAT(2.49)));
+  TEST_ASSERT_EQUAL(-2, q16Round(Q16_FROM_FLOAT(-2.5)));
+  TEST_ASSERT_EQUAL(-3, q16Round(Q16_FROM_FLOAT(-2.51)));
+}
+
+// Truncates: never above the exact product, and less than a step below
+static void test_mul_error() {
+  uint32_t state = 0x12345678;
+  for (int i = 0; i < 100000; i++) {
+    // Factors up to +-256 and +-64, so the product stays in range
+    q16_16 a = (int32_t)nextValue(state) >> 7;
+    q16_16 b = (int32_t)nextValue(state) >> 9;
+    double exact = toDouble(a) * toDouble(b);
+    double error = exact - toDouble(q16Mul(a, b));
+    TEST_ASSERT_TRUE(error >= 0);
+    TEST_ASSERT_TRUE(error < STEP);
+  }
+  TEST_ASSERT_EQUAL(Q16_ONE, q16Mul(Q16_ONE, Q16_ONE));
+  TEST_ASSERT_EQUAL(-6 * Q16_ONE, q16Mul(q16FromInt(-2), q16FromInt(3)));
+}
+
+static void test_mul_q8_error() {
+  uint32_t state = 0x9E3779B9;
+  for (int i = 0; i < 100000; i++) {
+    q16_16 a = (int32_t)nextValue(state) >> 9;   // Up to +-64
+    q8_8 b = (int16_t)nextValue(state);
+    double exact = toDouble(a) * ((double)b / Q8_ONE);
+    double error = exact - toDouble(q16MulQ8(a, b));
+    TEST_ASSERT_TRUE(error >= 0);
+    TEST_ASSERT_TRUE(error < STEP);
+  }
+}
+
+// Low by at most one step for |x| above 1/32768
+static void test_reciprocal_error() {
+  uint32_t state = 0xCAFEF00D;
+  for (int i = 0; i < 100000; i++) {
+    q16_16 x = (int32_t)nextValue(state) >> (nextValue(state) % 24);
+    if (x > -2 && x < 2) continue;
+    double exact = 1.0 / toDouble(x);
+    double low = (x > 0 ? exact - toDouble(q16Reciprocal(x)) : toDouble(q16Reciprocal(x)) - exact);
+    TEST_ASSERT_TRUE(low >= 0);
+    TEST_ASSERT_TRUE(low <= STEP);
+  }
+  TEST_ASSERT_EQUAL(Q16_ONE - 1, q16Reciprocal(Q16_ONE));
+  TEST_ASSERT_EQUAL(-(Q16_ONE / 2 - 1), q16Reciprocal(-2 * Q16_ONE));
+  TEST_ASSERT_EQUAL(INT32_MAX, q16Reciprocal(1));
+  TEST_ASSERT_EQUAL(INT32_MAX, q16Reciprocal(0));
+}
+
+// Under 1/16000 from float at every angle
+static void test_sin_cos_error() {
+  double worst = 0;
+  for (uint32_t a = 0; a < 65536; a++) {
+    double radians = a * (2 * M_PI / 65536);
+    double sinError = fabs(toDouble(fixedSin(a)) - sin(radians));
+    double cosError = fabs(toDouble(fixedCos(a)) - cos(radians));
+    worst = fmax(worst, fmax(sinError, cosError));
+  }
+  TEST_ASSERT_TRUE(worst < 1.0 / 16000);
+}
+
+// Under 1/320 from float over the quarter wave, and the ends exact
+static void test_sine_quarter_nearest_error() {
+  double worst = 0;
+  for (uint32_t x = 0; x <= FIXED_QUARTER_TURN; x++) {
+    double radians = x * (2 * M_PI / 65536);
+    worst = fmax(worst, fabs(toDouble(fixedSineQuarterNearest(x)) - sin(radians)));
+  }
+  TEST_ASSERT_TRUE(worst < 1.0 / 320);
+  TEST_ASSERT_EQUAL(0, fixedSineQuarterNearest(0));
+  TEST_ASSERT_EQUAL(65535, fixedSineQuarterNearest(FIXED_QUARTER_TURN));
+}
+
+static void test_sin_symmetry() {
+  for (uint32_t a = 0; a < 65536; a += 7) {
+    TEST_ASSERT_EQUAL(fixedSin(a), -fixedSin((fixed_angle)(0 - a)));
+    TEST_ASSERT_TRUE(fixedSin(a) <= 65535 && fixedSin(a) >= -65535);
+  }
+  TEST_ASSERT_EQUAL(0, fixedSin(0));
+  TEST_ASSERT_EQUAL(65535, fixedSin(FIXED_QUARTER_TURN));
+  TEST_ASSERT_EQUAL(0, fixedSin(FIXED_HALF_TURN));
+  TEST_ASSERT_EQUAL(-65535, fixedSin(FIXED_HALF_TURN + FIXED_QUARTER_TURN));
+}
+
+static void test_lerp() {
+  q16_16 a = q16FromInt(-10), b = q16FromInt(30);
+  TEST_ASSERT_EQUAL(a, q16Lerp(a, b, 0));
+  TEST_ASSERT_EQUAL(b, q16Lerp(a, b, Q16_ONE));
+  TEST_ASSERT_EQUAL(q16FromInt(10), q16Lerp(a, b, Q16_ONE / 2));
+  for (q16_16 t = 0; t <= Q16_ONE; t += 97) {
+    double exact = -10 + 40 * toDouble(t);
+    TEST_ASSERT_TRUE(fabs(toDouble(q16Lerp(a, b, t)) - exact) < STEP);
+  }
+
+  TEST_ASSERT_EQUAL(20, lerp8(20, 200, 0));
+  TEST_ASSERT_EQUAL(200, lerp8(20, 200, 256));
+  TEST_ASSERT_EQUAL(110, lerp8(20, 200, 128));
+  TEST_ASSERT_EQUAL(110, lerp8(200, 20, 128));
+  for (uint16_t t = 0; t <= 256; t++) {
+    double exact = 255 - 255 * t / 256.0;
+    TEST_ASSERT_TRUE(fabs(lerp8(255, 0, t) - exact) < 1);
+  }
+}
+
+// Each curve from 0 to 1, within a few steps of float and never going back
+static void test_easing() {
+  TEST_ASSERT_EQUAL(0, q16EaseIn(0));
+  TEST_ASSERT_EQUAL(Q16_ONE, q16EaseIn(Q16_ONE));
+  TEST_ASSERT_EQUAL(0, q16EaseOut(0));
+  TEST_ASSERT_EQUAL(Q16_ONE, q16EaseOut(Q16_ONE));
+  TEST_ASSERT_EQUAL(0, q16EaseInOut(0));
+  TEST_ASSERT_EQUAL(Q16_ONE, q16EaseInOut(Q16_ONE));
+  TEST_ASSERT_EQUAL(Q16_ONE / 2, q16EaseInOut(Q16_ONE / 2));
+
+  q16_16 lastIn = 0, lastOut = 0, lastInOut = 0;
+  for (q16_16 t = 0; t <= Q16_ONE; t += 13) {
+    double x = toDouble(t);
+    TEST_ASSERT_TRUE(fabs(toDouble(q16EaseIn(t)) - x * x) < 2 * STEP);
+    TEST_ASSERT_TRUE(fabs(toDouble(q16EaseOut(t)) - x * (2 - x)) < 2 * STEP);
+    TEST_ASSERT_TRUE(fabs(toDouble(q16EaseInOut(t)) - x * x * (3 - 2 * x)) < 4 * STEP);
+    TEST_ASSERT_TRUE(q16EaseIn(t) >= lastIn);
+    TEST_ASSERT_TRUE(q16EaseOut(t) >= lastOut);
+    TEST_ASSERT_TRUE(q16EaseInOut(t) >= lastInOut);
+    lastIn = q16EaseIn(t);
+    lastOut = q16EaseOut(t);
+    lastInOut = q16EaseInOut(t);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_conversions);
+  RUN_TEST(test_floor_and_round);
+  RUN_TEST(test_mul_error);
+  RUN_TEST(test_mul_q8_error);
+  RUN_TEST(test_reciprocal_error);
+  RUN_TEST(test_sin_cos_error);
+  RUN_TEST(test_sine_quarter_nearest_error);
+  RUN_TEST(test_sin_symmetry);
+  RUN_TEST(test_lerp);
+  RUN_TEST(test_easing);
+  return UNITY_END();
+}
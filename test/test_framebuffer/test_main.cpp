@@ -0,0 +1,223 @@
+#include <unity.h>
+#include "../../src/framebuffer.cpp"
+
+// Dirty-row flushing (framebuffer.h): what reaches the chain after each
+// kind of drawing, and what it costs in SPI bytes
+
+// Records every sendRows() instead of driving the chain
+class RecordingBackend : public DisplayBackend {
+ public:
+  uint32_t sends = 0;
+  uint8_t lastRowMask = 0;
+  PackedFrame lastFrame;
+
+  bool begin() { return true; }
+  const char* name() const { return "recording"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {
+    sends++;
+    lastRowMask = rowMask;
+    memcpy(&lastFrame, &frame, sizeof(lastFrame));
+  }
+};
+
+static RecordingBackend backend;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() {
+  return &backend;
+}
+
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+
+// Every test starts with a blank frame already on the chain
+void setUp() {
+  fbSetTarget(NULL);
+  fbClear();
+  fbInvalidate();
+  fbFlush();
+  fbResetStats();
+  backend.sends = 0;
+  backend.lastRowMask = 0;
+}
+
+void tearDown() {}
+
+static void test_first_flush_sends_every_row() {
+  fbInvalidate();
+  TEST_ASSERT_EQUAL(FRAME_ROWS * MAX7219_PACKET_BYTES, fbFlush());
+  TEST_ASSERT_EQUAL(1, backend.sends);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, backend.lastRowMask);
+  TEST_ASSERT_EQUAL(FRAME_ROWS, frameStats.rowsSent);
+}
+
+static void test_unchanged_frame_sends_nothing() {
+  TEST_ASSERT_EQUAL(0, fbFlush());
+  TEST_ASSERT_EQUAL(0, backend.sends);
+  TEST_ASSERT_EQUAL(1, frameStats.flushes);
+  TEST_ASSERT_EQUAL(0, frameStats.framesSent);
+}
+
+static void test_only_changed_rows_are_sent() {
+  fbSetPoint(2, 0, true);
+  fbSetPoint(5, FRAME_COLS - 1, true);
+  fbSetPoint(5, FRAME_COLS - 2, true);
+
+  TEST_ASSERT_EQUAL(2 * MAX7219_PACKET_BYTES, fbFlush());
+  TEST_ASSERT_EQUAL_HEX8((1 << 2) | (1 << 5), backend.lastRowMask);
+  TEST_ASSERT_EQUAL_HEX8(0x01, backend.lastFrame.bytes[2][0]);
+  TEST_ASSERT_EQUAL_HEX8(0xC0, backend.lastFrame.bytes[5][MAX_DEVICES - 1]);
+
+  // Sent once; the next flush has nothing to do
+  TEST_ASSERT_EQUAL(0, fbFlush());
+  TEST_ASSERT_EQUAL(1, backend.sends);
+}
+
+static void test_redrawing_the_same_bytes_costs_nothing() {
+  fbSetPoint(3, 10, true);
+  fbFlush();
+  backend.sends = 0;
+
+  // Cleared and drawn again before the flush: the chain already shows it
+  fbClear();
+  fbSetPoint(3, 10, true);
+  TEST_ASSERT_EQUAL(0, fbFlush());
+  TEST_ASSERT_EQUAL(0, backend.sends);
+
+  // Changed and changed back the same way
+  fbSetRowByte(4, 7, 0x5A);
+  fbSetRowByte(4, 7, 0x00);
+  TEST_ASSERT_EQUAL(0, fbFlush());
+}
+
+static void test_invalidate_resends_everything() {
+  fbSetPoint(1, 1, true);
+  fbFlush();
+
+  // Parola wrote to the chain behind the frame buffer's back
+  fbInvalidate();
+  TEST_ASSERT_EQUAL(FRAME_ROWS * MAX7219_PACKET_BYTES, fbFlush());
+  TEST_ASSERT_EQUAL_HEX8(0xFF, backend.lastRowMask);
+  TEST_ASSERT_EQUAL_HEX8(0x02, backend.lastFrame.bytes[1][0]);
+  TEST_ASSERT_EQUAL(0, fbFlush());
+}
+
+static void test_set_frame_marks_only_differing_rows() {
+  PackedFrame frame;
+  memcpy(&frame, &frameBuffer, sizeof(frame));
+  frame.bytes[6][MAX_DEVICES / 2] = 0x81;
+
+  fbSetFrame(frame);
+  TEST_ASSERT_EQUAL(MAX7219_PACKET_BYTES, fbFlush());
+  TEST_ASSERT_EQUAL_HEX8(1 << 6, backend.lastRowMask);
+
+  fbSetFrame(frame);
+  TEST_ASSERT_EQUAL(0, fbFlush());
+}
+
+static void test_other_targets_are_not_flushed() {
+  PackedFrame layer;
+  memset(&layer, 0, sizeof(layer));
+
+  fbSetTarget(&layer);
+  fbSetPoint(0, 0, true);
+  fbSetRowByte(7, 3, 0xFF);
+  TEST_ASSERT_TRUE(fbGetPoint(0, 0));
+  fbSetTarget(NULL);
+
+  TEST_ASSERT_FALSE(fbGetPoint(0, 0));
+  TEST_ASSERT_EQUAL_HEX8(0x01, layer.bytes[0][0]);
+  TEST_ASSERT_EQUAL(0, fbFlush());
+}
+
+static void test_stats_and_metrics_add_up() {
+  uint32_t before = metrics.spiBytes.load();
+
+  fbSetPoint(0, 0, true);
+  fbFlush();
+  fbSetPoint(0, 0, false);
+  fbSetPoint(1, 0, true);
+  fbFlush();
+
+  TEST_ASSERT_EQUAL(3, frameStats.rowsSent);
+  TEST_ASSERT_EQUAL(3 * MAX7219_PACKET_BYTES, frameStats.bytesSent);
+  TEST_ASSERT_EQUAL(2 * MAX7219_PACKET_BYTES, frameStats.lastFrameBytes);
+  TEST_ASSERT_EQUAL(2 * MAX7219_PACKET_BYTES, frameStats.maxFrameBytes);
+  TEST_ASSERT_EQUAL(2, frameStats.framesSent);
+
+  // The metric counts since boot and survives fbResetStats()
+  fbResetStats();
+  TEST_ASSERT_EQUAL(0, frameStats.bytesSent);
+  TEST_ASSERT_EQUAL(before + 3 * MAX7219_PACKET_BYTES, metrics.spiBytes.load());
+}
+
+static void test_draw_columns_right_to_left() {
+  // A 3-column strip at the left edge of a zone over columns 16-31
+  const uint8_t strip[] = {0x01, 0x02, 0x80};
+  fbSetRowByte(0, 1, 0xFF);   // Column 8-15 is outside the zone and stays
+  fbDrawColumns(strip, 3, 0, 16, 16, false);
+
+  // Zone x = 0 is the highest column of the zone
+  TEST_ASSERT_TRUE(fbGetPoint(0, 31));
+  TEST_ASSERT_TRUE(fbGetPoint(1, 30));
+  TEST_ASSERT_TRUE(fbGetPoint(7, 29));
+  TEST_ASSERT_FALSE(fbGetPoint(0, 30));
+  TEST_ASSERT_EQUAL_HEX8(0xFF, fbGetRowByte(0, 1));
+
+  // Inverted, the uncovered zone columns light up instead
+  fbDrawColumns(strip, 3, 0, 16, 16, true);
+  TEST_ASSERT_FALSE(fbGetPoint(0, 31));
+  TEST_ASSERT_TRUE(fbGetPoint(0, 16));
+  TEST_ASSERT_EQUAL_HEX8(0xFF, fbGetRowByte(0, 1));
+}
+
+static void test_partial_device_zone() {
+  // Columns 4-11 straddle devices 0 and 1
+  fbSetRowByte(2, 0, 0xFF);
+  fbSetRowByte(2, 1, 0xFF);
+  fbClearColumns(4, 8);
+  TEST_ASSERT_EQUAL_HEX8(0x0F, fbGetRowByte(2, 0));
+  TEST_ASSERT_EQUAL_HEX8(0xF0, fbGetRowByte(2, 1));
+
+  PackedFrame mask;
+  fbColumnMask(mask, 4, 8);
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    TEST_ASSERT_EQUAL_HEX8(0xF0, mask.bytes[row][0]);
+    TEST_ASSERT_EQUAL_HEX8(0x0F, mask.bytes[row][1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, mask.bytes[row][2]);
+  }
+}
+
+static void test_snapshot_follows_the_owner() {
+  fbSetPoint(4, 9, true);
+  fbFlush();
+  PackedFrame shown;
+  fbSnapshot(shown);
+  TEST_ASSERT_EQUAL_HEX8(0x02, shown.bytes[4][1]);
+
+  // After fbInvalidate() Parola drew last: read its column buffer
+  disp.getGraphicObject()->setColumn(0, 0x81);
+  fbInvalidate();
+  fbSnapshot(shown);
+  TEST_ASSERT_EQUAL_HEX8(0x01, shown.bytes[0][0]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, shown.bytes[7][0]);
+  TEST_ASSERT_EQUAL_HEX8(0x00, shown.bytes[4][1]);
+  disp.getGraphicObject()->clear();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_flush_sends_every_row);
+  RUN_TEST(test_unchanged_frame_sends_nothing);
+  RUN_TEST(test_only_changed_rows_are_sent);
+  RUN_TEST(test_redrawing_the_same_bytes_costs_nothing);
+  RUN_TEST(test_invalidate_resends_everything);
+  RUN_TEST(test_set_frame_marks_only_differing_rows);
+  RUN_TEST(test_other_targets_are_not_flushed);
+  RUN_TEST(test_stats_and_metrics_add_up);
+  RUN_TEST(test_draw_columns_right_to_left);
+  RUN_TEST(test_partial_device_zone);
+  RUN_TEST(test_snapshot_follows_the_owner);
+  return UNITY_END();
+}
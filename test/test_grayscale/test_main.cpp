@@ -0,0 +1,262 @@
+#include <unity.h>
+#include "../../src/framebuffer.cpp"
+#include "../../src/grayscale.cpp"
+
+// Bit-plane (BCM) grayscale (grayscale.h): slicing, the plane schedule
+// and the time each level is lit. The plane timer is the host esp_timer,
+// which only records delays; each test plays the timer by moving
+// hostTimeUs and calling grayEmitNextPlane().
+
+// Keeps the frame each sendRows() latched
+class RecordingBackend : public DisplayBackend {
+ public:
+  PackedFrame shown;
+  uint32_t sends = 0;
+
+  bool begin() { return true; }
+  const char* name() const { return "recording"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {
+    sends++;
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      if (rowMask & (1 << row)) memcpy(shown.bytes[row], frame.bytes[row], FRAME_ROW_BYTES);
+    }
+  }
+};
+
+static RecordingBackend backend;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() {
+  return &backend;
+}
+
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+
+TaskHandle_t getRenderTaskHandle() {
+  return NULL;
+}
+
+static bool shown(uint8_t row, uint16_t col) {
+  return backend.shown.bytes[row][col / 8] & (1 << (col % 8));
+}
+
+// Run whole cycles the way the timer would, adding up how long each
+// pixel of row 0 was lit
+static void runCycles(uint8_t cycles, uint32_t litUs[FRAME_COLS]) {
+  memset(litUs, 0, sizeof(uint32_t) * FRAME_COLS);
+  for (uint16_t plane = 0; plane < cycles * GRAY_PLANES; plane++) {
+    uint32_t heldUs = hostTimerDelayUs;
+    for (uint16_t col = 0; col < FRAME_COLS; col++) {
+      if (shown(0, col)) litUs[col] += heldUs;
+    }
+    hostTimeUs += heldUs;
+    grayEmitNextPlane();
+  }
+}
+
+void setUp() {
+  grayStop();
+  graySetTarget(NULL);
+  fbSetTarget(NULL);
+  fbClear();
+  fbInvalidate();
+  fbFlush();
+  hostTimeUs = 1000000;
+  hostTimerDelayUs = 0;
+  hostTimerStarts = 0;
+  initGrayscale();
+}
+
+void tearDown() {}
+
+static void test_pixels_pack_two_per_byte() {
+  graySetPixel(3, 10, 5);
+  graySetPixel(3, 11, 12);
+  graySetPixel(3, 12, 99);   // Clamped
+
+  TEST_ASSERT_EQUAL(5, grayGetPixel(3, 10));
+  TEST_ASSERT_EQUAL(12, grayGetPixel(3, 11));
+  TEST_ASSERT_EQUAL(GRAY_MAX_LEVEL, grayGetPixel(3, 12));
+  TEST_ASSERT_EQUAL_HEX8(0xC5, grayBuffer[3][5]);
+  TEST_ASSERT_EQUAL(0, grayGetPixel(FRAME_ROWS, 0));
+
+  grayClearColumns(11, 1);
+  TEST_ASSERT_EQUAL(5, grayGetPixel(3, 10));
+  TEST_ASSERT_EQUAL(0, grayGetPixel(3, 11));
+}
+
+static void test_set_columns_leaves_the_neighbours() {
+  static uint8_t levels[FRAME_ROWS][FRAME_COLS];
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t x = 0; x < FRAME_COLS; x++) levels[row][x] = (row * 7 + x) % (GRAY_MAX_LEVEL + 1);
+  }
+
+  // Both parities at either end, around and past the eight-column steps,
+  // and one running off the end of the chain
+  static const uint16_t zones[][2] = {
+    {0, FRAME_COLS}, {0, 1}, {1, 1}, {3, 8}, {4, 8}, {5, 9}, {6, 17}, {7, 22}, {10, 0},
+    {FRAME_COLS - 3, 10},
+  };
+  for (const uint16_t* zone : zones) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      for (uint16_t col = 0; col < FRAME_COLS; col++) graySetPixel(row, col, 9);
+    }
+    graySetColumns(levels, zone[0], zone[1]);
+
+    char message[32];
+    snprintf(message, sizeof(message), "columns %u +%u", zone[0], zone[1]);
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+      for (uint16_t col = 0; col < FRAME_COLS; col++) {
+        bool inside = col >= zone[0] && col < zone[0] + zone[1];
+        uint8_t expected = inside ? levels[row][col - zone[0]] : 9;
+        TEST_ASSERT_EQUAL_MESSAGE(expected, grayGetPixel(row, col), message);
+      }
+    }
+  }
+}
+
+static void test_slice_splits_levels_into_planes() {
+  for (uint16_t col = 0; col < FRAME_COLS; col++) {
+    graySetPixel(col % FRAME_ROWS, col, col % (GRAY_MAX_LEVEL + 1));
+  }
+
+  PackedFrame planes[GRAY_PLANES];
+  graySlice(grayBuffer, planes);
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = 0; col < FRAME_COLS; col++) {
+      uint8_t level = grayGetPixel(row, col);
+      for (uint8_t plane = 0; plane < GRAY_PLANES; plane++) {
+        bool lit = planes[plane].bytes[row][col / 8] & (1 << (col % 8));
+        TEST_ASSERT_EQUAL((level >> plane) & 1, lit);
+      }
+    }
+  }
+}
+
+static void test_planes_are_held_for_binary_weights() {
+  graySetPixel(0, 0, 1);
+  grayCommit();
+
+  TEST_ASSERT_TRUE(grayIsRunning());
+  TEST_ASSERT_TRUE(hostTimerRunning);
+
+  // Plane n stays up 2^n units, then the schedule starts over
+  for (uint8_t cycle = 0; cycle < 2; cycle++) {
+    for (uint8_t plane = 0; plane < GRAY_PLANES; plane++) {
+      TEST_ASSERT_EQUAL(GRAYSCALE_BCM_UNIT_US << plane, hostTimerDelayUs);
+      TEST_ASSERT_EQUAL(plane == 0, shown(0, 0));
+      hostTimeUs += hostTimerDelayUs;
+      grayEmitNextPlane();
+    }
+  }
+}
+
+static void test_every_level_is_lit_in_proportion() {
+  for (uint16_t col = 0; col <= GRAY_MAX_LEVEL; col++) graySetPixel(0, col, col);
+  grayCommit();
+
+  uint32_t litUs[FRAME_COLS];
+  runCycles(3, litUs);
+
+  for (uint16_t col = 0; col <= GRAY_MAX_LEVEL; col++) {
+    TEST_ASSERT_EQUAL_UINT32(3 * col * GRAYSCALE_BCM_UNIT_US, litUs[col]);
+  }
+}
+
+static void test_late_planes_keep_the_ideal_timeline() {
+  graySetPixel(0, 0, GRAY_MAX_LEVEL);
+  grayCommit();
+  int64_t deadline = hostTimeUs + GRAYSCALE_BCM_UNIT_US;
+
+  // Each plane goes out 100 us after its timer (a slow flush): the next
+  // delay is that much shorter, so every plane still ends on time
+  for (uint8_t i = 1; i <= 2 * GRAY_PLANES; i++) {
+    hostTimeUs += hostTimerDelayUs + 100;
+    grayEmitNextPlane();
+    deadline += GRAYSCALE_BCM_UNIT_US << (i % GRAY_PLANES);
+    TEST_ASSERT_EQUAL((GRAYSCALE_BCM_UNIT_US << (i % GRAY_PLANES)) - 100, hostTimerDelayUs);
+    TEST_ASSERT_EQUAL(deadline, hostTimeUs + hostTimerDelayUs);
+  }
+}
+
+static void test_far_behind_resyncs_instead_of_rushing() {
+  graySetPixel(0, 0, GRAY_MAX_LEVEL);
+  grayCommit();
+
+  // A long frame held up the render task past several deadlines
+  hostTimeUs += 100000;
+  uint32_t starts = hostTimerStarts;
+  grayEmitNextPlane();
+  TEST_ASSERT_EQUAL(starts + 1, hostTimerStarts);
+  TEST_ASSERT_EQUAL(GRAY_MIN_TIMER_US, hostTimerDelayUs);
+
+  // Back on the schedule from there
+  hostTimeUs += hostTimerDelayUs;
+  grayEmitNextPlane();
+  TEST_ASSERT_EQUAL(GRAYSCALE_BCM_UNIT_US << 2, hostTimerDelayUs);
+}
+
+static void test_identical_planes_cost_no_spi() {
+  // Full and blank pixels only: every plane is the same frame
+  for (uint16_t col = 0; col < FRAME_COLS; col += 2) graySetPixel(0, col, GRAY_MAX_LEVEL);
+  grayCommit();
+  uint32_t sends = backend.sends;
+
+  uint32_t litUs[FRAME_COLS];
+  runCycles(2, litUs);
+  TEST_ASSERT_EQUAL(sends, backend.sends);
+  TEST_ASSERT_EQUAL_UINT32(2 * GRAY_CYCLE_UNITS * GRAYSCALE_BCM_UNIT_US, litUs[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, litUs[1]);
+}
+
+static void test_stop_ends_the_cycle() {
+  graySetPixel(0, 0, 3);
+  grayCommit();
+  grayStop();
+
+  TEST_ASSERT_FALSE(grayIsRunning());
+  TEST_ASSERT_FALSE(hostTimerRunning);
+
+  // A tick that was already pending does nothing
+  uint32_t starts = hostTimerStarts;
+  uint32_t sends = backend.sends;
+  grayEmitNextPlane();
+  TEST_ASSERT_EQUAL(starts, hostTimerStarts);
+  TEST_ASSERT_EQUAL(sends, backend.sends);
+}
+
+static void test_commit_planes_built_elsewhere() {
+  PackedFrame planes[GRAY_PLANES];
+  memset(planes, 0, sizeof(planes));
+  planes[2].bytes[0][0] = 0x01;
+  grayCommitPlanes(planes);
+
+  TEST_ASSERT_EQUAL_HEX8(0x01, grayPlane(2).bytes[0][0]);
+  uint32_t litUs[FRAME_COLS];
+  runCycles(1, litUs);
+  TEST_ASSERT_EQUAL_UINT32(GRAYSCALE_BCM_UNIT_US << 2, litUs[0]);
+
+  // The intensity buffer is sliced again on the next grayCommit()
+  graySetPixel(0, 0, 1);
+  grayCommit();
+  TEST_ASSERT_EQUAL_HEX8(0x00, grayPlane(2).bytes[0][0]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, grayPlane(0).bytes[0][0]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_pixels_pack_two_per_byte);
+  RUN_TEST(test_set_columns_leaves_the_neighbours);
+  RUN_TEST(test_slice_splits_levels_into_planes);
+  RUN_TEST(test_planes_are_held_for_binary_weights);
+  RUN_TEST(test_every_level_is_lit_in_proportion);
+  RUN_TEST(test_late_planes_keep_the_ideal_timeline);
+  RUN_TEST(test_far_behind_resyncs_instead_of_rushing);
+  RUN_TEST(test_identical_planes_cost_no_spi);
+  RUN_TEST(test_stop_ends_the_cycle);
+  RUN_TEST(test_commit_planes_built_elsewhere);
+  return UNITY_END();
+}
@@ -0,0 +1,301 @@
+#include <unity.h>
+#include "../../src/life.cpp"
+#include "../../src/framebuffer.cpp"
+#include <host_bench.h>
+
+// The bit-sliced automata (life.h) against a plain per-cell version:
+// every cell's neighbours counted one by one on the same torus, for
+// random grids, several rules and widths that end inside, on and just
+// past word boundaries. The benchmark at the end times both.
+
+class NullBackend : public DisplayBackend {
+ public:
+  bool begin() { return true; }
+  const char* name() const { return "null"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {}
+};
+
+static NullBackend backend;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() { return &backend; }
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+
+static const uint16_t widths[] = {FRAME_COLS, FRAME_COLS - 1, 64, 63, 33, 32, 31, 17, 8, 3, 1};
+
+#define B(n) (1 << (n))
+
+// Birth, survive
+static const uint16_t rules[][2] = {
+  {B(3), B(2) | B(3)},                                           // Life
+  {B(3) | B(6), B(2) | B(3)},                                    // HighLife
+  {B(3) | B(6) | B(7) | B(8), B(3) | B(4) | B(6) | B(7) | B(8)},   // Day & Night
+  {B(2), 0},                                                     // Seeds
+  {0x1FF, 0x1FF},                                                // Every count
+  {B(0), B(8)},                                                  // Only the extremes
+};
+
+static bool cellAt(const uint32_t* row, int32_t col, uint16_t cols) {
+  col = (col % cols + cols) % cols;
+  return (row[col / 32] >> (col % 32)) & 1;
+}
+
+static void setCell(LifeGrid& grid, uint8_t row, uint16_t col) {
+  grid.rows[row][col / 32] |= 1UL << (col % 32);
+}
+
+static void referenceStep(const LifeGrid& in, LifeGrid& out, uint16_t cols, uint16_t birth, uint16_t survive) {
+  memset(&out, 0, sizeof(out));
+  for (int r = 0; r < FRAME_ROWS; r++) {
+    for (int c = 0; c < cols; c++) {
+      uint8_t neighbours = 0;
+      for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+          if (dr == 0 && dc == 0) continue;
+          neighbours += cellAt(in.rows[(r + dr + FRAME_ROWS) % FRAME_ROWS], c + dc, cols);
+        }
+      }
+      uint16_t rule = cellAt(in.rows[r], c, cols) ? survive : birth;
+      if (rule & B(neighbours)) setCell(out, r, c);
+    }
+  }
+}
+
+static void referenceStepElementary(const uint32_t* in, uint32_t* out, uint16_t cols, uint8_t rule) {
+  memset(out, 0, sizeof(uint32_t) * FRAME_ROW_WORDS);
+  for (int c = 0; c < cols; c++) {
+    // Left on screen is cell + 1
+    uint8_t n = cellAt(in, c + 1, cols) * 4 + cellAt(in, c, cols) * 2 + cellAt(in, c - 1, cols);
+    if (rule & B(n)) out[c / 32] |= 1UL << (c % 32);
+  }
+}
+
+void setUp() {
+  randomSeed(7);
+  fbSetTarget(NULL);
+  fbClear();
+}
+
+void tearDown() {}
+
+static void test_step_matches_the_reference() {
+  for (uint16_t cols : widths) {
+    for (const uint16_t* rule : rules) {
+      for (uint8_t trial = 0; trial < 20; trial++) {
+        LifeGrid grid, fast, slow;
+        lifeSeed(grid, cols, random(1, 100), 0);
+
+        // A few generations each, so the later ones start from grids the
+        // rule made rather than noise
+        for (uint8_t gen = 0; gen < 4; gen++) {
+          lifeStep(grid, fast, cols, rule[0], rule[1]);
+          referenceStep(grid, slow, cols, rule[0], rule[1]);
+          char message[48];
+          snprintf(message, sizeof(message), "cols %u B%03x S%03x gen %u", cols, rule[0], rule[1], gen);
+          TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&slow, &fast, sizeof(fast), message);
+          grid = fast;
+        }
+      }
+    }
+  }
+}
+
+static void test_step_elementary_matches_the_reference() {
+  for (uint16_t cols : widths) {
+    for (uint16_t rule = 0; rule < 256; rule++) {
+      LifeGrid grid;
+      lifeSeed(grid, cols, random(1, 100), FRAME_ROWS - 1);
+      uint32_t fast[FRAME_ROW_WORDS], slow[FRAME_ROW_WORDS];
+      lifeStepElementary(grid.rows[FRAME_ROWS - 1], fast, cols, rule);
+      referenceStepElementary(grid.rows[FRAME_ROWS - 1], slow, cols, rule);
+
+      char message[32];
+      snprintf(message, sizeof(message), "cols %u W%u", cols, rule);
+      TEST_ASSERT_EQUAL_MEMORY_MESSAGE(slow, fast, sizeof(fast), message);
+    }
+  }
+}
+
+static void test_glider_wraps_around_the_torus() {
+  // Moves one cell diagonally every 4 generations: back where it started
+  // after 4 * 8 on an 8 x 8 torus, and never the same in between
+  const uint16_t cols = 8;
+  LifeGrid start, grid, next;
+  memset(&start, 0, sizeof(start));
+  setCell(start, 0, 1);
+  setCell(start, 1, 2);
+  setCell(start, 2, 0);
+  setCell(start, 2, 1);
+  setCell(start, 2, 2);
+
+  grid = start;
+  for (uint8_t gen = 1; gen <= 32; gen++) {
+    lifeStep(grid, next, cols, B(3), B(2) | B(3));
+    grid = next;
+    if (gen < 32) TEST_ASSERT_NOT_EQUAL(lifeHash(start), lifeHash(grid));
+  }
+  TEST_ASSERT_EQUAL_MEMORY(&start, &grid, sizeof(grid));
+}
+
+static void test_cells_past_the_width_stay_clear() {
+  LifeGrid grid, next;
+  lifeSeed(grid, 40, 100, 0);
+  lifeStep(grid, next, 40, 0x1FF, 0x1FF);
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, next.rows[row][0]);
+    TEST_ASSERT_EQUAL_HEX32(0x000000FF, next.rows[row][1]);
+    for (uint8_t w = 2; w < FRAME_ROW_WORDS; w++) TEST_ASSERT_EQUAL_HEX32(0, next.rows[row][w]);
+  }
+
+  // No grid at all: out is left alone
+  memset(&next, 0x5A, sizeof(next));
+  LifeGrid untouched = next;
+  lifeStep(grid, next, 0, B(3), B(2) | B(3));
+  lifeStep(grid, next, FRAME_COLS + 1, B(3), B(2) | B(3));
+  TEST_ASSERT_EQUAL_MEMORY(&untouched, &next, sizeof(next));
+}
+
+static void test_seed() {
+  LifeGrid grid;
+
+  // Density 0: the middle cell of the last row
+  lifeSeed(grid, 21, 0, 0);
+  LifeGrid expected;
+  memset(&expected, 0, sizeof(expected));
+  setCell(expected, FRAME_ROWS - 1, 10);
+  TEST_ASSERT_EQUAL_MEMORY(&expected, &grid, sizeof(grid));
+
+  // Rows before firstRow stay empty, rows after are full at 100%
+  lifeSeed(grid, 21, 100, FRAME_ROWS - 1);
+  for (uint8_t row = 0; row < FRAME_ROWS - 1; row++) TEST_ASSERT_EQUAL_HEX32(0, grid.rows[row][0]);
+  TEST_ASSERT_EQUAL_HEX32(0x1FFFFF, grid.rows[FRAME_ROWS - 1][0]);
+  TEST_ASSERT_FALSE(lifeEmpty(grid));
+
+  memset(&grid, 0, sizeof(grid));
+  TEST_ASSERT_TRUE(lifeEmpty(grid));
+}
+
+static void test_hash_tells_grids_apart() {
+  LifeGrid a, b;
+  lifeSeed(a, FRAME_COLS, 50, 0);
+  b = a;
+  TEST_ASSERT_EQUAL_HEX32(lifeHash(a), lifeHash(b));
+  b.rows[FRAME_ROWS - 1][FRAME_ROW_WORDS - 1] ^= 0x80000000UL;
+  TEST_ASSERT_NOT_EQUAL(lifeHash(a), lifeHash(b));
+}
+
+static void test_draw_fills_only_the_zone() {
+  // A zone 37 columns wide from column 13: neither end on a device edge
+  for (uint8_t dev = 0; dev < MAX_DEVICES; dev++) {
+    for (uint8_t row = 0; row < FRAME_ROWS; row++) fbSetRowByte(row, dev, 0xAA);
+  }
+  LifeGrid grid;
+  lifeSeed(grid, 37, 50, 0);
+  lifeDraw(grid, 13, 37);
+
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = 0; col < FRAME_COLS; col++) {
+      bool inside = col >= 13 && col < 13 + 37;
+      bool expected = inside ? cellAt(grid.rows[row], col - 13, 37) : (col % 2 == 1);
+      TEST_ASSERT_EQUAL(expected, fbGetPoint(row, col));
+    }
+  }
+
+  // Clipped at the end of the chain
+  fbClear();
+  lifeSeed(grid, 16, 100, 0);
+  lifeDraw(grid, FRAME_COLS - 4, 16);
+  for (uint16_t col = 0; col < FRAME_COLS; col++) {
+    TEST_ASSERT_EQUAL(col >= FRAME_COLS - 4, fbGetPoint(0, col));
+  }
+}
+
+static void test_rules_parse_and_format() {
+  LifeParams params;
+  memset(&params, 0, sizeof(params));
+  char text[24];
+
+  TEST_ASSERT_TRUE(parseLifeRule("B36/S23", params));
+  TEST_ASSERT_FALSE(params.elementary);
+  TEST_ASSERT_EQUAL_HEX16(B(3) | B(6), params.birth);
+  TEST_ASSERT_EQUAL_HEX16(B(2) | B(3), params.survive);
+  formatLifeRule(params, text, sizeof(text));
+  TEST_ASSERT_EQUAL_STRING("B36/S23", text);
+
+  TEST_ASSERT_TRUE(parseLifeRule("s23/b3", params));   // Either order, any case
+  TEST_ASSERT_EQUAL_HEX16(B(3), params.birth);
+  TEST_ASSERT_TRUE(parseLifeRule("B/S", params));
+  formatLifeRule(params, text, sizeof(text));
+  TEST_ASSERT_EQUAL_STRING("B/S", text);
+
+  TEST_ASSERT_TRUE(parseLifeRule("w110", params));
+  TEST_ASSERT_TRUE(params.elementary);
+  TEST_ASSERT_EQUAL(110, params.wolfram);
+  formatLifeRule(params, text, sizeof(text));
+  TEST_ASSERT_EQUAL_STRING("W110", text);
+
+  // Every count in both parts still fits
+  TEST_ASSERT_TRUE(parseLifeRule("B012345678/S012345678", params));
+  formatLifeRule(params, text, sizeof(text));
+  TEST_ASSERT_EQUAL_STRING("B012345678/S012345678", text);
+  formatLifeRule(params, text, 4);
+  TEST_ASSERT_EQUAL_STRING("B01", text);
+
+  // Unreadable rules leave params as they were
+  LifeParams before = params;
+  const char* bad[] = {"W256", "W-1", "W", "W3x", "B9/S2", "B3", "S23", "B3/S2/B4", "hello", ""};
+  for (const char* rule : bad) {
+    TEST_ASSERT_FALSE_MESSAGE(parseLifeRule(rule, params), rule);
+    TEST_ASSERT_EQUAL_MEMORY(&before, &params, sizeof(params));
+  }
+  TEST_ASSERT_FALSE(parseLifeRule(NULL, params));
+}
+
+// Generations per second of Life on the full chain and a 32-column zone,
+// from a half-full grid: the bit-sliced step against the per-cell one
+static void test_generation_rate_against_the_reference() {
+  static const uint16_t benchWidths[] = {FRAME_COLS, 32};
+  benchReport("life B3/S23       lifeStep gen/s   per-cell gen/s   speed-up");
+  for (uint16_t cols : benchWidths) {
+    LifeGrid start, grid, next;
+    lifeSeed(start, cols, 50, 0);
+
+    // Each runs on from the same start and wraps back to it, so both
+    // see the same mix of busy and settled grids
+    grid = start;
+    uint16_t gen = 0;
+    auto fast = [&]() {
+      lifeStep(grid, next, cols, B(3), B(2) | B(3));
+      grid = ++gen % 64 ? next : start;
+    };
+    auto slow = [&]() {
+      referenceStep(grid, next, cols, B(3), B(2) | B(3));
+      grid = ++gen % 64 ? next : start;
+    };
+    double fastNs = benchNs(20000, fast);
+    grid = start;
+    gen = 0;
+    double slowNs = benchNs(640, slow);
+
+    benchReport("%3u columns      %15.0f  %15.0f  %8.1fx", cols, 1e9 / fastNs, 1e9 / slowNs, slowNs / fastNs);
+#if defined(__OPTIMIZE__) && !defined(__SANITIZE_ADDRESS__)
+    TEST_ASSERT_TRUE(fastNs * 10 < slowNs);
+#endif
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_step_matches_the_reference);
+  RUN_TEST(test_step_elementary_matches_the_reference);
+  RUN_TEST(test_glider_wraps_around_the_torus);
+  RUN_TEST(test_cells_past_the_width_stay_clear);
+  RUN_TEST(test_seed);
+  RUN_TEST(test_hash_tells_grids_apart);
+  RUN_TEST(test_draw_fills_only_the_zone);
+  RUN_TEST(test_rules_parse_and_format);
+  RUN_TEST(test_generation_rate_against_the_reference);
+  return UNITY_END();
+}
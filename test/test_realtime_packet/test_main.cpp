@@ -0,0 +1,180 @@
+#include <unity.h>
+#include "realtime_packet.h"
+
+// The realtime stream's wire format (realtime_packet.h): parsing,
+// sequence gaps, and encode/apply round trips of FULL and DELTA frames
+
+#define DEVICES 12
+#define MAX_PACKET (REALTIME_HEADER_BYTES + 8 * DEVICES)
+
+static uint8_t packet[MAX_PACKET];
+
+void setUp() {
+  memset(packet, 0, sizeof(packet));
+}
+
+void tearDown() {}
+
+static size_t header(uint8_t type, uint16_t seq, uint16_t baseSeq) {
+  packet[0] = 'L';
+  packet[1] = 'R';
+  packet[2] = type;
+  packet[3] = REALTIME_FLAG_ACK;
+  packet[4] = seq & 0xFF;
+  packet[5] = seq >> 8;
+  packet[6] = baseSeq & 0xFF;
+  packet[7] = baseSeq >> 8;
+  packet[8] = 0x78;
+  packet[9] = 0x56;
+  packet[10] = 0x34;
+  packet[11] = 0x12;
+  return REALTIME_HEADER_BYTES;
+}
+
+static void fillPattern(uint8_t rows[8][DEVICES], uint8_t seed) {
+  for (uint8_t row = 0; row < 8; row++) {
+    for (uint8_t dev = 0; dev < DEVICES; dev++) rows[row][dev] = (uint8_t)(seed + row * 31 + dev * 7);
+  }
+}
+
+static void test_parse_full() {
+  size_t length = header(REALTIME_PACKET_FULL, 0x1234, 0x1234) + 8 * DEVICES;
+  RealtimePacket parsed;
+  TEST_ASSERT_TRUE(realtimeParse(packet, length, DEVICES, parsed));
+  TEST_ASSERT_EQUAL(REALTIME_PACKET_FULL, parsed.type);
+  TEST_ASSERT_EQUAL(REALTIME_FLAG_ACK, parsed.flags);
+  TEST_ASSERT_EQUAL(0x1234, parsed.seq);
+  TEST_ASSERT_EQUAL_HEX32(0x12345678, parsed.timestamp);
+  TEST_ASSERT_EQUAL_PTR(packet + REALTIME_HEADER_BYTES, parsed.payload);
+  TEST_ASSERT_EQUAL(8 * DEVICES, parsed.payloadLength);
+
+  TEST_ASSERT_FALSE(realtimeParse(packet, length - 1, DEVICES, parsed));
+  TEST_ASSERT_FALSE(realtimeParse(packet, length, DEVICES - 1, parsed));
+}
+
+static void test_parse_delta() {
+  size_t length = header(REALTIME_PACKET_DELTA, 10, 9);
+  packet[length++] = 0x81;   // Rows 0 and 7
+  length += 2 * DEVICES;
+  RealtimePacket parsed;
+  TEST_ASSERT_TRUE(realtimeParse(packet, length, DEVICES, parsed));
+  TEST_ASSERT_EQUAL(9, parsed.baseSeq);
+
+  TEST_ASSERT_FALSE(realtimeParse(packet, length - DEVICES, DEVICES, parsed));
+  TEST_ASSERT_FALSE(realtimeParse(packet, REALTIME_HEADER_BYTES, DEVICES, parsed));   // No mask
+}
+
+static void test_parse_rejects() {
+  RealtimePacket parsed;
+  size_t length = header(REALTIME_PACKET_RELEASE, 1, 1);
+  TEST_ASSERT_TRUE(realtimeParse(packet, length, DEVICES, parsed));
+  TEST_ASSERT_FALSE(realtimeParse(packet, length + 1, DEVICES, parsed));
+  TEST_ASSERT_FALSE(realtimeParse(packet, length - 1, DEVICES, parsed));
+
+  packet[1] = 'A';   // An ack is not a request
+  TEST_ASSERT_FALSE(realtimeParse(packet, length, DEVICES, parsed));
+
+  header(7, 1, 1);
+  TEST_ASSERT_FALSE(realtimeParse(packet, length, DEVICES, parsed));
+}
+
+static void test_seq_gap() {
+  TEST_ASSERT_EQUAL(0, realtimeSeqGap(5, 6));
+  TEST_ASSERT_EQUAL(3, realtimeSeqGap(5, 9));
+  TEST_ASSERT_EQUAL(0, realtimeSeqGap(0xFFFF, 0));   // Wraps
+  TEST_ASSERT_EQUAL(1, realtimeSeqGap(0xFFFF, 1));
+  TEST_ASSERT_EQUAL(-1, realtimeSeqGap(5, 5));       // Duplicate
+  TEST_ASSERT_EQUAL(-3, realtimeSeqGap(5, 3));       // Late
+  TEST_ASSERT_EQUAL(-2, realtimeSeqGap(0, 0xFFFF));
+}
+
+static void test_apply_delta() {
+  uint8_t rows[8][DEVICES];
+  memset(rows, 0xAA, sizeof(rows));
+
+  size_t length = header(REALTIME_PACKET_DELTA, 2, 1);
+  packet[length++] = 0x24;   // Rows 2 and 5
+  memset(packet + length, 0x11, DEVICES);
+  memset(packet + length + DEVICES, 0x22, DEVICES);
+  length += 2 * DEVICES;
+
+  RealtimePacket parsed;
+  TEST_ASSERT_TRUE(realtimeParse(packet, length, DEVICES, parsed));
+  realtimeApply(parsed, &rows[0][0], DEVICES, DEVICES);
+  for (uint8_t row = 0; row < 8; row++) {
+    uint8_t expected = row == 2 ? 0x11 : (row == 5 ? 0x22 : 0xAA);
+    TEST_ASSERT_EACH_EQUAL_UINT8(expected, rows[row], DEVICES);
+  }
+}
+
+// Whatever encode picks, applying it to the previous frame gives the new one
+static void test_encode_round_trip() {
+  uint8_t previous[8][DEVICES], next[8][DEVICES], received[8][DEVICES];
+  fillPattern(previous, 1);
+  memcpy(next, previous, sizeof(next));
+  next[3][4] ^= 0x10;
+  next[6][11] ^= 0x01;
+  memcpy(received, previous, sizeof(received));
+
+  size_t length = realtimeEncode(packet, &next[0][0], &previous[0][0], DEVICES, DEVICES, 42, 7);
+  TEST_ASSERT_EQUAL(REALTIME_HEADER_BYTES + 1 + 2 * DEVICES, length);
+
+  RealtimePacket parsed;
+  TEST_ASSERT_TRUE(realtimeParse(packet, length, DEVICES, parsed));
+  TEST_ASSERT_EQUAL(REALTIME_PACKET_DELTA, parsed.type);
+  TEST_ASSERT_EQUAL(42, parsed.seq);
+  TEST_ASSERT_EQUAL(41, parsed.baseSeq);
+  TEST_ASSERT_EQUAL(7, parsed.timestamp);
+  realtimeApply(parsed, &received[0][0], DEVICES, DEVICES);
+  TEST_ASSERT_EQUAL_MEMORY(next, received, sizeof(next));
+}
+
+static void test_encode_full_frames() {
+  uint8_t previous[8][DEVICES], next[8][DEVICES], received[8][DEVICES];
+  fillPattern(previous, 1);
+  fillPattern(next, 2);   // Every row changed: a delta would be bigger
+  memset(received, 0, sizeof(received));
+
+  size_t length = realtimeEncode(packet, &next[0][0], &previous[0][0], DEVICES, DEVICES, 9, 0);
+  TEST_ASSERT_EQUAL(MAX_PACKET, length);
+  RealtimePacket parsed;
+  TEST_ASSERT_TRUE(realtimeParse(packet, length, DEVICES, parsed));
+  TEST_ASSERT_EQUAL(REALTIME_PACKET_FULL, parsed.type);
+  TEST_ASSERT_EQUAL(9, parsed.baseSeq);
+  realtimeApply(parsed, &received[0][0], DEVICES, DEVICES);
+  TEST_ASSERT_EQUAL_MEMORY(next, received, sizeof(next));
+
+  // Without a previous frame there is nothing to diff against
+  TEST_ASSERT_EQUAL(MAX_PACKET, realtimeEncode(packet, &next[0][0], NULL, DEVICES, DEVICES, 10, 0));
+  TEST_ASSERT_EQUAL(REALTIME_PACKET_FULL, packet[2]);
+}
+
+static void test_encode_unchanged() {
+  uint8_t rows[8][DEVICES];
+  fillPattern(rows, 3);
+  TEST_ASSERT_EQUAL(0, realtimeEncode(packet, &rows[0][0], &rows[0][0], DEVICES, DEVICES, 1, 0));
+}
+
+static void test_ack() {
+  header(REALTIME_PACKET_FULL, 77, 77);
+  uint8_t ack[REALTIME_HEADER_BYTES];
+  memcpy(ack, packet, sizeof(ack));
+  realtimeMakeAck(ack);
+  TEST_ASSERT_EQUAL('L', ack[0]);
+  TEST_ASSERT_EQUAL('A', ack[1]);
+  TEST_ASSERT_EQUAL_MEMORY(packet + 2, ack + 2, REALTIME_HEADER_BYTES - 2);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_full);
+  RUN_TEST(test_parse_delta);
+  RUN_TEST(test_parse_rejects);
+  RUN_TEST(test_seq_gap);
+  RUN_TEST(test_apply_delta);
+  RUN_TEST(test_encode_round_trip);
+  RUN_TEST(test_encode_full_frames);
+  RUN_TEST(test_encode_unchanged);
+  RUN_TEST(test_ack);
+  return UNITY_END();
+}
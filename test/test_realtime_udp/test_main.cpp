@@ -0,0 +1,180 @@
+#include <unity.h>
+#include "../../src/realtime.cpp"
+#include "../../src/framebuffer.cpp"
+#include "../../src/grayscale.cpp"
+#include "../../src/display_item.cpp"
+#include "../../src/text_pool.cpp"
+#include <host_bench.h>
+#include <chrono>
+#include <thread>
+
+// The realtime receiver (realtime.h) built for the host, with AsyncUDP on
+// a loopback socket: tools/realtime_sender.py streams to it from another
+// process while this thread plays the render task, so the firmware's
+// sequence-gap, ack and triple-buffer handling all run. The sender's loss
+// and round-trip report and the receiver's stats have to agree.
+
+class NullBackend : public DisplayBackend {
+ public:
+  bool begin() { return true; }
+  const char* name() const { return "null"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {}
+};
+
+static NullBackend backend;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+DisplayConfig config;
+bool textNeedsUpdate = false;
+
+DisplayBackend* getDisplayBackend() { return &backend; }
+TaskHandle_t getRenderTaskHandle() { return NULL; }
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+
+static const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+// The host clock at the real time, as the UDP thread reads it too
+static void syncClock() {
+  std::chrono::microseconds elapsed =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+  hostTimeUs = 10000000 + elapsed.count();
+}
+
+// One render task tick, at about 1 kHz
+static void renderTick() {
+  syncClock();
+  realtimeRender();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+typedef struct {
+  int status;          // Exit status; 127 if python3 is missing
+  unsigned sent;       // The sender's report
+  unsigned dropped;
+  unsigned acks;
+  unsigned lost;
+  std::string output;
+} SenderRun;
+
+// Run tools/realtime_sender.py against the receiver, rendering until it
+// exits and a little after, then stop the UDP task so its stats can be read
+static SenderRun runSender(const char* arguments) {
+  std::string file = __FILE__;
+  std::string root = file.substr(0, file.rfind("test/test_realtime_udp"));
+  std::string command = "python3 '" + root + "tools/realtime_sender.py' " + arguments +
+                        " --host 127.0.0.1 --port " + std::to_string(REALTIME_UDP_PORT) + " 2>&1";
+
+  SenderRun run = {-1, 0, 0, 0, 0, ""};
+  std::atomic<bool> done(false);
+  std::thread sender([&]() {
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe != NULL) {
+      char line[256];
+      while (fgets(line, sizeof(line), pipe) != NULL) {
+        run.output += line;
+        sscanf(line, "frames sent: %u", &run.sent);
+        sscanf(line, "dropped: %u", &run.dropped);
+        sscanf(line, "acks: %u", &run.acks);
+        sscanf(line, "lost: %u", &run.lost);
+      }
+      int status = pclose(pipe);
+      run.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+    done = true;
+  });
+  while (!done) renderTick();
+  sender.join();
+
+  for (uint8_t tick = 0; tick < 50; tick++) renderTick();
+  udp.close();
+  return run;
+}
+
+static void printReport(const SenderRun& run) {
+  size_t start = 0;
+  while (start < run.output.size()) {
+    size_t end = run.output.find('\n', start);
+    if (end == std::string::npos) end = run.output.size();
+    benchReport("%s", run.output.substr(start, end - start).c_str());
+    start = end + 1;
+  }
+}
+
+void setUp() {
+  syncClock();
+  config.displayOn = true;
+  config.realtimeTimeout = REALTIME_TIMEOUT_MS;
+  textNeedsUpdate = false;
+  memset(&realtimeStats, 0, sizeof(realtimeStats));
+  initRealtime();
+  TEST_ASSERT_TRUE_MESSAGE(udp.connected(), "realtime UDP port in use");
+}
+
+void tearDown() {
+  udp.close();
+}
+
+static void test_sender_loss_test_against_the_firmware() {
+  // Full frames every 10, deltas between; 5% of the frames are never sent,
+  // which the receiver has to count as lost and whose deltas it drops
+  SenderRun run = runSender("test --count 400 --fps 400 --pattern bounce --keyframe 10 --drop 5 --seed 3 --max-loss 0 --wait 1");
+  if (run.status == 127) TEST_IGNORE_MESSAGE("python3 not found");
+  printReport(run);
+  benchReport("receiver: %lu frames, %lu deltas, %lu stale, %lu shown, %lu overwritten, latency max %u us",
+              realtimeStats.frames, realtimeStats.deltas, realtimeStats.staleDeltas,
+              realtimeStats.shown, realtimeStats.overwritten, realtimeStats.maxLatencyUs);
+
+  // Every frame sent was acked, none lost on the way
+  TEST_ASSERT_EQUAL_MESSAGE(0, run.status, run.output.c_str());
+  TEST_ASSERT_EQUAL(400, run.sent + run.dropped);
+  TEST_ASSERT_TRUE(run.dropped > 0);
+  TEST_ASSERT_EQUAL(run.sent, run.acks);
+  TEST_ASSERT_EQUAL(0, run.lost);
+
+  // The gaps are exactly the frames left out; the release at the end is
+  // the one extra packet
+  TEST_ASSERT_EQUAL(run.sent + 1, realtimeStats.packets);
+  TEST_ASSERT_EQUAL(0, realtimeStats.badPackets);
+  TEST_ASSERT_EQUAL(0, realtimeStats.outOfOrder);
+  TEST_ASSERT_EQUAL(run.dropped, realtimeStats.lost);
+  TEST_ASSERT_EQUAL(run.sent, realtimeStats.frames + realtimeStats.deltas + realtimeStats.staleDeltas);
+  TEST_ASSERT_TRUE(realtimeStats.deltas > 0);
+  TEST_ASSERT_TRUE(realtimeStats.staleDeltas > 0);
+
+  // Every frame accepted was shown, replaced before it was, or is still
+  // waiting in the middle slot
+  unsigned long waiting = (middle.load() & SLOT_FRESH) ? 1 : 0;
+  TEST_ASSERT_EQUAL(realtimeStats.frames + realtimeStats.deltas,
+                    realtimeStats.shown + realtimeStats.overwritten + waiting);
+  TEST_ASSERT_TRUE(realtimeStats.shown > 0);
+
+  // Released: back to the playlist
+  TEST_ASSERT_FALSE(realtimeStats.active);
+  TEST_ASSERT_TRUE(textNeedsUpdate);
+}
+
+static void test_stream_times_out_to_the_playlist() {
+  config.realtimeTimeout = 500;
+  SenderRun run = runSender("send --count 20 --fps 200");
+  if (run.status == 127) TEST_IGNORE_MESSAGE("python3 not found");
+  TEST_ASSERT_EQUAL_MESSAGE(0, run.status, run.output.c_str());
+  TEST_ASSERT_EQUAL(20, realtimeStats.frames + realtimeStats.deltas);
+  TEST_ASSERT_TRUE(realtimeStats.shown > 0);
+
+  // Not released: the display stays the stream's until the timeout
+  TEST_ASSERT_TRUE(realtimeStats.active);
+  TEST_ASSERT_FALSE(textNeedsUpdate);
+  unsigned long lastPacket = lastPacketMs.load();
+  while (millis() - lastPacket < config.realtimeTimeout + 20) renderTick();
+  TEST_ASSERT_FALSE(realtimeStats.active);
+  TEST_ASSERT_TRUE(textNeedsUpdate);
+}
+
+int main() {
+  initTextPool();
+  UNITY_BEGIN();
+  RUN_TEST(test_sender_loss_test_against_the_firmware);
+  RUN_TEST(test_stream_times_out_to_the_playlist);
+  return UNITY_END();
+}
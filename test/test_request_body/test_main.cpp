@@ -0,0 +1,112 @@
+#include <unity.h>
+#include "request_body.h"
+
+// Reassembly of chunked request bodies (request_body.h), fed the way
+// ESPAsyncWebServer calls a body handler: chunk, offset, Content-Length.
+
+#define LIMIT 64
+
+static void* slot;
+
+void setUp() {
+  slot = NULL;
+}
+
+void tearDown() {
+  requestBodyRelease(&slot);
+}
+
+static RequestBodyResult append(const char* chunk, size_t index, size_t total) {
+  return requestBodyAppend(&slot, (const uint8_t*)chunk, strlen(chunk), index, total, LIMIT);
+}
+
+static void test_single_chunk() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_COMPLETE, append("{\"a\":1}", 0, 7));
+  TEST_ASSERT_EQUAL_STRING("{\"a\":1}", requestBodyData(slot));
+}
+
+static void test_split_chunks() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("{\"text\":", 0, 16));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("\"hel", 8, 16));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_COMPLETE, append("lo\"}", 12, 16));
+  TEST_ASSERT_EQUAL_STRING("{\"text\":\"hello\"}", requestBodyData(slot));
+}
+
+static void test_empty_body() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_COMPLETE, append("", 0, 0));
+  TEST_ASSERT_EQUAL_STRING("", requestBodyData(slot));
+}
+
+static void test_body_at_limit() {
+  char body[LIMIT + 1];
+  memset(body, 'x', LIMIT);
+  body[LIMIT] = '\0';
+  TEST_ASSERT_EQUAL(REQUEST_BODY_COMPLETE, append(body, 0, LIMIT));
+  TEST_ASSERT_EQUAL_STRING(body, requestBodyData(slot));
+}
+
+static void test_over_limit_refused() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_TOO_LARGE, append("{", 0, LIMIT + 1));
+  TEST_ASSERT_NULL(slot);
+  // The rest of the refused body is dropped without a buffer
+  TEST_ASSERT_EQUAL(REQUEST_BODY_IGNORED, append("}", 1, LIMIT + 1));
+  TEST_ASSERT_NULL(slot);
+}
+
+static void test_chunk_out_of_order() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("abcd", 0, 12));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_BAD_CHUNK, append("ijkl", 8, 12));
+  TEST_ASSERT_NULL(slot);
+  TEST_ASSERT_EQUAL(REQUEST_BODY_IGNORED, append("efgh", 4, 12));
+}
+
+static void test_chunk_overlapping() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("abcd", 0, 8));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_BAD_CHUNK, append("cdef", 2, 8));
+  TEST_ASSERT_NULL(slot);
+}
+
+static void test_total_changes() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("abcd", 0, 8));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_BAD_CHUNK, append("efgh", 4, 9));
+  TEST_ASSERT_NULL(slot);
+}
+
+static void test_chunk_past_total() {
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("abcd", 0, 6));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_BAD_CHUNK, append("efgh", 4, 6));
+  TEST_ASSERT_NULL(slot);
+}
+
+static void test_abandoned_body_replaced() {
+  // A body left half done is dropped when the next one starts
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("stale", 0, 20));
+  TEST_ASSERT_EQUAL(REQUEST_BODY_COMPLETE, append("fresh", 0, 5));
+  TEST_ASSERT_EQUAL_STRING("fresh", requestBodyData(slot));
+}
+
+static void test_abandoned_body_released() {
+  // What the server does with _tempObject when the client goes
+  TEST_ASSERT_EQUAL(REQUEST_BODY_PENDING, append("partial", 0, 20));
+  TEST_ASSERT_NOT_NULL(slot);
+  requestBodyRelease(&slot);
+  TEST_ASSERT_NULL(slot);
+  requestBodyRelease(&slot);
+  TEST_ASSERT_NULL(slot);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_chunk);
+  RUN_TEST(test_split_chunks);
+  RUN_TEST(test_empty_body);
+  RUN_TEST(test_body_at_limit);
+  RUN_TEST(test_over_limit_refused);
+  RUN_TEST(test_chunk_out_of_order);
+  RUN_TEST(test_chunk_overlapping);
+  RUN_TEST(test_total_changes);
+  RUN_TEST(test_chunk_past_total);
+  RUN_TEST(test_abandoned_body_replaced);
+  RUN_TEST(test_abandoned_body_released);
+  return UNITY_END();
+}
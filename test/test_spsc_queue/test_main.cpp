@@ -0,0 +1,93 @@
+#include <unity.h>
+#include <thread>
+#include "spsc_queue.h"
+
+// The web-to-render command queue (spsc_queue.h): order, the full and
+// empty cases, wrapping, and one producer and one consumer thread
+
+void setUp() {}
+void tearDown() {}
+
+static void test_fifo_order() {
+  SpscQueue<int, 8> queue;
+  TEST_ASSERT_TRUE(queue.empty());
+  for (int i = 0; i < 5; i++) TEST_ASSERT_TRUE(queue.push(i));
+  TEST_ASSERT_FALSE(queue.empty());
+
+  int item;
+  for (int i = 0; i < 5; i++) {
+    TEST_ASSERT_TRUE(queue.pop(item));
+    TEST_ASSERT_EQUAL(i, item);
+  }
+  TEST_ASSERT_FALSE(queue.pop(item));
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+// One slot stays free, so Capacity - 1 items fit
+static void test_full_drops() {
+  SpscQueue<int, 4> queue;
+  TEST_ASSERT_TRUE(queue.push(1));
+  TEST_ASSERT_TRUE(queue.push(2));
+  TEST_ASSERT_TRUE(queue.push(3));
+  TEST_ASSERT_FALSE(queue.push(4));
+
+  int item;
+  TEST_ASSERT_TRUE(queue.pop(item));
+  TEST_ASSERT_EQUAL(1, item);
+  TEST_ASSERT_TRUE(queue.push(5));
+  const int expected[] = {2, 3, 5};
+  for (int i = 0; i < 3; i++) {
+    TEST_ASSERT_TRUE(queue.pop(item));
+    TEST_ASSERT_EQUAL(expected[i], item);
+  }
+}
+
+static void test_wraps_around() {
+  SpscQueue<uint32_t, 4> queue;
+  uint32_t next = 0, expected = 0, item;
+  for (int round = 0; round < 1000; round++) {
+    int count = 1 + round % 3;
+    for (int i = 0; i < count; i++) TEST_ASSERT_TRUE(queue.push(next++));
+    for (int i = 0; i < count; i++) {
+      TEST_ASSERT_TRUE(queue.pop(item));
+      TEST_ASSERT_EQUAL(expected++, item);
+    }
+  }
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+// Every item pushed arrives once and in order, with both sides spinning
+// on a queue that is often full or empty
+static void test_two_threads() {
+  static SpscQueue<uint32_t, 16> queue;
+  const uint32_t count = 200000;
+
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < count; i++) {
+      while (!queue.push(i)) std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0, item, outOfOrder = 0;
+  while (expected < count) {
+    if (!queue.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (item != expected) outOfOrder++;
+    expected++;
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL(0, outOfOrder);
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fifo_order);
+  RUN_TEST(test_full_drops);
+  RUN_TEST(test_wraps_around);
+  RUN_TEST(test_two_threads);
+  return UNITY_END();
+}
@@ -0,0 +1,350 @@
+#include <unity.h>
+#include "../../src/effects.cpp"
+#include "../../src/effect_registry.cpp"
+#include "../../src/grayscale.cpp"
+#include "../../src/framebuffer.cpp"
+#include "../../src/life.cpp"
+#include "../../src/display_item.cpp"
+#include "../../src/text_pool.cpp"
+#include <host_bench.h>
+
+// The twinkle effect (effects.h): slots allocated per zone, kept packed,
+// and faded in and out along a fixed-point half sine. Time is the host
+// clock; most tests place twinkles by hand, with a density too low to
+// start random ones.
+
+class NullBackend : public DisplayBackend {
+ public:
+  bool begin() { return true; }
+  const char* name() const { return "null"; }
+  void sendRows(const PackedFrame& frame, uint8_t rowMask) {}
+};
+
+static NullBackend backend;
+static ZoneRuntime runtime;
+
+MD_Parola disp(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
+Metrics metrics;
+
+DisplayBackend* getDisplayBackend() { return &backend; }
+void metricsObserve(MetricsHistogram& histogram, uint32_t us) {}
+TaskHandle_t getRenderTaskHandle() { return NULL; }
+ZoneRuntime* zoneRuntime(uint8_t index) { return &runtime; }
+size_t parseLayers(DisplayItem& item, JsonArray layers) { return 0; }
+void writeLayers(JsonObject itemObj, const DisplayItem& item) {}
+
+static EffectInstance* zone() {
+  return &runtime.effects;
+}
+
+static DisplayItem twinkleItem(uint8_t density) {
+  DisplayItem item;
+  item.setMode(MODE_TWINKLE);
+  item.params.twinkle.density = density;
+  item.params.twinkle.minSpeed = 100;
+  item.params.twinkle.maxSpeed = 1000;
+  return item;
+}
+
+static void advanceMs(uint32_t ms) {
+  hostTimeUs += (int64_t)ms * 1000;
+}
+
+// Start a twinkle now, by hand
+static TwinkleState& place(uint8_t row, uint16_t col, uint16_t duration, uint8_t maxBrightness) {
+  TwinkleState& twinkle = zone()->twinkles[zone()->twinkleCount++];
+  twinkle.startTime = (uint16_t)millis();
+  twinkle.duration = duration;
+  twinkle.rate = (FIXED_HALF_TURN << TWINKLE_RATE_SHIFT) / duration;
+  twinkle.row = row;
+  twinkle.col = col;
+  twinkle.maxBrightness = maxBrightness;
+  return twinkle;
+}
+
+// What the fade should give, in double precision
+static double expectedLevel(uint32_t elapsed, uint16_t duration, uint8_t maxBrightness) {
+  return sin(M_PI * elapsed / duration) * maxBrightness;
+}
+
+void setUp() {
+  hostTimeUs = 5000000;
+  randomSeed(1);
+  graySetTarget(NULL);
+  grayClear();
+  resetEffects(zone(), 0, FRAME_COLS);
+  selectEffects(zone());
+}
+
+void tearDown() {}
+
+static void test_slots_only_while_twinkling() {
+  TEST_ASSERT_NULL(zone()->twinkles);
+  TEST_ASSERT_EQUAL(0, zone()->twinkleCapacity);
+
+  // A zone 16 columns wide gets a slot per LED on its first twinkle frame
+  resetEffects(zone(), 8, 16);
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_NOT_NULL(zone()->twinkles);
+  TEST_ASSERT_EQUAL(FRAME_ROWS * 16, zone()->twinkleCapacity);
+
+  // Given back when the zone starts over
+  resetEffects(zone(), 8, 16);
+  TEST_ASSERT_NULL(zone()->twinkles);
+  TEST_ASSERT_EQUAL(0, zone()->twinkleCount);
+}
+
+static void test_fade_follows_a_half_sine() {
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  place(2, 5, 1000, GRAY_MAX_LEVEL);
+
+  uint8_t peak = 0;
+  for (uint32_t elapsed = 0; elapsed < 1000; elapsed += 10) {
+    updateTwinkleEffect(item);
+    uint8_t level = grayGetPixel(2, 5);
+    // Rounding, plus the sine table's nearest entry (fixed_math.h)
+    TEST_ASSERT_FLOAT_WITHIN(0.5 + 0.05, expectedLevel(elapsed, 1000, GRAY_MAX_LEVEL), level);
+    if (level > peak) peak = level;
+    advanceMs(10);
+  }
+  TEST_ASSERT_EQUAL(GRAY_MAX_LEVEL, peak);
+
+  // Over: the slot is free and the LED dark
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(0, zone()->twinkleCount);
+  TEST_ASSERT_EQUAL(0, grayGetPixel(2, 5));
+}
+
+static void test_fade_scales_to_max_brightness() {
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  place(0, 0, 400, 6);
+
+  advanceMs(200);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(6, grayGetPixel(0, 0));
+  advanceMs(100);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(4, grayGetPixel(0, 0));   // 6 * sin(3/4 pi) = 4.24
+}
+
+static void test_finished_twinkles_keep_the_rest_packed() {
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  place(0, 0, 100, GRAY_MAX_LEVEL);
+  place(1, 1, 500, GRAY_MAX_LEVEL);
+  place(2, 2, 300, GRAY_MAX_LEVEL);
+
+  // The first ends: the last moves into its slot
+  advanceMs(150);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(2, zone()->twinkleCount);
+  TEST_ASSERT_EQUAL(2, zone()->twinkles[0].row);
+  TEST_ASSERT_EQUAL(1, zone()->twinkles[1].row);
+  TEST_ASSERT_EQUAL(0, grayGetPixel(0, 0));
+  TEST_ASSERT_TRUE(grayGetPixel(1, 1) > 0);
+  TEST_ASSERT_TRUE(grayGetPixel(2, 2) > 0);
+
+  advanceMs(200);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(1, zone()->twinkleCount);
+  TEST_ASSERT_EQUAL(1, zone()->twinkles[0].row);
+}
+
+static void test_overlap_keeps_the_brighter() {
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  place(4, 4, 1000, 3);
+  place(4, 4, 1000, 12);
+  place(4, 4, 1000, 7);
+
+  advanceMs(500);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(12, grayGetPixel(4, 4));
+}
+
+static void test_fade_survives_the_16_bit_wrap() {
+  // Start times are the low 16 bits of millis()
+  hostTimeUs = (int64_t)(0x10000 - 250) * 1000;
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  place(3, 3, 1000, GRAY_MAX_LEVEL);
+
+  advanceMs(500);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(GRAY_MAX_LEVEL, grayGetPixel(3, 3));
+  TEST_ASSERT_EQUAL(1, zone()->twinkleCount);
+}
+
+static void test_stale_twinkles_are_dropped() {
+  DisplayItem item = twinkleItem(1);
+  updateTwinkleEffect(item);
+  place(0, 0, 1000, GRAY_MAX_LEVEL);
+
+  // Another item was showing for a while: long enough for the 16-bit
+  // start time to look only 100 ms old
+  advanceMs(0x10000 + 100);
+  updateTwinkleEffect(item);
+  TEST_ASSERT_EQUAL(0, zone()->twinkleCount);
+  TEST_ASSERT_EQUAL(0, grayGetPixel(0, 0));
+}
+
+static void test_density_fills_the_zone_and_no_further() {
+  // One column: 8 slots, 10 new twinkles asked for each frame
+  resetEffects(zone(), 40, 1);
+  DisplayItem item = twinkleItem(50);
+  for (uint8_t frame = 0; frame < 5; frame++) {
+    updateTwinkleEffect(item);
+    TEST_ASSERT_LESS_OR_EQUAL(FRAME_ROWS, zone()->twinkleCount);
+    advanceMs(1);
+  }
+  TEST_ASSERT_EQUAL(FRAME_ROWS, zone()->twinkleCount);
+
+  // Drawn only inside the zone's column
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = 0; col < FRAME_COLS; col++) {
+      if (col != 40) TEST_ASSERT_EQUAL(0, grayGetPixel(row, col));
+    }
+  }
+}
+
+// The engine before packed slots, as the benchmark's baseline: 100 slots
+// scanned for free ones on every new twinkle, and sin() per twinkle
+#define OLD_MAX_TWINKLES 100
+
+typedef struct {
+  bool active;
+  unsigned long startTime;
+  unsigned long duration;
+  uint8_t maxBrightness;
+  uint8_t row;
+  uint8_t col;
+} OldTwinkleState;
+
+static OldTwinkleState oldTwinkles[OLD_MAX_TWINKLES];
+
+static void oldTwinkleFrame(const DisplayItem& item) {
+  unsigned long currentTime = millis();
+  grayClearColumns(0, FRAME_COLS);
+
+  int safeDensity = constrain(item.twinkle().density, 1, 50);
+  int safeMinSpeed = constrain(item.twinkle().minSpeed, 10, 1000);
+  int safeMaxSpeed = constrain(item.twinkle().maxSpeed, safeMinSpeed, 2000);
+
+  int inactiveCount = 0;
+  for (int i = 0; i < OLD_MAX_TWINKLES; i++) {
+    if (!oldTwinkles[i].active) inactiveCount++;
+  }
+  int newTwinkles = constrain(safeDensity / 5, 0, inactiveCount);
+  for (int i = 0; i < newTwinkles; i++) {
+    int slot = -1;
+    for (int j = 0; j < OLD_MAX_TWINKLES; j++) {
+      if (!oldTwinkles[j].active) {
+        slot = j;
+        break;
+      }
+    }
+    if (slot >= 0) {
+      oldTwinkles[slot].active = true;
+      oldTwinkles[slot].startTime = currentTime;
+      oldTwinkles[slot].duration = random(safeMinSpeed, safeMaxSpeed + 1);
+      oldTwinkles[slot].maxBrightness = random(5, DEFAULT_MAX_INTENSITY + 1);
+      oldTwinkles[slot].row = random(matrixRows);
+      oldTwinkles[slot].col = random(FRAME_COLS);
+    }
+  }
+
+  for (int i = 0; i < OLD_MAX_TWINKLES; i++) {
+    OldTwinkleState& twinkle = oldTwinkles[i];
+    if (!twinkle.active) continue;
+    unsigned long elapsed = currentTime - twinkle.startTime;
+    if (elapsed >= twinkle.duration) {
+      twinkle.active = false;
+      continue;
+    }
+    float brightness = sin(PI * ((float)elapsed / twinkle.duration)) * twinkle.maxBrightness;
+    if (brightness > 0 && twinkle.row < matrixRows && twinkle.col < FRAME_COLS) {
+      uint8_t level = (uint8_t)(brightness + 0.5f);
+      if (level > grayGetPixel(twinkle.row, twinkle.col)) graySetPixel(twinkle.row, twinkle.col, level);
+    }
+  }
+}
+
+static uint16_t litPixels() {
+  uint16_t lit = 0;
+  for (uint8_t row = 0; row < FRAME_ROWS; row++) {
+    for (uint16_t col = 0; col < FRAME_COLS; col++) lit += grayGetPixel(row, col) > 0;
+  }
+  return lit;
+}
+
+// Frame time at 50 fps with 100-2000 ms twinkles, once the number running
+// has settled: the old engine capped at 100 against slots for every LED
+static void test_frame_cost_against_the_old_engine() {
+  static const uint8_t densities[] = {5, 25, 50};
+  benchReport("twinkle frame, steady state   old (100 slots)        new (%u slots)", FRAME_ROWS * FRAME_COLS);
+  benchReport("density                       ns/frame  lit LEDs     ns/frame  lit LEDs  running");
+
+  for (uint8_t density : densities) {
+    DisplayItem item = twinkleItem(density);
+    item.params.twinkle.minSpeed = 100;
+    item.params.twinkle.maxSpeed = 2000;
+    // A clock each, as they take turns below
+    int64_t oldClock = hostTimeUs, newClock = hostTimeUs;
+    auto oldFrame = [&]() {
+      hostTimeUs = oldClock += 20000;
+      oldTwinkleFrame(item);
+    };
+    auto newFrame = [&]() {
+      hostTimeUs = newClock += 20000;
+      updateTwinkleEffect(item);
+    };
+
+    memset(oldTwinkles, 0, sizeof(oldTwinkles));
+    resetEffects(zone(), 0, FRAME_COLS);
+    for (uint16_t frame = 0; frame < 250; frame++) {
+      oldFrame();
+      newFrame();
+    }
+
+    // Rounds of each in turn, so a slower stretch of the machine does not
+    // fall on one engine only. Each frame redraws all of its columns.
+    double oldNs = 0, newNs = 0;
+    for (uint8_t round = 0; round < 10; round++) {
+      double oldRound = benchNs(500, oldFrame, 1);
+      double newRound = benchNs(500, newFrame, 1);
+      if (round == 0 || oldRound < oldNs) oldNs = oldRound;
+      if (round == 0 || newRound < newNs) newNs = newRound;
+    }
+    oldFrame();
+    uint16_t oldLit = litPixels();
+    newFrame();
+    uint16_t newLit = litPixels();
+
+    benchReport("%7u                       %8.0f  %8u     %8.0f  %8u  %7u",
+                density, oldNs, oldLit, newNs, newLit, zone()->twinkleCount);
+    // Past the old cap wherever the density asks for more
+    if (density >= 25) TEST_ASSERT_TRUE(zone()->twinkleCount > OLD_MAX_TWINKLES);
+#if defined(__OPTIMIZE__) && !defined(__SANITIZE_ADDRESS__)
+    // Timing a debug or sanitizer build says nothing about the device
+    TEST_ASSERT_TRUE_MESSAGE(newNs <= oldNs, "a frame costs more than with the old engine");
+#endif
+  }
+}
+
+int main() {
+  initTextPool();
+  UNITY_BEGIN();
+  RUN_TEST(test_slots_only_while_twinkling);
+  RUN_TEST(test_fade_follows_a_half_sine);
+  RUN_TEST(test_fade_scales_to_max_brightness);
+  RUN_TEST(test_finished_twinkles_keep_the_rest_packed);
+  RUN_TEST(test_overlap_keeps_the_brighter);
+  RUN_TEST(test_fade_survives_the_16_bit_wrap);
+  RUN_TEST(test_stale_twinkles_are_dropped);
+  RUN_TEST(test_density_fills_the_zone_and_no_further);
+  RUN_TEST(test_frame_cost_against_the_old_engine);
+  return UNITY_END();
+}
@@ -0,0 +1,486 @@
+#!/usr/bin/env python3
+"""Generate src/includes/font_atlas.h, the proportional font used by the
+text rasterizer.
+
+Glyphs are drawn below as rows of '#' (lit) and '.' (dark), row 0 at the
+top and row 7 reserved for descenders. Accented Latin-1 letters are built
+from their base letter plus an accent, capitals squeezed to five rows so
+the accent fits above them.
+
+The header holds:
+  FONT_COLUMNS     one byte per column, bit r = row r
+  FONT_GLYPHS      offset, width and flags of each glyph
+  FONT_RANGES      code point ranges mapped onto consecutive glyphs
+  FONT_KERN_PAIRS  glyph pairs (left << 8 | right) whose gap shrinks by a
+                   column, found by checking that their facing edges keep
+                   at least one dark row between any two lit pixels
+
+Usage:
+  python3 tools/gen_font_atlas.py                 regenerate the header
+  python3 tools/gen_font_atlas.py --measure TEXT  print TEXT's width in columns
+"""
+import argparse
+import os
+import sys
+
+HEIGHT = 8
+FLAG_JOIN = 0x01   # No gap between two joining glyphs (block elements)
+
+OUT_PATH = os.path.join(os.path.dirname(__file__), "..", "src", "includes", "font_atlas.h")
+
+# --- ASCII -----------------------------------------------------------------
+
+ASCII = {
+    " ": ["..", "..", "..", "..", "..", "..", ".."],
+    "!": ["#", "#", "#", "#", "#", ".", "#"],
+    '"': ["#.#", "#.#", "...", "...", "...", "...", "..."],
+    "#": [".#.#.", ".#.#.", "#####", ".#.#.", "#####", ".#.#.", ".#.#."],
+    "$": ["..#..", ".####", "#.#..", ".###.", "..#.#", "####.", "..#.."],
+    "%": ["##...", "##..#", "...#.", "..#..", ".#...", "#..##", "...##"],
+    "&": [".##..", "#..#.", "#.#..", ".#...", "#.#.#", "#..#.", ".##.#"],
+    "'": ["#", "#", ".", ".", ".", ".", "."],
+    "(": [".#", "#.", "#.", "#.", "#.", "#.", ".#"],
+    ")": ["#.", ".#", ".#", ".#", ".#", ".#", "#."],
+    "*": [".....", "..#..", "#.#.#", ".###.", "#.#.#", "..#..", "....."],
+    "+": [".....", "..#..", "..#..", "#####", "..#..", "..#..", "....."],
+    ",": ["..", "..", "..", "..", "..", ".#", ".#", "#."],
+    "-": ["....", "....", "....", "####", "....", "....", "...."],
+    ".": [".", ".", ".", ".", ".", ".", "#"],
+    "/": [".....", "....#", "...#.", "..#..", ".#...", "#....", "....."],
+    "0": [".###.", "#...#", "#..##", "#.#.#", "##..#", "#...#", ".###."],
+    "1": [".#.", "##.", ".#.", ".#.", ".#.", ".#.", "###"],
+    "2": [".###.", "#...#", "....#", "...#.", "..#..", ".#...", "#####"],
+    "3": ["#####", "...#.", "..#..", "...#.", "....#", "#...#", ".###."],
+    "4": ["...#.", "..##.", ".#.#.", "#..#.", "#####", "...#.", "...#."],
+    "5": ["#####", "#....", "####.", "....#", "....#", "#...#", ".###."],
+    "6": ["..##.", ".#...", "#....", "####.", "#...#", "#...#", ".###."],
+    "7": ["#####", "....#", "...#.", "..#..", ".#...", ".#...", ".#..."],
+    "8": [".###.", "#...#", "#...#", ".###.", "#...#", "#...#", ".###."],
+    "9": [".###.", "#...#", "#...#", ".####", "....#", "...#.", ".##.."],
+    ":": [".", ".", "#", ".", ".", "#", "."],
+    ";": ["..", "..", ".#", "..", "..", ".#", ".#", "#."],
+    "<": ["...#", "..#.", ".#..", "#...", ".#..", "..#.", "...#"],
+    "=": ["....", "....", "####", "....", "####", "....", "...."],
+    ">": ["#...", ".#..", "..#.", "...#", "..#.", ".#..", "#..."],
+    "?": [".###.", "#...#", "....#", "...#.", "..#..", ".....", "..#.."],
+    "@": [".###.", "#...#", "....#", ".##.#", "#.#.#", "#.#.#", ".###."],
+    "A": [".###.", "#...#", "#...#", "#####", "#...#", "#...#", "#...#"],
+    "B": ["####.", "#...#", "#...#", "####.", "#...#", "#...#", "####."],
+    "C": [".###.", "#...#", "#....", "#....", "#....", "#...#", ".###."],
+    "D": ["###..", "#..#.", "#...#", "#...#", "#...#", "#..#.", "###.."],
+    "E": ["#####", "#....", "#....", "####.", "#....", "#....", "#####"],
+    "F": ["#####", "#....", "#....", "####.", "#....", "#....", "#...."],
+    "G": [".###.", "#...#", "#....", "#.###", "#...#", "#...#", ".####"],
+    "H": ["#...#", "#...#", "#...#", "#####", "#...#", "#...#", "#...#"],
+    "I": ["###", ".#.", ".#.", ".#.", ".#.", ".#.", "###"],
+    "J": ["..###", "...#.", "...#.", "...#.", "...#.", "#..#.", ".##.."],
+    "K": ["#...#", "#..#.", "#.#..", "##...", "#.#..", "#..#.", "#...#"],
+    "L": ["#....", "#....", "#....", "#....", "#....", "#....", "#####"],
+    "M": ["#...#", "##.##", "#.#.#", "#.#.#", "#...#", "#...#", "#...#"],
+    "N": ["#...#", "#...#", "##..#", "#.#.#", "#..##", "#...#", "#...#"],
+    "O": [".###.", "#...#", "#...#", "#...#", "#...#", "#...#", ".###."],
+    "P": ["####.", "#...#", "#...#", "####.", "#....", "#....", "#...."],
+    "Q": [".###.", "#...#", "#...#", "#...#", "#.#.#", "#..#.", ".##.#"],
+    "R": ["####.", "#...#", "#...#", "####.", "#.#..", "#..#.", "#...#"],
+    "S": [".####", "#....", "#....", ".###.", "....#", "....#", "####."],
+    "T": ["#####", "..#..", "..#..", "..#..", "..#..", "..#..", "..#.."],
+    "U": ["#...#", "#...#", "#...#", "#...#", "#...#", "#...#", ".###."],
+    "V": ["#...#", "#...#", "#...#", "#...#", "#...#", ".#.#.", "..#.."],
+    "W": ["#...#", "#...#", "#...#", "#.#.#", "#.#.#", "#.#.#", ".#.#."],
+    "X": ["#...#", "#...#", ".#.#.", "..#..", ".#.#.", "#...#", "#...#"],
+    "Y": ["#...#", "#...#", ".#.#.", "..#..", "..#..", "..#..", "..#.."],
+    "Z": ["#####", "....#", "...#.", "..#..", ".#...", "#....", "#####"],
+    "[": ["##", "#.", "#.", "#.", "#.", "#.", "##"],
+    "\\": [".....", "#....", ".#...", "..#..", "...#.", "....#", "....."],
+    "]": ["##", ".#", ".#", ".#", ".#", ".#", "##"],
+    "^": ["..#..", ".#.#.", "#...#", ".....", ".....", ".....", "....."],
+    "_": ["....", "....", "....", "....", "....", "....", "....", "####"],
+    "`": ["#.", ".#", "..", "..", "..", "..", ".."],
+    "a": ["....", "....", ".##.", "...#", ".###", "#..#", ".###"],
+    "b": ["#...", "#...", "#.#.", "##.#", "#..#", "#..#", "###."],
+    "c": ["....", "....", ".##.", "#..#", "#...", "#..#", ".##."],
+    "d": ["...#", "...#", ".#.#", "#.##", "#..#", "#..#", ".###"],
+    "e": ["....", "....", ".##.", "#..#", "####", "#...", ".###"],
+    "f": ["..#", ".#.", "###", ".#.", ".#.", ".#.", ".#."],
+    "g": ["....", "....", ".###", "#..#", "#..#", ".###", "...#", ".##."],
+    "h": ["#...", "#...", "#.#.", "##.#", "#..#", "#..#", "#..#"],
+    "i": [".", "#", ".", "#", "#", "#", "#"],
+    "j": ["...", "..#", "...", "..#", "..#", "..#", "..#", "##."],
+    "k": ["#...", "#...", "#..#", "#.#.", "##..", "#.#.", "#..#"],
+    "l": ["#.", "#.", "#.", "#.", "#.", "#.", ".#"],
+    "m": [".....", ".....", "##.#.", "#.#.#", "#.#.#", "#.#.#", "#.#.#"],
+    "n": ["....", "....", "#.#.", "##.#", "#..#", "#..#", "#..#"],
+    "o": ["....", "....", ".##.", "#..#", "#..#", "#..#", ".##."],
+    "p": ["....", "....", "###.", "#..#", "#..#", "###.", "#...", "#..."],
+    "q": ["....", "....", ".###", "#..#", "#..#", ".###", "...#", "...#"],
+    "r": ["....", "....", "#.##", "##..", "#...", "#...", "#..."],
+    "s": ["....", "....", ".###", "#...", ".##.", "...#", "###."],
+    "t": [".#.", ".#.", "###", ".#.", ".#.", ".#.", "..#"],
+    "u": ["....", "....", "#..#", "#..#", "#..#", "#.##", ".#.#"],
+    "v": [".....", ".....", "#...#", "#...#", "#...#", ".#.#.", "..#.."],
+    "w": [".....", ".....", "#...#", "#...#", "#.#.#", "#.#.#", ".#.#."],
+    "x": [".....", ".....", "#...#", ".#.#.", "..#..", ".#.#.", "#...#"],
+    "y": ["....", "....", "#..#", "#..#", "#..#", ".###", "...#", ".##."],
+    "z": ["....", "....", "####", "...#", "..#.", ".#..", "####"],
+    "{": ["..#", ".#.", ".#.", "#..", ".#.", ".#.", "..#"],
+    "|": ["#", "#", "#", "#", "#", "#", "#"],
+    "}": ["#..", ".#.", ".#.", "..#", ".#.", ".#.", "#.."],
+    "~": [".....", ".....", ".#...", "#.#.#", "...#.", ".....", "....."],
+}
+
+# --- Latin-1 symbols (U+00A0..U+00FF that are not accented letters) ---------
+
+LATIN1 = {
+    0xA0: ASCII[" "],
+    0xA1: ["#", ".", "#", "#", "#", "#", "#"],
+    0xA2: ["..#..", ".####", "#.#..", "#.#..", "#.#..", ".####", "..#.."],
+    0xA3: ["..##.", ".#..#", ".#...", "###..", ".#...", ".#..#", "#.##."],
+    0xA4: [".....", "#...#", ".###.", ".#.#.", ".###.", "#...#", "....."],
+    0xA5: ["#...#", ".#.#.", "#####", "..#..", "#####", "..#..", "..#.."],
+    0xA6: ["#", "#", "#", ".", "#", "#", "#"],
+    0xA7: [".###", "#...", ".##.", "#..#", ".##.", "...#", "###."],
+    0xA8: ["#.#", "...", "...", "...", "...", "...", "..."],
+    0xA9: [".#####.", "#.....#", "#..##.#", "#.#...#", "#..##.#", "#.....#", ".#####."],
+    0xAA: ["##.", "..#", "###", "#.#", "###", "...", "..."],
+    0xAB: [".....", "..#.#", ".#.#.", "#.#..", ".#.#.", "..#.#", "....."],
+    0xAC: [".....", ".....", "#####", "....#", "....#", ".....", "....."],
+    0xAD: ["...", "...", "...", "###", "...", "...", "..."],
+    0xAE: [".#####.", "#.....#", "#.##..#", "#.#.#.#", "#.##..#", "#.#.#.#", ".#####."],
+    0xAF: ["####", "....", "....", "....", "....", "....", "...."],
+    0xB0: [".#.", "#.#", ".#.", "...", "...", "...", "..."],
+    0xB1: ["..#..", "..#..", "#####", "..#..", "..#..", ".....", "#####"],
+    0xB2: ["##.", "..#", ".#.", "###", "...", "...", "..."],
+    0xB3: ["##.", "..#", ".#.", "..#", "##.", "...", "..."],
+    0xB4: [".#", "#.", "..", "..", "..", "..", ".."],
+    0xB5: ["....", "....", "#..#", "#..#", "#..#", "###.", "#...", "#..."],
+    0xB6: [".####", "###.#", "###.#", ".##.#", "..#.#", "..#.#", "..#.#"],
+    0xB7: [".", ".", ".", "#", ".", ".", "."],
+    0xB8: ["..", "..", "..", "..", "..", "..", ".#", "#."],
+    0xB9: [".#", "##", ".#", ".#", "..", "..", ".."],
+    0xBA: [".#.", "#.#", ".#.", "...", "###", "...", "..."],
+    0xBB: [".....", "#.#..", ".#.#.", "..#.#", ".#.#.", "#.#..", "....."],
+    0xBC: ["#....#.", "#...#..", "#..#...", "..#..#.", ".#..##.", "#..####", ".....#."],
+    0xBD: ["#....#.", "#...#..", "#..#...", "..#.##.", ".#...#.", "#...#..", "....###"],
+    0xBE: ["##...#.", ".#..#..", "##.#...", "..#..#.", ".#..##.", "#..####", ".....#."],
+    0xBF: ["..#..", ".....", "..#..", ".#...", "#....", "#...#", ".###."],
+    0xC6: [".####", "#.#..", "#.#..", "#####", "#.#..", "#.#..", "#.###"],
+    0xD0: [".###..", ".#..#.", ".#...#", "####.#", ".#...#", ".#..#.", ".###.."],
+    0xD7: [".....", "#...#", ".#.#.", "..#..", ".#.#.", "#...#", "....."],
+    0xD8: [".####", "#..##", "#.#.#", "#.#.#", "#.#.#", "##..#", "####."],
+    0xDE: ["#....", "####.", "#...#", "#...#", "####.", "#....", "#...."],
+    0xDF: [".##.", "#..#", "#..#", "#.#.", "#..#", "#..#", "#.#."],
+    0xE6: [".....", ".....", "##.#.", "..#.#", ".####", "#.#..", ".#.##"],
+    0xF0: ["#.#.", ".#..", "#.#.", ".###", "#..#", "#..#", ".##."],
+    0xF7: [".....", "..#..", ".....", "#####", ".....", "..#..", "....."],
+    0xF8: ["....", "....", ".###", "#.##", "##.#", "##.#", "###."],
+    0xFE: ["#...", "#...", "###.", "#..#", "#..#", "###.", "#...", "#..."],
+}
+
+# Two-row accents drawn above x-height letters and squeezed capitals
+ACCENTS = {
+    "grave": ["#.", ".#"],
+    "acute": [".#", "#."],
+    "circumflex": [".#.", "#.#"],
+    "tilde": [".#.#", "#.#."],
+    "diaeresis": ["...", "#.#"],
+    "ring": ["##", "##"],
+}
+
+# Code point: (base letter, accent)
+ACCENTED = {
+    0xC0: ("A", "grave"), 0xC1: ("A", "acute"), 0xC2: ("A", "circumflex"),
+    0xC3: ("A", "tilde"), 0xC4: ("A", "diaeresis"), 0xC5: ("A", "ring"),
+    0xC8: ("E", "grave"), 0xC9: ("E", "acute"), 0xCA: ("E", "circumflex"), 0xCB: ("E", "diaeresis"),
+    0xCC: ("I", "grave"), 0xCD: ("I", "acute"), 0xCE: ("I", "circumflex"), 0xCF: ("I", "diaeresis"),
+    0xD1: ("N", "tilde"),
+    0xD2: ("O", "grave"), 0xD3: ("O", "acute"), 0xD4: ("O", "circumflex"),
+    0xD5: ("O", "tilde"), 0xD6: ("O", "diaeresis"),
+    0xD9: ("U", "grave"), 0xDA: ("U", "acute"), 0xDB: ("U", "circumflex"), 0xDC: ("U", "diaeresis"),
+    0xDD: ("Y", "acute"),
+    0xE0: ("a", "grave"), 0xE1: ("a", "acute"), 0xE2: ("a", "circumflex"),
+    0xE3: ("a", "tilde"), 0xE4: ("a", "diaeresis"), 0xE5: ("a", "ring"),
+    0xE8: ("e", "grave"), 0xE9: ("e", "acute"), 0xEA: ("e", "circumflex"), 0xEB: ("e", "diaeresis"),
+    0xEC: ("dotless_i", "grave"), 0xED: ("dotless_i", "acute"),
+    0xEE: ("dotless_i", "circumflex"), 0xEF: ("dotless_i", "diaeresis"),
+    0xF1: ("n", "tilde"),
+    0xF2: ("o", "grave"), 0xF3: ("o", "acute"), 0xF4: ("o", "circumflex"),
+    0xF5: ("o", "tilde"), 0xF6: ("o", "diaeresis"),
+    0xF9: ("u", "grave"), 0xFA: ("u", "acute"), 0xFB: ("u", "circumflex"), 0xFC: ("u", "diaeresis"),
+    0xFD: ("y", "acute"), 0xFF: ("y", "diaeresis"),
+}
+
+# Rows kept when a capital is squeezed from seven rows to five
+SQUEEZE_ROWS = {"N": [0, 2, 3, 4, 6]}
+SQUEEZE_DEFAULT = [0, 2, 3, 5, 6]
+
+# Letters with a cedilla hung below row 6
+CEDILLA = {0xC7: "C", 0xE7: "c"}
+
+# --- Arrows, triangles and block elements ----------------------------------
+
+SYMBOLS = {
+    0x2190: [".....", "..#..", ".#...", "#####", ".#...", "..#..", "....."],
+    0x2191: ["..#..", ".###.", "#.#.#", "..#..", "..#..", "..#..", "..#.."],
+    0x2192: [".....", "..#..", "...#.", "#####", "...#.", "..#..", "....."],
+    0x2193: ["..#..", "..#..", "..#..", "..#..", "#.#.#", ".###.", "..#.."],
+    0x2194: [".......", "..#.#..", ".#...#.", "#######", ".#...#.", "..#.#..", "......."],
+    0x2195: [".#.", "###", "#.#", ".#.", "#.#", "###", ".#."],
+    0x25B2: [".....", ".....", "..#..", ".###.", "#####", ".....", "....."],
+    0x25B6: ["#...", "##..", "###.", "####", "###.", "##..", "#..."],
+    0x25BC: [".....", ".....", "#####", ".###.", "..#..", ".....", "....."],
+    0x25C0: ["...#", "..##", ".###", "####", ".###", "..##", "...#"],
+}
+
+BLOCK_WIDTH = 8   # One block element per module
+
+
+def block_rows(lit):
+    """Rows for an 8x8 cell where lit(row, col) decides each pixel."""
+    return ["".join("#" if lit(r, c) else "." for c in range(BLOCK_WIDTH)) for r in range(HEIGHT)]
+
+
+BLOCKS = {
+    0x2580: block_rows(lambda r, c: r < 4),
+    0x2588: block_rows(lambda r, c: True),
+    0x2590: block_rows(lambda r, c: c >= 4),
+    0x2591: block_rows(lambda r, c: r % 2 == 0 and c % 2 == (r // 2) % 2),
+    0x2592: block_rows(lambda r, c: (r + c) % 2 == 0),
+    0x2593: block_rows(lambda r, c: not (r % 2 == 1 and c % 2 == 0)),
+}
+for n in range(1, 8):
+    BLOCKS[0x2580 + n] = block_rows(lambda r, c, n=n: r >= HEIGHT - n)      # Lower n/8
+    BLOCKS[0x2590 - n] = block_rows(lambda r, c, n=n: c < n)                # Left n/8
+
+# Shown for anything the font does not cover
+FALLBACK = ["#####", "#...#", "#...#", "#...#", "#...#", "#...#", "#####"]
+
+
+def pad(rows):
+    rows = list(rows)
+    width = len(rows[0])
+    for row in rows:
+        if len(row) != width:
+            raise ValueError(f"ragged glyph: {rows}")
+    return rows + ["." * width] * (HEIGHT - len(rows))
+
+
+def accented(base, accent):
+    if base == "dotless_i":
+        letter = [".#.", ".#.", ".#.", ".#.", ".#."]
+    elif base.isupper():
+        rows = ASCII[base]
+        letter = [rows[r] for r in SQUEEZE_ROWS.get(base, SQUEEZE_DEFAULT)]
+    else:
+        letter = ASCII[base][2:7]
+
+    width = len(letter[0])
+    mark = ACCENTS[accent]
+    if len(mark[0]) > width:
+        raise ValueError(f"{accent} wider than {base}")
+    left = (width - len(mark[0])) // 2
+    top = ["." * left + m + "." * (width - left - len(m)) for m in mark]
+    tail = ASCII[base][7:] if base in ASCII else []
+    return top + letter + tail
+
+
+def with_cedilla(base):
+    rows = pad(ASCII[base])
+    width = len(rows[0])
+    rows[7] = "." * (width // 2) + "#" + "." * (width - width // 2 - 1)
+    return rows
+
+
+def columns_of(rows):
+    rows = pad(rows)
+    cols = []
+    for c in range(len(rows[0])):
+        byte = 0
+        for r in range(HEIGHT):
+            if rows[r][c] == "#":
+                byte |= 1 << r
+        cols.append(byte)
+    return cols
+
+
+def build_glyphs():
+    """Returns (glyphs, ranges): glyphs as (name, columns, flags) and
+    ranges as (first code point, count, first glyph)."""
+    table = {}
+    for ch, rows in ASCII.items():
+        table[ord(ch)] = (rows, 0)
+    for cp, rows in LATIN1.items():
+        table[cp] = (rows, 0)
+    for cp, (base, accent) in ACCENTED.items():
+        table[cp] = (accented(base, accent), 0)
+    for cp, base in CEDILLA.items():
+        table[cp] = (with_cedilla(base), 0)
+    for cp, rows in SYMBOLS.items():
+        table[cp] = (rows, 0)
+    for cp, rows in BLOCKS.items():
+        table[cp] = (rows, FLAG_JOIN)
+
+    for cp in list(range(0x20, 0x7F)) + list(range(0xA0, 0x100)):
+        if cp not in table:
+            raise ValueError(f"missing glyph U+{cp:04X}")
+
+    glyphs = []
+    ranges = []
+    for cp in sorted(table):
+        rows, flags = table[cp]
+        if ranges and ranges[-1][0] + ranges[-1][1] == cp:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([cp, 1, len(glyphs)])
+        glyphs.append((f"U+{cp:04X}", columns_of(rows), flags))
+
+    glyphs.append(("fallback", columns_of(FALLBACK), 0))
+    return glyphs, ranges
+
+
+def edge_rows(byte):
+    return [r for r in range(HEIGHT) if byte & (1 << r)]
+
+
+def kerns(left, right):
+    """A pair kerns when the facing edge columns stay two rows apart."""
+    a = edge_rows(left[-1])
+    b = edge_rows(right[0])
+    if not a or not b:
+        return False
+    return all(abs(x - y) >= 2 for x in a for y in b)
+
+
+# Only glyphs with an open side are worth pairing; everything else keeps
+# its full gap so dense text stays legible
+KERN_LEFT = "TFPVWYrf7\"'"
+KERN_RIGHT = "acdegmnopqrsuvwxyz.,-:"
+
+
+def build_kern_pairs(glyphs, index_of):
+    pairs = []
+    for l in KERN_LEFT:
+        for r in KERN_RIGHT + KERN_LEFT.upper():
+            li, ri = index_of(ord(l)), index_of(ord(r))
+            if kerns(glyphs[li][1], glyphs[ri][1]):
+                pairs.append(li << 8 | ri)
+    return sorted(set(pairs))
+
+
+def make_index_of(ranges, fallback):
+    def index_of(cp):
+        for first, count, glyph in ranges:
+            if first <= cp < first + count:
+                return glyph + cp - first
+        return fallback
+    return index_of
+
+
+def measure(text, glyphs, index_of, kern_pairs, spacing=1):
+    width = 0
+    prev = None
+    for ch in text:
+        g = index_of(ord(ch))
+        if prev is not None:
+            if not (glyphs[prev][2] & glyphs[g][2] & FLAG_JOIN):
+                gap = spacing
+                if gap > 0 and (prev << 8 | g) in kern_pairs:
+                    gap -= 1
+                width += gap
+        width += len(glyphs[g][1])
+        prev = g
+    return width
+
+
+def write_header(path, glyphs, ranges, kern_pairs):
+    if len(glyphs) > 256:
+        raise ValueError("kern pairs pack glyph indices into a byte")
+
+    out = []
+    out.append("// Generated by tools/gen_font_atlas.py - edit the glyphs there, not here.")
+    out.append("#ifndef FONT_ATLAS_H")
+    out.append("#define FONT_ATLAS_H")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append(f"#define FONT_HEIGHT {HEIGHT}")
+    out.append(f"#define FONT_GLYPH_COUNT {len(glyphs)}")
+    out.append(f"#define FONT_FALLBACK_GLYPH {len(glyphs) - 1}")
+    out.append(f"#define FONT_MAX_GLYPH_WIDTH {max(len(g[1]) for g in glyphs)}")
+    out.append(f"#define FONT_FLAG_JOIN 0x{FLAG_JOIN:02X}   // No gap between two joining glyphs")
+    out.append("")
+    out.append("typedef struct {")
+    out.append("  uint16_t offset;   // First column in FONT_COLUMNS")
+    out.append("  uint8_t width;")
+    out.append("  uint8_t flags;")
+    out.append("} FontGlyph;")
+    out.append("")
+    out.append("typedef struct {")
+    out.append("  uint32_t first;    // First code point")
+    out.append("  uint16_t count;")
+    out.append("  uint16_t glyph;    // Glyph of the first code point")
+    out.append("} FontRange;")
+    out.append("")
+
+    offsets = []
+    offset = 0
+    out.append("// One byte per column, bit r = row r")
+    out.append("inline constexpr uint8_t FONT_COLUMNS[] = {")
+    for name, cols, flags in glyphs:
+        offsets.append(offset)
+        offset += len(cols)
+        out.append("  " + ", ".join(f"0x{c:02X}" for c in cols) + f",   // {name}")
+    out.append("};")
+    out.append("")
+
+    out.append("inline constexpr FontGlyph FONT_GLYPHS[FONT_GLYPH_COUNT] = {")
+    line = []
+    for (name, cols, flags), off in zip(glyphs, offsets):
+        line.append(f"{{{off}, {len(cols)}, {flags}}}")
+        if len(line) == 6:
+            out.append("  " + ", ".join(line) + ",")
+            line = []
+    if line:
+        out.append("  " + ", ".join(line) + ",")
+    out.append("};")
+    out.append("")
+
+    out.append("inline constexpr FontRange FONT_RANGES[] = {")
+    for first, count, glyph in ranges:
+        out.append(f"  {{0x{first:04X}, {count}, {glyph}}},")
+    out.append("};")
+    out.append("")
+
+    out.append("// Sorted (left << 8 | right) glyph pairs set one column tighter")
+    out.append("inline constexpr uint16_t FONT_KERN_PAIRS[] = {")
+    for i in range(0, len(kern_pairs), 10):
+        out.append("  " + ", ".join(f"0x{p:04X}" for p in kern_pairs[i:i + 10]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("#endif // FONT_ATLAS_H")
+
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the LED font atlas header")
+    parser.add_argument("--measure", type=str, help="Print the width of TEXT in columns instead")
+    parser.add_argument("--spacing", type=int, default=1, help="Columns between characters (default 1)")
+    parser.add_argument("--output", type=str, default=OUT_PATH, help="Header to write")
+    args = parser.parse_args()
+
+    glyphs, ranges = build_glyphs()
+    index_of = make_index_of(ranges, len(glyphs) - 1)
+    kern_pairs = build_kern_pairs(glyphs, index_of)
+
+    if args.measure is not None:
+        print(measure(args.measure, glyphs, index_of, set(kern_pairs), args.spacing))
+        return
+
+    write_header(args.output, glyphs, ranges, kern_pairs)
+    print(f"✅ {len(glyphs)} glyphs, {sum(len(g[1]) for g in glyphs)} columns, "
+          f"{len(ranges)} ranges, {len(kern_pairs)} kern pairs -> {os.path.normpath(args.output)}")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
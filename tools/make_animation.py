@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Build a .anim file for bitmap/animation items (format in
+src/includes/animation.h).
+
+Frames come from a GIF, a list of images, or a text file of '#'/'.' art
+with frames separated by blank lines. Images are scaled to 8 rows and
+thresholded; Pillow is only needed for image input. Each frame is stored
+as whichever of raw, RLE or XOR-delta RLE is smallest.
+
+Examples:
+  python3 tools/make_animation.py --gif spinner.gif -o spinner.anim
+  python3 tools/make_animation.py --art pacman.txt --delay 120 -o pacman.anim
+  python3 -m python-CLI upload-animation --name pacman --file pacman.anim
+"""
+import argparse
+import struct
+import sys
+
+HEIGHT = 8
+MAX_WIDTH = 96          # 12 modules
+VERSION = 1
+FRAME_RAW, FRAME_RLE, FRAME_DELTA = 0, 1, 2
+
+
+def packbits(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        # Run of identical bytes
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out += bytes([(1 - run) & 0xFF, data[i]])
+            i += run
+            continue
+
+        # Literal stretch up to the next run of two or more
+        start = i
+        while i < len(data) and i - start < 128:
+            if i + 1 < len(data) and data[i] == data[i + 1]:
+                break
+            i += 1
+        out += bytes([i - start - 1]) + bytes(data[start:i])
+    return bytes(out)
+
+
+def encode_frame(frame, prev):
+    options = [(FRAME_RAW, bytes(frame)), (FRAME_RLE, packbits(frame))]
+    if prev is not None:
+        options.append((FRAME_DELTA, packbits(bytes(a ^ b for a, b in zip(frame, prev)))))
+    kind, payload = min(options, key=lambda o: len(o[1]))
+    return struct.pack("<BH", kind, len(payload)) + payload
+
+
+def encode(frames, delay):
+    width = len(frames[0])
+    out = bytearray(b"LEDA" + struct.pack("<BBHHH", VERSION, 0, width, len(frames), delay))
+    prev = None
+    for frame in frames:
+        out += encode_frame(frame, prev)
+        prev = frame
+    return bytes(out)
+
+
+def columns_from_rows(rows, width):
+    cols = []
+    for c in range(width):
+        byte = 0
+        for r in range(min(HEIGHT, len(rows))):
+            if c < len(rows[r]) and rows[r][c] == "#":
+                byte |= 1 << r
+        cols.append(byte)
+    return cols
+
+
+def frames_from_art(path):
+    with open(path, encoding="utf-8") as f:
+        blocks = [b.split("\n") for b in f.read().strip().split("\n\n")]
+    width = max(len(row) for block in blocks for row in block)
+    return [columns_from_rows(block, width) for block in blocks]
+
+
+def frames_from_images(images, width, threshold, invert):
+    frames = []
+    for image in images:
+        image = image.convert("L")
+        w = width or max(1, round(image.width * HEIGHT / image.height))
+        image = image.resize((min(w, MAX_WIDTH), HEIGHT))
+        rows = []
+        for y in range(HEIGHT):
+            rows.append("".join("#" if (image.getpixel((x, y)) >= threshold) != invert else "."
+                                for x in range(image.width)))
+        frames.append(columns_from_rows(rows, image.width))
+    return frames
+
+
+def load_images(args):
+    try:
+        from PIL import Image, ImageSequence
+    except ImportError:
+        sys.exit("❌ Pillow is required for image input (pip install pillow)")
+
+    if args.gif:
+        gif = Image.open(args.gif)
+        delay = gif.info.get("duration", 100)
+        return [frame.copy() for frame in ImageSequence.Iterator(gif)], delay
+    return [Image.open(p) for p in args.frames], None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build a .anim file for the LED matrix")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--gif", help="Animated GIF")
+    source.add_argument("--frames", nargs="+", help="Images, one per frame")
+    source.add_argument("--art", help="Text file of '#'/'.' frames separated by blank lines")
+    parser.add_argument("--width", type=int, help="Scale images to this many columns")
+    parser.add_argument("--threshold", type=int, default=128, help="Gray level that lights a pixel")
+    parser.add_argument("--invert", action="store_true", help="Light dark pixels instead")
+    parser.add_argument("--delay", type=int, help="ms per frame (default: GIF timing or 100)")
+    parser.add_argument("-o", "--output", required=True, help="File to write")
+    args = parser.parse_args()
+
+    delay = None
+    if args.art:
+        frames = frames_from_art(args.art)
+    else:
+        images, delay = load_images(args)
+        frames = frames_from_images(images, args.width, args.threshold, args.invert)
+
+    width = len(frames[0])
+    if width > MAX_WIDTH or any(len(f) != width for f in frames):
+        sys.exit(f"❌ Frames must share one width of at most {MAX_WIDTH} columns")
+
+    data = encode(frames, args.delay or delay or 100)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print(f"✅ {len(frames)} frames, {width} columns: {len(data)} bytes "
+          f"({len(frames) * width} uncompressed) -> {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Stream frames to the realtime UDP port (format in
+src/includes/realtime_packet.h), or measure loss and latency.
+
+send     stream a test pattern; rows that did not change go as delta
+         frames, with a full frame every --keyframe frames
+test     send --count frames asking for acks and report loss and
+         round-trip time (the receiver's /debug "realtime" has its side);
+         --drop leaves out some frames on purpose, as a lossy link would
+release  hand the display back to the playlist now
+
+Without hardware, `pio test -e native -f test_realtime_udp` builds the
+firmware's receiver (src/realtime.cpp) on the host and runs `test`
+against it over loopback.
+
+Examples:
+  python3 tools/realtime_sender.py send --host ledmatrix.local --pattern scroll --fps 40
+  python3 tools/realtime_sender.py test --host ledmatrix.local --count 2000 --fps 200
+"""
+import argparse
+import math
+import random
+import select
+import socket
+import struct
+import sys
+import time
+
+PORT = 4048
+ROWS = 8
+DEVICES = 12
+COLS = DEVICES * 8
+HEADER = struct.Struct("<2sBBHHI")
+FULL, DELTA, RELEASE = 0, 1, 2
+FLAG_ACK = 0x01
+
+
+def blank():
+    return [bytearray(DEVICES) for _ in range(ROWS)]
+
+
+def set_pixel(frame, x, row):
+    """Light screen column x (0 = leftmost). Frame column 0 is the rightmost."""
+    col = COLS - 1 - x
+    frame[row][col // 8] |= 1 << (col % 8)
+
+
+def pattern_frame(name, t):
+    frame = blank()
+    if name == "scroll":
+        # A diagonal band moving left
+        for x in range(COLS):
+            for row in range(ROWS):
+                if (x + row + t) % 16 < 4:
+                    set_pixel(frame, x, row)
+    elif name == "sine":
+        for x in range(COLS):
+            row = int(3.5 + 3.5 * math.sin((x + t) / 6.0))
+            set_pixel(frame, x, row)
+    elif name == "bounce":
+        # One lit row sweeping up and down: exercises single-row deltas
+        row = abs((t % 14) - 7)
+        for x in range(COLS):
+            set_pixel(frame, x, row)
+    else:
+        rng = random.Random(t)
+        for x in range(COLS):
+            for row in range(ROWS):
+                if rng.random() < 0.2:
+                    set_pixel(frame, x, row)
+    return frame
+
+
+def encode(frame, prev, seq, base, flags, keyframe):
+    stamp = time.monotonic_ns() // 1000 & 0xFFFFFFFF
+    if not keyframe and prev is not None:
+        mask = 0
+        rows = b""
+        for row in range(ROWS):
+            if frame[row] != prev[row]:
+                mask |= 1 << row
+                rows += bytes(frame[row])
+        if 1 + len(rows) < ROWS * DEVICES:
+            return HEADER.pack(b"LR", DELTA, flags, seq, base, stamp) + bytes([mask]) + rows
+    payload = b"".join(bytes(r) for r in frame)
+    return HEADER.pack(b"LR", FULL, flags, seq, seq, stamp) + payload
+
+
+def release_packet(seq):
+    return HEADER.pack(b"LR", RELEASE, 0, seq, seq, 0)
+
+
+def stream(args, flags, on_sent=None, sock=None, idle=time.sleep, skip=None):
+    sock = sock or socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    target = (args.host, args.port)
+    period = 1.0 / args.fps
+    frames = args.count if args.count else int(args.seconds * args.fps)
+    prev = None
+    seq = args.start_seq & 0xFFFF
+    next_time = time.monotonic()
+    for t in range(frames):
+        frame = pattern_frame(args.pattern, t)
+        keyframe = prev is None or t % args.keyframe == 0
+        packet = encode(frame, prev, seq, (seq - 1) & 0xFFFF, flags, keyframe)
+        if not (skip and skip(t)):
+            sock.sendto(packet, target)
+            if on_sent:
+                on_sent(seq, packet)
+        prev = frame
+        seq = (seq + 1) & 0xFFFF
+
+        next_time += period
+        delay = next_time - time.monotonic()
+        if delay > 0:
+            idle(delay)
+    return seq
+
+
+def cmd_send(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    seq = stream(args, 0, sock=sock)
+    if args.release:
+        sock.sendto(release_packet(seq), (args.host, args.port))
+    print(f"sent {args.count or int(args.seconds * args.fps)} frames to {args.host}:{args.port}")
+
+
+def cmd_test(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setblocking(False)
+    sent = {}
+    rtts = []
+
+    def drain():
+        while True:
+            try:
+                data, _ = sock.recvfrom(64)
+            except BlockingIOError:
+                return
+            if len(data) < HEADER.size:
+                continue
+            magic, kind, _, seq, _, _ = HEADER.unpack_from(data)
+            if magic != b"LA" or seq not in sent:
+                continue
+            rtts.append((time.monotonic() - sent.pop(seq)) * 1000.0)
+
+    def on_sent(seq, packet):
+        sent[seq] = time.monotonic()
+
+    def idle(delay):
+        # Wait for acks between frames so round trips are timed on arrival
+        end = time.monotonic() + delay
+        while True:
+            remaining = end - time.monotonic()
+            if remaining <= 0:
+                return
+            if select.select([sock], [], [], remaining)[0]:
+                drain()
+
+    # Never the first or last frame, so every gap is followed by a frame
+    # that shows it
+    count = args.count
+    rng = random.Random(args.seed)
+    dropped = []
+
+    def skip(t):
+        drop = rng.random() * 100.0 < args.drop and 0 < t < count - 1
+        if drop:
+            dropped.append(t)
+        return drop
+
+    stream(args, FLAG_ACK, on_sent=on_sent, sock=sock, idle=idle, skip=skip)
+
+    deadline = time.monotonic() + args.wait
+    while sent and time.monotonic() < deadline:
+        drain()
+        time.sleep(0.001)
+    sock.sendto(release_packet(0), (args.host, args.port))
+
+    lost = len(sent)
+    sent_count = count - len(dropped)
+    print(f"frames sent: {sent_count}")
+    print(f"dropped:     {len(dropped)} (--drop, never sent)")
+    print(f"acks:        {len(rtts)}")
+    print(f"lost:        {lost} ({100.0 * lost / max(sent_count, 1):.2f}%)")
+    if rtts:
+        rtts.sort()
+        pick = lambda q: rtts[min(len(rtts) - 1, int(q * len(rtts)))]
+        print(f"rtt ms:      min {rtts[0]:.3f}  p50 {pick(0.5):.3f}  "
+              f"p99 {pick(0.99):.3f}  max {rtts[-1]:.3f}")
+    return 1 if lost > sent_count * args.max_loss / 100.0 else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Realtime UDP frames for the LED matrix")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    def add_stream_args(p):
+        p.add_argument("--host", default="127.0.0.1", help="Display address")
+        p.add_argument("--port", type=int, default=PORT)
+        p.add_argument("--pattern", default="scroll", choices=["scroll", "sine", "bounce", "noise"])
+        p.add_argument("--fps", type=float, default=40.0)
+        p.add_argument("--keyframe", type=int, default=25, help="Full frame every N frames")
+        p.add_argument("--start-seq", type=int, default=0)
+
+    p = sub.add_parser("send", help="Stream a test pattern")
+    add_stream_args(p)
+    p.add_argument("--seconds", type=float, default=10.0)
+    p.add_argument("--count", type=int, default=0, help="Frames to send (overrides --seconds)")
+    p.add_argument("--release", action="store_true", help="Release the display when done")
+
+    p = sub.add_parser("test", help="Measure loss and round-trip time with acks")
+    add_stream_args(p)
+    p.add_argument("--count", type=int, default=1000)
+    p.add_argument("--wait", type=float, default=1.0, help="Seconds to wait for the last acks")
+    p.add_argument("--max-loss", type=float, default=1.0, help="Fail above this loss percentage")
+    p.add_argument("--drop", type=float, default=0.0, help="Leave out this percentage of frames")
+    p.add_argument("--seed", type=int, default=1, help="Which frames --drop leaves out")
+
+    p = sub.add_parser("release", help="Give the display back to the playlist")
+    p.add_argument("--host", default="127.0.0.1")
+    p.add_argument("--port", type=int, default=PORT)
+
+    args = parser.parse_args()
+    if args.command == "send":
+        cmd_send(args)
+    elif args.command == "test":
+        return cmd_test(args)
+    elif args.command == "release":
+        socket.socket(socket.AF_INET, socket.SOCK_DGRAM).sendto(release_packet(0), (args.host, args.port))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())